@@ -0,0 +1,21 @@
+#ifndef COMMAND_FLAGS_H
+#define COMMAND_FLAGS_H
+
+#include <cstdint>
+
+// Bits of CommandSpec::flags, reported by COMMAND INFO
+namespace CommandFlag {
+    constexpr uint32_t WRITE = 1 << 0;      // may modify the keyspace
+    constexpr uint32_t READONLY = 1 << 1;   // only reads keys
+    constexpr uint32_t ADMIN = 1 << 2;      // server administration
+    constexpr uint32_t FAST = 1 << 3;       // O(1) or O(log N), never blocks
+    constexpr uint32_t DENYOOM = 1 << 4;    // may add data; refused over maxmemory
+}
+
+// Cost of a command relative to its input, reported by COMMAND DOCS
+enum class CommandComplexity {
+    CONSTANT,   // O(1)
+    LINEAR      // O(N) in the arguments or the value size
+};
+
+#endif // COMMAND_FLAGS_H
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+
+// What RedisDatabase evicts once it is over maxmemory
+enum class EvictionPolicy : uint8_t {
+    NOEVICTION,      // evict nothing; commands that add data fail
+    ALLKEYS_LRU,     // least recently used key
+    ALLKEYS_LFU,     // least frequently used key
+    ALLKEYS_RANDOM,  // any key
+    VOLATILE_LRU,    // least recently used key with an expiry
+    VOLATILE_TTL     // key with the nearest expiry
+};
@@ -0,0 +1,11 @@
+#ifndef PARSE_STATUS_H
+#define PARSE_STATUS_H
+
+// Outcome of feeding a request buffer to the incremental parser
+enum class ParseStatus {
+    INCOMPLETE,   // need more bytes; call again with the same input plus the new data
+    COMPLETE,     // one request parsed
+    ERROR         // protocol error, the connection cannot be resynchronised
+};
+
+#endif // PARSE_STATUS_H
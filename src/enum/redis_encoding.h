@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+
+// How a RedisValue stores its payload
+enum class RedisEncoding : uint8_t {
+    EMBSTR,      // short string kept inside the value itself
+    INT,         // string holding a 64-bit integer, stored as the number
+    RAW,         // string in its own heap allocation
+    LINKEDLIST,  // list as std::list
+    HASHSET,     // set as a KeyTable with no values
+    HASHTABLE,   // hash as a KeyTable
+    SORTEDMAP,   // sorted set as a score-ordered std::map
+    NONE         // type without a payload
+};
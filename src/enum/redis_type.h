@@ -1,7 +1,8 @@
 #pragma once
+#include <cstdint>
 
 // Enum para los tipos de valores que maneja RedisValue
-enum class RedisType {
+enum class RedisType : uint8_t {
     STRING,
     LIST,
     SET,
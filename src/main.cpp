@@ -1,19 +1,87 @@
 #include "../src/server/tcp_server.h"
+#include "../src/utils/utility_functions.h"
 
-int main() {
+#include <string>
+
+static void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--port N] [--reactors N] [--cpu-affinity] [--maxclients N] [--io-backend epoll|io_uring] [--shards N]"
+              << " [--maxmemory BYTES] [--maxmemory-policy POLICY] [--client-query-buffer-limit BYTES]"
+              << " [--client-output-buffer-limit BYTES]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--port" && has_value) {
+            config.port = std::stoi(argv[++i]);
+        } else if (arg == "--reactors" && has_value) {
+            config.reactors = std::stoul(argv[++i]);
+        } else if (arg == "--shards" && has_value) {
+            config.database_shards = std::stoul(argv[++i]);
+        } else if (arg == "--maxclients" && has_value) {
+            config.max_clients = std::stoul(argv[++i]);
+        } else if (arg == "--maxmemory" && has_value) {
+            auto bytes = UtilityFunctions::parseMemorySize(argv[++i]);
+            if (!bytes) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            config.maxmemory = *bytes;
+        } else if (arg == "--client-query-buffer-limit" && has_value) {
+            auto bytes = UtilityFunctions::parseMemorySize(argv[++i]);
+            if (!bytes || *bytes == 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            config.client_limits.query_buffer = *bytes;
+        } else if (arg == "--client-output-buffer-limit" && has_value) {
+            auto bytes = UtilityFunctions::parseMemorySize(argv[++i]);
+            if (!bytes) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            // 0 turns the limit off, as in Redis
+            config.client_limits.output_buffer = *bytes ? *bytes : SIZE_MAX;
+        } else if (arg == "--maxmemory-policy" && has_value) {
+            auto policy = parseEvictionPolicy(argv[++i]);
+            if (!policy) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            config.maxmemory_policy = *policy;
+        } else if (arg == "--io-backend" && has_value) {
+            std::string backend = argv[++i];
+            if (backend == "io_uring") {
+                config.backend = IOBackend::IO_URING;
+            } else if (backend == "epoll") {
+                config.backend = IOBackend::EPOLL;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--cpu-affinity") {
+            config.cpu_affinity = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
 
     try {
-        TCPServer server(6379);
-        std::cout << "Starting TCP server on port 6379..." << std::endl;
-        std::cout << "Connect using: telnet localhost 6379" << std::endl;
+        TCPServer server(config);
+        std::cout << "Starting TCP server on port " << config.port << "..." << std::endl;
+        std::cout << "Connect using: telnet localhost " << config.port << std::endl;
         std::cout << "Type 'exit' to disconnect" << std::endl;
-        
+
         server.start();
-        
+
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <initializer_list>
+
+// Read-only arguments of one command. Connections build it from slices of
+// their query buffer, so nothing is copied before the command runs; the
+// slices stay valid until the command returns and must not be kept longer.
+// It can also wrap owned strings, which is what tests and internal callers use.
+class CommandArgs {
+private:
+    const std::string_view* items = nullptr;
+    size_t count = 0;
+    std::vector<std::string_view> owned_views;  // only when wrapping owned strings
+
+public:
+    CommandArgs() = default;
+    CommandArgs(const std::vector<std::string_view>& views)
+        : items(views.data()), count(views.size()) {}
+    CommandArgs(const std::vector<std::string>& strings)
+        : owned_views(strings.begin(), strings.end()) {
+        items = owned_views.data();
+        count = owned_views.size();
+    }
+    CommandArgs(std::initializer_list<std::string_view> list)
+        : owned_views(list) {
+        items = owned_views.data();
+        count = owned_views.size();
+    }
+
+    // Views may point into owned_views; copying would leave them dangling
+    CommandArgs(const CommandArgs&) = delete;
+    CommandArgs& operator=(const CommandArgs&) = delete;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    std::string_view operator[](size_t index) const { return items[index]; }
+    const std::string_view* begin() const { return items; }
+    const std::string_view* end() const { return items + count; }
+};
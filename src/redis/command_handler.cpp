@@ -1,98 +1,232 @@
 #include "command_handler.h"
+#include <array>
+#include <iterator>
 
-CommandHandler::CommandHandler() 
-    : start_time(std::chrono::system_clock::now()),
+CommandHandler::CommandHandler() : CommandHandler(std::make_unique<RedisDatabase>(), nullptr, nullptr) {}
+
+CommandHandler::CommandHandler(RedisDatabase& shared_db) : CommandHandler(nullptr, &shared_db, nullptr) {}
+
+CommandHandler::CommandHandler(RedisDatabase& shared_db, std::atomic<uint64_t>& shared_commands_processed)
+    : CommandHandler(nullptr, &shared_db, &shared_commands_processed) {}
+
+CommandHandler::CommandHandler(std::unique_ptr<RedisDatabase> own_db, RedisDatabase* shared_db,
+                               std::atomic<uint64_t>* shared_commands_processed)
+    : owned_db(std::move(own_db)),
+      db(shared_db ? *shared_db : *owned_db),
+      start_time(std::chrono::system_clock::now()),
+      total_commands_processed(shared_commands_processed ? *shared_commands_processed : own_commands_processed),
       string_commands(std::make_unique<StringCommands>(db)),
       list_commands(std::make_unique<ListCommands>(db)),
       set_commands(std::make_unique<SetCommands>(db)),
       hash_commands(std::make_unique<HashCommands>(db)),
+      zset_commands(std::make_unique<ZSetCommands>(db)),
       ttl_commands(std::make_unique<TTLCommands>(db)),
       server_commands(std::make_unique<ServerCommands>(db, start_time, total_commands_processed)) {
-    initializeCommands();
 }
 
-void CommandHandler::initializeCommands() {
+// name, handler,
+//     arity, flags, first key, last key, key step, complexity
+constexpr CommandHandler::CommandSpec CommandHandler::COMMAND_TABLE[] = {
     // String commands
-    commands["SET"] = [this](const std::vector<std::string>& args) { return string_commands->cmdSet(args); };
-    commands["GET"] = [this](const std::vector<std::string>& args) { return string_commands->cmdGet(args); };
-    commands["DEL"] = [this](const std::vector<std::string>& args) { return string_commands->cmdDel(args); };
-    commands["EXISTS"] = [this](const std::vector<std::string>& args) { return string_commands->cmdExists(args); };
-    commands["TYPE"] = [this](const std::vector<std::string>& args) { return string_commands->cmdType(args); };
-    commands["INCR"] = [this](const std::vector<std::string>& args) { return string_commands->cmdIncr(args); };
-    commands["DECR"] = [this](const std::vector<std::string>& args) { return string_commands->cmdDecr(args); };
-    commands["INCRBY"] = [this](const std::vector<std::string>& args) { return string_commands->cmdIncrBy(args); };
-    commands["DECRBY"] = [this](const std::vector<std::string>& args) { return string_commands->cmdDecrBy(args); };
-    commands["STRLEN"] = [this](const std::vector<std::string>& args) { return string_commands->cmdStrlen(args); };
-    commands["APPEND"] = [this](const std::vector<std::string>& args) { return string_commands->cmdAppend(args); };
-    commands["MGET"] = [this](const std::vector<std::string>& args) { return string_commands->cmdMget(args); };
-    commands["MSET"] = [this](const std::vector<std::string>& args) { return string_commands->cmdMset(args); };
-    
+    {"SET", &invoke<&CommandHandler::string_commands, &StringCommands::cmdSet>,
+        -3, CommandFlag::WRITE | CommandFlag::DENYOOM, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"GET", &invoke<&CommandHandler::string_commands, &StringCommands::cmdGet>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"DEL", &invoke<&CommandHandler::string_commands, &StringCommands::cmdDel>,
+        -2, CommandFlag::WRITE, 1, -1, 1, CommandComplexity::LINEAR},
+    {"UNLINK", &invoke<&CommandHandler::string_commands, &StringCommands::cmdUnlink>,
+        -2, CommandFlag::WRITE | CommandFlag::FAST, 1, -1, 1, CommandComplexity::LINEAR},
+    {"EXISTS", &invoke<&CommandHandler::string_commands, &StringCommands::cmdExists>,
+        -2, CommandFlag::READONLY | CommandFlag::FAST, 1, -1, 1, CommandComplexity::LINEAR},
+    {"TYPE", &invoke<&CommandHandler::string_commands, &StringCommands::cmdType>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"INCR", &invoke<&CommandHandler::string_commands, &StringCommands::cmdIncr>,
+        2, CommandFlag::WRITE | CommandFlag::DENYOOM | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"DECR", &invoke<&CommandHandler::string_commands, &StringCommands::cmdDecr>,
+        2, CommandFlag::WRITE | CommandFlag::DENYOOM | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"INCRBY", &invoke<&CommandHandler::string_commands, &StringCommands::cmdIncrBy>,
+        3, CommandFlag::WRITE | CommandFlag::DENYOOM | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"DECRBY", &invoke<&CommandHandler::string_commands, &StringCommands::cmdDecrBy>,
+        3, CommandFlag::WRITE | CommandFlag::DENYOOM | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"STRLEN", &invoke<&CommandHandler::string_commands, &StringCommands::cmdStrlen>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"APPEND", &invoke<&CommandHandler::string_commands, &StringCommands::cmdAppend>,
+        3, CommandFlag::WRITE | CommandFlag::DENYOOM | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"MGET", &invoke<&CommandHandler::string_commands, &StringCommands::cmdMget>,
+        -2, CommandFlag::READONLY | CommandFlag::FAST, 1, -1, 1, CommandComplexity::LINEAR},
+    {"MSET", &invoke<&CommandHandler::string_commands, &StringCommands::cmdMset>,
+        -3, CommandFlag::WRITE | CommandFlag::DENYOOM, 1, -1, 2, CommandComplexity::LINEAR},
+
     // List commands
-    commands["LPUSH"] = [this](const std::vector<std::string>& args) { return list_commands->cmdLpush(args); };
-    commands["RPUSH"] = [this](const std::vector<std::string>& args) { return list_commands->cmdRpush(args); };
-    commands["LPOP"] = [this](const std::vector<std::string>& args) { return list_commands->cmdLpop(args); };
-    commands["RPOP"] = [this](const std::vector<std::string>& args) { return list_commands->cmdRpop(args); };
-    commands["LLEN"] = [this](const std::vector<std::string>& args) { return list_commands->cmdLlen(args); };
-    commands["LRANGE"] = [this](const std::vector<std::string>& args) { return list_commands->cmdLrange(args); };
-    commands["LINDEX"] = [this](const std::vector<std::string>& args) { return list_commands->cmdLindex(args); };
-    commands["LSET"] = [this](const std::vector<std::string>& args) { return list_commands->cmdLset(args); };
-    
+    {"LPUSH", &invoke<&CommandHandler::list_commands, &ListCommands::cmdLpush>,
+        -3, CommandFlag::WRITE | CommandFlag::DENYOOM | CommandFlag::FAST, 1, 1, 1, CommandComplexity::LINEAR},
+    {"RPUSH", &invoke<&CommandHandler::list_commands, &ListCommands::cmdRpush>,
+        -3, CommandFlag::WRITE | CommandFlag::DENYOOM | CommandFlag::FAST, 1, 1, 1, CommandComplexity::LINEAR},
+    {"LPOP", &invoke<&CommandHandler::list_commands, &ListCommands::cmdLpop>,
+        2, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"RPOP", &invoke<&CommandHandler::list_commands, &ListCommands::cmdRpop>,
+        2, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"LLEN", &invoke<&CommandHandler::list_commands, &ListCommands::cmdLlen>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"LRANGE", &invoke<&CommandHandler::list_commands, &ListCommands::cmdLrange>,
+        4, CommandFlag::READONLY, 1, 1, 1, CommandComplexity::LINEAR},
+    {"LINDEX", &invoke<&CommandHandler::list_commands, &ListCommands::cmdLindex>,
+        3, CommandFlag::READONLY, 1, 1, 1, CommandComplexity::LINEAR},
+    {"LSET", &invoke<&CommandHandler::list_commands, &ListCommands::cmdLset>,
+        4, CommandFlag::WRITE | CommandFlag::DENYOOM, 1, 1, 1, CommandComplexity::LINEAR},
+
     // Set commands
-    commands["SADD"] = [this](const std::vector<std::string>& args) { return set_commands->cmdSadd(args); };
-    commands["SREM"] = [this](const std::vector<std::string>& args) { return set_commands->cmdSrem(args); };
-    commands["SISMEMBER"] = [this](const std::vector<std::string>& args) { return set_commands->cmdSismember(args); };
-    commands["SCARD"] = [this](const std::vector<std::string>& args) { return set_commands->cmdScard(args); };
-    commands["SMEMBERS"] = [this](const std::vector<std::string>& args) { return set_commands->cmdSmembers(args); };
-    commands["SPOP"] = [this](const std::vector<std::string>& args) { return set_commands->cmdSpop(args); };
-    
+    {"SADD", &invoke<&CommandHandler::set_commands, &SetCommands::cmdSadd>,
+        -3, CommandFlag::WRITE | CommandFlag::DENYOOM | CommandFlag::FAST, 1, 1, 1, CommandComplexity::LINEAR},
+    {"SREM", &invoke<&CommandHandler::set_commands, &SetCommands::cmdSrem>,
+        -3, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::LINEAR},
+    {"SISMEMBER", &invoke<&CommandHandler::set_commands, &SetCommands::cmdSismember>,
+        3, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"SCARD", &invoke<&CommandHandler::set_commands, &SetCommands::cmdScard>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"SMEMBERS", &invoke<&CommandHandler::set_commands, &SetCommands::cmdSmembers>,
+        2, CommandFlag::READONLY, 1, 1, 1, CommandComplexity::LINEAR},
+    {"SPOP", &invoke<&CommandHandler::set_commands, &SetCommands::cmdSpop>,
+        2, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"SSCAN", &invoke<&CommandHandler::set_commands, &SetCommands::cmdSscan>,
+        -3, CommandFlag::READONLY, 1, 1, 1, CommandComplexity::CONSTANT},
+
     // Hash commands
-    commands["HSET"] = [this](const std::vector<std::string>& args) { return hash_commands->cmdHset(args); };
-    commands["HGET"] = [this](const std::vector<std::string>& args) { return hash_commands->cmdHget(args); };
-    commands["HDEL"] = [this](const std::vector<std::string>& args) { return hash_commands->cmdHdel(args); };
-    commands["HEXISTS"] = [this](const std::vector<std::string>& args) { return hash_commands->cmdHexists(args); };
-    commands["HLEN"] = [this](const std::vector<std::string>& args) { return hash_commands->cmdHlen(args); };
-    commands["HKEYS"] = [this](const std::vector<std::string>& args) { return hash_commands->cmdHkeys(args); };
-    commands["HVALS"] = [this](const std::vector<std::string>& args) { return hash_commands->cmdHvals(args); };
-    commands["HGETALL"] = [this](const std::vector<std::string>& args) { return hash_commands->cmdHgetall(args); };
-    
+    {"HSET", &invoke<&CommandHandler::hash_commands, &HashCommands::cmdHset>,
+        -4, CommandFlag::WRITE | CommandFlag::DENYOOM | CommandFlag::FAST, 1, 1, 1, CommandComplexity::LINEAR},
+    {"HGET", &invoke<&CommandHandler::hash_commands, &HashCommands::cmdHget>,
+        3, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"HDEL", &invoke<&CommandHandler::hash_commands, &HashCommands::cmdHdel>,
+        -3, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::LINEAR},
+    {"HEXISTS", &invoke<&CommandHandler::hash_commands, &HashCommands::cmdHexists>,
+        3, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"HLEN", &invoke<&CommandHandler::hash_commands, &HashCommands::cmdHlen>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"HKEYS", &invoke<&CommandHandler::hash_commands, &HashCommands::cmdHkeys>,
+        2, CommandFlag::READONLY, 1, 1, 1, CommandComplexity::LINEAR},
+    {"HVALS", &invoke<&CommandHandler::hash_commands, &HashCommands::cmdHvals>,
+        2, CommandFlag::READONLY, 1, 1, 1, CommandComplexity::LINEAR},
+    {"HGETALL", &invoke<&CommandHandler::hash_commands, &HashCommands::cmdHgetall>,
+        2, CommandFlag::READONLY, 1, 1, 1, CommandComplexity::LINEAR},
+    {"HSCAN", &invoke<&CommandHandler::hash_commands, &HashCommands::cmdHscan>,
+        -3, CommandFlag::READONLY, 1, 1, 1, CommandComplexity::CONSTANT},
+
+    // Sorted set commands
+    {"ZSCAN", &invoke<&CommandHandler::zset_commands, &ZSetCommands::cmdZscan>,
+        -3, CommandFlag::READONLY, 1, 1, 1, CommandComplexity::CONSTANT},
+
     // TTL commands
-    commands["EXPIRE"] = [this](const std::vector<std::string>& args) { return ttl_commands->cmdExpire(args); };
-    commands["EXPIREAT"] = [this](const std::vector<std::string>& args) { return ttl_commands->cmdExpireat(args); };
-    commands["TTL"] = [this](const std::vector<std::string>& args) { return ttl_commands->cmdTtl(args); };
-    commands["PERSIST"] = [this](const std::vector<std::string>& args) { return ttl_commands->cmdPersist(args); };
-    
+    {"EXPIRE", &invoke<&CommandHandler::ttl_commands, &TTLCommands::cmdExpire>,
+        -3, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"PEXPIRE", &invoke<&CommandHandler::ttl_commands, &TTLCommands::cmdPexpire>,
+        -3, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"EXPIREAT", &invoke<&CommandHandler::ttl_commands, &TTLCommands::cmdExpireat>,
+        -3, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"PEXPIREAT", &invoke<&CommandHandler::ttl_commands, &TTLCommands::cmdPexpireat>,
+        -3, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"TTL", &invoke<&CommandHandler::ttl_commands, &TTLCommands::cmdTtl>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"PTTL", &invoke<&CommandHandler::ttl_commands, &TTLCommands::cmdPttl>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"EXPIRETIME", &invoke<&CommandHandler::ttl_commands, &TTLCommands::cmdExpiretime>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"PEXPIRETIME", &invoke<&CommandHandler::ttl_commands, &TTLCommands::cmdPexpiretime>,
+        2, CommandFlag::READONLY | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+    {"PERSIST", &invoke<&CommandHandler::ttl_commands, &TTLCommands::cmdPersist>,
+        2, CommandFlag::WRITE | CommandFlag::FAST, 1, 1, 1, CommandComplexity::CONSTANT},
+
     // Server commands
-    commands["PING"] = [this](const std::vector<std::string>& args) { return server_commands->cmdPing(args); };
-    commands["ECHO"] = [this](const std::vector<std::string>& args) { return server_commands->cmdEcho(args); };
-    commands["INFO"] = [this](const std::vector<std::string>& args) { return server_commands->cmdInfo(args); };
-    commands["FLUSHALL"] = [this](const std::vector<std::string>& args) { return server_commands->cmdFlushall(args); };
-    commands["KEYS"] = [this](const std::vector<std::string>& args) { return server_commands->cmdKeys(args); };
-    commands["DBSIZE"] = [this](const std::vector<std::string>& args) { return server_commands->cmdDbsize(args); };
-    commands["TIME"] = [this](const std::vector<std::string>& args) { return server_commands->cmdTime(args); };
+    {"PING", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdPing>,
+        -1, CommandFlag::FAST, 0, 0, 0, CommandComplexity::CONSTANT},
+    {"ECHO", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdEcho>,
+        2, CommandFlag::FAST, 0, 0, 0, CommandComplexity::CONSTANT},
+    {"INFO", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdInfo>,
+        -1, 0, 0, 0, 0, CommandComplexity::CONSTANT},
+    {"FLUSHALL", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdFlushall>,
+        -1, CommandFlag::WRITE | CommandFlag::ADMIN, 0, 0, 0, CommandComplexity::LINEAR},
+    {"FLUSHDB", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdFlushdb>,
+        -1, CommandFlag::WRITE | CommandFlag::ADMIN, 0, 0, 0, CommandComplexity::LINEAR},
+    {"KEYS", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdKeys>,
+        2, CommandFlag::READONLY, 0, 0, 0, CommandComplexity::LINEAR},
+    {"SCAN", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdScan>,
+        -2, CommandFlag::READONLY, 0, 0, 0, CommandComplexity::CONSTANT},
+    {"DBSIZE", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdDbsize>,
+        1, CommandFlag::READONLY | CommandFlag::FAST, 0, 0, 0, CommandComplexity::CONSTANT},
+    {"TIME", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdTime>,
+        1, CommandFlag::FAST, 0, 0, 0, CommandComplexity::CONSTANT},
+    {"COMMAND", &invoke<&CommandHandler::server_commands, &ServerCommands::cmdCommand>,
+        -1, 0, 0, 0, 0, CommandComplexity::LINEAR}
+};
+
+constexpr size_t CommandHandler::COMMAND_COUNT = std::size(CommandHandler::COMMAND_TABLE);
+
+namespace {
+
+constexpr std::array<std::string_view, CommandHandler::COMMAND_COUNT> commandNames() {
+    std::array<std::string_view, CommandHandler::COMMAND_COUNT> names{};
+    for (size_t i = 0; i < names.size(); ++i) {
+        names[i] = CommandHandler::COMMAND_TABLE[i].name;
+    }
+    return names;
+}
+
+// Built by the compiler; the seed search fails the build if the names
+// ever stop fitting
+constexpr PerfectHash<CommandHandler::COMMAND_COUNT, 256> COMMAND_INDEX(commandNames());
+
+} // namespace
+
+const CommandHandler::CommandSpec* CommandHandler::findCommand(std::string_view name) {
+    int index = COMMAND_INDEX.find(name);
+    return index < 0 ? nullptr : &COMMAND_TABLE[index];
+}
+
+void CommandHandler::serverCron() {
+    // Keys nobody reads again are only deleted here; lookups delete the
+    // rest when they find them expired
+    db.activeExpireCycle(ACTIVE_EXPIRE_BUDGET);
+    // Keyspace tables that are growing get 1ms of migration per tick, so
+    // an idle server still finishes a rehash
+    db.incrementalRehash(std::chrono::milliseconds(1));
 }
 
-std::string CommandHandler::processCommand(const std::vector<std::string>& args) {
+void CommandHandler::processCommand(const CommandArgs& args, ResponseWriter& out) {
     if (args.empty()) {
-        return RESPFormatter::formatError("ERR empty command");
+        out.writeError("ERR empty command");
+        return;
     }
     
-    total_commands_processed++;
+    // Only a statistic: no ordering with the command itself is needed
+    total_commands_processed.fetch_add(1, std::memory_order_relaxed);
     
-    // Clean up expired keys periodically
-    if (total_commands_processed % 100 == 0) {
-        db.cleanupExpiredKeys();
+    const CommandSpec* command = findCommand(args[0]);
+    if (!command) {
+        out.writeError("ERR unknown command '" + std::string(args[0]) + "'");
+        return;
     }
-    
-    std::string command = UtilityFunctions::toUpper(args[0]);
-    auto it = commands.find(command);
-    
-    if (it == commands.end()) {
-        return RESPFormatter::formatError("ERR unknown command '" + args[0] + "'");
+    if (!command->acceptsArgCount(args.size())) {
+        std::string name(command->name);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        out.writeError("ERR wrong number of arguments for '" + name + "' command");
+        return;
     }
     
+    // Over maxmemory, writes first evict; when that cannot make room,
+    // only the ones that would add data are refused
+    if (command->hasFlag(CommandFlag::WRITE) && !db.performEvictions() &&
+        command->hasFlag(CommandFlag::DENYOOM)) {
+        out.writeError("OOM command not allowed when used memory > 'maxmemory'.");
+        return;
+    }
+
+    // A command may throw half way through an array; drop what it wrote.
+    // If part of it was already streamed to the client, let the caller
+    // deal with the broken reply.
+    size_t reply_start = out.position();
     try {
-        return it->second(args);
+        command->func(*this, args, out);
     } catch (const std::exception& e) {
-        return RESPFormatter::formatError("ERR " + std::string(e.what()));
+        if (!out.truncate(reply_start)) throw;
+        out.writeError("ERR " + std::string(e.what()));
     }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
 #include <functional>
@@ -11,6 +12,7 @@
 #include <queue>
 #include <map>
 #include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <random>
 #include <ctime>
@@ -19,49 +21,107 @@
 #include "resp/resp_value.h"
 #include "resp/resp_parser.h"
 #include "resp/resp_formatter.h"
+#include "resp/response_writer.h"
 #include "utils/utility_functions.h"
+#include "utils/perfect_hash.h"
+#include "redis/command_args.h"
+#include "enum/command_flags.h"
 #include "redis/database/redis_database.h"
 #include "redis/commands/string_commands.h"
 #include "redis/commands/list_commands.h"
 #include "redis/commands/set_commands.h"
 #include "redis/commands/hash_commands.h"
+#include "redis/commands/zset_commands.h"
 #include "redis/commands/ttl_commands.h"
 #include "redis/commands/server_commands.h"
 
 // Command handler class
 class CommandHandler {
+public:
+    // Dispatch entry: the handler is a thunk that calls the command's
+    // member function on the right module
+    using CommandFunc = void (*)(CommandHandler&, const CommandArgs&, ResponseWriter&);
+
+    // Command descriptor. Arity counts the command name and follows the
+    // Redis convention: N means exactly N arguments, -N at least N. Keys
+    // sit at first_key, first_key + step, ... up to last_key, where a
+    // negative last_key counts from the end (-1 is the last argument);
+    // first_key 0 means the command takes no keys.
+    struct CommandSpec {
+        std::string_view name;
+        CommandFunc func;
+        int arity;
+        uint32_t flags;
+        int first_key;
+        int last_key;
+        int step;
+        CommandComplexity complexity;
+
+        constexpr bool acceptsArgCount(size_t argc) const {
+            return arity >= 0 ? argc == static_cast<size_t>(arity)
+                              : argc >= static_cast<size_t>(-arity);
+        }
+        constexpr bool hasFlag(uint32_t flag) const { return (flags & flag) != 0; }
+        // Inclusive upper bound of the key positions for a call with `argc`
+        // arguments; only meaningful when first_key > 0 and the arity was
+        // accepted
+        constexpr size_t lastKeyIndex(size_t argc) const {
+            return last_key >= 0 ? static_cast<size_t>(last_key) : argc + last_key;
+        }
+    };
+
+    static const CommandSpec COMMAND_TABLE[];
+    static const size_t COMMAND_COUNT;
+
+    // Case-insensitive and allocation-free; nullptr for unknown commands
+    static const CommandSpec* findCommand(std::string_view name);
+
 private:
 
-    //Database
-    RedisDatabase db;
+    //Database: owned when standalone, shared when several handlers serve one keyspace
+    std::unique_ptr<RedisDatabase> owned_db;
+    RedisDatabase& db;
     
     // Server info
     std::chrono::system_clock::time_point start_time;
-    size_t total_commands_processed = 0;
-    
-    // Command function type
-    using CommandFunc = std::function<std::string(const std::vector<std::string>&)>;
-    std::unordered_map<std::string, CommandFunc> commands;
+    // Counter: owned when standalone, shared by every reactor of a server
+    std::atomic<uint64_t> own_commands_processed{0};
+    std::atomic<uint64_t>& total_commands_processed;
     
     // Helper methods
-    void initializeCommands();
+    CommandHandler(std::unique_ptr<RedisDatabase> own_db, RedisDatabase* shared_db,
+                   std::atomic<uint64_t>* shared_commands_processed);
+
+    template <auto Module, auto Method>
+    static void invoke(CommandHandler& handler, const CommandArgs& args, ResponseWriter& out) {
+        ((*(handler.*Module)).*Method)(args, out);
+    }
     
     // Command handlers
     std::unique_ptr<StringCommands> string_commands;
     std::unique_ptr<ListCommands> list_commands;
     std::unique_ptr<SetCommands> set_commands;
     std::unique_ptr<HashCommands> hash_commands;
+    std::unique_ptr<ZSetCommands> zset_commands;
     std::unique_ptr<TTLCommands> ttl_commands;
     std::unique_ptr<ServerCommands> server_commands;
  
 public:
     CommandHandler();
+    explicit CommandHandler(RedisDatabase& shared_db);
+    CommandHandler(RedisDatabase& shared_db, std::atomic<uint64_t>& shared_commands_processed);
     ~CommandHandler() = default;
     
-    // Main processing method
-    std::string processCommand(const std::vector<std::string>& args);
+    // Main processing method: appends the reply to `out`
+    void processCommand(const CommandArgs& args, ResponseWriter& out);
+    
+    // Periodic housekeeping, run by the event loop every CRON_INTERVAL
+    static constexpr std::chrono::milliseconds CRON_INTERVAL{100};
+    // At most a quarter of each tick goes to deleting expired keys
+    static constexpr std::chrono::milliseconds ACTIVE_EXPIRE_BUDGET{CRON_INTERVAL / 4};
+    void serverCron();
     
     // Statistics
-    size_t getTotalCommandsProcessed() const { return total_commands_processed; }
+    uint64_t getTotalCommandsProcessed() const { return total_commands_processed.load(std::memory_order_relaxed); }
     std::chrono::system_clock::time_point getStartTime() const { return start_time; }
 };
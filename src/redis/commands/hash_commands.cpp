@@ -2,172 +2,209 @@
 
 HashCommands::HashCommands(RedisDatabase& database) : db(database) {}
 
-std::string HashCommands::cmdHset(const std::vector<std::string>& args) {
+void HashCommands::cmdHset(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 4 || args.size() % 2 != 0) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'hset' command");
+        out.writeError("ERR wrong number of arguments for 'hset' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.getOrCreate(key, RedisType::HASH);
     
-    if (value && value->type != RedisType::HASH) {
-        return RESPFormatter::formatError("ERR Operation against a key holding the wrong kind of value");
-    }
-    
-    if (!value) {
-        db.setValue(key, RedisValue(RedisType::HASH));
-        value = db.getValue(key);
+    if (value->type() != RedisType::HASH) {
+        out.writeError("ERR Operation against a key holding the wrong kind of value");
+        return;
     }
     
     int added = 0;
     for (size_t i = 2; i < args.size(); i += 2) {
-        const std::string& field = args[i];
-        const std::string& field_value = args[i + 1];
-        
-        if (value->hash_value.find(field) == value->hash_value.end()) {
+        auto result = value->hash().tryEmplace(HashedKey(args[i]), args[i + 1]);
+        if (result.second) {
             added++;
+        } else {
+            result.first->value = args[i + 1];
         }
-        value->hash_value[field] = field_value;
     }
     
-    return RESPFormatter::formatInteger(added);
+    out.writeInteger(added);
 }
 
-std::string HashCommands::cmdHget(const std::vector<std::string>& args) {
+void HashCommands::cmdHget(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'hget' command");
+        out.writeError("ERR wrong number of arguments for 'hget' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    const std::string& field = args[2];
+    std::string_view key = args[1];
+    HashedKey field(args[2]);
     
-    RedisValue* value = db.getValue(key);
-    if (!value || value->type != RedisType::HASH) {
-        return RESPFormatter::formatNull();
+    auto value = db.readValue(key);
+    if (!value || value->type() != RedisType::HASH) {
+        out.writeNull();
+        return;
     }
     
-    auto it = value->hash_value.find(field);
-    if (it == value->hash_value.end()) {
-        return RESPFormatter::formatNull();
+    auto* entry = value->hash().find(field);
+    if (!entry) {
+        out.writeNull();
+        return;
     }
     
-    return RESPFormatter::formatBulkString(it->second);
+    out.writeBulkString(entry->value);
 }
 
-std::string HashCommands::cmdHdel(const std::vector<std::string>& args) {
+void HashCommands::cmdHdel(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'hdel' command");
+        out.writeError("ERR wrong number of arguments for 'hdel' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.writeValue(key);
     
-    if (!value || value->type != RedisType::HASH) {
-        return RESPFormatter::formatInteger(0);
+    if (!value || value->type() != RedisType::HASH) {
+        out.writeInteger(0);
+        return;
     }
     
     int deleted = 0;
     for (size_t i = 2; i < args.size(); i++) {
-        if (value->hash_value.erase(args[i]) > 0) {
+        if (value->hash().erase(HashedKey(args[i]))) {
             deleted++;
         }
     }
     
-    if (value->hash_value.empty()) {
-        db.deleteKey(key);
+    if (value->hash().empty()) {
+        value.erase();
     }
     
-    return RESPFormatter::formatInteger(deleted);
+    out.writeInteger(deleted);
 }
 
-std::string HashCommands::cmdHexists(const std::vector<std::string>& args) {
+void HashCommands::cmdHexists(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'hexists' command");
+        out.writeError("ERR wrong number of arguments for 'hexists' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    const std::string& field = args[2];
+    std::string_view key = args[1];
+    HashedKey field(args[2]);
     
-    RedisValue* value = db.getValue(key);
-    if (!value || value->type != RedisType::HASH) {
-        return RESPFormatter::formatInteger(0);
+    auto value = db.readValue(key);
+    if (!value || value->type() != RedisType::HASH) {
+        out.writeInteger(0);
+        return;
     }
     
-    return RESPFormatter::formatInteger(value->hash_value.count(field) > 0 ? 1 : 0);
+    out.writeInteger(value->hash().contains(field) ? 1 : 0);
 }
 
-std::string HashCommands::cmdHlen(const std::vector<std::string>& args) {
+void HashCommands::cmdHlen(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'hlen' command");
+        out.writeError("ERR wrong number of arguments for 'hlen' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
-    if (!value || value->type != RedisType::HASH) {
-        return RESPFormatter::formatInteger(0);
+    if (!value || value->type() != RedisType::HASH) {
+        out.writeInteger(0);
+        return;
     }
     
-    return RESPFormatter::formatInteger(value->hash_value.size());
+    out.writeInteger(value->hash().size());
 }
 
-std::string HashCommands::cmdHkeys(const std::vector<std::string>& args) {
+void HashCommands::cmdHkeys(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'hkeys' command");
+        out.writeError("ERR wrong number of arguments for 'hkeys' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
-    
-    if (!value || value->type != RedisType::HASH) {
-        return RESPFormatter::formatArray(std::vector<std::string>());
-    }
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
-    std::vector<std::string> keys;
-    for (const auto& pair : value->hash_value) {
-        keys.push_back(pair.first);
+    if (!value || value->type() != RedisType::HASH) {
+        out.writeArrayHeader(0);
+        return;
     }
     
-    return RESPFormatter::formatArray(keys);
+    out.writeArrayHeader(value->hash().size());
+    value->hash().forEach([&out](const RedisValue::Hash::Entry& field) {
+        out.writeBulkString(field.key.view());
+        out.flushIfNeeded();
+    });
 }
 
-std::string HashCommands::cmdHvals(const std::vector<std::string>& args) {
+void HashCommands::cmdHvals(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'hvals' command");
+        out.writeError("ERR wrong number of arguments for 'hvals' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
-    if (!value || value->type != RedisType::HASH) {
-        return RESPFormatter::formatArray(std::vector<std::string>());
+    if (!value || value->type() != RedisType::HASH) {
+        out.writeArrayHeader(0);
+        return;
     }
     
-    std::vector<std::string> values;
-    for (const auto& pair : value->hash_value) {
-        values.push_back(pair.second);
-    }
-    
-    return RESPFormatter::formatArray(values);
+    out.writeArrayHeader(value->hash().size());
+    value->hash().forEach([&out](const RedisValue::Hash::Entry& field) {
+        out.writeBulkString(field.value);
+        out.flushIfNeeded();
+    });
 }
 
-std::string HashCommands::cmdHgetall(const std::vector<std::string>& args) {
+void HashCommands::cmdHgetall(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'hgetall' command");
+        out.writeError("ERR wrong number of arguments for 'hgetall' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
-    if (!value || value->type != RedisType::HASH) {
-        return RESPFormatter::formatArray(std::vector<std::string>());
+    if (!value || value->type() != RedisType::HASH) {
+        out.writeArrayHeader(0);
+        return;
     }
     
-    std::vector<std::string> result;
-    for (const auto& pair : value->hash_value) {
-        result.push_back(pair.first);
-        result.push_back(pair.second);
+    out.writeArrayHeader(value->hash().size() * 2);
+    value->hash().forEach([&out](const RedisValue::Hash::Entry& field) {
+        out.writeBulkString(field.key.view());
+        out.writeBulkString(field.value);
+        out.flushIfNeeded();
+    });
+}
+
+void HashCommands::cmdHscan(const CommandArgs& args, ResponseWriter& out) {
+    if (args.size() < 3) {
+        out.writeError("ERR wrong number of arguments for 'hscan' command");
+        return;
     }
-    
-    return RESPFormatter::formatArray(result);
-}
\ No newline at end of file
+    auto options = ScanOptions::parse(args, 2, false, out);
+    if (!options) return;
+
+    auto value = db.readValue(args[1]);
+    if (!value) {
+        writeScanReply(out, 0, {});
+        return;
+    }
+    if (value->type() != RedisType::HASH) {
+        out.writeError("ERR Operation against a key holding the wrong kind of value");
+        return;
+    }
+
+    // Field, value, field, value...; MATCH applies to the fields
+    std::vector<std::string_view> pairs;
+    uint64_t cursor = scanTable(value->hash(), options->cursor, options->count,
+        [&options, &pairs](const RedisValue::Hash::Entry& field) {
+            if (!options->matches(field.key.view())) return;
+            pairs.push_back(field.key.view());
+            pairs.push_back(field.value);
+        });
+    writeScanReply(out, cursor, pairs);
+}
@@ -4,7 +4,9 @@
 #include <vector>
 #include <chrono>
 #include "redis/database/redis_database.h"
-#include "resp/resp_formatter.h"
+#include "redis/command_args.h"
+#include "redis/commands/scan_options.h"
+#include "resp/response_writer.h"
 #include "redis/database/redis_value.h"
 #include "utils/utility_functions.h"
 #include "enum/redis_type.h"
@@ -17,12 +19,13 @@ public:
     ~HashCommands() = default;
 
     // Hash command implementations
-    std::string cmdHset(const std::vector<std::string>& args);
-    std::string cmdHget(const std::vector<std::string>& args);
-    std::string cmdHdel(const std::vector<std::string>& args);
-    std::string cmdHexists(const std::vector<std::string>& args);
-    std::string cmdHlen(const std::vector<std::string>& args);
-    std::string cmdHkeys(const std::vector<std::string>& args);
-    std::string cmdHvals(const std::vector<std::string>& args);
-    std::string cmdHgetall(const std::vector<std::string>& args);
+    void cmdHset(const CommandArgs& args, ResponseWriter& out);
+    void cmdHget(const CommandArgs& args, ResponseWriter& out);
+    void cmdHdel(const CommandArgs& args, ResponseWriter& out);
+    void cmdHexists(const CommandArgs& args, ResponseWriter& out);
+    void cmdHlen(const CommandArgs& args, ResponseWriter& out);
+    void cmdHkeys(const CommandArgs& args, ResponseWriter& out);
+    void cmdHvals(const CommandArgs& args, ResponseWriter& out);
+    void cmdHgetall(const CommandArgs& args, ResponseWriter& out);
+    void cmdHscan(const CommandArgs& args, ResponseWriter& out);
 };
\ No newline at end of file
@@ -2,132 +2,135 @@
 
 ListCommands::ListCommands(RedisDatabase& database) : db(database) {}
 
-std::string ListCommands::cmdLpush(const std::vector<std::string>& args) {
+void ListCommands::cmdLpush(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'lpush' command");
+        out.writeError("ERR wrong number of arguments for 'lpush' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.getOrCreate(key, RedisType::LIST);
     
-    if (value && value->type != RedisType::LIST) {
-        return RESPFormatter::formatError("ERR Operation against a key holding the wrong kind of value");
-    }
-    
-    if (!value) {
-        db.setValue(key, RedisValue(RedisType::LIST));
-        value = db.getValue(key);
+    if (value->type() != RedisType::LIST) {
+        out.writeError("ERR Operation against a key holding the wrong kind of value");
+        return;
     }
     
     for (size_t i = 2; i < args.size(); i++) {
-        value->list_value.push_front(args[i]);
+        value->list().emplace_front(args[i]);
     }
     
-    return RESPFormatter::formatInteger(value->list_value.size());
+    out.writeInteger(value->list().size());
 }
 
-std::string ListCommands::cmdRpush(const std::vector<std::string>& args) {
+void ListCommands::cmdRpush(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'rpush' command");
+        out.writeError("ERR wrong number of arguments for 'rpush' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
-    
-    if (value && value->type != RedisType::LIST) {
-        return RESPFormatter::formatError("ERR Operation against a key holding the wrong kind of value");
-    }
+    std::string_view key = args[1];
+    auto value = db.getOrCreate(key, RedisType::LIST);
     
-    if (!value) {
-        db.setValue(key, RedisValue(RedisType::LIST));
-        value = db.getValue(key);
+    if (value->type() != RedisType::LIST) {
+        out.writeError("ERR Operation against a key holding the wrong kind of value");
+        return;
     }
     
     for (size_t i = 2; i < args.size(); i++) {
-        value->list_value.push_back(args[i]);
+        value->list().emplace_back(args[i]);
     }
     
-    return RESPFormatter::formatInteger(value->list_value.size());
+    out.writeInteger(value->list().size());
 }
 
-std::string ListCommands::cmdLpop(const std::vector<std::string>& args) {
+void ListCommands::cmdLpop(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'lpop' command");
+        out.writeError("ERR wrong number of arguments for 'lpop' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.writeValue(key);
     
-    if (!value || value->type != RedisType::LIST || value->list_value.empty()) {
-        return RESPFormatter::formatNull();
+    if (!value || value->type() != RedisType::LIST || value->list().empty()) {
+        out.writeNull();
+        return;
     }
     
-    std::string result = value->list_value.front();
-    value->list_value.pop_front();
+    std::string result = value->list().front();
+    value->list().pop_front();
     
-    if (value->list_value.empty()) {
-        db.deleteKey(key);
+    if (value->list().empty()) {
+        value.erase();
     }
     
-    return RESPFormatter::formatBulkString(result);
+    out.writeBulkString(result);
 }
 
-std::string ListCommands::cmdRpop(const std::vector<std::string>& args) {
+void ListCommands::cmdRpop(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'rpop' command");
+        out.writeError("ERR wrong number of arguments for 'rpop' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.writeValue(key);
     
-    if (!value || value->type != RedisType::LIST || value->list_value.empty()) {
-        return RESPFormatter::formatNull();
+    if (!value || value->type() != RedisType::LIST || value->list().empty()) {
+        out.writeNull();
+        return;
     }
     
-    std::string result = value->list_value.back();
-    value->list_value.pop_back();
+    std::string result = value->list().back();
+    value->list().pop_back();
     
-    if (value->list_value.empty()) {
-        db.deleteKey(key);
+    if (value->list().empty()) {
+        value.erase();
     }
     
-    return RESPFormatter::formatBulkString(result);
+    out.writeBulkString(result);
 }
 
-std::string ListCommands::cmdLlen(const std::vector<std::string>& args) {
+void ListCommands::cmdLlen(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'llen' command");
+        out.writeError("ERR wrong number of arguments for 'llen' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
-    if (!value || value->type != RedisType::LIST) {
-        return RESPFormatter::formatInteger(0);
+    if (!value || value->type() != RedisType::LIST) {
+        out.writeInteger(0);
+        return;
     }
     
-    return RESPFormatter::formatInteger(value->list_value.size());
+    out.writeInteger(value->list().size());
 }
 
-std::string ListCommands::cmdLrange(const std::vector<std::string>& args) {
+void ListCommands::cmdLrange(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 4) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'lrange' command");
+        out.writeError("ERR wrong number of arguments for 'lrange' command");
+        return;
     }
     
-    const std::string& key = args[1];
+    std::string_view key = args[1];
     if (!UtilityFunctions::isInteger(args[2]) || !UtilityFunctions::isInteger(args[3])) {
-        return RESPFormatter::formatError("ERR value is not an integer or out of range");
+        out.writeError("ERR value is not an integer or out of range");
+        return;
     }
     
-    RedisValue* value = db.getValue(key);
-    if (!value || value->type != RedisType::LIST) {
-        return RESPFormatter::formatArray(std::vector<std::string>());
+    auto value = db.readValue(key);
+    if (!value || value->type() != RedisType::LIST) {
+        out.writeArrayHeader(0);
+        return;
     }
     
     long long start = UtilityFunctions::parseInt(args[2]);
     long long end = UtilityFunctions::parseInt(args[3]);
     
-    const auto& list = value->list_value;
+    const auto& list = value->list();
     long long list_size = static_cast<long long>(list.size());
     
     // Handle negative indices
@@ -138,79 +141,88 @@ std::string ListCommands::cmdLrange(const std::vector<std::string>& args) {
     start = std::max(0LL, std::min(start, list_size - 1));
     end = std::max(0LL, std::min(end, list_size - 1));
     
-    std::vector<std::string> result;
-    if (start <= end) {
-        auto it = list.begin();
-        std::advance(it, start);
-        
-        for (long long i = start; i <= end && it != list.end(); i++, ++it) {
-            result.push_back(*it);
-        }
+    if (list_size == 0 || start > end) {
+        out.writeArrayHeader(0);
+        return;
     }
     
-    return RESPFormatter::formatArray(result);
+    out.writeArrayHeader(end - start + 1);
+    auto it = list.begin();
+    std::advance(it, start);
+    for (long long i = start; i <= end; i++, ++it) {
+        out.writeBulkString(*it);
+        out.flushIfNeeded();
+    }
 }
 
-std::string ListCommands::cmdLindex(const std::vector<std::string>& args) {
+void ListCommands::cmdLindex(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'lindex' command");
+        out.writeError("ERR wrong number of arguments for 'lindex' command");
+        return;
     }
     
-    const std::string& key = args[1];
+    std::string_view key = args[1];
     if (!UtilityFunctions::isInteger(args[2])) {
-        return RESPFormatter::formatError("ERR value is not an integer or out of range");
+        out.writeError("ERR value is not an integer or out of range");
+        return;
     }
     
-    RedisValue* value = db.getValue(key);
-    if (!value || value->type != RedisType::LIST) {
-        return RESPFormatter::formatNull();
+    auto value = db.readValue(key);
+    if (!value || value->type() != RedisType::LIST) {
+        out.writeNull();
+        return;
     }
     
     long long index = UtilityFunctions::parseInt(args[2]);
-    const auto& list = value->list_value;
+    const auto& list = value->list();
     long long list_size = static_cast<long long>(list.size());
     
     // Handle negative index
     if (index < 0) index += list_size;
     
     if (index < 0 || index >= list_size) {
-        return RESPFormatter::formatNull();
+        out.writeNull();
+        return;
     }
     
     auto it = list.begin();
     std::advance(it, index);
-    return RESPFormatter::formatBulkString(*it);
+    out.writeBulkString(*it);
 }
 
-std::string ListCommands::cmdLset(const std::vector<std::string>& args) {
+void ListCommands::cmdLset(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 4) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'lset' command");
+        out.writeError("ERR wrong number of arguments for 'lset' command");
+        return;
     }
     
-    const std::string& key = args[1];
+    std::string_view key = args[1];
     if (!UtilityFunctions::isInteger(args[2])) {
-        return RESPFormatter::formatError("ERR value is not an integer or out of range");
+        out.writeError("ERR value is not an integer or out of range");
+        return;
     }
     
-    RedisValue* value = db.getValue(key);
-    if (!value || value->type != RedisType::LIST) {
-        return RESPFormatter::formatError("ERR no such key");
+    auto value = db.writeValue(key);
+    if (!value || value->type() != RedisType::LIST) {
+        out.writeError("ERR no such key");
+        return;
     }
     
     long long index = UtilityFunctions::parseInt(args[2]);
-    auto& list = value->list_value;
+    auto& list = value->list();
     long long list_size = static_cast<long long>(list.size());
     
     // Handle negative index
     if (index < 0) index += list_size;
     
     if (index < 0 || index >= list_size) {
-        return RESPFormatter::formatError("ERR index out of range");
+        out.writeError("ERR index out of range");
+        return;
     }
     
     auto it = list.begin();
     std::advance(it, index);
     *it = args[3];
     
-    return RESPFormatter::formatSimpleString("OK");
+    out.writeSimpleString("OK");
 }
\ No newline at end of file
@@ -4,7 +4,8 @@
 #include <vector>
 #include <chrono>
 #include "redis/database/redis_database.h"
-#include "resp/resp_formatter.h"
+#include "redis/command_args.h"
+#include "resp/response_writer.h"
 #include "redis/database/redis_value.h"
 #include "utils/utility_functions.h"
 #include "enum/redis_type.h"
@@ -17,12 +18,12 @@ public:
     ~ListCommands() = default;
 
     // List command implementations
-    std::string cmdLpush(const std::vector<std::string>& args);
-    std::string cmdRpush(const std::vector<std::string>& args);
-    std::string cmdLpop(const std::vector<std::string>& args);
-    std::string cmdRpop(const std::vector<std::string>& args);
-    std::string cmdLlen(const std::vector<std::string>& args);
-    std::string cmdLrange(const std::vector<std::string>& args);
-    std::string cmdLindex(const std::vector<std::string>& args);
-    std::string cmdLset(const std::vector<std::string>& args);
+    void cmdLpush(const CommandArgs& args, ResponseWriter& out);
+    void cmdRpush(const CommandArgs& args, ResponseWriter& out);
+    void cmdLpop(const CommandArgs& args, ResponseWriter& out);
+    void cmdRpop(const CommandArgs& args, ResponseWriter& out);
+    void cmdLlen(const CommandArgs& args, ResponseWriter& out);
+    void cmdLrange(const CommandArgs& args, ResponseWriter& out);
+    void cmdLindex(const CommandArgs& args, ResponseWriter& out);
+    void cmdLset(const CommandArgs& args, ResponseWriter& out);
 };
\ No newline at end of file
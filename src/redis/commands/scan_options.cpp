@@ -0,0 +1,91 @@
+#include "scan_options.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <string>
+
+namespace {
+
+struct TypeName {
+    RedisType type;
+    const char* name;
+};
+
+const TypeName TYPE_NAMES[] = {
+    {RedisType::STRING, "string"},
+    {RedisType::LIST, "list"},
+    {RedisType::SET, "set"},
+    {RedisType::HASH, "hash"},
+    {RedisType::ZSET, "zset"},
+    {RedisType::STREAM, "stream"},
+};
+
+std::optional<RedisType> parseTypeName(std::string_view name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    for (const auto& entry : TYPE_NAMES) {
+        if (lower == entry.name) return entry.type;
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+std::optional<ScanOptions> ScanOptions::parse(const CommandArgs& args, size_t cursor_index, bool allow_type,
+                                              ResponseWriter& out) {
+    ScanOptions options;
+    std::string_view cursor = args[cursor_index];
+    auto result = std::from_chars(cursor.data(), cursor.data() + cursor.size(), options.cursor);
+    if (result.ec != std::errc() || result.ptr != cursor.data() + cursor.size()) {
+        out.writeError("ERR invalid cursor");
+        return std::nullopt;
+    }
+
+    for (size_t i = cursor_index + 1; i < args.size(); i += 2) {
+        std::string option = UtilityFunctions::toUpper(args[i]);
+        if (i + 1 >= args.size()) {
+            out.writeError("ERR syntax error");
+            return std::nullopt;
+        }
+        std::string_view value = args[i + 1];
+        if (option == "COUNT") {
+            if (!UtilityFunctions::isInteger(value)) {
+                out.writeError("ERR value is not an integer or out of range");
+                return std::nullopt;
+            }
+            long long count = UtilityFunctions::parseInt(value);
+            if (count < 1) {
+                out.writeError("ERR syntax error");
+                return std::nullopt;
+            }
+            // Scans take up to count * 10 steps; keep that from overflowing
+            options.count = std::min(static_cast<size_t>(count), SIZE_MAX / 10);
+        } else if (option == "MATCH") {
+            options.pattern = value == "*" ? std::string_view() : value;
+        } else if (option == "TYPE" && allow_type) {
+            options.type = parseTypeName(value);
+            if (!options.type) {
+                out.writeError("ERR unknown type name '" + std::string(value) + "'");
+                return std::nullopt;
+            }
+        } else {
+            out.writeError("ERR syntax error");
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+void writeScanReply(ResponseWriter& out, uint64_t cursor, const std::vector<std::string_view>& elements) {
+    char digits[20];
+    char* end = std::to_chars(digits, digits + sizeof(digits), cursor).ptr;
+    out.writeArrayHeader(2);
+    out.writeBulkString(std::string_view(digits, end - digits));
+    out.writeArrayHeader(elements.size());
+    for (std::string_view element : elements) {
+        out.writeBulkString(element);
+        out.flushIfNeeded();
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "redis/command_args.h"
+#include "redis/database/key_table.h"
+#include "resp/response_writer.h"
+#include "utils/utility_functions.h"
+#include "enum/redis_type.h"
+
+// Arguments of SCAN, SSCAN, HSCAN and ZSCAN: the cursor, then MATCH,
+// COUNT and, for SCAN only, TYPE, in any order
+struct ScanOptions {
+    static constexpr size_t DEFAULT_COUNT = 10;
+
+    uint64_t cursor = 0;
+    size_t count = DEFAULT_COUNT;
+    std::string_view pattern;       // empty: no MATCH, or MATCH *
+    std::optional<RedisType> type;
+
+    bool matches(std::string_view name) const {
+        return pattern.empty() || UtilityFunctions::matchPattern(pattern, name);
+    }
+
+    // Options start after args[cursor_index]. Writes the error and
+    // returns nothing when an argument is invalid.
+    static std::optional<ScanOptions> parse(const CommandArgs& args, size_t cursor_index, bool allow_type,
+                                            ResponseWriter& out);
+};
+
+// The two-element reply: the next cursor, then the elements
+void writeScanReply(ResponseWriter& out, uint64_t cursor, const std::vector<std::string_view>& elements);
+
+// One SSCAN or HSCAN step over the KeyTable of a set or hash: steps of
+// KeyTable::scan until about `count` elements were looked at or count * 10
+// steps were taken, so the cursor keeps its guarantees when the value
+// grows or shrinks between calls. Returns 0 when the scan is complete.
+template <typename V, typename Fn>
+uint64_t scanTable(const KeyTable<V>& table, uint64_t cursor, size_t count, Fn&& fn) {
+    size_t visited = 0;
+    for (size_t steps = count * 10; visited < count && steps > 0; --steps) {
+        cursor = table.scan(cursor, [&visited, &fn](const typename KeyTable<V>::Entry& entry) {
+            visited++;
+            fn(entry);
+        });
+        if (cursor == 0) break;
+    }
+    return cursor;
+}
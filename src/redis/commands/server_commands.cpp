@@ -1,31 +1,82 @@
 #include "server_commands.h"
+#include "redis/command_handler.h"
+
+namespace {
+
+using CommandSpec = CommandHandler::CommandSpec;
+
+std::string lowerName(const CommandSpec& spec) {
+    std::string name(spec.name);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    return name;
+}
+
+// Classic six-field COMMAND INFO entry
+void writeCommandInfo(ResponseWriter& out, const CommandSpec& spec) {
+    static const std::pair<uint32_t, const char*> FLAG_NAMES[] = {
+        {CommandFlag::WRITE, "write"},
+        {CommandFlag::DENYOOM, "denyoom"},
+        {CommandFlag::READONLY, "readonly"},
+        {CommandFlag::ADMIN, "admin"},
+        {CommandFlag::FAST, "fast"}
+    };
+
+    out.writeArrayHeader(6);
+    out.writeBulkString(lowerName(spec));
+    out.writeInteger(spec.arity);
+
+    size_t flag_count = 0;
+    for (const auto& flag : FLAG_NAMES) {
+        if (spec.hasFlag(flag.first)) flag_count++;
+    }
+    out.writeArrayHeader(flag_count);
+    for (const auto& flag : FLAG_NAMES) {
+        if (spec.hasFlag(flag.first)) out.writeSimpleString(flag.second);
+    }
+
+    out.writeInteger(spec.first_key);
+    out.writeInteger(spec.last_key);
+    out.writeInteger(spec.step);
+}
+
+void writeCommandDocs(ResponseWriter& out, const CommandSpec& spec) {
+    out.writeBulkString(lowerName(spec));
+    out.writeArrayHeader(2);
+    out.writeBulkString("complexity");
+    out.writeBulkString(spec.complexity == CommandComplexity::CONSTANT ? "O(1)" : "O(N)");
+}
+
+} // namespace
 
 ServerCommands::ServerCommands(RedisDatabase& database, 
                               std::chrono::system_clock::time_point server_start_time,
-                              size_t& commands_processed)
+                              const std::atomic<uint64_t>& commands_processed)
     : db(database), start_time(server_start_time), total_commands_processed(commands_processed) {}
 
-std::string ServerCommands::cmdPing(const std::vector<std::string>& args) {
+void ServerCommands::cmdPing(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() > 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'ping' command");
+        out.writeError("ERR wrong number of arguments for 'ping' command");
+        return;
     }
     
     if (args.size() == 2) {
-        return RESPFormatter::formatBulkString(args[1]);
+        out.writeBulkString(args[1]);
+        return;
     }
     
-    return RESPFormatter::formatSimpleString("PONG");
+    out.writeSimpleString("PONG");
 }
 
-std::string ServerCommands::cmdEcho(const std::vector<std::string>& args) {
+void ServerCommands::cmdEcho(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'echo' command");
+        out.writeError("ERR wrong number of arguments for 'echo' command");
+        return;
     }
     
-    return RESPFormatter::formatBulkString(args[1]);
+    out.writeBulkString(args[1]);
 }
 
-std::string ServerCommands::cmdInfo(const std::vector<std::string>& /*args*/) {
+void ServerCommands::cmdInfo(const CommandArgs& /*args*/, ResponseWriter& out) {
     auto now = std::chrono::system_clock::now();
     auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - start_time);
     
@@ -34,47 +85,106 @@ std::string ServerCommands::cmdInfo(const std::vector<std::string>& /*args*/) {
     info << "redis_version:7.0.0\r\n";
     info << "uptime_in_seconds:" << uptime.count() << "\r\n";
     info << "\r\n";
+    info << "# Memory\r\n";
+    info << "used_memory:" << db.usedMemory() << "\r\n";
+    info << "maxmemory:" << db.getMaxMemory() << "\r\n";
+    info << "maxmemory_policy:" << evictionPolicyName(db.getEvictionPolicy()) << "\r\n";
+    info << "\r\n";
     info << "# Stats\r\n";
-    info << "total_commands_processed:" << total_commands_processed << "\r\n";
+    info << "total_commands_processed:" << total_commands_processed.load(std::memory_order_relaxed) << "\r\n";
+    info << "lazyfree_pending_objects:" << LazyFree::instance().pending() << "\r\n";
+    info << "lazyfreed_objects:" << LazyFree::instance().freed() << "\r\n";
+    info << "evicted_keys:" << db.evictedKeys() << "\r\n";
     info << "\r\n";
     info << "# Keyspace\r\n";
     info << "db0:keys=" << db.getDatabaseSize() << "\r\n";
     
-    return RESPFormatter::formatBulkString(info.str());
+    out.writeBulkString(info.str());
 }
 
-std::string ServerCommands::cmdFlushall(const std::vector<std::string>& args) {
+void ServerCommands::flush(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() > 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'flushall' command");
+        std::string name(args[0]);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        out.writeError("ERR wrong number of arguments for '" + name + "' command");
+        return;
     }
-    
-    db.clearDatabase();
-    return RESPFormatter::formatSimpleString("OK");
+
+    bool async = false;
+    if (args.size() == 2) {
+        std::string mode = UtilityFunctions::toUpper(args[1]);
+        if (mode == "ASYNC") {
+            async = true;
+        } else if (mode != "SYNC") {
+            out.writeError("ERR syntax error");
+            return;
+        }
+    }
+
+    if (async) {
+        db.clearDatabaseAsync();
+    } else {
+        db.clearDatabase();
+    }
+    out.writeSimpleString("OK");
+}
+
+void ServerCommands::cmdFlushall(const CommandArgs& args, ResponseWriter& out) {
+    flush(args, out);
 }
 
-std::string ServerCommands::cmdKeys(const std::vector<std::string>& args) {
+void ServerCommands::cmdFlushdb(const CommandArgs& args, ResponseWriter& out) {
+    flush(args, out);
+}
+
+void ServerCommands::cmdKeys(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'keys' command");
+        out.writeError("ERR wrong number of arguments for 'keys' command");
+        return;
     }
     
-    const std::string& pattern = args[1];
-    std::vector<std::string> matching_keys = db.getMatchingKeys(pattern);
-    
-    return RESPFormatter::formatArray(matching_keys);
+    std::string pattern(args[1]);
+    db.forEachMatchingKey(pattern,
+        [&out](size_t count) { out.writeArrayHeader(count); },
+        [&out](std::string_view key) {
+            out.writeBulkString(key);
+            out.flushIfNeeded();
+        });
+}
+
+void ServerCommands::cmdScan(const CommandArgs& args, ResponseWriter& out) {
+    if (args.size() < 2) {
+        out.writeError("ERR wrong number of arguments for 'scan' command");
+        return;
+    }
+    auto options = ScanOptions::parse(args, 1, true, out);
+    if (!options) return;
+
+    // Copied: the shard locks are released before the reply is written
+    std::vector<std::string> keys;
+    uint64_t cursor = db.scan(options->cursor, options->count,
+        [&options, &keys](std::string_view key, const RedisValue& value) {
+            if (options->type && value.type() != *options->type) return;
+            if (options->matches(key)) keys.emplace_back(key);
+        });
+    writeScanReply(out, cursor, std::vector<std::string_view>(keys.begin(), keys.end()));
 }
 
-std::string ServerCommands::cmdDbsize(const std::vector<std::string>& args) {
+void ServerCommands::cmdDbsize(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 1) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'dbsize' command");
+        out.writeError("ERR wrong number of arguments for 'dbsize' command");
+        return;
     }
     
-    db.cleanupExpiredKeys();
-    return RESPFormatter::formatInteger(db.getDatabaseSize());
+    // O(1), as in Redis: keys that expired but were not reclaimed yet
+    // still count until lazy or active expiry removes them
+    out.writeInteger(db.getDatabaseSize());
 }
 
-std::string ServerCommands::cmdTime(const std::vector<std::string>& args) {
+void ServerCommands::cmdTime(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 1) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'time' command");
+        out.writeError("ERR wrong number of arguments for 'time' command");
+        return;
     }
     
     auto now = std::chrono::system_clock::now();
@@ -82,10 +192,67 @@ std::string ServerCommands::cmdTime(const std::vector<std::string>& args) {
     auto duration = now.time_since_epoch();
     auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count() % 1000000;
     
-    std::vector<std::string> time_result = {
-        std::to_string(time_t_now),
-        std::to_string(microseconds)
-    };
+    out.writeArrayHeader(2);
+    out.writeBulkString(static_cast<long long>(time_t_now));
+    out.writeBulkString(static_cast<long long>(microseconds));
+}
+
+void ServerCommands::cmdCommand(const CommandArgs& args, ResponseWriter& out) {
+    const CommandSpec* table = CommandHandler::COMMAND_TABLE;
+    const size_t count = CommandHandler::COMMAND_COUNT;
+
+    if (args.size() == 1) {
+        out.writeArrayHeader(count);
+        for (size_t i = 0; i < count; i++) {
+            writeCommandInfo(out, table[i]);
+        }
+        return;
+    }
     
-    return RESPFormatter::formatArray(time_result);
+    std::string subcommand = UtilityFunctions::toUpper(args[1]);
+    if (subcommand == "COUNT") {
+        if (args.size() != 2) {
+            out.writeError("ERR wrong number of arguments for 'command|count' command");
+            return;
+        }
+        out.writeInteger(count);
+    } else if (subcommand == "INFO") {
+        if (args.size() == 2) {
+            out.writeArrayHeader(count);
+            for (size_t i = 0; i < count; i++) {
+                writeCommandInfo(out, table[i]);
+            }
+            return;
+        }
+        // One entry per requested name, null for unknown ones
+        out.writeArrayHeader(args.size() - 2);
+        for (size_t i = 2; i < args.size(); i++) {
+            const CommandSpec* spec = CommandHandler::findCommand(args[i]);
+            if (spec) {
+                writeCommandInfo(out, *spec);
+            } else {
+                out.writeNullArray();
+            }
+        }
+    } else if (subcommand == "DOCS") {
+        // Name/doc pairs; unknown names are left out
+        if (args.size() == 2) {
+            out.writeArrayHeader(count * 2);
+            for (size_t i = 0; i < count; i++) {
+                writeCommandDocs(out, table[i]);
+            }
+            return;
+        }
+        size_t found = 0;
+        for (size_t i = 2; i < args.size(); i++) {
+            if (CommandHandler::findCommand(args[i])) found++;
+        }
+        out.writeArrayHeader(found * 2);
+        for (size_t i = 2; i < args.size(); i++) {
+            const CommandSpec* spec = CommandHandler::findCommand(args[i]);
+            if (spec) writeCommandDocs(out, *spec);
+        }
+    } else {
+        out.writeError("ERR unknown subcommand '" + std::string(args[1]) + "'. Try COMMAND INFO, COUNT or DOCS.");
+    }
 }
\ No newline at end of file
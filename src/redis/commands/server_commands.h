@@ -1,12 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 #include "redis/database/redis_database.h"
-#include "resp/resp_formatter.h"
+#include "redis/command_args.h"
+#include "redis/commands/scan_options.h"
+#include "resp/response_writer.h"
 #include "redis/database/redis_value.h"
 #include "utils/utility_functions.h"
 #include "enum/redis_type.h"
@@ -14,18 +17,25 @@ class ServerCommands {
 private:
     RedisDatabase& db;
     std::chrono::system_clock::time_point start_time;
-    size_t& total_commands_processed;
+    const std::atomic<uint64_t>& total_commands_processed;
+
+    // FLUSHALL and FLUSHDB [ASYNC|SYNC]; there is a single database
+    void flush(const CommandArgs& args, ResponseWriter& out);
 
 public:
-    ServerCommands(RedisDatabase& database, std::chrono::system_clock::time_point server_start_time, size_t& commands_processed);
+    ServerCommands(RedisDatabase& database, std::chrono::system_clock::time_point server_start_time,
+                   const std::atomic<uint64_t>& commands_processed);
     ~ServerCommands() = default;
 
     // Server command implementations
-    std::string cmdPing(const std::vector<std::string>& args);
-    std::string cmdEcho(const std::vector<std::string>& args);
-    std::string cmdInfo(const std::vector<std::string>& args);
-    std::string cmdFlushall(const std::vector<std::string>& args);
-    std::string cmdKeys(const std::vector<std::string>& args);
-    std::string cmdDbsize(const std::vector<std::string>& args);
-    std::string cmdTime(const std::vector<std::string>& args);
+    void cmdPing(const CommandArgs& args, ResponseWriter& out);
+    void cmdEcho(const CommandArgs& args, ResponseWriter& out);
+    void cmdInfo(const CommandArgs& args, ResponseWriter& out);
+    void cmdFlushall(const CommandArgs& args, ResponseWriter& out);
+    void cmdFlushdb(const CommandArgs& args, ResponseWriter& out);
+    void cmdKeys(const CommandArgs& args, ResponseWriter& out);
+    void cmdScan(const CommandArgs& args, ResponseWriter& out);
+    void cmdDbsize(const CommandArgs& args, ResponseWriter& out);
+    void cmdTime(const CommandArgs& args, ResponseWriter& out);
+    void cmdCommand(const CommandArgs& args, ResponseWriter& out);
 };
\ No newline at end of file
@@ -2,131 +2,171 @@
 
 SetCommands::SetCommands(RedisDatabase& database) : db(database) {}
 
-std::string SetCommands::cmdSadd(const std::vector<std::string>& args) {
+void SetCommands::cmdSadd(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'sadd' command");
+        out.writeError("ERR wrong number of arguments for 'sadd' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.getOrCreate(key, RedisType::SET);
     
-    if (value && value->type != RedisType::SET) {
-        return RESPFormatter::formatError("ERR Operation against a key holding the wrong kind of value");
-    }
-    
-    if (!value) {
-        db.setValue(key, RedisValue(RedisType::SET));
-        value = db.getValue(key);
+    if (value->type() != RedisType::SET) {
+        out.writeError("ERR Operation against a key holding the wrong kind of value");
+        return;
     }
     
     int added = 0;
     for (size_t i = 2; i < args.size(); i++) {
-        if (value->set_value.insert(args[i]).second) {
+        if (value->set().tryEmplace(HashedKey(args[i])).second) {
             added++;
         }
     }
     
-    return RESPFormatter::formatInteger(added);
+    out.writeInteger(added);
 }
 
-std::string SetCommands::cmdSrem(const std::vector<std::string>& args) {
+void SetCommands::cmdSrem(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'srem' command");
+        out.writeError("ERR wrong number of arguments for 'srem' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.writeValue(key);
     
-    if (!value || value->type != RedisType::SET) {
-        return RESPFormatter::formatInteger(0);
+    if (!value || value->type() != RedisType::SET) {
+        out.writeInteger(0);
+        return;
     }
     
     int removed = 0;
     for (size_t i = 2; i < args.size(); i++) {
-        if (value->set_value.erase(args[i]) > 0) {
+        if (value->set().erase(HashedKey(args[i]))) {
             removed++;
         }
     }
     
-    if (value->set_value.empty()) {
-        db.deleteKey(key);
+    if (value->set().empty()) {
+        value.erase();
     }
     
-    return RESPFormatter::formatInteger(removed);
+    out.writeInteger(removed);
 }
 
-std::string SetCommands::cmdSismember(const std::vector<std::string>& args) {
+void SetCommands::cmdSismember(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'sismember' command");
+        out.writeError("ERR wrong number of arguments for 'sismember' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    const std::string& member = args[2];
+    std::string_view key = args[1];
+    HashedKey member(args[2]);
     
-    RedisValue* value = db.getValue(key);
-    if (!value || value->type != RedisType::SET) {
-        return RESPFormatter::formatInteger(0);
+    auto value = db.readValue(key);
+    if (!value || value->type() != RedisType::SET) {
+        out.writeInteger(0);
+        return;
     }
     
-    return RESPFormatter::formatInteger(value->set_value.count(member) > 0 ? 1 : 0);
+    out.writeInteger(value->set().contains(member) ? 1 : 0);
 }
 
-std::string SetCommands::cmdScard(const std::vector<std::string>& args) {
+void SetCommands::cmdScard(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'scard' command");
+        out.writeError("ERR wrong number of arguments for 'scard' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
-    if (!value || value->type != RedisType::SET) {
-        return RESPFormatter::formatInteger(0);
+    if (!value || value->type() != RedisType::SET) {
+        out.writeInteger(0);
+        return;
     }
     
-    return RESPFormatter::formatInteger(value->set_value.size());
+    out.writeInteger(value->set().size());
 }
 
-std::string SetCommands::cmdSmembers(const std::vector<std::string>& args) {
+void SetCommands::cmdSmembers(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'smembers' command");
+        out.writeError("ERR wrong number of arguments for 'smembers' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
-    if (!value || value->type != RedisType::SET) {
-        return RESPFormatter::formatArray(std::vector<std::string>());
+    if (!value || value->type() != RedisType::SET) {
+        out.writeArrayHeader(0);
+        return;
     }
     
-    std::vector<std::string> members(value->set_value.begin(), value->set_value.end());
-    return RESPFormatter::formatArray(members);
+    out.writeArrayHeader(value->set().size());
+    value->set().forEach([&out](const RedisValue::Set::Entry& member) {
+        out.writeBulkString(member.key.view());
+        out.flushIfNeeded();
+    });
 }
 
-std::string SetCommands::cmdSpop(const std::vector<std::string>& args) {
+void SetCommands::cmdSpop(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'spop' command");
+        out.writeError("ERR wrong number of arguments for 'spop' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.writeValue(key);
     
-    if (!value || value->type != RedisType::SET || value->set_value.empty()) {
-        return RESPFormatter::formatNull();
+    if (!value || value->type() != RedisType::SET || value->set().empty()) {
+        out.writeNull();
+        return;
     }
     
-    // Get random element
-    auto it = value->set_value.begin();
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, value->set_value.size() - 1);
-    std::advance(it, dis(gen));
-    
-    std::string result = *it;
-    value->set_value.erase(it);
+    // The first member at or after a random slot, as Redis's
+    // dictGetRandomKey does, instead of walking to a random position.
+    // A sparse stretch can come up empty, so try again until one hits.
+    thread_local std::mt19937_64 random(std::random_device{}());
+    std::string result;
+    size_t found = 0;
+    while (found == 0) {
+        found = value->set().sample(random(), 1, [&result](const RedisValue::Set::Entry& member) {
+            result.assign(member.key.view());
+        });
+    }
+    value->set().erase(HashedKey(result));
     
-    if (value->set_value.empty()) {
-        db.deleteKey(key);
+    if (value->set().empty()) {
+        value.erase();
     }
     
-    return RESPFormatter::formatBulkString(result);
-}
\ No newline at end of file
+    out.writeBulkString(result);
+}
+
+void SetCommands::cmdSscan(const CommandArgs& args, ResponseWriter& out) {
+    if (args.size() < 3) {
+        out.writeError("ERR wrong number of arguments for 'sscan' command");
+        return;
+    }
+    auto options = ScanOptions::parse(args, 2, false, out);
+    if (!options) return;
+
+    auto value = db.readValue(args[1]);
+    if (!value) {
+        writeScanReply(out, 0, {});
+        return;
+    }
+    if (value->type() != RedisType::SET) {
+        out.writeError("ERR Operation against a key holding the wrong kind of value");
+        return;
+    }
+
+    // Views into the set, written out before the ref lets go of the lock
+    std::vector<std::string_view> members;
+    uint64_t cursor = scanTable(value->set(), options->cursor, options->count,
+        [&options, &members](const RedisValue::Set::Entry& member) {
+            if (options->matches(member.key.view())) members.push_back(member.key.view());
+        });
+    writeScanReply(out, cursor, members);
+}
@@ -5,7 +5,9 @@
 #include <chrono>
 #include <random>
 #include "redis/database/redis_database.h"
-#include "resp/resp_formatter.h"
+#include "redis/command_args.h"
+#include "redis/commands/scan_options.h"
+#include "resp/response_writer.h"
 #include "redis/database/redis_value.h"
 #include "utils/utility_functions.h"
 #include "enum/redis_type.h"
@@ -18,10 +20,11 @@ public:
     ~SetCommands() = default;
 
     // Set command implementations
-    std::string cmdSadd(const std::vector<std::string>& args);
-    std::string cmdSrem(const std::vector<std::string>& args);
-    std::string cmdSismember(const std::vector<std::string>& args);
-    std::string cmdScard(const std::vector<std::string>& args);
-    std::string cmdSmembers(const std::vector<std::string>& args);
-    std::string cmdSpop(const std::vector<std::string>& args);
+    void cmdSadd(const CommandArgs& args, ResponseWriter& out);
+    void cmdSrem(const CommandArgs& args, ResponseWriter& out);
+    void cmdSismember(const CommandArgs& args, ResponseWriter& out);
+    void cmdScard(const CommandArgs& args, ResponseWriter& out);
+    void cmdSmembers(const CommandArgs& args, ResponseWriter& out);
+    void cmdSpop(const CommandArgs& args, ResponseWriter& out);
+    void cmdSscan(const CommandArgs& args, ResponseWriter& out);
 };
\ No newline at end of file
@@ -1,286 +1,310 @@
 #include "string_commands.h"
 #include <chrono>
+#include <climits>
+#include <optional>
 
 StringCommands::StringCommands(RedisDatabase& database) : db(database) {
 }
 
-std::string StringCommands::cmdSet(const std::vector<std::string>& args) {
+void StringCommands::writeString(const RedisValue& value, ResponseWriter& out) {
+    if (value.isInteger()) {
+        out.writeBulkString(value.integer());
+    } else {
+        out.writeBulkString(value.str());
+    }
+}
+
+void StringCommands::cmdSet(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'set' command");
+        out.writeError("ERR wrong number of arguments for 'set' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    const std::string& value = args[2];
+    std::string_view key = args[1];
+    std::string_view value = args[2];
     
     RedisValue redis_value(value);
+    std::optional<std::chrono::milliseconds> ttl;
+    bool nx = false;
+    bool xx = false;
     
     // Handle optional parameters (EX, PX, NX, XX)
     for (size_t i = 3; i < args.size(); i += 2) {
         if (i + 1 >= args.size()) {
-            return RESPFormatter::formatError("ERR syntax error");
+            out.writeError("ERR syntax error");
+            return;
         }
         
         std::string param = UtilityFunctions::toUpper(args[i]);
         if (param == "EX") {
             if (!UtilityFunctions::isInteger(args[i + 1])) {
-                return RESPFormatter::formatError("ERR value is not an integer or out of range");
+                out.writeError("ERR value is not an integer or out of range");
+                return;
             }
-            redis_value.setExpiry(std::chrono::seconds(UtilityFunctions::parseInt(args[i + 1])));
+            ttl = std::chrono::seconds(UtilityFunctions::parseInt(args[i + 1]));
         } else if (param == "PX") {
             if (!UtilityFunctions::isInteger(args[i + 1])) {
-                return RESPFormatter::formatError("ERR value is not an integer or out of range");
+                out.writeError("ERR value is not an integer or out of range");
+                return;
             }
-            redis_value.setExpiry(std::chrono::milliseconds(UtilityFunctions::parseInt(args[i + 1])));
+            ttl = std::chrono::milliseconds(UtilityFunctions::parseInt(args[i + 1]));
         } else if (param == "NX") {
-            if (db.keyExists(key)) {
-                return RESPFormatter::formatNull();
-            }
+            nx = true;
             i--; // NX doesn't have a value
         } else if (param == "XX") {
-            if (!db.keyExists(key)) {
-                return RESPFormatter::formatNull();
-            }
+            xx = true;
             i--; // XX doesn't have a value
         }
     }
     
-    db.setValue(key, redis_value);
-    return RESPFormatter::formatSimpleString("OK");
+    // The existence check and the write are one lookup under one lock
+    auto ref = db.getOrCreate(key, RedisType::STRING);
+    if (nx && !ref.wasCreated()) {
+        out.writeNull();
+        return;
+    }
+    if (xx && ref.wasCreated()) {
+        ref.erase();
+        out.writeNull();
+        return;
+    }
+    // Replaces any old value and TTL
+    ref.create(std::move(redis_value));
+    if (ttl) {
+        ref.setExpiry(ServerClock::nowMs() + ttl->count());
+    }
+    out.writeSimpleString("OK");
 }
 
-std::string StringCommands::cmdGet(const std::vector<std::string>& args) {
+void StringCommands::cmdGet(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'get' command");
+        out.writeError("ERR wrong number of arguments for 'get' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
-    if (!value || value->type != RedisType::STRING) {
-        return RESPFormatter::formatNull();
+    if (!value || value->type() != RedisType::STRING) {
+        out.writeNull();
+        return;
     }
     
-    return RESPFormatter::formatBulkString(value->string_value);
+    writeString(*value, out);
 }
 
-std::string StringCommands::cmdDel(const std::vector<std::string>& args) {
+void StringCommands::cmdDel(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'del' command");
+        out.writeError("ERR wrong number of arguments for 'del' command");
+        return;
     }
     
+    auto lock = db.lockKeys(args, 1, 1, true);
     int deleted = 0;
     for (size_t i = 1; i < args.size(); i++) {
-        if (db.deleteKey(args[i])) {
+        if (lock.erase(args[i])) {
             deleted++;
         }
     }
     
-    return RESPFormatter::formatInteger(deleted);
+    out.writeInteger(deleted);
+}
+
+void StringCommands::cmdUnlink(const CommandArgs& args, ResponseWriter& out) {
+    if (args.size() < 2) {
+        out.writeError("ERR wrong number of arguments for 'unlink' command");
+        return;
+    }
+
+    // DEL already hands large values to the LazyFree thread, so the two
+    // differ only in name
+    cmdDel(args, out);
 }
 
-std::string StringCommands::cmdExists(const std::vector<std::string>& args) {
+void StringCommands::cmdExists(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'exists' command");
+        out.writeError("ERR wrong number of arguments for 'exists' command");
+        return;
     }
     
+    auto lock = db.lockKeys(args, 1, 1, false);
     int count = 0;
     for (size_t i = 1; i < args.size(); i++) {
-        if (db.keyExists(args[i])) {
+        if (lock.exists(args[i])) {
             count++;
         }
     }
     
-    return RESPFormatter::formatInteger(count);
+    out.writeInteger(count);
 }
 
-std::string StringCommands::cmdType(const std::vector<std::string>& args) {
+void StringCommands::cmdType(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'type' command");
+        out.writeError("ERR wrong number of arguments for 'type' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
     if (!value) {
-        return RESPFormatter::formatSimpleString("none");
+        out.writeSimpleString("none");
+        return;
     }
     
-    switch (value->type) {
-        case RedisType::STRING: return RESPFormatter::formatSimpleString("string");
-        case RedisType::LIST: return RESPFormatter::formatSimpleString("list");
-        case RedisType::SET: return RESPFormatter::formatSimpleString("set");
-        case RedisType::HASH: return RESPFormatter::formatSimpleString("hash");
-        case RedisType::ZSET: return RESPFormatter::formatSimpleString("zset");
-        default: return RESPFormatter::formatSimpleString("unknown");
+    switch (value->type()) {
+        case RedisType::STRING: out.writeSimpleString("string"); break;
+        case RedisType::LIST: out.writeSimpleString("list"); break;
+        case RedisType::SET: out.writeSimpleString("set"); break;
+        case RedisType::HASH: out.writeSimpleString("hash"); break;
+        case RedisType::ZSET: out.writeSimpleString("zset"); break;
+        default: out.writeSimpleString("unknown"); break;
     }
 }
 
-std::string StringCommands::cmdIncr(const std::vector<std::string>& args) {
-    if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'incr' command");
-    }
-    
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+void StringCommands::incrementBy(std::string_view key, long long delta, ResponseWriter& out) {
+    auto value = db.getOrCreate(key, RedisType::STRING);
     
     long long current = 0;
-    if (value) {
-        if (value->type != RedisType::STRING) {
-            return RESPFormatter::formatError("ERR Operation against a key holding the wrong kind of value");
+    if (!value.wasCreated()) {
+        if (value->type() != RedisType::STRING) {
+            out.writeError("ERR Operation against a key holding the wrong kind of value");
+            return;
         }
-        if (!UtilityFunctions::isInteger(value->string_value)) {
-            return RESPFormatter::formatError("ERR value is not an integer or out of range");
+        if (value->isInteger()) {
+            current = value->integer();
+        } else if (UtilityFunctions::isInteger(value->str())) {
+            // Parsed once; from here on the value is kept as a number
+            current = UtilityFunctions::parseInt(value->str());
+        } else {
+            out.writeError("ERR value is not an integer or out of range");
+            return;
         }
-        current = UtilityFunctions::parseInt(value->string_value);
     }
     
-    current++;
-    db.setValue(key, RedisValue(std::to_string(current)));
-    return RESPFormatter::formatInteger(current);
+    if (__builtin_add_overflow(current, delta, &current)) {
+        out.writeError("ERR increment or decrement would overflow");
+        return;
+    }
+    value->setInteger(current);
+    out.writeInteger(current);
 }
 
-std::string StringCommands::cmdDecr(const std::vector<std::string>& args) {
+void StringCommands::cmdIncr(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'decr' command");
+        out.writeError("ERR wrong number of arguments for 'incr' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
-    
-    long long current = 0;
-    if (value) {
-        if (value->type != RedisType::STRING) {
-            return RESPFormatter::formatError("ERR Operation against a key holding the wrong kind of value");
-        }
-        if (!UtilityFunctions::isInteger(value->string_value)) {
-            return RESPFormatter::formatError("ERR value is not an integer or out of range");
-        }
-        current = UtilityFunctions::parseInt(value->string_value);
+    incrementBy(args[1], 1, out);
+}
+
+void StringCommands::cmdDecr(const CommandArgs& args, ResponseWriter& out) {
+    if (args.size() != 2) {
+        out.writeError("ERR wrong number of arguments for 'decr' command");
+        return;
     }
     
-    current--;
-    db.setValue(key, RedisValue(std::to_string(current)));
-    return RESPFormatter::formatInteger(current);
+    incrementBy(args[1], -1, out);
 }
 
-std::string StringCommands::cmdIncrBy(const std::vector<std::string>& args) {
+void StringCommands::cmdIncrBy(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'incrby' command");
+        out.writeError("ERR wrong number of arguments for 'incrby' command");
+        return;
     }
     
-    const std::string& key = args[1];
     if (!UtilityFunctions::isInteger(args[2])) {
-        return RESPFormatter::formatError("ERR value is not an integer or out of range");
+        out.writeError("ERR value is not an integer or out of range");
+        return;
     }
-    long long increment = UtilityFunctions::parseInt(args[2]);
     
-    RedisValue* value = db.getValue(key);
-    long long current = 0;
-    if (value) {
-        if (value->type != RedisType::STRING) {
-            return RESPFormatter::formatError("ERR Operation against a key holding the wrong kind of value");
-        }
-        if (!UtilityFunctions::isInteger(value->string_value)) {
-            return RESPFormatter::formatError("ERR value is not an integer or out of range");
-        }
-        current = UtilityFunctions::parseInt(value->string_value);
-    }
-    
-    current += increment;
-    db.setValue(key, RedisValue(std::to_string(current)));
-    return RESPFormatter::formatInteger(current);
+    incrementBy(args[1], UtilityFunctions::parseInt(args[2]), out);
 }
 
-std::string StringCommands::cmdDecrBy(const std::vector<std::string>& args) {
+void StringCommands::cmdDecrBy(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'decrby' command");
+        out.writeError("ERR wrong number of arguments for 'decrby' command");
+        return;
     }
     
-    const std::string& key = args[1];
     if (!UtilityFunctions::isInteger(args[2])) {
-        return RESPFormatter::formatError("ERR value is not an integer or out of range");
+        out.writeError("ERR value is not an integer or out of range");
+        return;
     }
     long long decrement = UtilityFunctions::parseInt(args[2]);
-    
-    RedisValue* value = db.getValue(key);
-    long long current = 0;
-    if (value) {
-        if (value->type != RedisType::STRING) {
-            return RESPFormatter::formatError("ERR Operation against a key holding the wrong kind of value");
-        }
-        if (!UtilityFunctions::isInteger(value->string_value)) {
-            return RESPFormatter::formatError("ERR value is not an integer or out of range");
-        }
-        current = UtilityFunctions::parseInt(value->string_value);
+    if (decrement == LLONG_MIN) {
+        out.writeError("ERR decrement would overflow");
+        return;
     }
     
-    current -= decrement;
-    db.setValue(key, RedisValue(std::to_string(current)));
-    return RESPFormatter::formatInteger(current);
+    incrementBy(args[1], -decrement, out);
 }
 
-std::string StringCommands::cmdStrlen(const std::vector<std::string>& args) {
+void StringCommands::cmdStrlen(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'strlen' command");
+        out.writeError("ERR wrong number of arguments for 'strlen' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
+    std::string_view key = args[1];
+    auto value = db.readValue(key);
     
-    if (!value || value->type != RedisType::STRING) {
-        return RESPFormatter::formatInteger(0);
+    if (!value || value->type() != RedisType::STRING) {
+        out.writeInteger(0);
+        return;
     }
     
-    return RESPFormatter::formatInteger(value->string_value.length());
+    out.writeInteger(value->length());
 }
 
-std::string StringCommands::cmdAppend(const std::vector<std::string>& args) {
+void StringCommands::cmdAppend(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'append' command");
+        out.writeError("ERR wrong number of arguments for 'append' command");
+        return;
     }
     
-    const std::string& key = args[1];
-    const std::string& append_value = args[2];
-    
-    RedisValue* value = db.getValue(key);
-    std::string result;
-    
-    if (value && value->type == RedisType::STRING) {
-        result = value->string_value + append_value;
-    } else {
-        result = append_value;
+    auto value = db.getOrCreate(args[1], RedisType::STRING);
+    if (value->type() != RedisType::STRING) {
+        out.writeError("ERR Operation against a key holding the wrong kind of value");
+        return;
     }
     
-    db.setValue(key, RedisValue(result));
-    return RESPFormatter::formatInteger(result.length());
+    // Grows the stored string in place; the TTL is left as it was
+    value->appendString(args[2]);
+    out.writeInteger(value->length());
 }
 
-std::string StringCommands::cmdMget(const std::vector<std::string>& args) {
+void StringCommands::cmdMget(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'mget' command");
+        out.writeError("ERR wrong number of arguments for 'mget' command");
+        return;
     }
     
-    std::vector<std::string> results;
+    auto lock = db.lockKeys(args, 1, 1, false);
+    out.writeArrayHeader(args.size() - 1);
     for (size_t i = 1; i < args.size(); i++) {
-        RedisValue* value = db.getValue(args[i]);
-        if (value && value->type == RedisType::STRING) {
-            results.push_back(value->string_value);
+        RedisValue* value = lock.get(args[i]);
+        if (value && value->type() == RedisType::STRING) {
+            writeString(*value, out);
         } else {
-            results.push_back(""); // Will be formatted as NULL
+            out.writeNull();
         }
+        out.flushIfNeeded();
     }
-    
-    return RESPFormatter::formatArray(results);
 }
 
-std::string StringCommands::cmdMset(const std::vector<std::string>& args) {
+void StringCommands::cmdMset(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() < 3 || args.size() % 2 == 0) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'mset' command");
+        out.writeError("ERR wrong number of arguments for 'mset' command");
+        return;
     }
     
+    // All keys are set under one lock set, so no reader sees half of them
+    auto lock = db.lockKeys(args, 1, 2, true);
     for (size_t i = 1; i < args.size(); i += 2) {
-        db.setValue(args[i], RedisValue(args[i + 1]));
+        lock.set(args[i], RedisValue(args[i + 1]));
     }
     
-    return RESPFormatter::formatSimpleString("OK");
+    out.writeSimpleString("OK");
 }
\ No newline at end of file
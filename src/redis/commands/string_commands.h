@@ -4,7 +4,8 @@
 #include <vector>
 #include <chrono>
 #include "redis/database/redis_database.h"
-#include "resp/resp_formatter.h"
+#include "redis/command_args.h"
+#include "resp/response_writer.h"
 #include "redis/database/redis_value.h"
 #include "utils/utility_functions.h"
 #include "enum/redis_type.h"
@@ -13,22 +14,30 @@ class StringCommands {
 private:
     RedisDatabase& db;
 
+    // Shared by the INCR family: adds `delta` to the integer at `key` in
+    // place, so the key keeps its TTL
+    void incrementBy(std::string_view key, long long delta, ResponseWriter& out);
+    // A STRING value as a bulk string; integers are formatted here, so
+    // INCR never has to
+    static void writeString(const RedisValue& value, ResponseWriter& out);
+
 public:
     explicit StringCommands(RedisDatabase& database);
     ~StringCommands() = default;
 
     // String command implementations
-    std::string cmdSet(const std::vector<std::string>& args);
-    std::string cmdGet(const std::vector<std::string>& args);
-    std::string cmdDel(const std::vector<std::string>& args);
-    std::string cmdExists(const std::vector<std::string>& args);
-    std::string cmdType(const std::vector<std::string>& args);
-    std::string cmdIncr(const std::vector<std::string>& args);
-    std::string cmdDecr(const std::vector<std::string>& args);
-    std::string cmdIncrBy(const std::vector<std::string>& args);
-    std::string cmdDecrBy(const std::vector<std::string>& args);
-    std::string cmdStrlen(const std::vector<std::string>& args);
-    std::string cmdAppend(const std::vector<std::string>& args);
-    std::string cmdMget(const std::vector<std::string>& args);
-    std::string cmdMset(const std::vector<std::string>& args);
+    void cmdSet(const CommandArgs& args, ResponseWriter& out);
+    void cmdGet(const CommandArgs& args, ResponseWriter& out);
+    void cmdDel(const CommandArgs& args, ResponseWriter& out);
+    void cmdUnlink(const CommandArgs& args, ResponseWriter& out);
+    void cmdExists(const CommandArgs& args, ResponseWriter& out);
+    void cmdType(const CommandArgs& args, ResponseWriter& out);
+    void cmdIncr(const CommandArgs& args, ResponseWriter& out);
+    void cmdDecr(const CommandArgs& args, ResponseWriter& out);
+    void cmdIncrBy(const CommandArgs& args, ResponseWriter& out);
+    void cmdDecrBy(const CommandArgs& args, ResponseWriter& out);
+    void cmdStrlen(const CommandArgs& args, ResponseWriter& out);
+    void cmdAppend(const CommandArgs& args, ResponseWriter& out);
+    void cmdMget(const CommandArgs& args, ResponseWriter& out);
+    void cmdMset(const CommandArgs& args, ResponseWriter& out);
 };
\ No newline at end of file
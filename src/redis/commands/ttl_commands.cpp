@@ -1,102 +1,180 @@
 #include "ttl_commands.h"
+#include <charconv>
+#include <climits>
+
+namespace {
+
+// Expiry times and TTLs must fit in a long long; parseInt would turn an
+// overflowing value into 0 and delete the key
+bool parseTime(std::string_view arg, long long& value) {
+    if (!UtilityFunctions::isInteger(arg)) return false;
+    if (arg[0] == '+') arg.remove_prefix(1);
+    auto result = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+    return result.ec == std::errc();
+}
+
+std::string lowerName(std::string_view name) {
+    std::string result(name);
+    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+    return result;
+}
+
+} // namespace
 
 TTLCommands::TTLCommands(RedisDatabase& database) : db(database) {}
 
-std::string TTLCommands::cmdExpire(const std::vector<std::string>& args) {
-    if (args.size() != 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'expire' command");
+void TTLCommands::expireGeneric(const CommandArgs& args, ResponseWriter& out, long long unit_ms, bool absolute) {
+    if (args.size() < 3) {
+        out.writeError("ERR wrong number of arguments for '" + lowerName(args[0]) + "' command");
+        return;
     }
-    
-    const std::string& key = args[1];
-    if (!UtilityFunctions::isInteger(args[2])) {
-        return RESPFormatter::formatError("ERR value is not an integer or out of range");
+
+    bool nx = false;
+    bool xx = false;
+    bool gt = false;
+    bool lt = false;
+    for (size_t i = 3; i < args.size(); i++) {
+        std::string option = UtilityFunctions::toUpper(args[i]);
+        if (option == "NX") {
+            nx = true;
+        } else if (option == "XX") {
+            xx = true;
+        } else if (option == "GT") {
+            gt = true;
+        } else if (option == "LT") {
+            lt = true;
+        } else {
+            out.writeError("ERR Unsupported option " + std::string(args[i]));
+            return;
+        }
     }
-    
-    RedisValue* value = db.getValue(key);
-    if (!value) {
-        return RESPFormatter::formatInteger(0);
+    if (nx && (xx || gt || lt)) {
+        out.writeError("ERR NX and XX, GT or LT options at the same time are not compatible");
+        return;
     }
-    
-    long long seconds = UtilityFunctions::parseInt(args[2]);
-    if (seconds <= 0) {
-        db.deleteKey(key);
-        return RESPFormatter::formatInteger(1);
+    if (gt && lt) {
+        out.writeError("ERR GT and LT options at the same time are not compatible");
+        return;
     }
-    
-    value->setExpiry(std::chrono::seconds(seconds));
-    return RESPFormatter::formatInteger(1);
-}
 
-std::string TTLCommands::cmdExpireat(const std::vector<std::string>& args) {
-    if (args.size() != 3) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'expireat' command");
+    long long when = 0;
+    if (!parseTime(args[2], when)) {
+        out.writeError("ERR value is not an integer or out of range");
+        return;
+    }
+    int64_t now = ServerClock::nowMs();
+    if (when > LLONG_MAX / unit_ms || when < LLONG_MIN / unit_ms) {
+        out.writeError("ERR invalid expire time in '" + lowerName(args[0]) + "' command");
+        return;
     }
-    
-    const std::string& key = args[1];
-    if (!UtilityFunctions::isInteger(args[2])) {
-        return RESPFormatter::formatError("ERR value is not an integer or out of range");
+    when *= unit_ms;
+    if (!absolute) {
+        if ((when > 0 && now > LLONG_MAX - when) || (when < 0 && now < LLONG_MIN - when)) {
+            out.writeError("ERR invalid expire time in '" + lowerName(args[0]) + "' command");
+            return;
+        }
+        when += now;
     }
-    
-    RedisValue* value = db.getValue(key);
+
+    auto value = db.writeValue(args[1]);
     if (!value) {
-        return RESPFormatter::formatInteger(0);
-    }
-    
-    long long timestamp = UtilityFunctions::parseInt(args[2]);
-    auto expiry_time = std::chrono::system_clock::from_time_t(timestamp);
-    
-    if (expiry_time <= std::chrono::system_clock::now()) {
-        db.deleteKey(key);
-        return RESPFormatter::formatInteger(1);
-    }
-    
-    value->expiry = expiry_time;
-    value->has_expiry = true;
-    return RESPFormatter::formatInteger(1);
+        out.writeInteger(0);
+        return;
+    }
+
+    // A key without an expiry counts as never expiring, so GT never
+    // applies to it and LT always does
+    if (nx || xx || gt || lt) {
+        bool has_expiry = value.hasExpiry();
+        int64_t current = has_expiry ? value.getExpiry() : 0;
+        if ((nx && has_expiry) || (xx && !has_expiry) ||
+            (gt && (!has_expiry || when <= current)) ||
+            (lt && has_expiry && when >= current)) {
+            out.writeInteger(0);
+            return;
+        }
+    }
+
+    if (when <= now) {
+        value.erase();
+    } else {
+        value.setExpiry(when);
+    }
+    out.writeInteger(1);
 }
 
-std::string TTLCommands::cmdTtl(const std::vector<std::string>& args) {
+void TTLCommands::ttlGeneric(const CommandArgs& args, ResponseWriter& out, bool milliseconds, bool absolute) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'ttl' command");
+        out.writeError("ERR wrong number of arguments for '" + lowerName(args[0]) + "' command");
+        return;
     }
-    
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
-    
+
+    // Expired keys read as missing
+    auto value = db.readValue(args[1]);
     if (!value) {
-        return RESPFormatter::formatInteger(-2); // Key doesn't exist
+        out.writeInteger(-2);
+        return;
     }
-    
-    if (!value->has_expiry) {
-        return RESPFormatter::formatInteger(-1); // Key exists but has no expiry
+    if (!value.hasExpiry()) {
+        out.writeInteger(-1);
+        return;
     }
-    
-    auto now = std::chrono::system_clock::now();
-    if (now >= value->expiry) {
-        db.deleteKey(key);
-        return RESPFormatter::formatInteger(-2); // Key expired
+
+    int64_t expiry = value.getExpiry();
+    if (absolute) {
+        out.writeInteger(milliseconds ? expiry : expiry / 1000);
+        return;
     }
-    
-    auto ttl_seconds = std::chrono::duration_cast<std::chrono::seconds>(value->expiry - now);
-    return RESPFormatter::formatInteger(ttl_seconds.count());
+    int64_t ttl = std::max<int64_t>(0, expiry - ServerClock::nowMs());
+    // Rounded to the nearest second, as Redis does
+    out.writeInteger(milliseconds ? ttl : (ttl + 500) / 1000);
+}
+
+void TTLCommands::cmdExpire(const CommandArgs& args, ResponseWriter& out) {
+    expireGeneric(args, out, 1000, false);
 }
 
-std::string TTLCommands::cmdPersist(const std::vector<std::string>& args) {
+void TTLCommands::cmdPexpire(const CommandArgs& args, ResponseWriter& out) {
+    expireGeneric(args, out, 1, false);
+}
+
+void TTLCommands::cmdExpireat(const CommandArgs& args, ResponseWriter& out) {
+    expireGeneric(args, out, 1000, true);
+}
+
+void TTLCommands::cmdPexpireat(const CommandArgs& args, ResponseWriter& out) {
+    expireGeneric(args, out, 1, true);
+}
+
+void TTLCommands::cmdTtl(const CommandArgs& args, ResponseWriter& out) {
+    ttlGeneric(args, out, false, false);
+}
+
+void TTLCommands::cmdPttl(const CommandArgs& args, ResponseWriter& out) {
+    ttlGeneric(args, out, true, false);
+}
+
+void TTLCommands::cmdExpiretime(const CommandArgs& args, ResponseWriter& out) {
+    ttlGeneric(args, out, false, true);
+}
+
+void TTLCommands::cmdPexpiretime(const CommandArgs& args, ResponseWriter& out) {
+    ttlGeneric(args, out, true, true);
+}
+
+void TTLCommands::cmdPersist(const CommandArgs& args, ResponseWriter& out) {
     if (args.size() != 2) {
-        return RESPFormatter::formatError("ERR wrong number of arguments for 'persist' command");
+        out.writeError("ERR wrong number of arguments for 'persist' command");
+        return;
     }
-    
-    const std::string& key = args[1];
-    RedisValue* value = db.getValue(key);
-    
+
+    std::string_view key = args[1];
+    auto value = db.writeValue(key);
+
     if (!value) {
-        return RESPFormatter::formatInteger(0);
-    }
-    
-    if (!value->has_expiry) {
-        return RESPFormatter::formatInteger(0);
+        out.writeInteger(0);
+        return;
     }
-    
-    value->clearExpiry();
-    return RESPFormatter::formatInteger(1);
-}
\ No newline at end of file
+
+    out.writeInteger(value.clearExpiry() ? 1 : 0);
+}
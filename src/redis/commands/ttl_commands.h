@@ -4,7 +4,8 @@
 #include <vector>
 #include <chrono>
 #include "redis/database/redis_database.h"
-#include "resp/resp_formatter.h"
+#include "redis/command_args.h"
+#include "resp/response_writer.h"
 #include "redis/database/redis_value.h"
 #include "utils/utility_functions.h"
 #include "enum/redis_type.h"
@@ -12,13 +13,24 @@ class TTLCommands {
 private:
     RedisDatabase& db;
 
+    // EXPIRE, PEXPIRE, EXPIREAT and PEXPIREAT: the argument is in units of
+    // `unit_ms`, and a Unix time rather than a TTL when `absolute`
+    void expireGeneric(const CommandArgs& args, ResponseWriter& out, long long unit_ms, bool absolute);
+    // TTL, PTTL, EXPIRETIME and PEXPIRETIME
+    void ttlGeneric(const CommandArgs& args, ResponseWriter& out, bool milliseconds, bool absolute);
+
 public:
     explicit TTLCommands(RedisDatabase& database);
     ~TTLCommands() = default;
 
     // TTL command implementations
-    std::string cmdExpire(const std::vector<std::string>& args);
-    std::string cmdExpireat(const std::vector<std::string>& args);
-    std::string cmdTtl(const std::vector<std::string>& args);
-    std::string cmdPersist(const std::vector<std::string>& args);
+    void cmdExpire(const CommandArgs& args, ResponseWriter& out);
+    void cmdPexpire(const CommandArgs& args, ResponseWriter& out);
+    void cmdExpireat(const CommandArgs& args, ResponseWriter& out);
+    void cmdPexpireat(const CommandArgs& args, ResponseWriter& out);
+    void cmdTtl(const CommandArgs& args, ResponseWriter& out);
+    void cmdPttl(const CommandArgs& args, ResponseWriter& out);
+    void cmdExpiretime(const CommandArgs& args, ResponseWriter& out);
+    void cmdPexpiretime(const CommandArgs& args, ResponseWriter& out);
+    void cmdPersist(const CommandArgs& args, ResponseWriter& out);
 };
\ No newline at end of file
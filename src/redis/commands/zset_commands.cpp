@@ -0,0 +1,73 @@
+#include "zset_commands.h"
+#include <charconv>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr uint64_t SIGN_BIT = 1ull << 63;
+
+// A ZSCAN cursor is the next score to visit, mapped onto the integers in
+// score order (negative scores are flipped, the rest get the sign bit),
+// plus one so 0 still means done
+uint64_t scoreCursor(double score) {
+    uint64_t bits;
+    std::memcpy(&bits, &score, sizeof(bits));
+    return ((bits & SIGN_BIT) ? ~bits : bits | SIGN_BIT) + 1;
+}
+
+double cursorScore(uint64_t cursor) {
+    uint64_t key = cursor - 1;
+    uint64_t bits = (key & SIGN_BIT) ? key & ~SIGN_BIT : ~key;
+    double score;
+    std::memcpy(&score, &bits, sizeof(score));
+    return score;
+}
+
+} // namespace
+
+ZSetCommands::ZSetCommands(RedisDatabase& database) : db(database) {}
+
+void ZSetCommands::cmdZscan(const CommandArgs& args, ResponseWriter& out) {
+    if (args.size() < 3) {
+        out.writeError("ERR wrong number of arguments for 'zscan' command");
+        return;
+    }
+    auto options = ScanOptions::parse(args, 2, false, out);
+    if (!options) return;
+
+    auto value = db.readValue(args[1]);
+    if (!value) {
+        writeScanReply(out, 0, {});
+        return;
+    }
+    if (value->type() != RedisType::ZSET) {
+        out.writeError("ERR Operation against a key holding the wrong kind of value");
+        return;
+    }
+
+    // Sorted sets have no member index to walk, so the cursor moves in
+    // score order instead, and each score's members come together: a
+    // member present throughout is returned once unless its score changes
+    // mid-scan. A cursor that decodes to NaN starts over.
+    const RedisValue::ZSet& zset = value->zset();
+    auto group = options->cursor == 0 ? zset.begin() : zset.lower_bound(cursorScore(options->cursor));
+    std::vector<std::pair<std::string_view, std::string>> matched;
+    size_t visited = 0;
+    for (; group != zset.end() && visited < options->count; ++group) {
+        char digits[32];
+        char* end = std::to_chars(digits, digits + sizeof(digits), group->first).ptr;
+        for (const std::string& member : group->second) {
+            if (options->matches(member)) matched.emplace_back(member, std::string(digits, end - digits));
+        }
+        visited += group->second.size();
+    }
+
+    std::vector<std::string_view> pairs;
+    pairs.reserve(matched.size() * 2);
+    for (const auto& [member, score] : matched) {
+        pairs.push_back(member);
+        pairs.push_back(score);
+    }
+    writeScanReply(out, group == zset.end() ? 0 : scoreCursor(group->first), pairs);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "redis/database/redis_database.h"
+#include "redis/command_args.h"
+#include "redis/commands/scan_options.h"
+#include "resp/response_writer.h"
+#include "redis/database/redis_value.h"
+#include "utils/utility_functions.h"
+#include "enum/redis_type.h"
+class ZSetCommands {
+private:
+    RedisDatabase& db;
+
+public:
+    explicit ZSetCommands(RedisDatabase& database);
+    ~ZSetCommands() = default;
+
+    // Sorted set command implementations
+    void cmdZscan(const CommandArgs& args, ResponseWriter& out);
+};
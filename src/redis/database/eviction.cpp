@@ -0,0 +1,108 @@
+#include "eviction.h"
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include "utils/server_clock.h"
+
+namespace {
+
+struct PolicyName {
+    EvictionPolicy policy;
+    const char* name;
+};
+
+const PolicyName POLICY_NAMES[] = {
+    {EvictionPolicy::NOEVICTION, "noeviction"},
+    {EvictionPolicy::ALLKEYS_LRU, "allkeys-lru"},
+    {EvictionPolicy::ALLKEYS_LFU, "allkeys-lfu"},
+    {EvictionPolicy::ALLKEYS_RANDOM, "allkeys-random"},
+    {EvictionPolicy::VOLATILE_LRU, "volatile-lru"},
+    {EvictionPolicy::VOLATILE_TTL, "volatile-ttl"},
+};
+
+} // namespace
+
+std::optional<EvictionPolicy> parseEvictionPolicy(std::string_view name) {
+    for (const auto& entry : POLICY_NAMES) {
+        std::string_view candidate(entry.name);
+        if (candidate.size() == name.size() &&
+            std::equal(candidate.begin(), candidate.end(), name.begin(),
+                       [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); })) {
+            return entry.policy;
+        }
+    }
+    return std::nullopt;
+}
+
+const char* evictionPolicyName(EvictionPolicy policy) {
+    for (const auto& entry : POLICY_NAMES) {
+        if (entry.policy == policy) return entry.name;
+    }
+    return "unknown";
+}
+
+uint32_t AccessClock::lruNow() {
+    return static_cast<uint32_t>(ServerClock::nowMs() / 1000);
+}
+
+uint16_t AccessClock::minutesNow() {
+    return static_cast<uint16_t>(ServerClock::nowMs() / 60000);
+}
+
+uint32_t AccessClock::initial(EvictionPolicy policy) {
+    if (policy == EvictionPolicy::ALLKEYS_LFU) {
+        return (static_cast<uint32_t>(minutesNow()) << 8) | LFU_INIT_VAL;
+    }
+    return lruNow();
+}
+
+uint8_t AccessClock::lfuCounter(uint32_t clock) {
+    uint16_t last = static_cast<uint16_t>(clock >> 8);
+    uint8_t counter = static_cast<uint8_t>(clock & 0xff);
+    // 16-bit minutes wrap after 45 days, so the subtraction wraps too
+    uint16_t elapsed = static_cast<uint16_t>(minutesNow() - last);
+    uint32_t periods = elapsed / LFU_DECAY_MINUTES;
+    return periods >= counter ? 0 : static_cast<uint8_t>(counter - periods);
+}
+
+uint32_t AccessClock::touched(uint32_t clock, EvictionPolicy policy) {
+    if (policy != EvictionPolicy::ALLKEYS_LFU) return lruNow();
+
+    uint8_t counter = lfuCounter(clock);
+    if (counter < 255) {
+        // The more hits a key has, the less likely each one counts
+        thread_local std::minstd_rand random(std::random_device{}());
+        double r = static_cast<double>(random() - std::minstd_rand::min()) /
+                   static_cast<double>(std::minstd_rand::max() - std::minstd_rand::min());
+        double base = counter > LFU_INIT_VAL ? counter - LFU_INIT_VAL : 0;
+        if (r < 1.0 / (base * LFU_LOG_FACTOR + 1)) counter++;
+    }
+    return (static_cast<uint32_t>(minutesNow()) << 8) | counter;
+}
+
+uint64_t AccessClock::evictionScore(uint32_t clock, EvictionPolicy policy) {
+    if (policy == EvictionPolicy::ALLKEYS_LFU) return 255 - lfuCounter(clock);
+    // Wraps like the clock itself, so a future time reads as recent
+    uint32_t idle = lruNow() - clock;
+    return idle > UINT32_MAX / 2 ? 0 : idle;
+}
+
+void EvictionPool::offer(uint64_t score, size_t shard, std::string_view key) {
+    auto same = std::find_if(candidates.begin(), candidates.end(),
+                             [key](const Candidate& c) { return c.key == key; });
+    if (same != candidates.end()) candidates.erase(same);
+    if (candidates.size() == SIZE) {
+        if (score <= candidates.front().score) return;
+        candidates.erase(candidates.begin());
+    }
+    auto at = std::upper_bound(candidates.begin(), candidates.end(), score,
+                               [](uint64_t s, const Candidate& c) { return s < c.score; });
+    candidates.insert(at, Candidate{score, shard, std::string(key)});
+}
+
+std::optional<EvictionPool::Candidate> EvictionPool::popBest() {
+    if (candidates.empty()) return std::nullopt;
+    Candidate best = std::move(candidates.back());
+    candidates.pop_back();
+    return best;
+}
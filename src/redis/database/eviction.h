@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "enum/eviction_policy.h"
+
+std::optional<EvictionPolicy> parseEvictionPolicy(std::string_view name);
+// The name as CONFIG and INFO spell it, e.g. "allkeys-lru"
+const char* evictionPolicyName(EvictionPolicy policy);
+
+// The 32-bit access clock every RedisValue carries, after Redis's 24-bit
+// lru field. Under LFU it is the last decrement time in minutes (16 bits)
+// above an 8-bit logarithmic access counter; under the other policies it
+// is the time of last access in seconds. Times come from ServerClock, so
+// touching a key reads no clock.
+class AccessClock {
+public:
+    // Counter of a new key, so it is not evicted before its second access
+    static constexpr uint8_t LFU_INIT_VAL = 5;
+    // Redis's lfu-log-factor: about a million hits take the counter to 255
+    static constexpr double LFU_LOG_FACTOR = 10;
+    // Redis's lfu-decay-time: the counter drops by one per idle minute
+    static constexpr uint32_t LFU_DECAY_MINUTES = 1;
+
+    static uint32_t initial(EvictionPolicy policy);
+    static uint32_t touched(uint32_t clock, EvictionPolicy policy);
+    // Higher means evict sooner: idle seconds, or 255 minus the decayed
+    // LFU counter
+    static uint64_t evictionScore(uint32_t clock, EvictionPolicy policy);
+    // The counter after the decay for the minutes since its last access
+    static uint8_t lfuCounter(uint32_t clock);
+
+private:
+    static uint32_t lruNow();
+    static uint16_t minutesNow();
+};
+
+// Redis's eviction pool: the best eviction candidates seen by sampling,
+// kept across evictions, so each eviction compares a handful of fresh
+// samples against the best of earlier ones instead of scanning the
+// keyspace. Not thread-safe; the database guards it.
+class EvictionPool {
+public:
+    static constexpr size_t SIZE = 16;
+
+    struct Candidate {
+        uint64_t score;
+        size_t shard;
+        std::string key;
+    };
+
+    // Keeps the SIZE highest scores; a key already in the pool gets the
+    // new score
+    void offer(uint64_t score, size_t shard, std::string_view key);
+    // Removes and returns the highest-scoring candidate
+    std::optional<Candidate> popBest();
+    size_t size() const { return candidates.size(); }
+    void clear() { candidates.clear(); }
+
+private:
+    std::vector<Candidate> candidates;   // ascending by score
+};
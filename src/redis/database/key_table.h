@@ -0,0 +1,496 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "utils/compact_string.h"
+#include "utils/string_hash.h"
+
+// Open-addressing hash table in the Swiss table style, for the keyspace
+// and for the fields of hash values. Entries live inline in one flat
+// array. Beside it is one control byte per slot: empty, deleted, or 7
+// bits of the key's hash. A lookup scans a group of 16 control bytes with
+// one SSE2 compare and only touches the entries whose byte matches. Keys
+// of up to 31 bytes are stored inside the entry, and slots start on a
+// cache line, so for a keyspace entry (64 bytes) a hit with a short key
+// and an embedded value reads one line.
+//
+// Growing does not move everything at once. A second table is allocated
+// and every insert or erase migrates a couple of groups into it; lookups
+// check both tables until the old one is drained. rehashStep() lets an
+// idle server finish the move in the background. Only writes move
+// entries, so readers holding a shared lock never see a migration, and
+// an Entry* stays valid until the next insert or erase.
+template <typename V>
+class KeyTable {
+public:
+    struct Entry {
+        EmbeddedString key;
+        uint64_t hash;
+        V value;
+    };
+
+private:
+    static constexpr size_t GROUP_SIZE = 16;
+    // Smaller than a group, so a hash value with a few fields stays small:
+    // such a table is one partial group, its control bytes past the
+    // capacity set to PADDING
+    static constexpr size_t MIN_CAPACITY = 4;
+    static constexpr size_t SLOT_ALIGNMENT = alignof(Entry) > 64 ? alignof(Entry) : 64;
+    static constexpr int8_t EMPTY = -128;
+    static constexpr int8_t DELETED = -2;
+    // Never matches a hash byte and is never handed out as a free slot
+    static constexpr int8_t PADDING = -1;
+    // Old groups migrated by each insert or erase while rehashing
+    static constexpr size_t REHASH_GROUPS_PER_WRITE = 2;
+
+    static int8_t h2(uint64_t hash) { return static_cast<int8_t>(hash & 0x7f); }
+    static size_t h1(uint64_t hash) { return static_cast<size_t>(hash >> 7); }
+
+    // Bit i set when control byte i of the group equals `value`
+    static uint32_t match(const int8_t* group, int8_t value) {
+#if defined(__SSE2__)
+        __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), ctrl)));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_SIZE; ++i) {
+            if (group[i] == value) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Empty or deleted slots: the only control bytes with the sign bit set
+    static uint32_t matchFree(const int8_t* group) {
+#if defined(__SSE2__)
+        __m128i ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_SIZE; ++i) {
+            if (group[i] < 0) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    struct Table {
+        int8_t* ctrl = nullptr;
+        Entry* slots = nullptr;
+        size_t capacity = 0;   // a power of two, at least one group
+        size_t size = 0;
+        size_t deleted = 0;
+
+        Table() = default;
+        explicit Table(size_t slot_count) : capacity(slot_count) {
+            // Group loads always read GROUP_SIZE control bytes
+            size_t ctrl_bytes = std::max(capacity, GROUP_SIZE);
+            ctrl = static_cast<int8_t*>(::operator new(ctrl_bytes, std::align_val_t(GROUP_SIZE)));
+            std::memset(ctrl, EMPTY, capacity);
+            std::memset(ctrl + capacity, PADDING, ctrl_bytes - capacity);
+            slots = static_cast<Entry*>(::operator new(capacity * sizeof(Entry), std::align_val_t(SLOT_ALIGNMENT)));
+        }
+        Table(Table&& other) noexcept { swap(other); }
+        Table& operator=(Table&& other) noexcept {
+            Table(std::move(other)).swap(*this);
+            return *this;
+        }
+        Table(const Table&) = delete;
+        Table& operator=(const Table&) = delete;
+        ~Table() {
+            if (!ctrl) return;
+            for (size_t i = 0; i < capacity; ++i) {
+                if (ctrl[i] >= 0) slots[i].~Entry();
+            }
+            ::operator delete(ctrl, std::align_val_t(GROUP_SIZE));
+            ::operator delete(slots, std::align_val_t(SLOT_ALIGNMENT));
+        }
+
+        void swap(Table& other) noexcept {
+            std::swap(ctrl, other.ctrl);
+            std::swap(slots, other.slots);
+            std::swap(capacity, other.capacity);
+            std::swap(size, other.size);
+            std::swap(deleted, other.deleted);
+        }
+
+        size_t groupCount() const { return (capacity + GROUP_SIZE - 1) / GROUP_SIZE; }
+        size_t groupMask() const { return groupCount() - 1; }
+        bool contains(const Entry* entry) const {
+            return capacity > 0 && entry >= slots && entry < slots + capacity;
+        }
+        // Inserts must leave at least one empty slot per probe sequence
+        bool full() const { return (size + deleted + 1) * 8 > capacity * 7; }
+
+        Entry* find(std::string_view key, uint64_t hash) const {
+            if (capacity == 0) return nullptr;
+            size_t mask = groupMask();
+            size_t group = h1(hash) & mask;
+            // Triangular probing visits every group of a power-of-two table
+            for (size_t step = 1; step <= mask + 1; ++step) {
+                const int8_t* ctrl_group = ctrl + group * GROUP_SIZE;
+                for (uint32_t bits = match(ctrl_group, h2(hash)); bits; bits &= bits - 1) {
+                    Entry& entry = slots[group * GROUP_SIZE + __builtin_ctz(bits)];
+                    if (entry.hash == hash && entry.key == key) return &entry;
+                }
+                if (match(ctrl_group, EMPTY)) return nullptr;
+                group = (group + step) & mask;
+            }
+            return nullptr;
+        }
+
+        // First free slot on the probe sequence; the key must be absent
+        size_t findInsertSlot(uint64_t hash) const {
+            size_t mask = groupMask();
+            size_t group = h1(hash) & mask;
+            for (size_t step = 1;; ++step) {
+                uint32_t bits = matchFree(ctrl + group * GROUP_SIZE);
+                if (capacity < GROUP_SIZE) bits &= (1u << capacity) - 1;
+                if (bits) return group * GROUP_SIZE + __builtin_ctz(bits);
+                group = (group + step) & mask;
+            }
+        }
+
+        template <typename... Args>
+        Entry* emplace(uint64_t hash, Args&&... args) {
+            size_t index = findInsertSlot(hash);
+            if (ctrl[index] == DELETED) deleted--;
+            new (&slots[index]) Entry{std::forward<Args>(args)...};
+            ctrl[index] = h2(hash);
+            size++;
+            return &slots[index];
+        }
+
+        void eraseSlot(size_t index) {
+            // A group that already has an empty slot ends every probe that
+            // reaches it, so the slot can go back to empty instead of
+            // becoming a tombstone
+            const int8_t* group = ctrl + (index & ~(GROUP_SIZE - 1));
+            if (match(group, EMPTY)) {
+                ctrl[index] = EMPTY;
+            } else {
+                ctrl[index] = DELETED;
+                deleted++;
+            }
+            slots[index].~Entry();
+            size--;
+        }
+    };
+
+    Table main;
+    Table next;              // the table being grown into, while rehashing
+    size_t rehash_group = 0; // next group of `main` to migrate
+
+    // Room for the live entries, plus everything inserted while the old
+    // table drains, at no more than half load
+    static size_t capacityFor(size_t entries) {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity < entries * 2) capacity <<= 1;
+        return capacity;
+    }
+
+    void startRehash(size_t capacity) {
+        next = Table(capacity);
+        rehash_group = 0;
+    }
+
+    void finishRehash() {
+        main = std::move(next);
+        next = Table();
+    }
+
+    // Moves the entries whose home group is one of the next `groups`
+    // groups of the old table into the new one. Going by home group, not
+    // by position, lets lookups skip the old table for every home group
+    // already done; the slots left behind become tombstones, so probe
+    // sequences through them still reach the entries not moved yet.
+    void migrate(size_t groups) {
+        size_t group_count = main.groupCount();
+        size_t mask = main.groupMask();
+        for (size_t done = 0; done < groups && rehash_group < group_count; ++done, ++rehash_group) {
+            size_t group = rehash_group;
+            for (size_t step = 1; step <= mask + 1; ++step) {
+                size_t begin = group * GROUP_SIZE;
+                for (size_t i = begin; i < begin + GROUP_SIZE; ++i) {
+                    if (main.ctrl[i] < 0) continue;
+                    Entry& entry = main.slots[i];
+                    if ((h1(entry.hash) & mask) != rehash_group) continue;
+                    next.emplace(entry.hash, std::move(entry.key), entry.hash, std::move(entry.value));
+                    main.ctrl[i] = DELETED;
+                    main.deleted++;
+                    entry.~Entry();
+                    main.size--;
+                }
+                if (match(main.ctrl + begin, EMPTY)) break;
+                group = (group + step) & mask;
+            }
+        }
+        if (rehash_group == group_count) finishRehash();
+    }
+
+    // Called before an insert: ensures the table receiving it has room
+    Table& prepareInsert() {
+        if (isRehashing()) {
+            migrate(REHASH_GROUPS_PER_WRITE);
+        }
+        if (isRehashing()) {
+            if (!next.full()) return next;
+            migrate(main.groupCount());
+        }
+        if (main.capacity == 0) {
+            main = Table(MIN_CAPACITY);
+        } else if (main.full()) {
+            // Sized by live entries, so a table full of tombstones is
+            // cleaned rather than doubled
+            startRehash(capacityFor(main.size + main.groupCount() / REHASH_GROUPS_PER_WRITE + 1));
+            migrate(REHASH_GROUPS_PER_WRITE);
+            return isRehashing() ? next : main;
+        }
+        return main;
+    }
+
+    // Calls `fn` for the entries whose home group is `home`. They sit in
+    // it or further along its probe sequence, which ends at the first
+    // group with an empty slot: erasing never empties a slot of a group
+    // that has none.
+    template <typename Fn>
+    static void scanHomeGroup(const Table& table, size_t home, Fn& fn) {
+        size_t mask = table.groupMask();
+        size_t group = home;
+        for (size_t step = 1; step <= mask + 1; ++step) {
+            const int8_t* ctrl_group = table.ctrl + group * GROUP_SIZE;
+            for (size_t i = 0; i < GROUP_SIZE; ++i) {
+                if (ctrl_group[i] < 0) continue;
+                const Entry& entry = table.slots[group * GROUP_SIZE + i];
+                if ((h1(entry.hash) & mask) == home) fn(entry);
+            }
+            if (match(ctrl_group, EMPTY)) return;
+            group = (group + step) & mask;
+        }
+    }
+
+    // Adds one to the bits of `cursor` under `mask` in reverse order
+    static uint64_t nextCursor(uint64_t cursor, uint64_t mask) {
+        cursor |= ~mask;
+        cursor = reverseBits(cursor);
+        cursor++;
+        return reverseBits(cursor);
+    }
+
+    static uint64_t reverseBits(uint64_t v) {
+        v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+        v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+        v = ((v >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((v & 0x0f0f0f0f0f0f0f0fULL) << 4);
+        return __builtin_bswap64(v);
+    }
+
+    void maybeShrink() {
+        if (!isRehashing() && main.capacity > MIN_CAPACITY && main.size * 8 < main.capacity) {
+            startRehash(capacityFor(main.size + main.groupCount() / REHASH_GROUPS_PER_WRITE + 1));
+        }
+    }
+
+public:
+    KeyTable() = default;
+    // A copy is built fresh, sized for the entries and not rehashing
+    KeyTable(const KeyTable& other) {
+        if (other.empty()) return;
+        main = Table(capacityFor(other.size()));
+        other.forEach([this](const Entry& entry) {
+            main.emplace(entry.hash, EmbeddedString(entry.key.view()), entry.hash, V(entry.value));
+        });
+    }
+    KeyTable& operator=(const KeyTable& other) {
+        if (this != &other) KeyTable(other).swap(*this);
+        return *this;
+    }
+    // Moves leave the source empty
+    KeyTable(KeyTable&& other) noexcept { swap(other); }
+    KeyTable& operator=(KeyTable&& other) noexcept {
+        KeyTable(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    void swap(KeyTable& other) noexcept {
+        main.swap(other.main);
+        next.swap(other.next);
+        std::swap(rehash_group, other.rehash_group);
+    }
+
+    size_t size() const { return main.size + next.size; }
+    bool empty() const { return size() == 0; }
+    // Slots allocated across both tables
+    size_t capacity() const { return main.capacity + next.capacity; }
+    bool isRehashing() const { return next.capacity > 0; }
+
+    Entry* find(const HashedKey& key) const {
+        if (isRehashing()) {
+            if (Entry* entry = next.find(key.view(), key.hash())) return entry;
+            // Home groups before rehash_group have moved out entirely
+            if ((h1(key.hash()) & main.groupMask()) < rehash_group) return nullptr;
+        }
+        return main.find(key.view(), key.hash());
+    }
+
+    // Finds `key` or inserts it with a value built from `args`; one probe
+    // either way. The bool is true when the entry was inserted.
+    template <typename... Args>
+    std::pair<Entry*, bool> tryEmplace(const HashedKey& key, Args&&... args) {
+        if (Entry* entry = find(key)) return {entry, false};
+        Table& target = prepareInsert();
+        return {target.emplace(key.hash(), EmbeddedString(key.view()), key.hash(), V(std::forward<Args>(args)...)), true};
+    }
+
+    bool contains(const HashedKey& key) const { return find(key) != nullptr; }
+
+    void erase(Entry* entry) {
+        Table& table = main.contains(entry) ? main : next;
+        table.eraseSlot(entry - table.slots);
+        if (isRehashing()) {
+            migrate(REHASH_GROUPS_PER_WRITE);
+        } else {
+            maybeShrink();
+        }
+    }
+
+    // Returns false when the key was absent
+    bool erase(const HashedKey& key) {
+        Entry* entry = find(key);
+        if (!entry) return false;
+        erase(entry);
+        return true;
+    }
+
+    // Erases every entry `pred` returns true for; returns how many
+    template <typename Pred>
+    size_t eraseIf(Pred&& pred) {
+        size_t erased = 0;
+        for (Table* table : {&main, &next}) {
+            for (size_t i = 0; i < table->capacity; ++i) {
+                if (table->ctrl[i] >= 0 && pred(static_cast<const Entry&>(table->slots[i]))) {
+                    table->eraseSlot(i);
+                    erased++;
+                }
+            }
+        }
+        maybeShrink();
+        return erased;
+    }
+
+    struct StepResult {
+        size_t visited = 0;
+        size_t erased = 0;
+    };
+
+    // A bounded slice of eraseIf, for work spread over time: tests up to
+    // `limit` entries in slot order from `cursor`, looking at no more than
+    // `limit` * 8 slots, and advances the cursor. The cursor goes back to
+    // 0 after the last slot; one that a resize left out of range restarts
+    // there too.
+    template <typename Pred>
+    StepResult eraseIfStep(size_t& cursor, size_t limit, Pred&& pred) {
+        StepResult result;
+        size_t total = main.capacity + next.capacity;
+        if (cursor >= total) cursor = 0;
+        size_t slots_left = limit * 8;
+        while (cursor < total && result.visited < limit && slots_left > 0) {
+            Table& table = cursor < main.capacity ? main : next;
+            size_t i = cursor < main.capacity ? cursor : cursor - main.capacity;
+            if (table.ctrl[i] >= 0) {
+                result.visited++;
+                if (pred(static_cast<const Entry&>(table.slots[i]))) {
+                    table.eraseSlot(i);
+                    result.erased++;
+                }
+            }
+            cursor++;
+            slots_left--;
+        }
+        if (cursor >= total) cursor = 0;
+        if (result.erased > 0) maybeShrink();
+        return result;
+    }
+
+    // Up to `count` entries from consecutive slots, starting at slot
+    // `start` modulo the capacity and wrapping round, for sampled
+    // eviction. Looks at no more than `count` * 16 slots, so a sparse
+    // table may give fewer; returns how many went to `fn`.
+    template <typename Fn>
+    size_t sample(size_t start, size_t count, Fn&& fn) const {
+        size_t total = main.capacity + next.capacity;
+        if (total == 0) return 0;
+        size_t cursor = start % total;
+        size_t slots_left = std::min(total, count * 16);
+        size_t found = 0;
+        for (; found < count && slots_left > 0; --slots_left) {
+            const Table& table = cursor < main.capacity ? main : next;
+            size_t i = cursor < main.capacity ? cursor : cursor - main.capacity;
+            if (table.ctrl[i] >= 0) {
+                fn(static_cast<const Entry&>(table.slots[i]));
+                found++;
+            }
+            if (++cursor == total) cursor = 0;
+        }
+        return found;
+    }
+
+    // One step of a cursor scan, after Redis's dictScan: calls `fn` for
+    // the entries whose home group is the one `cursor` names, in both
+    // tables while rehashing, and returns the cursor for the next step; 0
+    // when the scan is complete. Cursors count up from 0 in bit-reversed
+    // order, so the groups still to visit keep covering the same hashes
+    // when the table doubles or halves between steps: an entry present
+    // for the whole scan is visited at least once, and entries may be
+    // visited twice.
+    template <typename Fn>
+    uint64_t scan(uint64_t cursor, Fn&& fn) const {
+        if (!isRehashing()) {
+            if (main.capacity == 0) return 0;
+            scanHomeGroup(main, cursor & main.groupMask(), fn);
+            return nextCursor(cursor, main.groupMask());
+        }
+        const Table* small = &main;
+        const Table* large = &next;
+        if (small->capacity > large->capacity) std::swap(small, large);
+        uint64_t small_mask = small->groupMask();
+        uint64_t large_mask = large->groupMask();
+        scanHomeGroup(*small, cursor & small_mask, fn);
+        // Then the groups of the larger table that split this one
+        do {
+            scanHomeGroup(*large, cursor & large_mask, fn);
+            cursor = nextCursor(cursor, large_mask);
+        } while (cursor & (small_mask ^ large_mask));
+        return cursor;
+    }
+
+    // Visits every entry; the order is stable while the table is not written
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Table* table : {&main, &next}) {
+            for (size_t i = 0; i < table->capacity; ++i) {
+                if (table->ctrl[i] >= 0) fn(static_cast<const Entry&>(table->slots[i]));
+            }
+        }
+    }
+
+    // Background migration of up to `groups` groups; returns true while
+    // a rehash is still in progress
+    bool rehashStep(size_t groups) {
+        if (isRehashing()) migrate(groups);
+        return isRehashing();
+    }
+
+    void clear() {
+        main = Table();
+        next = Table();
+        rehash_group = 0;
+    }
+};
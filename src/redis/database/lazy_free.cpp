@@ -0,0 +1,55 @@
+#include "lazy_free.h"
+
+LazyFree& LazyFree::instance() {
+    static LazyFree lazy_free;
+    return lazy_free;
+}
+
+LazyFree::~LazyFree() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_one();
+    if (worker.joinable()) worker.join();
+}
+
+size_t LazyFree::pending() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size() + in_progress;
+}
+
+void LazyFree::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return queue.empty() && in_progress == 0; });
+}
+
+void LazyFree::enqueue(std::unique_ptr<Garbage> garbage) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(garbage));
+        if (!worker.joinable()) {
+            worker = std::thread([this] { run(); });
+        }
+    }
+    work_ready.notify_one();
+}
+
+void LazyFree::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_ready.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) return;   // stopping, and nothing left
+
+        std::unique_ptr<Garbage> garbage = std::move(queue.front());
+        queue.pop_front();
+        in_progress++;
+        // The destructors run without the lock, so callers never wait on them
+        lock.unlock();
+        garbage.reset();
+        freed_count.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+        in_progress--;
+        if (queue.empty() && in_progress == 0) idle.notify_all();
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Background destruction, after Redis's lazyfree. Deleting a hash with
+// millions of fields or a whole keyspace runs millions of destructors;
+// instead the object is moved into a queue, which is O(1), and one
+// background thread for the process destroys it while the caller goes on
+// serving clients. The thread starts on first use and drains the queue
+// before the process exits.
+class LazyFree {
+public:
+    // Below this many frees (Redis's LAZYFREE_THRESHOLD), destroying in
+    // place is cheaper than the handoff
+    static constexpr size_t THRESHOLD = 64;
+
+    static LazyFree& instance();
+
+    // Takes `object` over and destroys it on the background thread
+    template <typename T>
+    void free(T&& object) {
+        using Object = std::decay_t<T>;
+        static_assert(!std::is_lvalue_reference_v<T>, "pass the object with std::move");
+        enqueue(std::make_unique<Holder<Object>>(std::move(object)));
+    }
+
+    // Objects queued or being destroyed
+    size_t pending() const;
+    // Objects the background thread has destroyed so far
+    size_t freed() const { return freed_count.load(std::memory_order_relaxed); }
+    // Blocks until everything queued so far is destroyed
+    void waitIdle();
+
+private:
+    struct Garbage {
+        virtual ~Garbage() = default;
+    };
+
+    template <typename T>
+    struct Holder : Garbage {
+        T object;
+        explicit Holder(T&& source) : object(std::move(source)) {}
+    };
+
+    mutable std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable idle;
+    std::deque<std::unique_ptr<Garbage>> queue;
+    size_t in_progress = 0;
+    bool stopping = false;
+    std::thread worker;
+    std::atomic<size_t> freed_count{0};
+
+    LazyFree() = default;
+    ~LazyFree();
+    LazyFree(const LazyFree&) = delete;
+    LazyFree& operator=(const LazyFree&) = delete;
+
+    void enqueue(std::unique_ptr<Garbage> garbage);
+    void run();
+};
@@ -1,64 +1,618 @@
 #include "redis_database.h"
 
-bool RedisDatabase::keyExists(const std::string& key) {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    auto it = database.find(key);
-    if (it != database.end() && !it->second.isExpired()) {
-        return true;
+RedisDatabase::RedisDatabase(size_t shard_count) {
+    size_t count = 1;
+    while (count < shard_count && count < MAX_SHARD_COUNT) {
+        count <<= 1;
     }
-    if (it != database.end() && it->second.isExpired()) {
-        database.erase(it);
+    shards.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        shards.push_back(std::make_unique<Shard>());
     }
-    return false;
+    shard_mask = count - 1;
+    eviction_random.seed(std::random_device{}());
+}
+
+RedisDatabase::Map::Entry* RedisDatabase::upsert(Shard& shard, const HashedKey& key, RedisValue&& value) {
+    // tryEmplace leaves `value` alone when the key is already there
+    auto result = shard.map.tryEmplace(key, std::move(value));
+    Map::Entry* entry = result.first;
+    if (result.second) {
+        account(shard, entryMemory(*entry));
+    } else {
+        int64_t before = entryMemory(*entry);
+        clearExpiry(shard, *entry);
+        freeLazily(entry->value);
+        entry->value = std::move(value);
+        account(shard, entryMemory(*entry) - before);
+    }
+    entry->value.setExpiryFlag(false);
+    entry->value.setAccessClock(initialAccessClock());
+    return entry;
+}
+
+void RedisDatabase::removeIfExpired(Shard& shard, const HashedKey& key) {
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto* entry = shard.map.find(key);
+    if (entry && isExpired(shard, *entry, ServerClock::nowMs())) {
+        eraseEntry(shard, entry);
+    }
+}
+
+int64_t RedisDatabase::expiryOf(const Shard& shard, const Map::Entry& entry) {
+    // The entry already carries the key's hash
+    auto* expiry = shard.expires.find(HashedKey(entry.key.view(), entry.hash));
+    return expiry ? expiry->value : 0;
+}
+
+bool RedisDatabase::isExpired(const Shard& shard, const Map::Entry& entry, int64_t now) {
+    return entry.value.hasExpiry() && expiryOf(shard, entry) <= now;
+}
+
+void RedisDatabase::setExpiry(Shard& shard, Map::Entry& entry, int64_t when) {
+    auto result = shard.expires.tryEmplace(HashedKey(entry.key.view(), entry.hash), when);
+    if (result.second) {
+        account(shard, expiryMemory(*result.first));
+    } else {
+        result.first->value = when;
+    }
+    entry.value.setExpiryFlag(true);
+}
+
+bool RedisDatabase::clearExpiry(Shard& shard, Map::Entry& entry) {
+    if (!entry.value.hasExpiry()) return false;
+    auto* expiry = shard.expires.find(HashedKey(entry.key.view(), entry.hash));
+    if (expiry) {
+        account(shard, -expiryMemory(*expiry));
+        shard.expires.erase(expiry);
+    }
+    entry.value.setExpiryFlag(false);
+    return true;
+}
+
+void RedisDatabase::eraseEntry(Shard& shard, Map::Entry* entry) {
+    account(shard, -entryMemory(*entry));
+    clearExpiry(shard, *entry);
+    freeLazily(entry->value);
+    shard.map.erase(entry);
 }
-RedisValue* RedisDatabase::getValue(const std::string& key) {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    auto it = database.find(key);
-    if (it != database.end()) {
-        if (it->second.isExpired()) {
-            database.erase(it);
-            return nullptr;
+
+void RedisDatabase::freeLazily(RedisValue& value) {
+    if (value.freeEffort() > LazyFree::THRESHOLD) {
+        LazyFree::instance().free(std::move(value));
+    }
+}
+
+bool RedisDatabase::dropIfDue(Shard& shard, const KeyTable<int64_t>::Entry& expiry, int64_t now) {
+    if (expiry.value > now) return false;
+    auto* entry = shard.map.find(HashedKey(expiry.key.view(), expiry.hash));
+    if (entry) {
+        account(shard, -entryMemory(*entry));
+        freeLazily(entry->value);
+        shard.map.erase(entry);
+    }
+    account(shard, -expiryMemory(expiry));
+    return true;
+}
+
+int64_t RedisDatabase::entryMemory(const Map::Entry& entry) {
+    return static_cast<int64_t>(sizeof(Map::Entry) + entry.key.allocatedSize() + entry.value.memoryUsage());
+}
+
+int64_t RedisDatabase::expiryMemory(const KeyTable<int64_t>::Entry& expiry) {
+    return static_cast<int64_t>(sizeof(KeyTable<int64_t>::Entry) + expiry.key.allocatedSize());
+}
+
+void RedisDatabase::touch(RedisValue& value) const {
+    uint32_t clock = value.accessClock();
+    uint32_t next = AccessClock::touched(clock, eviction_policy.load(std::memory_order_relaxed));
+    // Most hits of a busy key land in the same second; skip the store
+    if (next != clock) value.setAccessClock(next);
+}
+
+uint32_t RedisDatabase::initialAccessClock() const {
+    return AccessClock::initial(eviction_policy.load(std::memory_order_relaxed));
+}
+
+RedisDatabase::ValueRef RedisDatabase::readValue(std::string_view key) {
+    HashedKey lookup(key);
+    Shard& shard = shardFor(lookup);
+    shard.mutex.lock_shared();
+    ValueRef ref(*this, shard, false, key);
+    auto* entry = shard.map.find(lookup);
+    if (entry && !isExpired(shard, *entry, ServerClock::nowMs())) {
+        touch(entry->value);
+        ref.attach(entry);
+    }
+    return ref;
+}
+
+RedisDatabase::ValueRef RedisDatabase::writeValue(std::string_view key) {
+    HashedKey lookup(key);
+    Shard& shard = shardFor(lookup);
+    shard.mutex.lock();
+    ValueRef ref(*this, shard, true, key);
+    auto* entry = shard.map.find(lookup);
+    if (entry) {
+        if (isExpired(shard, *entry, ServerClock::nowMs())) {
+            eraseEntry(shard, entry);
+        } else {
+            touch(entry->value);
+            ref.attach(entry);
         }
-        return &it->second;
     }
+    return ref;
+}
+
+RedisDatabase::ValueRef RedisDatabase::getOrCreate(std::string_view key, RedisType type) {
+    HashedKey lookup(key);
+    Shard& shard = shardFor(lookup);
+    shard.mutex.lock();
+    ValueRef ref(*this, shard, true, key);
+    auto result = shard.map.tryEmplace(lookup, type);
+    Map::Entry* entry = result.first;
+    ref.created = result.second;
+    if (ref.created) {
+        account(shard, entryMemory(*entry));
+        entry->value.setAccessClock(initialAccessClock());
+    } else if (isExpired(shard, *entry, ServerClock::nowMs())) {
+        int64_t before = entryMemory(*entry);
+        clearExpiry(shard, *entry);
+        freeLazily(entry->value);
+        entry->value = RedisValue(type);
+        account(shard, entryMemory(*entry) - before);
+        entry->value.setAccessClock(initialAccessClock());
+        ref.created = true;
+    } else {
+        touch(entry->value);
+    }
+    ref.attach(entry);
+    return ref;
+}
+
+bool RedisDatabase::keyExists(std::string_view key) {
+    return static_cast<bool>(readValue(key));
+}
+
+RedisValue* RedisDatabase::getValue(std::string_view key) {
+    HashedKey lookup(key);
+    Shard& shard = shardFor(lookup);
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto* entry = shard.map.find(lookup);
+        if (!entry) return nullptr;
+        if (!isExpired(shard, *entry, ServerClock::nowMs())) return &entry->value;
+    }
+    // Expired: deleting needs the exclusive lock
+    removeIfExpired(shard, lookup);
     return nullptr;
 }
 
-void RedisDatabase::setValue(const std::string& key, RedisValue value) {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    database[key] = std::move(value);
+void RedisDatabase::setValue(std::string_view key, RedisValue value) {
+    HashedKey lookup(key);
+    Shard& shard = shardFor(lookup);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    upsert(shard, lookup, std::move(value));
+}
+
+bool RedisDatabase::deleteKey(std::string_view key) {
+    HashedKey lookup(key);
+    Shard& shard = shardFor(lookup);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto* entry = shard.map.find(lookup);
+    if (!entry) return false;
+    eraseEntry(shard, entry);
+    return true;
 }
 
-bool RedisDatabase::deleteKey(const std::string& key) {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    return database.erase(key) > 0;
+bool RedisDatabase::setExpiry(std::string_view key, std::chrono::milliseconds ttl) {
+    auto ref = writeValue(key);
+    if (!ref) return false;
+    ref.setExpiry(ServerClock::nowMs() + ttl.count());
+    return true;
+}
+
+std::optional<int64_t> RedisDatabase::getExpiry(std::string_view key) {
+    auto ref = readValue(key);
+    if (!ref || !ref.hasExpiry()) return std::nullopt;
+    return ref.getExpiry();
 }
 
 void RedisDatabase::clearDatabase() {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    database.clear();
+    // Every shard at once, in order, so no reader sees a half-cleared keyspace
+    std::vector<std::unique_lock<std::shared_mutex>> locks;
+    locks.reserve(shards.size());
+    for (auto& shard : shards) {
+        locks.emplace_back(shard->mutex);
+    }
+    for (auto& shard : shards) {
+        shard->map.clear();
+        shard->expires.clear();
+        shard->used_memory.store(0, std::memory_order_relaxed);
+    }
+}
+
+void RedisDatabase::clearDatabaseAsync() {
+    std::vector<std::unique_lock<std::shared_mutex>> locks;
+    locks.reserve(shards.size());
+    for (auto& shard : shards) {
+        locks.emplace_back(shard->mutex);
+    }
+    for (auto& shard : shards) {
+        if (shard->map.size() > 0) LazyFree::instance().free(std::move(shard->map));
+        if (shard->expires.size() > 0) LazyFree::instance().free(std::move(shard->expires));
+        shard->used_memory.store(0, std::memory_order_relaxed);
+    }
 }
 
 size_t RedisDatabase::getDatabaseSize() const {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    return database.size();
+    size_t size = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        size += shard->map.size();
+    }
+    return size;
 }
 
 void RedisDatabase::cleanupExpiredKeys() {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    auto it = database.begin();
-    while (it != database.end()) {
-        if (it->second.isExpired()) {
-            it = database.erase(it);
+    int64_t now = ServerClock::nowMs();
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard->mutex);
+        // Only the keys that have an expiry need looking at
+        Shard& locked = *shard;
+        shard->expires.eraseIf([&locked, now](const KeyTable<int64_t>::Entry& expiry) {
+            return dropIfDue(locked, expiry, now);
+        });
+    }
+}
+
+size_t RedisDatabase::activeExpireCycle(std::chrono::microseconds budget) {
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    size_t expired = 0;
+    size_t start = expire_shard.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < shards.size(); i++) {
+        size_t index = (start + i) & shard_mask;
+        Shard& shard = *shards[index];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || shard.expires.empty()) continue;
+
+        int64_t now = ServerClock::nowMs();
+        KeyTable<int64_t>::StepResult step;
+        do {
+            step = shard.expires.eraseIfStep(shard.expire_cursor, KEYS_PER_LOOP,
+                [&shard, now](const KeyTable<int64_t>::Entry& expiry) {
+                    return dropIfDue(shard, expiry, now);
+                });
+            expired += step.erased;
+            if (std::chrono::steady_clock::now() >= deadline) {
+                expire_shard.store(index, std::memory_order_relaxed);
+                return expired;
+            }
+        } while (step.visited > 0 && step.erased * 100 > step.visited * ACCEPTABLE_STALE_PERCENT);
+    }
+    expire_shard.store((start + 1) & shard_mask, std::memory_order_relaxed);
+    return expired;
+}
+
+bool RedisDatabase::incrementalRehash(std::chrono::microseconds budget) {
+    // Groups per step: small enough that the clock is checked often
+    static const size_t GROUPS_PER_STEP = 64;
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    bool pending = false;
+    size_t start = rehash_cursor.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < shards.size(); i++) {
+        size_t index = (start + i) & shard_mask;
+        Shard& shard = *shards[index];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            pending = true;
+            continue;
+        }
+        while (shard.map.rehashStep(GROUPS_PER_STEP) | shard.expires.rehashStep(GROUPS_PER_STEP)) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                rehash_cursor.store(index, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return pending;
+}
+
+void RedisDatabase::setMaxMemory(size_t bytes, EvictionPolicy policy) {
+    std::lock_guard<std::mutex> lock(eviction_mutex);
+    max_memory.store(bytes, std::memory_order_relaxed);
+    eviction_policy.store(policy, std::memory_order_relaxed);
+    // Scores from another policy do not compare with the new ones
+    eviction_pool.clear();
+}
+
+size_t RedisDatabase::usedMemory() const {
+    int64_t total = 0;
+    for (const auto& shard : shards) {
+        total += shard->used_memory.load(std::memory_order_relaxed);
+    }
+    return total > 0 ? static_cast<size_t>(total) : 0;
+}
+
+bool RedisDatabase::performEvictions() {
+    size_t limit = max_memory.load(std::memory_order_relaxed);
+    if (limit == 0 || usedMemory() <= limit) return true;
+    EvictionPolicy policy = eviction_policy.load(std::memory_order_relaxed);
+    if (policy == EvictionPolicy::NOEVICTION) return false;
+
+    std::lock_guard<std::mutex> lock(eviction_mutex);
+    while (usedMemory() > limit) {
+        if (!evictOne(policy)) return false;
+        evicted_keys.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool RedisDatabase::evictOne(EvictionPolicy policy) {
+    if (policy == EvictionPolicy::ALLKEYS_RANDOM) return evictRandom();
+
+    bool volatile_only = policy == EvictionPolicy::VOLATILE_LRU || policy == EvictionPolicy::VOLATILE_TTL;
+    // Each round samples the next shard and takes the best candidate in
+    // the pool; candidates deleted or persisted since they were sampled
+    // are dropped. Two passes over the shards bound the rounds when other
+    // threads keep deleting what was sampled.
+    size_t empty_rounds = 0;
+    for (size_t round = 0; round < 2 * shards.size() && empty_rounds < shards.size(); round++) {
+        size_t index = eviction_shard++ & shard_mask;
+        if (populatePool(index, policy, volatile_only) == 0) {
+            empty_rounds++;
+            continue;
+        }
+        empty_rounds = 0;
+        while (auto candidate = eviction_pool.popBest()) {
+            if (evictCandidate(*candidate, volatile_only)) return true;
+        }
+    }
+    while (auto candidate = eviction_pool.popBest()) {
+        if (evictCandidate(*candidate, volatile_only)) return true;
+    }
+    return false;
+}
+
+size_t RedisDatabase::populatePool(size_t index, EvictionPolicy policy, bool volatile_only) {
+    Shard& shard = *shards[index];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    // A window can miss in a sparse table, so only an empty one gives 0
+    size_t sampled = 0;
+    if (!volatile_only) {
+        while (sampled == 0 && !shard.map.empty()) {
+            sampled = shard.map.sample(eviction_random(), EVICTION_SAMPLES, [&](const Map::Entry& entry) {
+                eviction_pool.offer(AccessClock::evictionScore(entry.value.accessClock(), policy),
+                                    index, entry.key.view());
+            });
+        }
+        return sampled;
+    }
+    auto offer = [&](const KeyTable<int64_t>::Entry& expiry) {
+        uint64_t score;
+        if (policy == EvictionPolicy::VOLATILE_TTL) {
+            // The sooner it expires, the higher it scores
+            score = UINT64_MAX - static_cast<uint64_t>(expiry.value);
+        } else {
+            auto* entry = shard.map.find(HashedKey(expiry.key.view(), expiry.hash));
+            if (!entry) return;
+            score = AccessClock::evictionScore(entry->value.accessClock(), policy);
+        }
+        eviction_pool.offer(score, index, expiry.key.view());
+    };
+    while (sampled == 0 && !shard.expires.empty()) {
+        sampled = shard.expires.sample(eviction_random(), EVICTION_SAMPLES, offer);
+    }
+    return sampled;
+}
+
+bool RedisDatabase::evictCandidate(const EvictionPool::Candidate& candidate, bool volatile_only) {
+    Shard& shard = *shards[candidate.shard];
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto* entry = shard.map.find(HashedKey(candidate.key));
+    if (!entry || (volatile_only && !entry->value.hasExpiry())) return false;
+    eraseEntry(shard, entry);
+    return true;
+}
+
+bool RedisDatabase::evictRandom() {
+    size_t start = eviction_random();
+    for (size_t i = 0; i < shards.size(); i++) {
+        Shard& shard = *shards[(start + i) & shard_mask];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        Map::Entry* victim = nullptr;
+        // A window can miss in a sparse table; a non-empty one is hit soon
+        while (!victim && !shard.map.empty()) {
+            shard.map.sample(eviction_random(), 1, [&](const Map::Entry& entry) {
+                victim = shard.map.find(HashedKey(entry.key.view(), entry.hash));
+            });
+        }
+        if (victim) {
+            eraseEntry(shard, victim);
+            return true;
+        }
+    }
+    return false;
+}
+
+RedisDatabase::MultiKeyLock RedisDatabase::lockKeys(const CommandArgs& args, size_t first, size_t step, bool exclusive) {
+    std::vector<size_t> indices;
+    for (size_t i = first; i < args.size(); i += step) {
+        indices.push_back(shardIndex(StringHash::hash(args[i])));
+    }
+    // The global order that makes concurrent multi-key commands deadlock-free
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    return MultiKeyLock(*this, std::move(indices), exclusive);
+}
+
+RedisDatabase::ValueRef::ValueRef(RedisDatabase& database, Shard& locked_shard, bool exclusive_lock,
+                                  std::string_view key_name)
+    : db(&database), shard(&locked_shard), exclusive(exclusive_lock), key(key_name) {
+}
+
+RedisDatabase::ValueRef::ValueRef(ValueRef&& other) noexcept
+    : db(other.db), shard(other.shard), exclusive(other.exclusive), created(other.created),
+      key(other.key), entry(other.entry), value(other.value), accounted(other.accounted) {
+    other.shard = nullptr;
+    other.value = nullptr;
+}
+
+RedisDatabase::ValueRef::~ValueRef() {
+    if (!shard) return;
+    settle();
+    if (exclusive) {
+        shard->mutex.unlock();
+    } else {
+        shard->mutex.unlock_shared();
+    }
+}
+
+void RedisDatabase::ValueRef::attach(Map::Entry* found) {
+    entry = found;
+    value = &found->value;
+    if (exclusive) accounted = entryMemory(*found);
+}
+
+void RedisDatabase::ValueRef::settle() {
+    if (!exclusive || !value) return;
+    int64_t now_accounted = entryMemory(*entry);
+    account(*shard, now_accounted - accounted);
+    accounted = now_accounted;
+}
+
+RedisValue& RedisDatabase::ValueRef::create(RedisValue new_value) {
+    if (value) {
+        RedisDatabase::clearExpiry(*shard, *entry);
+        freeLazily(*value);
+        *value = std::move(new_value);
+        value->setExpiryFlag(false);
+        value->setAccessClock(db->initialAccessClock());
+    } else {
+        attach(db->upsert(*shard, HashedKey(key), std::move(new_value)));
+    }
+    return *value;
+}
+
+void RedisDatabase::ValueRef::erase() {
+    // The entry from the lookup, so no second hash of the key
+    if (value) {
+        settle();
+        eraseEntry(*shard, entry);
+        value = nullptr;
+    }
+}
+
+int64_t RedisDatabase::ValueRef::getExpiry() const {
+    return expiryOf(*shard, *entry);
+}
+
+void RedisDatabase::ValueRef::setExpiry(int64_t when) {
+    RedisDatabase::setExpiry(*shard, *entry, when);
+}
+
+bool RedisDatabase::ValueRef::clearExpiry() {
+    return RedisDatabase::clearExpiry(*shard, *entry);
+}
+
+RedisDatabase::MultiKeyLock::MultiKeyLock(RedisDatabase& database, std::vector<size_t> indices, bool exclusive_lock)
+    : db(database), exclusive(exclusive_lock), locked(std::move(indices)) {
+    for (size_t index : locked) {
+        if (exclusive) {
+            db.shards[index]->mutex.lock();
+        } else {
+            db.shards[index]->mutex.lock_shared();
+        }
+    }
+}
+
+RedisDatabase::MultiKeyLock::MultiKeyLock(MultiKeyLock&& other) noexcept
+    : db(other.db), exclusive(other.exclusive), locked(std::move(other.locked)) {
+    other.locked.clear();
+}
+
+RedisDatabase::MultiKeyLock::~MultiKeyLock() {
+    for (auto it = locked.rbegin(); it != locked.rend(); ++it) {
+        if (exclusive) {
+            db.shards[*it]->mutex.unlock();
         } else {
-            ++it;
+            db.shards[*it]->mutex.unlock_shared();
         }
     }
 }
 
+RedisValue* RedisDatabase::MultiKeyLock::get(std::string_view key) {
+    HashedKey lookup(key);
+    Shard& shard = db.shardFor(lookup);
+    auto* entry = shard.map.find(lookup);
+    if (!entry) return nullptr;
+    if (isExpired(shard, *entry, ServerClock::nowMs())) {
+        if (exclusive) eraseEntry(shard, entry);
+        return nullptr;
+    }
+    db.touch(entry->value);
+    return &entry->value;
+}
+
+void RedisDatabase::MultiKeyLock::set(std::string_view key, RedisValue value) {
+    HashedKey lookup(key);
+    db.upsert(db.shardFor(lookup), lookup, std::move(value));
+}
+
+bool RedisDatabase::MultiKeyLock::erase(std::string_view key) {
+    HashedKey lookup(key);
+    Shard& shard = db.shardFor(lookup);
+    auto* entry = shard.map.find(lookup);
+    if (!entry) return false;
+    eraseEntry(shard, entry);
+    return true;
+}
+
+uint64_t RedisDatabase::scan(uint64_t cursor, size_t count,
+                             const std::function<void(std::string_view, const RedisValue&)>& fn) const {
+    const size_t shard_bits = __builtin_ctzll(shards.size());
+    size_t index = cursor & shard_mask;
+    uint64_t table_cursor = cursor >> shard_bits;
+    size_t visited = 0;
+    size_t steps_left = count * 10;   // bounds the work when groups are sparse
+    int64_t now = ServerClock::nowMs();
+    while (true) {
+        const Shard& shard = *shards[index];
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            while (visited < count && steps_left > 0) {
+                steps_left--;
+                table_cursor = shard.map.scan(table_cursor, [&](const Map::Entry& entry) {
+                    visited++;
+                    if (!isExpired(shard, entry, now)) fn(entry.key.view(), entry.value);
+                });
+                if (table_cursor == 0) break;
+            }
+        }
+        if (table_cursor != 0) break;
+        if (++index == shards.size()) return 0;
+        if (visited >= count || steps_left == 0) break;
+    }
+    return (table_cursor << shard_bits) | index;
+}
+
 std::vector<std::string> RedisDatabase::getMatchingKeys(const std::string& pattern) const {
-    std::lock_guard<std::mutex> lock(db_mutex);
     std::vector<std::string> matching_keys;
+    forEachMatchingKey(pattern,
+        [&matching_keys](size_t count) { matching_keys.reserve(count); },
+        [&matching_keys](std::string_view key) { matching_keys.emplace_back(key); });
+    return matching_keys;
+}
+
+void RedisDatabase::forEachMatchingKey(const std::string& pattern,
+                                       const std::function<void(size_t)>& on_count,
+                                       const std::function<void(std::string_view)>& on_key) const {
+    // A consistent view across shards: all of them, shared, in order
+    std::vector<std::shared_lock<std::shared_mutex>> locks;
+    locks.reserve(shards.size());
+    for (const auto& shard : shards) {
+        locks.emplace_back(shard->mutex);
+    }
     
     // Convert Redis pattern to regex
     std::string regex_pattern;
@@ -77,12 +631,31 @@ std::vector<std::string> RedisDatabase::getMatchingKeys(const std::string& patte
     }
     
     std::regex pattern_regex(regex_pattern);
+    bool match_all = pattern == "*";
     
-    for (const auto& pair : database) {
-        if (!pair.second.isExpired() && std::regex_match(pair.first, pattern_regex)) {
-            matching_keys.push_back(pair.first);
-        }
+    // The count has to go out before the first key, so match once and
+    // remember the result in a bitmap; the table does not change while
+    // the lock is held, so the second pass sees the same order
+    std::vector<bool> matches;
+    size_t count = 0;
+    int64_t now = ServerClock::nowMs();
+    for (const auto& shard : shards) {
+        shard->map.forEach([&](const Map::Entry& entry) {
+            std::string_view key = entry.key.view();
+            bool match = !isExpired(*shard, entry, now) &&
+                         (match_all || std::regex_match(key.begin(), key.end(), pattern_regex));
+            matches.push_back(match);
+            if (match) count++;
+        });
     }
     
-    return matching_keys;
+    on_count(count);
+    size_t i = 0;
+    for (const auto& shard : shards) {
+        shard->map.forEach([&](const Map::Entry& entry) {
+            if (matches[i++]) {
+                on_key(entry.key.view());
+            }
+        });
+    }
 }
\ No newline at end of file
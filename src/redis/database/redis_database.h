@@ -1,25 +1,280 @@
 #pragma once
 #include "redis_value.h"
-#include <unordered_map>
+#include "key_table.h"
+#include "lazy_free.h"
+#include "eviction.h"
+#include "redis/command_args.h"
+#include "utils/string_hash.h"
+#include "utils/server_clock.h"
 #include <mutex>
+#include <shared_mutex>
+#include <memory>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <regex>
+#include <functional>
+#include <optional>
+#include <random>
+#include <vector>
 
+// The keyspace is split into a power-of-two number of shards picked by key
+// hash, each with its own map and reader/writer lock. Single-key calls lock
+// one shard (shared for reads); multi-key commands lock every shard they
+// touch through MultiKeyLock, always in ascending shard order, so two of
+// them can never deadlock.
+//
+// Expiry times are kept per shard in a separate table, as ServerClock
+// milliseconds since the Unix epoch, for the keys that have one; their values carry a flag
+// so reads of the other keys never look there.
+//
+// Each shard counts the bytes its entries take (entryMemory()), adjusted
+// wherever an entry is added, removed or written through a ValueRef, so
+// usedMemory() is a sum over the shards. Past maxmemory, writes first
+// evict keys the policy picks, by sampling; see performEvictions().
 class RedisDatabase {
+public:
+    static constexpr size_t DEFAULT_SHARD_COUNT = 64;
+    static constexpr size_t MAX_SHARD_COUNT = 4096;
+
 private:
-    std::unordered_map<std::string, RedisValue> database;
-    mutable std::mutex db_mutex;
+    using Map = KeyTable<RedisValue>;
+
+    // One cache line per lock so neighbouring shards do not contend
+    struct alignas(64) Shard {
+        Map map;
+        KeyTable<int64_t> expires;
+        size_t expire_cursor = 0;   // where active expiry resumes in `expires`
+        mutable std::shared_mutex mutex;
+        // Changed under the exclusive lock, summed without it
+        std::atomic<int64_t> used_memory{0};
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t shard_mask;
+    std::atomic<size_t> rehash_cursor{0};   // shard incrementalRehash resumes at
+    std::atomic<size_t> expire_shard{0};    // shard activeExpireCycle resumes at
+
+    std::atomic<size_t> max_memory{0};      // 0: no limit
+    std::atomic<EvictionPolicy> eviction_policy{EvictionPolicy::NOEVICTION};
+    std::atomic<size_t> evicted_keys{0};
+    // One thread evicts at a time; guards the members below it
+    std::mutex eviction_mutex;
+    EvictionPool eviction_pool;
+    size_t eviction_shard = 0;              // shard sampled next
+    std::minstd_rand eviction_random;
+
+    // The high half of the key hash picks the shard; the map buckets on
+    // the low bits
+    size_t shardIndex(uint64_t hash) const { return (hash >> 32) & shard_mask; }
+    Shard& shardFor(const HashedKey& key) { return *shards[shardIndex(key.hash())]; }
+    // Insert `value` or overwrite the current one and its expiry, in one
+    // lookup
+    Map::Entry* upsert(Shard& shard, const HashedKey& key, RedisValue&& value);
+    // Erase `key` if it has expired; takes the shard's exclusive lock
+    void removeIfExpired(Shard& shard, const HashedKey& key);
+
+    // Expiry of an entry whose value has the flag set
+    static int64_t expiryOf(const Shard& shard, const Map::Entry& entry);
+    static bool isExpired(const Shard& shard, const Map::Entry& entry, int64_t now);
+    static void setExpiry(Shard& shard, Map::Entry& entry, int64_t when);
+    static bool clearExpiry(Shard& shard, Map::Entry& entry);
+    // Removes the entry together with its expiry
+    static void eraseEntry(Shard& shard, Map::Entry* entry);
+    // A value above LazyFree::THRESHOLD goes to the background thread and
+    // `value` is left an empty string; smaller ones are left for the
+    // caller to destroy. Used wherever a value is deleted or overwritten.
+    static void freeLazily(RedisValue& value);
+    // For the expires tables' eraseIf: deletes the key of an expiry that
+    // is due and returns true, so the expiry is erased too
+    static bool dropIfDue(Shard& shard, const KeyTable<int64_t>::Entry& expiry, int64_t now);
+
+    // Bytes accounted to an entry: its slot, a key too long to embed and
+    // the value's memoryUsage(); expiries are counted separately
+    static int64_t entryMemory(const Map::Entry& entry);
+    static int64_t expiryMemory(const KeyTable<int64_t>::Entry& expiry);
+    static void account(Shard& shard, int64_t bytes) {
+        shard.used_memory.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    // Records an access in the value's access clock
+    void touch(RedisValue& value) const;
+    uint32_t initialAccessClock() const;
+
+    // One eviction under `policy`; false when nothing may be evicted
+    bool evictOne(EvictionPolicy policy);
+    bool evictRandom();
+    // Offers EVICTION_SAMPLES keys of shard `index` to the pool; returns
+    // how many it sampled
+    size_t populatePool(size_t index, EvictionPolicy policy, bool volatile_only);
+    // Deletes a pool candidate if it is still there and still eligible
+    bool evictCandidate(const EvictionPool::Candidate& candidate, bool volatile_only);
 
 public:
-    bool keyExists(const std::string& key);
-    RedisValue* getValue(const std::string& key);
-    void setValue(const std::string& key, RedisValue value);
-    bool deleteKey(const std::string& key);
+    // One key's value together with its shard's lock, held until
+    // destruction, so a command can look a key up, create, change or
+    // delete it without another thread getting in between. Empty when
+    // the key does not exist. Read refs must not modify the value, and
+    // the key must outlive the ref.
+    class ValueRef {
+    private:
+        RedisDatabase* db;
+        Shard* shard;
+        bool exclusive;
+        bool created = false;
+        std::string_view key;
+        Map::Entry* entry = nullptr;
+        RedisValue* value = nullptr;
+        int64_t accounted = 0;   // entryMemory() as last added to the shard
+
+        friend class RedisDatabase;
+        ValueRef(RedisDatabase& database, Shard& locked_shard, bool exclusive_lock, std::string_view key_name);
+        void attach(Map::Entry* found);
+        // Write refs: adds what the command changed in the value's size
+        // to the shard's used memory
+        void settle();
+
+    public:
+        ValueRef(ValueRef&& other) noexcept;
+        ValueRef(const ValueRef&) = delete;
+        ValueRef& operator=(const ValueRef&) = delete;
+        ValueRef& operator=(ValueRef&&) = delete;
+        ~ValueRef();
+
+        explicit operator bool() const { return value != nullptr; }
+        RedisValue* get() const { return value; }
+        RedisValue* operator->() const { return value; }
+        RedisValue& operator*() const { return *value; }
+        // True when getOrCreate had to insert the value
+        bool wasCreated() const { return created; }
+
+        // The ref must hold a value
+        bool hasExpiry() const { return value->hasExpiry(); }
+        // Milliseconds since the epoch; only meaningful when hasExpiry()
+        int64_t getExpiry() const;
+        // Write refs only; `when` as from ServerClock::nowMs()
+        void setExpiry(int64_t when);
+        // Write refs only; false when there was no expiry
+        bool clearExpiry();
+
+        // Write refs only: store `new_value` under the key, replacing any
+        // current value and expiry, and keep referring to it
+        RedisValue& create(RedisValue new_value);
+        // Write refs only: remove the key; the ref is empty afterwards
+        void erase();
+    };
+
+    // Locks of several shards, taken in ascending order and held until
+    // destruction. Keys passed to the accessors must be among those the
+    // lock was taken for.
+    class MultiKeyLock {
+    private:
+        RedisDatabase& db;
+        bool exclusive;
+        std::vector<size_t> locked;   // sorted shard indices
+
+        friend class RedisDatabase;
+        MultiKeyLock(RedisDatabase& database, std::vector<size_t> indices, bool exclusive_lock);
+
+    public:
+        MultiKeyLock(MultiKeyLock&& other) noexcept;
+        MultiKeyLock(const MultiKeyLock&) = delete;
+        MultiKeyLock& operator=(const MultiKeyLock&) = delete;
+        MultiKeyLock& operator=(MultiKeyLock&&) = delete;
+        ~MultiKeyLock();
+
+        // Expired values read as missing; they are only removed under an
+        // exclusive lock
+        RedisValue* get(std::string_view key);
+        bool exists(std::string_view key) { return get(key) != nullptr; }
+        // Exclusive locks only
+        void set(std::string_view key, RedisValue value);
+        bool erase(std::string_view key);
+    };
+
+    explicit RedisDatabase(size_t shard_count = DEFAULT_SHARD_COUNT);
+
+    // Shared lock: readers of other keys in the shard proceed, and an
+    // expired value reads as missing
+    ValueRef readValue(std::string_view key);
+    // Exclusive lock: an expired value is removed before returning
+    ValueRef writeValue(std::string_view key);
+    // Exclusive lock on the key's value, inserting an empty value of
+    // `type` when it is missing or expired. The caller still has to check
+    // the type of an existing value; one lookup either way.
+    ValueRef getOrCreate(std::string_view key, RedisType type);
+
+    bool keyExists(std::string_view key);
+    // The pointer is not protected once this returns; commands use
+    // readValue/writeValue instead
+    RedisValue* getValue(std::string_view key);
+    void setValue(std::string_view key, RedisValue value);
+    bool deleteKey(std::string_view key);
+    // False when the key does not exist
+    bool setExpiry(std::string_view key, std::chrono::milliseconds ttl);
+    // Milliseconds since the epoch; nothing when the key does not exist or
+    // has no expiry
+    std::optional<int64_t> getExpiry(std::string_view key);
     void clearDatabase();
+    // Swaps in empty tables and destroys the old ones on the LazyFree
+    // thread, so it returns in O(shards) however big the keyspace is
+    void clearDatabaseAsync();
     size_t getDatabaseSize() const;
+    // Removes every expired key at once; walks all the expires tables
     void cleanupExpiredKeys();
-    
+    // Active expiry, after Redis's activeExpireCycle: samples each shard's
+    // expires table KEYS_PER_LOOP keys at a time, deleting the expired
+    // ones, and samples the same shard again while more than
+    // ACCEPTABLE_STALE_PERCENT of a sample had expired. Stops when
+    // `budget` runs out and resumes there next time; skips shards a
+    // command holds. Returns how many keys it deleted.
+    size_t activeExpireCycle(std::chrono::microseconds budget);
+    static constexpr size_t KEYS_PER_LOOP = 20;
+    static constexpr size_t ACCEPTABLE_STALE_PERCENT = 10;
+    // Background share of the incremental rehashing: migrates groups of
+    // the shards that are growing until `budget` runs out, skipping shards
+    // a command holds. Returns true while some shard is still rehashing.
+    bool incrementalRehash(std::chrono::microseconds budget);
+
+    // 0 bytes for no limit. Takes effect at the next performEvictions();
+    // access clocks set under another policy read as old ones until the
+    // keys are touched again.
+    void setMaxMemory(size_t bytes, EvictionPolicy policy);
+    size_t getMaxMemory() const { return max_memory.load(std::memory_order_relaxed); }
+    EvictionPolicy getEvictionPolicy() const { return eviction_policy.load(std::memory_order_relaxed); }
+    // Bytes accounted to the keyspace: entries, keys too long to embed,
+    // values (sampled for big containers) and expiries. Table slack and
+    // allocator overhead are not counted.
+    size_t usedMemory() const;
+    size_t evictedKeys() const { return evicted_keys.load(std::memory_order_relaxed); }
+    // After Redis's performEvictions: while usedMemory() is over
+    // maxmemory, deletes the key the policy ranks first among those in the
+    // eviction pool, refilled with EVICTION_SAMPLES keys of one shard per
+    // round, so no eviction walks the keyspace. False when still over the
+    // limit: under noeviction, or with nothing left the policy may evict.
+    bool performEvictions();
+    static constexpr size_t EVICTION_SAMPLES = 5;
+
+    // Locks the shards of args[first], args[first + step], ... up to the
+    // last argument; shared locks unless `exclusive`
+    MultiKeyLock lockKeys(const CommandArgs& args, size_t first, size_t step, bool exclusive);
+    size_t getShardCount() const { return shards.size(); }
+
+    // One SCAN step: offers the keys of the shard `cursor` names to `fn`,
+    // and of the shards after it, until about `count` keys were looked at
+    // or count * 10 table steps were taken, locking one shard at a time.
+    // Expired keys are skipped. Returns the cursor for the next call, 0
+    // when every shard is done; the shard index is in the low bits, the
+    // KeyTable::scan cursor above them, so the guarantees are those of
+    // KeyTable::scan.
+    uint64_t scan(uint64_t cursor, size_t count,
+                  const std::function<void(std::string_view, const RedisValue&)>& fn) const;
+
     // Iterator support for KEYS command
     std::vector<std::string> getMatchingKeys(const std::string& pattern) const;
-    
-};
\ No newline at end of file
+    // Streams the matches without collecting them: `on_count` gets the
+    // number of matches first, then `on_key` is called for each one
+    void forEachMatchingKey(const std::string& pattern,
+                            const std::function<void(size_t)>& on_count,
+                            const std::function<void(std::string_view)>& on_key) const;
+
+};
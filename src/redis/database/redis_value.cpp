@@ -0,0 +1,260 @@
+#include "redis_value.h"
+#include <charconv>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace {
+
+// Bytes per element besides what the element itself points to: the
+// element object plus the container's node links
+constexpr size_t LIST_NODE_BYTES = sizeof(std::string) + 2 * sizeof(void*);
+constexpr size_t TREE_NODE_BYTES = sizeof(std::string) + 4 * sizeof(void*);
+constexpr size_t ZSET_NODE_BYTES = sizeof(RedisValue::ZSet::value_type) + 4 * sizeof(void*);
+
+// Heap bytes of a std::string too long for its inline buffer
+size_t stringHeap(std::string_view str) {
+    return str.size() > 15 ? str.size() + 1 : 0;
+}
+
+// The container and its nodes, plus the element heap bytes averaged over
+// the first MEMORY_SAMPLES elements and scaled to the whole container
+template <typename Container, typename ElementHeap>
+size_t sampledUsage(const Container& container, size_t node_bytes, ElementHeap element_heap) {
+    size_t sampled = 0;
+    size_t heap = 0;
+    for (auto it = container.begin(); it != container.end() && sampled < RedisValue::MEMORY_SAMPLES; ++it) {
+        heap += element_heap(*it);
+        sampled++;
+    }
+    size_t total = sizeof(Container) + container.size() * node_bytes;
+    return sampled == 0 ? total : total + heap * container.size() / sampled;
+}
+
+// The same for a KeyTable, whose slots are allocated whether used or
+// not: each is an entry plus a control byte
+template <typename Table, typename ElementHeap>
+size_t sampledTableUsage(const Table& table, ElementHeap element_heap) {
+    size_t sampled = 0;
+    size_t heap = 0;
+    table.sample(0, RedisValue::MEMORY_SAMPLES, [&](const typename Table::Entry& entry) {
+        heap += element_heap(entry);
+        sampled++;
+    });
+    size_t total = sizeof(Table) + table.capacity() * (sizeof(typename Table::Entry) + 1);
+    return sampled == 0 ? total : total + heap * table.size() / sampled;
+}
+
+} // namespace
+
+RedisValue::RedisValue(RedisType type) : value_type(type), value_encoding(RedisEncoding::NONE) {
+    switch (type) {
+        case RedisType::STRING:
+            value_encoding = RedisEncoding::EMBSTR;
+            break;
+        case RedisType::LIST:
+            payload.list = new List();
+            value_encoding = RedisEncoding::LINKEDLIST;
+            break;
+        case RedisType::SET:
+            payload.set = new Set();
+            value_encoding = RedisEncoding::HASHSET;
+            break;
+        case RedisType::HASH:
+            payload.hash = new Hash();
+            value_encoding = RedisEncoding::HASHTABLE;
+            break;
+        case RedisType::ZSET:
+            payload.zset = new ZSet();
+            value_encoding = RedisEncoding::SORTEDMAP;
+            break;
+        default:
+            break;
+    }
+}
+
+RedisValue::RedisValue(std::string_view str) : value_type(RedisType::STRING), value_encoding(RedisEncoding::EMBSTR) {
+    if (str.size() <= EMBEDDED_CAPACITY) {
+        embed(str);
+    } else {
+        new (&payload.raw) CompactString(str);
+        value_encoding = RedisEncoding::RAW;
+    }
+}
+
+RedisValue::RedisValue(long long integer) : value_type(RedisType::STRING), value_encoding(RedisEncoding::INT) {
+    payload.integer = integer;
+}
+
+RedisValue::RedisValue(const RedisValue& other) : value_type(RedisType::STRING), value_encoding(RedisEncoding::EMBSTR) {
+    copyFrom(other);
+}
+
+RedisValue::RedisValue(RedisValue&& other) noexcept {
+    moveFrom(other);
+}
+
+RedisValue& RedisValue::operator=(const RedisValue& other) {
+    if (this != &other) {
+        // Build first so a failed allocation leaves this value intact
+        RedisValue copy(other);
+        release();
+        moveFrom(copy);
+    }
+    return *this;
+}
+
+RedisValue& RedisValue::operator=(RedisValue&& other) noexcept {
+    if (this != &other) {
+        release();
+        moveFrom(other);
+    }
+    return *this;
+}
+
+void RedisValue::embed(std::string_view str) {
+    std::memcpy(payload.embedded, str.data(), str.size());
+    embedded_size = static_cast<uint8_t>(str.size());
+}
+
+void RedisValue::release() {
+    switch (value_encoding) {
+        case RedisEncoding::RAW: payload.raw.~CompactString(); break;
+        case RedisEncoding::LINKEDLIST: delete payload.list; break;
+        case RedisEncoding::HASHSET: delete payload.set; break;
+        case RedisEncoding::HASHTABLE: delete payload.hash; break;
+        case RedisEncoding::SORTEDMAP: delete payload.zset; break;
+        default: break;
+    }
+    value_encoding = RedisEncoding::EMBSTR;
+    embedded_size = 0;
+}
+
+void RedisValue::copyFrom(const RedisValue& other) {
+    value_type = other.value_type;
+    value_encoding = other.value_encoding;
+    embedded_size = other.embedded_size;
+    expiry_flag = false;
+    switch (other.value_encoding) {
+        case RedisEncoding::RAW: new (&payload.raw) CompactString(other.payload.raw.view()); break;
+        case RedisEncoding::LINKEDLIST: payload.list = new List(*other.payload.list); break;
+        case RedisEncoding::HASHSET: payload.set = new Set(*other.payload.set); break;
+        case RedisEncoding::HASHTABLE: payload.hash = new Hash(*other.payload.hash); break;
+        case RedisEncoding::SORTEDMAP: payload.zset = new ZSet(*other.payload.zset); break;
+        default: std::memcpy(payload.embedded, other.payload.embedded, EMBEDDED_CAPACITY); break;
+    }
+}
+
+void RedisValue::moveFrom(RedisValue& other) noexcept {
+    if (other.value_encoding == RedisEncoding::RAW) {
+        new (&payload.raw) CompactString(std::move(other.payload.raw));
+        other.payload.raw.~CompactString();
+    } else {
+        // Inline bytes or a container pointer, which moves by copying
+        std::memcpy(payload.embedded, other.payload.embedded, EMBEDDED_CAPACITY);
+    }
+    value_type = other.value_type;
+    value_encoding = other.value_encoding;
+    embedded_size = other.embedded_size;
+    expiry_flag = other.expiry_flag;
+    access_clock = other.access_clock;
+    other.value_type = RedisType::STRING;
+    other.value_encoding = RedisEncoding::EMBSTR;
+    other.embedded_size = 0;
+    other.expiry_flag = false;
+    other.access_clock = 0;
+}
+
+std::string_view RedisValue::str() const {
+    if (value_encoding == RedisEncoding::RAW) return payload.raw.view();
+    if (value_encoding == RedisEncoding::EMBSTR) return std::string_view(payload.embedded, embedded_size);
+    return std::string_view();
+}
+
+std::string RedisValue::toString() const {
+    if (value_encoding == RedisEncoding::INT) return std::to_string(payload.integer);
+    return std::string(str());
+}
+
+size_t RedisValue::length() const {
+    if (value_encoding != RedisEncoding::INT) return str().size();
+    char digits[MAX_INTEGER_DIGITS];
+    return std::to_chars(digits, digits + sizeof(digits), payload.integer).ptr - digits;
+}
+
+size_t RedisValue::freeEffort() const {
+    switch (value_encoding) {
+        case RedisEncoding::LINKEDLIST: return payload.list->size();
+        case RedisEncoding::HASHSET: return payload.set->size();
+        case RedisEncoding::HASHTABLE: return payload.hash->size();
+        // Score groups, a lower bound that is O(1) to get
+        case RedisEncoding::SORTEDMAP: return payload.zset->size();
+        default: return 1;
+    }
+}
+
+size_t RedisValue::memoryUsage() const {
+    switch (value_encoding) {
+        case RedisEncoding::RAW:
+            return payload.raw.allocatedSize();
+        case RedisEncoding::LINKEDLIST:
+            return sampledUsage(*payload.list, LIST_NODE_BYTES, stringHeap);
+        case RedisEncoding::HASHSET:
+            return sampledTableUsage(*payload.set, [](const Set::Entry& member) {
+                return member.key.allocatedSize();
+            });
+        case RedisEncoding::HASHTABLE:
+            return sampledTableUsage(*payload.hash, [](const Hash::Entry& field) {
+                return field.key.allocatedSize() + stringHeap(field.value);
+            });
+        case RedisEncoding::SORTEDMAP:
+            return sampledUsage(*payload.zset, ZSET_NODE_BYTES, [](const ZSet::value_type& group) {
+                return sampledUsage(group.second, TREE_NODE_BYTES, stringHeap);
+            });
+        default:
+            return 0;
+    }
+}
+
+void RedisValue::setInteger(long long integer) {
+    if (value_encoding != RedisEncoding::INT) {
+        release();
+        value_encoding = RedisEncoding::INT;
+    }
+    payload.integer = integer;
+}
+
+void RedisValue::setString(std::string_view str) {
+    if (value_encoding == RedisEncoding::RAW && str.size() > EMBEDDED_CAPACITY) {
+        payload.raw.assign(str);
+        return;
+    }
+    bool flag = expiry_flag;
+    *this = RedisValue(str);
+    expiry_flag = flag;
+}
+
+void RedisValue::decodeInteger() {
+    char digits[MAX_INTEGER_DIGITS];
+    char* end = std::to_chars(digits, digits + sizeof(digits), payload.integer).ptr;
+    setString(std::string_view(digits, end - digits));
+}
+
+void RedisValue::appendString(std::string_view str) {
+    if (value_encoding == RedisEncoding::INT) {
+        decodeInteger();
+    }
+    if (value_encoding == RedisEncoding::EMBSTR && embedded_size + str.size() <= EMBEDDED_CAPACITY) {
+        std::memcpy(payload.embedded + embedded_size, str.data(), str.size());
+        embedded_size = static_cast<uint8_t>(embedded_size + str.size());
+        return;
+    }
+    if (value_encoding != RedisEncoding::RAW) {
+        // Appends tend to repeat, so move to a growable heap string
+        CompactString raw(this->str());
+        release();
+        new (&payload.raw) CompactString(std::move(raw));
+        value_encoding = RedisEncoding::RAW;
+    }
+    payload.raw.append(str);
+}
@@ -1,39 +1,123 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <list>
 #include <set>
-#include <unordered_map>
 #include <map>
-#include <chrono>
 #include "enum/redis_type.h"
+#include "enum/redis_encoding.h"
+#include "utils/compact_string.h"
+#include "utils/string_hash.h"
+#include "redis/database/key_table.h"
 
-struct RedisValue {
-    RedisType type;
+// A keyspace value in 24 bytes: a type tag, an encoding tag and a 16-byte
+// payload holding either a short string inline (EMBSTR), a number (INT,
+// for strings the INCR family wrote), a CompactString (RAW, one
+// allocation with a size-classed header) or a pointer to the container. The expiry is not stored here; the database
+// keeps it in a separate table and only flags the values that have one.
+class RedisValue {
+public:
+    // A set member has nothing besides its key
+    struct NoValue {};
 
-    std::string string_value;
-    std::list<std::string> list_value;
-    std::set<std::string> set_value;
-    std::unordered_map<std::string, std::string> hash_value;
-    std::map<double, std::set<std::string>> zset_value;
+    using List = std::list<std::string>;
+    using Set = KeyTable<NoValue>;
+    using Hash = KeyTable<std::string>;
+    using ZSet = std::map<double, std::set<std::string>>;
 
-    std::chrono::system_clock::time_point expiry;
-    bool has_expiry = false;
+    static constexpr size_t EMBEDDED_CAPACITY = 16;
 
-    RedisValue() : type(RedisType::STRING) {}
-    explicit RedisValue(RedisType t) : type(t) {}
-    explicit RedisValue(const std::string& str)
-        : type(RedisType::STRING), string_value(str) {}
+private:
+    // "-9223372036854775808"
+    static constexpr size_t MAX_INTEGER_DIGITS = 20;
 
-    bool isExpired() const {
-        return has_expiry && std::chrono::system_clock::now() >= expiry;
-    }
+    union Payload {
+        char embedded[EMBEDDED_CAPACITY];
+        long long integer;
+        CompactString raw;
+        List* list;
+        Set* set;
+        Hash* hash;
+        ZSet* zset;
 
-    void setExpiry(std::chrono::milliseconds ttl) {
-        expiry = std::chrono::system_clock::now() + ttl;
-        has_expiry = true;
-    }
+        Payload() : embedded{} {}
+        ~Payload() {}
+    };
 
-    void clearExpiry() {
-        has_expiry = false;
-    }
+    Payload payload;
+    RedisType value_type;
+    RedisEncoding value_encoding;
+    uint8_t embedded_size = 0;
+    bool expiry_flag = false;
+    // In what would be padding; see AccessClock
+    uint32_t access_clock = 0;
+
+    void embed(std::string_view str);
+    void release();
+    void copyFrom(const RedisValue& other);
+    // Turns an INT value back into its decimal string
+    void decodeInteger();
+    // Takes the payload over and leaves `other` an empty string
+    void moveFrom(RedisValue& other) noexcept;
+
+public:
+    RedisValue() : RedisValue(std::string_view()) {}
+    explicit RedisValue(RedisType type);
+    explicit RedisValue(std::string_view str);
+    // A STRING value holding the decimal form of `integer`
+    explicit RedisValue(long long integer);
+    // Copies never carry the expiry flag: the copy is not in the database
+    RedisValue(const RedisValue& other);
+    RedisValue(RedisValue&& other) noexcept;
+    RedisValue& operator=(const RedisValue& other);
+    RedisValue& operator=(RedisValue&& other) noexcept;
+    ~RedisValue() { release(); }
+
+    RedisType type() const { return value_type; }
+    RedisEncoding encoding() const { return value_encoding; }
+
+    // STRING values. An integer-encoded value has no bytes to view, so
+    // str() is only for the other encodings; toString() works for all.
+    std::string_view str() const;
+    std::string toString() const;
+    size_t length() const;
+    void setString(std::string_view str);
+    void appendString(std::string_view str);
+
+    bool isInteger() const { return value_encoding == RedisEncoding::INT; }
+    long long integer() const { return payload.integer; }
+    // Switches a STRING value to the INT encoding; keeps the expiry flag
+    void setInteger(long long integer);
+
+    // Containers; only valid for a value of the matching type
+    List& list() { return *payload.list; }
+    const List& list() const { return *payload.list; }
+    Set& set() { return *payload.set; }
+    const Set& set() const { return *payload.set; }
+    Hash& hash() { return *payload.hash; }
+    const Hash& hash() const { return *payload.hash; }
+    ZSet& zset() { return *payload.zset; }
+    const ZSet& zset() const { return *payload.zset; }
+
+    // Roughly how many frees destroying this value takes, as Redis's
+    // lazyfreeGetFreeEffort: one per container element, one for a string
+    size_t freeEffort() const;
+    // Heap bytes the value owns, for maxmemory accounting. Containers are
+    // estimated from their first MEMORY_SAMPLES elements, as Redis's
+    // objectComputeSize does, so this is O(1); the same contents always
+    // give the same estimate.
+    size_t memoryUsage() const;
+    static constexpr size_t MEMORY_SAMPLES = 5;
+
+    // Maintained by RedisDatabase: set while the key has an expiry, so
+    // reads of keys without one skip the expires table
+    bool hasExpiry() const { return expiry_flag; }
+    void setExpiryFlag(bool flag) { expiry_flag = flag; }
+
+    // Maintained by RedisDatabase for eviction. Readers holding a shared
+    // lock update it too, hence the relaxed atomics; moves keep it,
+    // copies start at 0.
+    uint32_t accessClock() const { return __atomic_load_n(&access_clock, __ATOMIC_RELAXED); }
+    void setAccessClock(uint32_t clock) { __atomic_store_n(&access_clock, clock, __ATOMIC_RELAXED); }
 };
@@ -1,25 +1,39 @@
 #include "resp/resp_formatter.h"
+#include "resp/response_writer.h"
+
+// Standalone replies for callers without an output buffer; the encoding
+// itself lives in ResponseWriter
 
 std::string RESPFormatter::formatError(const std::string& message) {
-    return "-" + message + "\r\n";
+    std::string response;
+    ResponseWriter(response).writeError(message);
+    return response;
 }
 
-std::string RESPFormatter::formatSimpleString(const std::string& str) {
-    return "+" + str + "\r\n";
+std::string RESPFormatter::formatSimpleString(std::string_view str) {
+    std::string response;
+    ResponseWriter(response).writeSimpleString(str);
+    return response;
 }
 
-std::string RESPFormatter::formatBulkString(const std::string& str) {
-    return "$" + std::to_string(str.length()) + "\r\n" + str + "\r\n";
+std::string RESPFormatter::formatBulkString(std::string_view str) {
+    std::string response;
+    ResponseWriter(response).writeBulkString(str);
+    return response;
 }
 
 std::string RESPFormatter::formatInteger(long long value) {
-    return ":" + std::to_string(value) + "\r\n";
+    std::string response;
+    ResponseWriter(response).writeInteger(value);
+    return response;
 }
 
 std::string RESPFormatter::formatArray(const std::vector<std::string>& items) {
-    std::string response = "*" + std::to_string(items.size()) + "\r\n";
+    std::string response;
+    ResponseWriter writer(response);
+    writer.writeArrayHeader(items.size());
     for (const auto& item : items) {
-        response += formatBulkString(item);
+        writer.writeBulkString(item);
     }
     return response;
 }
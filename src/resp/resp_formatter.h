@@ -1,12 +1,13 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 
 class RESPFormatter {
 public:
     static std::string formatError(const std::string& message);
-    static std::string formatSimpleString(const std::string& str);
-    static std::string formatBulkString(const std::string& str);
+    static std::string formatSimpleString(std::string_view str);
+    static std::string formatBulkString(std::string_view str);
     static std::string formatInteger(long long value);
     static std::string formatArray(const std::vector<std::string>& items);
     static std::string formatNull();
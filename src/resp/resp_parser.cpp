@@ -4,7 +4,7 @@
 #include "resp_parser.h"
 
 // New comprehensive parsing method
-bool RESPParser::parse(const std::string& input, RESPValue& result, size_t& consumed) {
+bool RESPParser::parse(std::string_view input, RESPValue& result, size_t& consumed) {
     consumed = 0;
     if (input.empty()) return false;
     
@@ -13,8 +13,149 @@ bool RESPParser::parse(const std::string& input, RESPValue& result, size_t& cons
 }
 
 
+// Incremental request parsing: *<count>\r\n followed by <count> bulk strings
+ParseStatus RESPParser::parseRequest(std::string_view input, std::vector<std::string_view>& args, size_t& consumed) {
+    consumed = 0;
+
+    if (state == RequestState::START) {
+        if (input.empty()) return ParseStatus::INCOMPLETE;
+        if (input[0] != '*') return parseOtherRequest(input, args, consumed);
+        state = RequestState::ARRAY_HEADER;
+        cursor = scan_pos = 1;
+    }
+
+    while (true) {
+        switch (state) {
+            case RequestState::ARRAY_HEADER: {
+                long long count;
+                ParseStatus status = readHeader(input, count);
+                if (status != ParseStatus::COMPLETE) return status;
+                if (count > MAX_ARGS || count < -1) return fail("invalid multibulk length");
+
+                if (count <= 0) {  // *0 and *-1 carry no command
+                    args.clear();
+                    consumed = cursor;
+                    reset();
+                    return ParseStatus::COMPLETE;
+                }
+                expected_args = static_cast<int>(count);
+                arg_slices.clear();
+                arg_slices.reserve(expected_args);
+                state = RequestState::BULK_MARKER;
+                break;
+            }
+
+            case RequestState::BULK_MARKER:
+                if (cursor >= input.size()) return ParseStatus::INCOMPLETE;
+                if (input[cursor] != '$') {
+                    return fail(std::string("expected '$', got '") + input[cursor] + "'");
+                }
+                cursor++;
+                scan_pos = cursor;
+                state = RequestState::BULK_HEADER;
+                break;
+
+            case RequestState::BULK_HEADER: {
+                long long length;
+                ParseStatus status = readHeader(input, length);
+                if (status != ParseStatus::COMPLETE) return status;
+                if (length < 0 || static_cast<size_t>(length) > MAX_STRING_LENGTH) {
+                    return fail("invalid bulk length");
+                }
+                bulk_length = static_cast<size_t>(length);
+                state = RequestState::BULK_DATA;
+                break;
+            }
+
+            case RequestState::BULK_DATA: {
+                // The payload is never scanned, only its size is checked
+                if (input.size() < cursor + bulk_length + 2) return ParseStatus::INCOMPLETE;
+                if (input[cursor + bulk_length] != '\r' || input[cursor + bulk_length + 1] != '\n') {
+                    return fail("bulk string not terminated by CRLF");
+                }
+                arg_slices.emplace_back(cursor, bulk_length);
+                cursor += bulk_length + 2;
+
+                if (static_cast<int>(arg_slices.size()) < expected_args) {
+                    state = RequestState::BULK_MARKER;
+                    break;
+                }
+
+                args.clear();
+                for (const auto& slice : arg_slices) {
+                    args.push_back(input.substr(slice.first, slice.second));
+                }
+                consumed = cursor;
+                reset();
+                return ParseStatus::COMPLETE;
+            }
+
+            case RequestState::START:
+                return fail("parser in invalid state");
+        }
+    }
+}
+
+void RESPParser::reset() {
+    state = RequestState::START;
+    cursor = scan_pos = 0;
+    expected_args = 0;
+    bulk_length = 0;
+    arg_slices.clear();
+}
+
+// Reads the number of a "*<n>\r\n" or "$<n>\r\n" line starting at cursor
+ParseStatus RESPParser::readHeader(std::string_view input, long long& value) {
+    size_t line_end;
+    if (!findCRLF(input, scan_pos, line_end)) {
+        if (input.size() - cursor > MAX_HEADER_LENGTH) return fail("header line too long");
+        // A lone '\r' at the end may be the first half of the CRLF
+        scan_pos = input.size() > cursor ? input.size() - 1 : cursor;
+        return ParseStatus::INCOMPLETE;
+    }
+
+    if (!safeStringToLongLong(input.substr(cursor, line_end - cursor), value)) {
+        return fail("invalid length in header");
+    }
+    cursor = line_end + 2;
+    scan_pos = cursor;
+    return ParseStatus::COMPLETE;
+}
+
+// Requests that are not multibulk arrays: other RESP values as before, and
+// inline commands ("PING\r\n") as sent by telnet
+ParseStatus RESPParser::parseOtherRequest(std::string_view input, std::vector<std::string_view>& args, size_t& consumed) {
+    switch (input[0]) {
+        case '+': case '-': case ':': case '$': {
+            RESPValue value;
+            if (!parse(input, value, consumed)) return ParseStatus::INCOMPLETE;
+            owned_args = toStringVector(value);
+            break;
+        }
+        default: {
+            size_t line_end = input.find('\n');
+            if (line_end == std::string_view::npos) {
+                if (input.size() > MAX_INLINE_LENGTH) return fail("too big inline request");
+                return ParseStatus::INCOMPLETE;
+            }
+            owned_args = parsePlainText(std::string(input.substr(0, line_end)));
+            consumed = line_end + 1;
+            break;
+        }
+    }
+
+    args.assign(owned_args.begin(), owned_args.end());
+    return ParseStatus::COMPLETE;
+}
+
+ParseStatus RESPParser::fail(const std::string& message) {
+    error_message = "Protocol error: " + message;
+    reset();
+    return ParseStatus::ERROR;
+}
+
 // Core recursive parsing logic
-bool RESPParser::parseValue(const std::string& input, size_t& pos, RESPValue& result, int depth) {
+bool RESPParser::parseValue(std::string_view input, size_t& pos, RESPValue& result, int depth) {
     if (pos >= input.size()) return false;
     if (depth > MAX_DEPTH) return false;  // Prevent stack overflow
     
@@ -31,33 +172,33 @@ bool RESPParser::parseValue(const std::string& input, size_t& pos, RESPValue& re
 }
 
 // Parse Simple String: +OK\r\n
-bool RESPParser::parseSimpleString(const std::string& input, size_t& pos, RESPValue& result) {
+bool RESPParser::parseSimpleString(std::string_view input, size_t& pos, RESPValue& result) {
     if (pos >= input.size() || input[pos] != '+') return false;
     
     size_t line_end;
     if (!findCRLF(input, pos + 1, line_end)) return false;
     
-    std::string str = input.substr(pos + 1, line_end - pos - 1);
+    std::string str(input.substr(pos + 1, line_end - pos - 1));
     result = RESPValue(RESPType::SIMPLE_STRING, str);
     pos = line_end + 2;
     return true;
 }
 
 // Parse Error: -ERR unknown command\r\n
-bool RESPParser::parseError(const std::string& input, size_t& pos, RESPValue& result) {
+bool RESPParser::parseError(std::string_view input, size_t& pos, RESPValue& result) {
     if (pos >= input.size() || input[pos] != '-') return false;
     
     size_t line_end;
     if (!findCRLF(input, pos + 1, line_end)) return false;
     
-    std::string error = input.substr(pos + 1, line_end - pos - 1);
+    std::string error(input.substr(pos + 1, line_end - pos - 1));
     result = RESPValue(RESPType::ERROR, error);
     pos = line_end + 2;
     return true;
 }
 
 // Parse Integer: :1000\r\n
-bool RESPParser::parseInteger(const std::string& input, size_t& pos, RESPValue& result) {
+bool RESPParser::parseInteger(std::string_view input, size_t& pos, RESPValue& result) {
     if (pos >= input.size() || input[pos] != ':') return false;
     
     size_t line_end;
@@ -72,7 +213,7 @@ bool RESPParser::parseInteger(const std::string& input, size_t& pos, RESPValue&
 }
 
 // Parse Bulk String: $6\r\nfoobar\r\n or $-1\r\n (NULL)
-bool RESPParser::parseBulkString(const std::string& input, size_t& pos, RESPValue& result) {
+bool RESPParser::parseBulkString(std::string_view input, size_t& pos, RESPValue& result) {
     if (pos >= input.size() || input[pos] != '$') return false;
     
     size_t len_end;
@@ -90,7 +231,7 @@ bool RESPParser::parseBulkString(const std::string& input, size_t& pos, RESPValu
     if (len < 0 || static_cast<size_t>(len) > MAX_STRING_LENGTH) return false;
     if (pos + len + 2 > input.size()) return false;
     
-    std::string str = input.substr(pos, len);
+    std::string str(input.substr(pos, len));
     pos += len;
     
     if (pos + 2 > input.size() || input[pos] != '\r' || input[pos + 1] != '\n')
@@ -102,7 +243,7 @@ bool RESPParser::parseBulkString(const std::string& input, size_t& pos, RESPValu
 }
 
 // Parse Array: *2\r\n$3\r\nfoo\r\n$3\r\nbar\r\n
-bool RESPParser::parseArray(const std::string& input, size_t& pos, RESPValue& result, int depth) {
+bool RESPParser::parseArray(std::string_view input, size_t& pos, RESPValue& result, int depth) {
     if (pos >= input.size() || input[pos] != '*') return false;
     
     size_t line_end;
@@ -198,41 +339,26 @@ void RESPParser::printValue(const RESPValue& value, int indent) {
 }
 
 // Private helper methods
-bool RESPParser::findCRLF(const std::string& input, size_t start, size_t& end) {
-    end = input.find("\r\n", start);
-    return end != std::string::npos;
-}
-
-bool RESPParser::safeStringToInt(const std::string& str, int& result) {
-    if (str.empty()) return false;
-    
-    try {
-        size_t processed;
-        long long val = std::stoll(str, &processed);
-        
-        if (processed != str.length()) return false;
-        
-        if (val < std::numeric_limits<int>::min() || val > std::numeric_limits<int>::max()) {
-            return false;
-        }
-        
-        result = static_cast<int>(val);
-        return true;
-    } catch (const std::exception&) {
-        return false;
-    }
+bool RESPParser::findCRLF(std::string_view input, size_t start, size_t& end) {
+    if (start >= input.size()) return false;
+    size_t offset = RESPScanner::findCRLF(input.data() + start, input.size() - start);
+    if (offset == RESPScanner::npos) return false;
+    end = start + offset;
+    return true;
 }
 
-bool RESPParser::safeStringToLongLong(const std::string& str, long long& result) {
-    if (str.empty()) return false;
-    
-    try {
-        size_t processed;
-        result = std::stoll(str, &processed);
-        return processed == str.length();
-    } catch (const std::exception&) {
+bool RESPParser::safeStringToInt(std::string_view str, int& result) {
+    long long val;
+    if (!RESPScanner::parseInteger(str, val)) return false;
+    if (val < std::numeric_limits<int>::min() || val > std::numeric_limits<int>::max()) {
         return false;
     }
+    result = static_cast<int>(val);
+    return true;
+}
+
+bool RESPParser::safeStringToLongLong(std::string_view str, long long& result) {
+    return RESPScanner::parseInteger(str, result);
 }
 
 // Plain text parser utility
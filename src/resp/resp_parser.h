@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
@@ -11,7 +12,9 @@
 #include <variant>
 #include <optional>
 #include "enum/resp_type.h"
+#include "enum/parse_status.h"
 #include "resp_value.h"
+#include "resp_scanner.h"
 
 
 class RESPParser {
@@ -19,22 +22,59 @@ private:
     static const size_t MAX_STRING_LENGTH = 1024 * 1024;  // 1MB
     static const int MAX_ARGS = 1000;
     static const int MAX_DEPTH = 100;  // Prevent stack overflow in nested arrays
+    static const size_t MAX_HEADER_LENGTH = 32;           // "*<count>" / "$<length>" lines
+    static const size_t MAX_INLINE_LENGTH = 64 * 1024;
+
+    // Where parseRequest() stopped inside the current request
+    enum class RequestState {
+        START,          // nothing of this request seen yet
+        ARRAY_HEADER,   // inside "*<count>\r\n"
+        BULK_MARKER,    // expecting the '$' of the next argument
+        BULK_HEADER,    // inside "$<length>\r\n"
+        BULK_DATA       // waiting for <length> bytes plus CRLF
+    };
+
+    // Request progress. Positions are offsets from the start of the input,
+    // which stays the same until the request completes.
+    RequestState state = RequestState::START;
+    size_t cursor = 0;          // first byte not yet accepted
+    size_t scan_pos = 0;        // where the CRLF search of a header resumes
+    int expected_args = 0;
+    size_t bulk_length = 0;
+    std::vector<std::pair<size_t, size_t>> arg_slices;  // offset, length
+    std::vector<std::string> owned_args;   // storage for non-multibulk requests
+    std::string error_message;
+
+    ParseStatus readHeader(std::string_view input, long long& value);
+    ParseStatus parseOtherRequest(std::string_view input, std::vector<std::string_view>& args, size_t& consumed);
+    ParseStatus fail(const std::string& message);
     
     // Private parsing helpers
-    static bool findCRLF(const std::string& input, size_t start, size_t& end);
-    static bool safeStringToInt(const std::string& str, int& result);
-    static bool safeStringToLongLong(const std::string& str, long long& result);
-    static bool parseValue(const std::string& input, size_t& pos, RESPValue& result, int depth = 0);
-    static bool parseSimpleString(const std::string& input, size_t& pos, RESPValue& result);
-    static bool parseError(const std::string& input, size_t& pos, RESPValue& result);
-    static bool parseInteger(const std::string& input, size_t& pos, RESPValue& result);
-    static bool parseBulkString(const std::string& input, size_t& pos, RESPValue& result);
-    static bool parseArray(const std::string& input, size_t& pos, RESPValue& result, int depth);
+    static bool findCRLF(std::string_view input, size_t start, size_t& end);
+    static bool safeStringToInt(std::string_view str, int& result);
+    static bool safeStringToLongLong(std::string_view str, long long& result);
+    static bool parseValue(std::string_view input, size_t& pos, RESPValue& result, int depth = 0);
+    static bool parseSimpleString(std::string_view input, size_t& pos, RESPValue& result);
+    static bool parseError(std::string_view input, size_t& pos, RESPValue& result);
+    static bool parseInteger(std::string_view input, size_t& pos, RESPValue& result);
+    static bool parseBulkString(std::string_view input, size_t& pos, RESPValue& result);
+    static bool parseArray(std::string_view input, size_t& pos, RESPValue& result, int depth);
 
 public:
     // New comprehensive parsing method
-    static bool parse(const std::string& input, RESPValue& result, size_t& consumed);
+    static bool parse(std::string_view input, RESPValue& result, size_t& consumed);
     
+    // Incremental parser for client requests, normally arrays of bulk
+    // strings. On INCOMPLETE the state is kept, so the next call with the
+    // same unconsumed input plus the new bytes only looks at the new bytes.
+    // On COMPLETE the caller drops `consumed` bytes before the next call.
+    // The arguments are views into the input (or into parser storage for
+    // inline requests) and are valid until that input changes or the next
+    // call, whichever comes first.
+    ParseStatus parseRequest(std::string_view input, std::vector<std::string_view>& args, size_t& consumed);
+    void reset();
+    const std::string& getError() const { return error_message; }
+
     // Utility methods
     static std::vector<std::string> toStringVector(const RESPValue& value);
     static void printValue(const RESPValue& value, int indent = 0);
@@ -0,0 +1,181 @@
+#include "resp_scanner.h"
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RESP_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+size_t findCRLFScalar(const char* data, size_t len) {
+    // memchr is vectorised by libc; only confirm the '\n' after each '\r'
+    const char* p = data;
+    const char* end = data + len;
+    while (p + 1 < end) {
+        const char* cr = static_cast<const char*>(memchr(p, '\r', end - p - 1));
+        if (!cr) break;
+        if (cr[1] == '\n') return cr - data;
+        p = cr + 1;
+    }
+    return RESPScanner::npos;
+}
+
+#ifdef RESP_SCANNER_X86
+
+// Each set bit of `mask` marks a '\r' at data[base + bit]
+inline size_t confirmCR(const char* data, size_t len, size_t base, unsigned long long mask) {
+    while (mask) {
+        size_t i = base + __builtin_ctzll(mask);
+        if (i + 1 < len && data[i + 1] == '\n') return i;
+        mask &= mask - 1;
+    }
+    return RESPScanner::npos;
+}
+
+__attribute__((target("sse2")))
+size_t findCRLFSse2(const char* data, size_t len) {
+    const __m128i cr = _mm_set1_epi8('\r');
+    size_t i = 0;
+    // 64 bytes per iteration; the per-block masks are only built on a hit
+    for (; i + 64 <= len; i += 64) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(data + i);
+        __m128i m0 = _mm_cmpeq_epi8(_mm_loadu_si128(block), cr);
+        __m128i m1 = _mm_cmpeq_epi8(_mm_loadu_si128(block + 1), cr);
+        __m128i m2 = _mm_cmpeq_epi8(_mm_loadu_si128(block + 2), cr);
+        __m128i m3 = _mm_cmpeq_epi8(_mm_loadu_si128(block + 3), cr);
+        __m128i any = _mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3));
+        if (_mm_movemask_epi8(any)) {
+            unsigned long long mask = static_cast<unsigned>(_mm_movemask_epi8(m0))
+                | static_cast<unsigned long long>(_mm_movemask_epi8(m1)) << 16
+                | static_cast<unsigned long long>(_mm_movemask_epi8(m2)) << 32
+                | static_cast<unsigned long long>(_mm_movemask_epi8(m3)) << 48;
+            size_t found = confirmCR(data, len, i, mask);
+            if (found != RESPScanner::npos) return found;
+        }
+    }
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, cr));
+        if (mask) {
+            size_t found = confirmCR(data, len, i, mask);
+            if (found != RESPScanner::npos) return found;
+        }
+    }
+    size_t tail = findCRLFScalar(data + i, len - i);
+    return tail == RESPScanner::npos ? tail : i + tail;
+}
+
+__attribute__((target("avx2")))
+size_t findCRLFAvx2(const char* data, size_t len) {
+    const __m256i cr = _mm256_set1_epi8('\r');
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        const __m256i* block = reinterpret_cast<const __m256i*>(data + i);
+        __m256i m0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block), cr);
+        __m256i m1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block + 1), cr);
+        if (!_mm256_testz_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m0, m1))) {
+            unsigned long long mask = static_cast<unsigned>(_mm256_movemask_epi8(m0))
+                | static_cast<unsigned long long>(static_cast<unsigned>(_mm256_movemask_epi8(m1))) << 32;
+            size_t found = confirmCR(data, len, i, mask);
+            if (found != RESPScanner::npos) return found;
+        }
+    }
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, cr)));
+        if (mask) {
+            size_t found = confirmCR(data, len, i, mask);
+            if (found != RESPScanner::npos) return found;
+        }
+    }
+    size_t tail = findCRLFScalar(data + i, len - i);
+    return tail == RESPScanner::npos ? tail : i + tail;
+}
+
+#endif // RESP_SCANNER_X86
+
+RESPScanner::Implementation detectImplementation() {
+#ifdef RESP_SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return RESPScanner::Implementation::AVX2;
+    if (__builtin_cpu_supports("sse2")) return RESPScanner::Implementation::SSE2;
+#endif
+    return RESPScanner::Implementation::SCALAR;
+}
+
+RESPScanner::Implementation active_implementation = detectImplementation();
+
+} // namespace
+
+size_t RESPScanner::findCRLF(const char* data, size_t len) {
+    return findCRLF(active_implementation, data, len);
+}
+
+size_t RESPScanner::findCRLF(Implementation impl, const char* data, size_t len) {
+    switch (impl) {
+#ifdef RESP_SCANNER_X86
+        case Implementation::AVX2: return findCRLFAvx2(data, len);
+        case Implementation::SSE2: return findCRLFSse2(data, len);
+#endif
+        default: return findCRLFScalar(data, len);
+    }
+}
+
+bool RESPScanner::parseInteger(std::string_view str, long long& result) {
+    const char* p = str.data();
+    const char* end = p + str.size();
+    if (p == end) return false;
+
+    bool negative = *p == '-';
+    if (negative || *p == '+') {
+        if (++p == end) return false;
+    }
+    // 19 digits always fit in 64 unsigned bits; the range check is below
+    if (end - p > 19) return false;
+
+    unsigned long long value = 0;
+    for (; p < end; ++p) {
+        unsigned digit = static_cast<unsigned char>(*p) - '0';
+        if (digit > 9) return false;
+        value = value * 10 + digit;
+    }
+
+    const unsigned long long max = std::numeric_limits<long long>::max();
+    if (negative) {
+        if (value > max + 1) return false;
+        result = value == max + 1 ? std::numeric_limits<long long>::min() : -static_cast<long long>(value);
+    } else {
+        if (value > max) return false;
+        result = static_cast<long long>(value);
+    }
+    return true;
+}
+
+bool RESPScanner::isSupported(Implementation impl) {
+    switch (impl) {
+        case Implementation::SCALAR: return true;
+#ifdef RESP_SCANNER_X86
+        case Implementation::SSE2: return __builtin_cpu_supports("sse2");
+        case Implementation::AVX2: return __builtin_cpu_supports("avx2");
+#endif
+        default: return false;
+    }
+}
+
+RESPScanner::Implementation RESPScanner::getImplementation() {
+    return active_implementation;
+}
+
+void RESPScanner::setImplementation(Implementation impl) {
+    if (isSupported(impl)) active_implementation = impl;
+}
+
+const char* RESPScanner::getImplementationName(Implementation impl) {
+    switch (impl) {
+        case Implementation::SSE2: return "sse2";
+        case Implementation::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef RESP_SCANNER_H
+#define RESP_SCANNER_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// Low-level scanning used by the RESP parser: CRLF search and the integer
+// in '*', '$' and ':' headers. The CRLF search picks an SSE2 or AVX2 loop
+// at startup depending on the CPU, with a portable scalar fallback.
+class RESPScanner {
+public:
+    enum class Implementation {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    // Offset of the first "\r\n" in data[0, len), or npos
+    static size_t findCRLF(const char* data, size_t len);
+    static size_t findCRLF(Implementation impl, const char* data, size_t len);
+
+    // Decimal integer with optional sign, nothing else. No exceptions;
+    // false on empty input, stray characters or overflow.
+    static bool parseInteger(std::string_view str, long long& result);
+
+    static bool isSupported(Implementation impl);
+    static Implementation getImplementation();
+    // Benchmarks and tests only; ignored when the CPU lacks support
+    static void setImplementation(Implementation impl);
+    static const char* getImplementationName(Implementation impl);
+
+    static constexpr size_t npos = std::string_view::npos;
+};
+
+#endif // RESP_SCANNER_H
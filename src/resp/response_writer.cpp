@@ -0,0 +1,69 @@
+#include "resp/response_writer.h"
+#include <charconv>
+
+namespace {
+
+// Longest decimal long long plus sign
+const size_t MAX_DIGITS = 21;
+
+} // namespace
+
+void ResponseWriter::writePrefixed(char prefix, long long value) {
+    char buf[MAX_DIGITS + 3];
+    buf[0] = prefix;
+    char* end = std::to_chars(buf + 1, buf + sizeof(buf), value).ptr;
+    *end++ = '\r';
+    *end++ = '\n';
+    output.append(buf, end - buf);
+}
+
+void ResponseWriter::setFlushHandler(FlushHandler handler, size_t threshold) {
+    flush_handler = std::move(handler);
+    flush_threshold = threshold;
+}
+
+bool ResponseWriter::truncate(size_t pos) {
+    if (pos < flushed) return false;
+    output.resize(pos - flushed);
+    return true;
+}
+
+void ResponseWriter::writeSimpleString(std::string_view str) {
+    output += '+';
+    output.append(str);
+    output += "\r\n";
+}
+
+void ResponseWriter::writeError(std::string_view message) {
+    output += '-';
+    output.append(message);
+    output += "\r\n";
+}
+
+void ResponseWriter::writeInteger(long long value) {
+    writePrefixed(':', value);
+}
+
+void ResponseWriter::writeBulkString(std::string_view str) {
+    writePrefixed('$', static_cast<long long>(str.size()));
+    output.append(str);
+    output += "\r\n";
+}
+
+void ResponseWriter::writeBulkString(long long value) {
+    char digits[MAX_DIGITS];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    writeBulkString(std::string_view(digits, end - digits));
+}
+
+void ResponseWriter::writeNull() {
+    output += "$-1\r\n";
+}
+
+void ResponseWriter::writeArrayHeader(size_t count) {
+    writePrefixed('*', static_cast<long long>(count));
+}
+
+void ResponseWriter::writeNullArray() {
+    output += "*-1\r\n";
+}
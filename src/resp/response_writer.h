@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <functional>
+
+// Appends RESP replies straight into an output buffer, normally the
+// connection's pending output, so commands never build a reply string of
+// their own. Arrays are written as a header followed by their elements.
+//
+// Large collection replies are streamed: their loops call flushIfNeeded()
+// after each element, and once the buffer holds a chunk the flush handler
+// gets to send what the socket takes, so while the peer keeps reading the
+// buffer stays around one chunk in size.
+class ResponseWriter {
+public:
+    // Sends what it can from the front of the buffer, erases it, and
+    // returns how many bytes it removed
+    using FlushHandler = std::function<size_t(std::string&)>;
+    static const size_t STREAM_CHUNK_SIZE = 64 * 1024;
+
+private:
+    std::string& output;
+    FlushHandler flush_handler;
+    size_t flush_threshold = STREAM_CHUNK_SIZE;
+    size_t flushed = 0;   // bytes the handler already took
+
+    void writePrefixed(char prefix, long long value);   // "<prefix><value>\r\n"
+
+public:
+    explicit ResponseWriter(std::string& buffer) : output(buffer) {}
+
+    void setFlushHandler(FlushHandler handler, size_t threshold = STREAM_CHUNK_SIZE);
+
+    void writeSimpleString(std::string_view str);
+    void writeError(std::string_view message);
+    void writeInteger(long long value);
+    void writeBulkString(std::string_view str);
+    void writeBulkString(long long value);   // decimal, as a bulk string
+    void writeNull();                        // null bulk string
+    void writeArrayHeader(size_t count);     // followed by `count` elements
+    void writeNullArray();
+
+    // Streaming point between the elements of a large reply
+    void flushIfNeeded() {
+        if (flush_handler && output.size() >= flush_threshold) {
+            flushed += flush_handler(output);
+        }
+    }
+
+    // Lets a caller drop a partially written reply, e.g. on an exception.
+    // Positions count flushed bytes too; truncate() fails once part of
+    // the reply after `pos` has already been flushed.
+    size_t position() const { return flushed + output.size(); }
+    bool truncate(size_t pos);
+};
@@ -0,0 +1,201 @@
+#include "client_connection.h"
+#include <algorithm>
+
+ClientConnection::ClientConnection(int socket_fd, const std::string& ip, int port)
+    : fd(socket_fd), client_ip(ip), client_port(port) {}
+
+ClientConnection::~ClientConnection() {
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+bool ClientConnection::readAvailable() {
+    // Edge-triggered: read until the kernel buffer is empty or the budget
+    // is spent; in the latter case input_ready stays set and the loop
+    // comes back after serving the other clients.
+    // Reads land directly behind the unparsed bytes, no intermediate copy.
+    input_ready = true;
+    size_t budget = READ_BUDGET;
+    while (budget > 0) {
+        char* dst = query_buffer.prepareWrite(READ_SIZE);
+        ssize_t n = read(fd, dst, std::min(query_buffer.writableBytes(), budget));
+        if (n > 0) {
+            query_buffer.commitWrite(n);
+            budget -= n;
+            checkQueryLimit();
+            if (close_requested) return true;
+            continue;
+        }
+        if (n == 0) return false;  // peer closed
+        if (errno == EINTR) continue;
+        input_ready = false;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    return true;
+}
+
+void ClientConnection::setLimits(const ClientLimits& limits) {
+    query_buffer.setMaxSize(limits.query_buffer);
+    output_limit = limits.output_buffer;
+}
+
+void ClientConnection::appendInput(const char* data, size_t len) {
+    if (close_requested) return;
+    query_buffer.append(data, len);
+    checkQueryLimit();
+}
+
+void ClientConnection::closeForLimit(const char* limit) {
+    // As Redis does for its client buffer limits: no reply, just close
+    logError("Closing client " + client_ip + ":" + std::to_string(client_port) +
+             " that reached the " + limit + " limit");
+    close_requested = true;
+}
+
+void ClientConnection::checkQueryLimit() {
+    if (!query_buffer.overLimit()) return;
+    closeForLimit("query buffer");
+    query_buffer.clear();
+}
+
+void ClientConnection::processInput(CommandHandler& handler) {
+    // The handler also enforces the output limit in the middle of a large
+    // reply, so it is installed even when replies are not streamed
+    ResponseWriter out(pending_output);
+    stream_retry_size = 0;
+    out.setFlushHandler([this](std::string& output) { return flushStreamedReply(output); });
+
+    input_paused = false;
+    while (!close_requested) {
+        if (isOutputBacklogged()) {
+            input_paused = true;  // resumed once the peer has read
+            break;
+        }
+
+        size_t consumed = 0;
+        ParseStatus status = parser.parseRequest(query_buffer.readable(), args, consumed);
+        if (status == ParseStatus::INCOMPLETE) break;  // parser resumes on the next read
+
+        if (status == ParseStatus::ERROR) {
+            // The stream cannot be resynchronised: report and hang up
+            out.writeError("ERR " + parser.getError());
+            close_requested = true;
+            break;
+        }
+
+        if (!args.empty()) {  // skip blank inline lines and empty arrays
+            logCommand(args, consumed);
+
+            // Replies are written straight into the output buffer; the loop
+            // flushes the whole batch with one send once every complete
+            // command has been executed
+            try {
+                handler.processCommand(args, out);
+            } catch (const std::exception& e) {
+                // Failed after part of its reply was streamed: the reply
+                // cannot be completed, so the connection has to go
+                logError("Aborting streamed reply: " + std::string(e.what()));
+                close_requested = true;
+            }
+        }
+
+        // The arguments point into the buffer, so advance only now; the
+        // rest of the pipeline stays in place
+        query_buffer.consume(consumed);
+
+        if (getPendingOutputSize() > output_limit) {
+            closeForLimit("output buffer");
+            dropOutput();
+        }
+    }
+
+    // Whatever a dropped reply wrote after its last flush goes too
+    if (output_dropped) dropOutput();
+
+    // Idle connections should not keep a large burst buffer around
+    query_buffer.shrinkIfIdle();
+}
+
+bool ClientConnection::sendPending() {
+    while (hasPendingOutput()) {
+        ssize_t n = send(fd, pending_output.data() + pending_offset,
+                         pending_output.size() - pending_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            pending_offset += n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        return false;
+    }
+    return true;
+}
+
+bool ClientConnection::flushOutput() {
+    if (!sendPending()) return false;
+    if (hasPendingOutput()) return true;
+
+    // Fully drained: keep a small buffer for the next batch, but release
+    // what a large reply left behind so idle connections stay small
+    pending_output.clear();
+    if (pending_output.capacity() > IDLE_BUFFER_CAPACITY) {
+        std::string().swap(pending_output);
+    }
+    pending_offset = 0;
+    return true;
+}
+
+size_t ClientConnection::flushStreamedReply(std::string& output) {
+    // Called from inside a command once a chunk of its reply is buffered,
+    // often under keyspace locks, so it never waits: it sends what the
+    // socket takes right now and leaves the rest to the event loop. The
+    // next try comes a chunk later, so a peer that is not reading costs
+    // one send per chunk rather than one per element.
+    if (output.size() < stream_retry_size) return 0;
+    if (output_dropped) return dropOutput();
+
+    size_t sent = 0;
+    if (stream_replies) {
+        if (!sendPending()) {
+            // The peer is gone: the rest of the reply has nowhere to go
+            close_requested = true;
+            return dropOutput();
+        }
+        sent = pending_offset;
+        output.erase(0, pending_offset);
+        pending_offset = 0;
+    }
+
+    if (output.size() > output_limit) {
+        closeForLimit("output buffer");
+        return sent + dropOutput();
+    }
+    stream_retry_size = output.size() + ResponseWriter::STREAM_CHUNK_SIZE;
+    return sent;
+}
+
+size_t ClientConnection::dropOutput() {
+    // Keeps discarding, a chunk at a time, whatever the running command
+    // still produces; returns the bytes removed from the reply buffer
+    output_dropped = true;
+    size_t dropped = pending_output.size();
+    std::string().swap(pending_output);
+    pending_offset = 0;
+    stream_retry_size = ResponseWriter::STREAM_CHUNK_SIZE;
+    return dropped;
+}
+
+bool ClientConnection::takeOutput(std::string& out) {
+    if (!hasPendingOutput()) return false;
+
+    out.clear();
+    if (pending_offset == 0) {
+        out.swap(pending_output);
+    } else {
+        out.assign(pending_output, pending_offset, std::string::npos);
+        pending_output.clear();
+    }
+    pending_offset = 0;
+    return true;
+}
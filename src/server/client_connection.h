@@ -0,0 +1,114 @@
+#ifndef CLIENT_CONNECTION_H
+#define CLIENT_CONNECTION_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "query_buffer.h"
+#include "resp/resp_parser.h"
+#include "resp/response_writer.h"
+#include "redis/command_handler.h"
+#include "utils/logger.h"
+
+// Buffer sizes past which a client is disconnected, like Redis's
+// client-query-buffer-limit and client-output-buffer-limit
+struct ClientLimits {
+    size_t query_buffer = QueryBuffer::DEFAULT_MAX_SIZE;
+    size_t output_buffer = 1024 * 1024 * 1024;   // unsent replies
+};
+
+// Per-connection state for the event loop: socket, pending input and
+// pending output. All methods are called from the owning loop thread.
+class ClientConnection {
+private:
+    static const size_t IDLE_BUFFER_CAPACITY = 4096;
+    static const size_t READ_SIZE = 16 * 1024;   // minimum room offered to read()
+    static const size_t READ_BUDGET = 4 * READ_SIZE;   // per readAvailable() call
+    // Unsent output at which the pipeline stops executing until the peer
+    // has read some of it
+    static const size_t OUTPUT_PAUSE_SIZE = 4 * ResponseWriter::STREAM_CHUNK_SIZE;
+
+    int fd;
+    std::string client_ip;
+    int client_port;
+
+    QueryBuffer query_buffer;     // bytes received but not yet parsed
+    std::string pending_output;   // replies queued for the next flush
+    size_t pending_offset = 0;
+    RESPParser parser;
+    std::vector<std::string_view> args;   // reused for every command
+    bool close_requested = false;
+    bool stream_replies = true;     // false when the loop submits the sends itself
+    size_t stream_retry_size = 0;   // buffered size at which streaming sends again
+    size_t output_limit = ClientLimits().output_buffer;
+    bool output_dropped = false;    // over a limit or peer gone: replies are discarded
+    bool input_ready = false;       // the socket may still hold unread bytes
+    bool input_paused = false;      // commands left unexecuted behind a full output
+
+    bool sendPending();
+    size_t flushStreamedReply(std::string& output);
+    size_t dropOutput();
+    void closeForLimit(const char* limit);
+    void checkQueryLimit();
+
+public:
+    ClientConnection(int socket_fd, const std::string& ip, int port);
+    ~ClientConnection();
+
+    // Prevent copying
+    ClientConnection(const ClientConnection&) = delete;
+    ClientConnection& operator=(const ClientConnection&) = delete;
+
+    // Read the socket into the query buffer, at most READ_BUDGET bytes so
+    // a flooding client cannot hold the loop; canRead() stays true while
+    // more may be waiting. Returns false on EOF or on a fatal socket
+    // error. A client whose unparsed input goes past the query buffer
+    // limit is dropped: its input is discarded and shouldClose() turns true.
+    bool readAvailable();
+    // The socket reported readiness (edge-triggered loops)
+    void markReadable() { input_ready = true; }
+
+    // Execute the complete commands in the query buffer and queue the
+    // replies; nothing is written until flushOutput()/takeOutput(). Stops
+    // early while the output is backlogged, leaving the rest of the
+    // pipeline for a later call. A client whose unsent output goes past
+    // the output buffer limit is dropped.
+    void processInput(CommandHandler& handler);
+
+    // Backpressure: while the peer is not reading its replies, neither
+    // read nor execute more of its input
+    bool isOutputBacklogged() const { return getPendingOutputSize() >= OUTPUT_PAUSE_SIZE; }
+    bool canRead() const { return input_ready && !isOutputBacklogged(); }
+    // More work is possible right now without a new socket event
+    bool needsService() const {
+        return !close_requested && !isOutputBacklogged() && (input_ready || input_paused);
+    }
+
+    // Completion-based backends (io_uring) receive into their own buffers
+    // and submit the sends: they feed input here and collect the queued
+    // replies with takeOutput() instead of calling flushOutput(). Such
+    // backends also turn off streaming, which writes to the socket
+    // directly while a large reply is produced.
+    void appendInput(const char* data, size_t len);
+    void setStreamReplies(bool enabled) { stream_replies = enabled; }
+
+    void setLimits(const ClientLimits& limits);
+    bool takeOutput(std::string& out);
+
+    // Write as much pending output as the socket accepts.
+    // Returns false on a fatal socket error.
+    bool flushOutput();
+
+    bool hasPendingOutput() const { return pending_offset < pending_output.size(); }
+    size_t getPendingOutputSize() const { return pending_output.size() - pending_offset; }
+    bool shouldClose() const { return close_requested; }
+    int getFd() const { return fd; }
+    const std::string& getIp() const { return client_ip; }
+    int getPort() const { return client_port; }
+};
+
+#endif // CLIENT_CONNECTION_H
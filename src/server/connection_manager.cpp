@@ -1,54 +1,45 @@
 #include "connection_manager.h"
 
+ConnectionManager::ConnectionManager(size_t max_clients, const ClientLimits& limits)
+    : max_clients(max_clients), limits(limits) {}
+
 ConnectionManager::~ConnectionManager() {
     stopAllConnections();
 }
 
 bool ConnectionManager::canAcceptNewConnection() const {
-    return active_connections < MAX_CLIENTS;
+    return active_connections < max_clients;
 }
 
-void ConnectionManager::addConnection(std::function<void()> handler) {
-    std::lock_guard<std::mutex> lock(threads_mutex);
-    
-    // Clean up finished threads before adding new one
-    cleanupFinishedThreads();
-    
-    if (client_threads.size() >= MAX_CLIENTS) {
+ClientConnection* ConnectionManager::addConnection(int client_socket, const std::string& client_ip, int client_port) {
+    if (!canAcceptNewConnection()) {
         throw std::runtime_error("Maximum connections reached");
     }
-    
-    client_threads.emplace_back([this, handler]() {
-        active_connections++;
-        try {
-            handler();
-        } catch (const std::exception& e) {
-            std::cerr << "Connection handler error: " << e.what() << std::endl;
-        }
-        active_connections--;
-    });
+
+    auto connection = std::make_unique<ClientConnection>(client_socket, client_ip, client_port);
+    ClientConnection* raw = connection.get();
+    raw->setLimits(limits);
+    connections[client_socket] = std::move(connection);
+    active_connections = connections.size();
+    return raw;
+}
+
+ClientConnection* ConnectionManager::getConnection(int client_socket) {
+    auto it = connections.find(client_socket);
+    return it != connections.end() ? it->second.get() : nullptr;
+}
+
+void ConnectionManager::removeConnection(int client_socket) {
+    // Destroying the connection closes its socket
+    connections.erase(client_socket);
+    active_connections = connections.size();
 }
 
 void ConnectionManager::stopAllConnections() {
-    std::lock_guard<std::mutex> lock(threads_mutex);
-    
-    for (auto& thread : client_threads) {
-        if (thread.joinable()) {
-            thread.join();
-        }
-    }
-    client_threads.clear();
+    connections.clear();
     active_connections = 0;
 }
 
 size_t ConnectionManager::getActiveConnections() const {
     return active_connections;
 }
-
-void ConnectionManager::cleanupFinishedThreads() {
-    auto it = std::remove_if(client_threads.begin(), client_threads.end(),
-        [](std::thread& t) {
-            return !t.joinable();
-        });
-    client_threads.erase(it, client_threads.end());
-}
\ No newline at end of file
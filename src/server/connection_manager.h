@@ -1,31 +1,37 @@
 #ifndef CONNECTION_MANAGER_H
 #define CONNECTION_MANAGER_H
 
-#include <vector>
-#include <thread>
-#include <mutex>
+#include <unordered_map>
+#include <memory>
 #include <atomic>
-#include <functional>
-#include <algorithm>
-#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "client_connection.h"
 
+// Registry of the connections owned by an event loop. Connections are
+// added, looked up and removed by the loop thread only; the active count
+// can be read from any thread.
 class ConnectionManager {
 private:
-    
-    std::vector<std::thread> client_threads;
-    std::mutex threads_mutex;
+    std::unordered_map<int, std::unique_ptr<ClientConnection>> connections;
     std::atomic<size_t> active_connections{0};
-    
-    void cleanupFinishedThreads();
+    size_t max_clients;
+    ClientLimits limits;   // applied to every connection added
 
 public:
-    static inline const int MAX_CLIENTS = 100;
+    static inline const size_t DEFAULT_MAX_CLIENTS = 10000;
+
+    explicit ConnectionManager(size_t max_clients = DEFAULT_MAX_CLIENTS, const ClientLimits& limits = {});
     ~ConnectionManager();
-    
+
     bool canAcceptNewConnection() const;
-    void addConnection(std::function<void()> handler);
+    ClientConnection* addConnection(int client_socket, const std::string& client_ip = "", int client_port = 0);
+    ClientConnection* getConnection(int client_socket);
+    void removeConnection(int client_socket);
     void stopAllConnections();
     size_t getActiveConnections() const;
+    size_t getMaxClients() const { return max_clients; }
+    const ClientLimits& getClientLimits() const { return limits; }
 };
 
 #endif
@@ -0,0 +1,205 @@
+#include "event_loop.h"
+#include <algorithm>
+#include <netinet/tcp.h>
+#include "utils/server_clock.h"
+
+EventLoop::EventLoop(int listen_fd, CommandHandler& handler, ConnectionManager& connections)
+    : listen_fd(listen_fd), command_handler(handler), connection_manager(connections) {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1) {
+        throw std::runtime_error("Failed to create epoll instance: " + std::string(strerror(errno)));
+    }
+
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd == -1) {
+        close(epoll_fd);
+        throw std::runtime_error("Failed to create wakeup eventfd: " + std::string(strerror(errno)));
+    }
+
+    // The listening socket stays level-triggered so a failed accept (e.g.
+    // out of descriptors) is retried on the next iteration
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd;
+    epoll_event wake_ev{};
+    wake_ev.events = EPOLLIN;
+    wake_ev.data.fd = wakeup_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) == -1 ||
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &wake_ev) == -1) {
+        std::string error = strerror(errno);
+        close(wakeup_fd);
+        close(epoll_fd);
+        throw std::runtime_error("Failed to register with epoll: " + error);
+    }
+}
+
+EventLoop::~EventLoop() {
+    if (wakeup_fd != -1) close(wakeup_fd);
+    if (epoll_fd != -1) close(epoll_fd);
+}
+
+bool EventLoop::setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags == -1) return false;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+void EventLoop::run() {
+    std::vector<epoll_event> events(MAX_EVENTS);
+    auto next_cron = std::chrono::steady_clock::now() + CommandHandler::CRON_INTERVAL;
+
+    while (!stop_requested) {
+        // Sleep no longer than the next cron tick, and not at all while
+        // some client still has work queued
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_cron - std::chrono::steady_clock::now());
+        int timeout = ready_clients.empty() ? std::max<int>(0, wait.count()) : 0;
+        int n = epoll_wait(epoll_fd, events.data(), MAX_EVENTS, timeout);
+        if (n < 0 && errno != EINTR) {
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        // Commands and cron of this iteration read expiry time from here
+        ServerClock::update(now);
+        if (now >= next_cron) {
+            command_handler.serverCron();
+            next_cron = now + CommandHandler::CRON_INTERVAL;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wakeup_fd) {
+                uint64_t value;
+                while (read(wakeup_fd, &value, sizeof(value)) > 0) {}
+            } else if (fd == listen_fd) {
+                acceptConnections();
+            } else {
+                handleClientEvent(fd, events[i].events);
+            }
+        }
+        serviceReadyClients();
+    }
+
+    connection_manager.stopAllConnections();
+    ServerClock::stopCaching();
+}
+
+void EventLoop::stop() {
+    stop_requested = true;
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeup_fd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void EventLoop::acceptConnections() {
+    while (true) {
+        sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+
+        int client_socket = accept4(listen_fd, (sockaddr*)&client_addr, &client_len,
+                                    SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK && !stop_requested) {
+                std::cerr << "Accept failed: " << strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        // Check connection limit using ConnectionManager
+        if (!connection_manager.canAcceptNewConnection()) {
+            static const char error[] = "-ERR max number of clients reached\r\n";
+            ssize_t ignored = send(client_socket, error, sizeof(error) - 1, MSG_NOSIGNAL);
+            (void)ignored;
+            std::cerr << "Maximum connections reached, rejecting client" << std::endl;
+            close(client_socket);
+            continue;
+        }
+
+        int nodelay = 1;
+        setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        char client_ip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+        int client_port = ntohs(client_addr.sin_port);
+
+        connection_manager.addConnection(client_socket, client_ip, client_port);
+
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = client_socket;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_socket, &ev) == -1) {
+            std::cerr << "Failed to register client: " << strerror(errno) << std::endl;
+            connection_manager.removeConnection(client_socket);
+            continue;
+        }
+
+        std::cout << "New Redis connection from: " << client_ip << ":" << client_port
+                  << " (Active: " << connection_manager.getActiveConnections() << ")" << std::endl;
+    }
+}
+
+void EventLoop::handleClientEvent(int client_socket, uint32_t events) {
+    ClientConnection* connection = connection_manager.getConnection(client_socket);
+    if (!connection) return;
+
+    if (events & EPOLLERR) {
+        closeConnection(client_socket);
+        return;
+    }
+
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+        connection->markReadable();
+    }
+    serviceClient(client_socket, *connection);
+}
+
+void EventLoop::serviceClient(int client_socket, ClientConnection& connection) {
+    // Whatever an earlier batch left behind when the socket was full goes
+    // first: once the peer has read it, a paused pipeline can continue
+    if (connection.hasPendingOutput() && !connection.flushOutput()) {
+        closeConnection(client_socket);
+        return;
+    }
+
+    // A client whose replies are not being read gets neither reads nor
+    // command execution until they drain (EPOLLOUT brings it back)
+    bool peer_open = true;
+    if (connection.canRead()) {
+        peer_open = connection.readAvailable();
+    }
+    connection.processInput(command_handler);
+
+    // One send for every reply produced by this read batch
+    if (connection.hasPendingOutput() && !connection.flushOutput()) {
+        closeConnection(client_socket);
+        return;
+    }
+
+    if (!peer_open || connection.shouldClose()) {
+        closeConnection(client_socket);
+    } else if (connection.needsService()) {
+        ready_clients.push_back(client_socket);
+    }
+}
+
+void EventLoop::serviceReadyClients() {
+    if (ready_clients.empty()) return;
+
+    // A client may have queued itself from an event and from a previous
+    // pass; serve it once. Those that still have work queue up again.
+    std::vector<int> clients;
+    clients.swap(ready_clients);
+    std::sort(clients.begin(), clients.end());
+    clients.erase(std::unique(clients.begin(), clients.end()), clients.end());
+    for (int client_socket : clients) {
+        ClientConnection* connection = connection_manager.getConnection(client_socket);
+        if (connection) serviceClient(client_socket, *connection);
+    }
+}
+
+void EventLoop::closeConnection(int client_socket) {
+    // Closing the descriptor also removes it from the epoll set
+    connection_manager.removeConnection(client_socket);
+}
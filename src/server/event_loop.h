@@ -0,0 +1,61 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include "io_loop.h"
+#include "connection_manager.h"
+#include "redis/command_handler.h"
+
+// Non-blocking epoll reactor. Accepts clients from a listening socket and
+// serves all of them from the thread that calls run(). Client sockets are
+// registered once, edge-triggered, for both reads and writes. A client that
+// still has input after its per-event read budget is queued for another
+// pass, so one busy client is served in turns with the others.
+class EventLoop : public IOLoop {
+private:
+    static const int MAX_EVENTS = 256;
+
+    int listen_fd;
+    int epoll_fd = -1;
+    int wakeup_fd = -1;
+    std::atomic<bool> stop_requested{false};
+
+    CommandHandler& command_handler;
+    ConnectionManager& connection_manager;
+
+    std::vector<int> ready_clients;   // served again without waiting for an event
+
+    void acceptConnections();
+    void handleClientEvent(int client_socket, uint32_t events);
+    void serviceClient(int client_socket, ClientConnection& connection);
+    void serviceReadyClients();
+    void closeConnection(int client_socket);
+
+public:
+    EventLoop(int listen_fd, CommandHandler& handler, ConnectionManager& connections);
+    ~EventLoop() override;
+
+    // Prevent copying
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // Serve events until stop() is called; closes every client on return
+    void run() override;
+    // Thread-safe: wakes the loop and makes run() return
+    void stop() override;
+    IOBackend getBackend() const override { return IOBackend::EPOLL; }
+
+    static bool setNonBlocking(int fd);
+};
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,21 @@
+#ifndef IO_LOOP_H
+#define IO_LOOP_H
+
+// Network backends a reactor can run on
+enum class IOBackend {
+    EPOLL,
+    IO_URING
+};
+
+// Common interface of the reactor backends: serve clients from the thread
+// that calls run() until another thread calls stop()
+class IOLoop {
+public:
+    virtual ~IOLoop() = default;
+
+    virtual void run() = 0;
+    virtual void stop() = 0;
+    virtual IOBackend getBackend() const = 0;
+};
+
+#endif // IO_LOOP_H
@@ -0,0 +1,60 @@
+#include "query_buffer.h"
+#include <algorithm>
+
+char* QueryBuffer::prepareWrite(size_t min_bytes) {
+    if (writableBytes() >= min_bytes) {
+        return data.get() + write_pos;
+    }
+
+    size_t unread = size();
+    if (unread + min_bytes <= capacity) {
+        // Enough room overall: slide the unread bytes to the front
+        if (unread > 0) memmove(data.get(), data.get() + read_pos, unread);
+        read_pos = 0;
+        write_pos = unread;
+    } else {
+        size_t new_capacity = capacity == 0 ? INITIAL_CAPACITY : capacity * 2;
+        while (new_capacity < unread + min_bytes) new_capacity *= 2;
+        // Doubling past the limit would only allocate for a client that
+        // is about to be dropped
+        new_capacity = std::max(std::min(new_capacity, max_size), unread + min_bytes);
+        reallocate(new_capacity);
+    }
+    return data.get() + write_pos;
+}
+
+void QueryBuffer::append(const char* bytes, size_t len) {
+    memcpy(prepareWrite(len), bytes, len);
+    commitWrite(len);
+}
+
+void QueryBuffer::consume(size_t n) {
+    read_pos += n;
+    if (read_pos >= write_pos) {
+        // Everything parsed: rewind for free instead of moving bytes later
+        read_pos = write_pos = 0;
+    }
+}
+
+void QueryBuffer::shrinkIfIdle() {
+    if (empty() && capacity > INITIAL_CAPACITY) {
+        clear();
+    }
+}
+
+void QueryBuffer::clear() {
+    data.reset();
+    capacity = 0;
+    read_pos = write_pos = 0;
+}
+
+void QueryBuffer::reallocate(size_t new_capacity) {
+    // Copies only the unread bytes, which also compacts the buffer
+    std::unique_ptr<char[]> grown(new char[new_capacity]);
+    size_t unread = size();
+    if (unread > 0) memcpy(grown.get(), data.get() + read_pos, unread);
+    data = std::move(grown);
+    capacity = new_capacity;
+    read_pos = 0;
+    write_pos = unread;
+}
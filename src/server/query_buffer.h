@@ -0,0 +1,63 @@
+#ifndef QUERY_BUFFER_H
+#define QUERY_BUFFER_H
+
+#include <memory>
+#include <cstring>
+#include <string_view>
+
+// Input buffer of a connection. Bytes are appended at the write cursor and
+// consumed at the read cursor, so executing a command never moves the rest
+// of a pipeline. Unread bytes are moved to the front only when the tail
+// runs out of room, and a buffer grown by a large request is released once
+// it has been fully consumed. Growth stops at about the maximum size; the
+// connection checks overLimit() and drops a client that goes past it.
+class QueryBuffer {
+public:
+    // Redis's default client-query-buffer-limit
+    static const size_t DEFAULT_MAX_SIZE = 1024 * 1024 * 1024;
+
+private:
+    static const size_t INITIAL_CAPACITY = 16 * 1024;
+
+    std::unique_ptr<char[]> data;
+    size_t capacity = 0;
+    size_t read_pos = 0;
+    size_t write_pos = 0;
+    size_t max_size = DEFAULT_MAX_SIZE;
+
+    void reallocate(size_t new_capacity);
+
+public:
+    QueryBuffer() = default;
+
+    // Prevent copying
+    QueryBuffer(const QueryBuffer&) = delete;
+    QueryBuffer& operator=(const QueryBuffer&) = delete;
+
+    // Returns room for at least min_bytes after the write cursor; the
+    // caller fills up to writableBytes() of it and calls commitWrite()
+    char* prepareWrite(size_t min_bytes);
+    void commitWrite(size_t n) { write_pos += n; }
+    size_t writableBytes() const { return capacity - write_pos; }
+
+    void append(const char* bytes, size_t len);
+
+    // Unread bytes; valid until the next prepareWrite()/append()
+    std::string_view readable() const { return std::string_view(data.get() + read_pos, write_pos - read_pos); }
+    void consume(size_t n);
+
+    // Drop the allocation if it is empty and larger than a normal read
+    void shrinkIfIdle();
+    // Drop every unread byte and the allocation
+    void clear();
+
+    void setMaxSize(size_t bytes) { max_size = bytes; }
+    size_t getMaxSize() const { return max_size; }
+    bool overLimit() const { return size() > max_size; }
+
+    size_t size() const { return write_pos - read_pos; }
+    bool empty() const { return read_pos == write_pos; }
+    size_t getCapacity() const { return capacity; }
+};
+
+#endif // QUERY_BUFFER_H
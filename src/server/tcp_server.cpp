@@ -1,144 +1,216 @@
 #include "tcp_server.h"
+#include <pthread.h>
+#include <sched.h>
 
-TCPServer::TCPServer(int port) : port(port), running(false) {
-    server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd == -1) {
-        throw std::runtime_error("Failed to create socket: " + std::string(strerror(errno)));
-    }
-    
-    // Set socket option to reuse address
-    int opt = 1;
-    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt))) {
-        close(server_fd);
-        throw std::runtime_error("Failed to set socket options: " + std::string(strerror(errno)));
-    }
-    
-    std::cout << "TCP Server initialized on port " << port << std::endl;
+TCPServer::TCPServer(int port) : TCPServer(ServerConfig{port}) {}
+
+TCPServer::TCPServer(const ServerConfig& server_config)
+    : config(server_config), running(false), database(server_config.database_shards) {
+    if (config.reactors == 0) config.reactors = 1;
+    database.setMaxMemory(config.maxmemory, config.maxmemory_policy);
+    selectBackend();
+    server_fd = createListenSocket();
+
+    std::cout << "TCP Server initialized on port " << config.port << std::endl;
 }
 
 TCPServer::~TCPServer() {
     stop();
+    releaseReactors();
     if (server_fd != -1) {
         close(server_fd);
     }
 }
 
-void TCPServer::start() {
-    if (running) {
-        std::cout << "Server is already running" << std::endl;
-        return;
+int TCPServer::createListenSocket() {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to create socket: " + std::string(strerror(errno)));
+    }
+
+    // Set socket option to reuse address
+    int opt = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt))) {
+        close(fd);
+        throw std::runtime_error("Failed to set socket options: " + std::string(strerror(errno)));
     }
 
+    // With several reactors every one of them listens on the same port and
+    // the kernel spreads incoming connections across the listeners
+    if (config.reactors > 1 && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt))) {
+        close(fd);
+        throw std::runtime_error("Failed to set SO_REUSEPORT: " + std::string(strerror(errno)));
+    }
+
+    return fd;
+}
+
+void TCPServer::bindAndListen(int fd) {
     sockaddr_in address;
     address.sin_family = AF_INET;
     address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(port);
+    address.sin_port = htons(config.port);
 
-    if (bind(server_fd, (sockaddr*)&address, sizeof(address)) < 0) {
+    if (bind(fd, (sockaddr*)&address, sizeof(address)) < 0) {
         throw std::runtime_error("Bind failed: " + std::string(strerror(errno)));
     }
 
-    if (listen(server_fd, ConnectionManager::MAX_CLIENTS) < 0) {  // Use ConnectionManager constant
+    if (listen(fd, LISTEN_BACKLOG) < 0) {
         throw std::runtime_error("Listen failed: " + std::string(strerror(errno)));
     }
 
-    running = true;
-    std::cout << "Redis Mock Server started on port " << port << std::endl;
-    std::cout << "Max connections: " << ConnectionManager::MAX_CLIENTS << std::endl;  // Use ConnectionManager constant
-    std::cout << "Usage: redis-cli -p " << port << " or telnet localhost " << port << std::endl;
+    if (!EventLoop::setNonBlocking(fd)) {
+        throw std::runtime_error("Failed to make socket non-blocking: " + std::string(strerror(errno)));
+    }
 
-    acceptConnections();
+    // Port 0 asks the kernel for a free port; the other reactors must share it
+    if (config.port == 0) {
+        socklen_t len = sizeof(address);
+        if (getsockname(fd, (sockaddr*)&address, &len) == 0) {
+            config.port = ntohs(address.sin_port);
+        }
+    }
 }
 
-void TCPServer::stop() {
-    if (!running) return;
-    
-    std::cout << "Stopping Redis server..." << std::endl;
-    running = false;
-    
-    // Close the server socket to break out of accept()
-    if (server_fd != -1) {
-        shutdown(server_fd, SHUT_RDWR);
-    }    
-    // Stop all connections through ConnectionManager
-    connection_manager.stopAllConnections();
-    
-}
+void TCPServer::setupReactors() {
+    std::lock_guard<std::mutex> lock(loop_mutex);
+    for (size_t i = 0; i < config.reactors; ++i) {
+        reactors.push_back(std::make_unique<Reactor>());
+        Reactor& reactor = *reactors.back();
+
+        if (i == 0) {
+            reactor.listen_fd = server_fd;
+        } else {
+            reactor.listen_fd = createListenSocket();
+            bindAndListen(reactor.listen_fd);
+        }
 
-void TCPServer::acceptConnections() {
-    while (running) {
-        sockaddr_in client_addr;
-        socklen_t client_len = sizeof(client_addr);
-        
-        int client_socket = accept(server_fd, (sockaddr*)&client_addr, &client_len);
-        
-        if (client_socket < 0) {
-            if (running) {
-                std::cerr << "Accept failed: " << strerror(errno) << std::endl;
-            }
-            continue;
+        reactor.connections = std::make_unique<ConnectionManager>(config.max_clients, config.client_limits);
+        reactor.handler = std::make_unique<CommandHandler>(database, commands_processed);
+        if (config.backend == IOBackend::IO_URING) {
+            reactor.loop = std::make_unique<UringEventLoop>(reactor.listen_fd, *reactor.handler, *reactor.connections);
+        } else {
+            reactor.loop = std::make_unique<EventLoop>(reactor.listen_fd, *reactor.handler, *reactor.connections);
         }
+    }
+}
 
-        // Check connection limit using ConnectionManager
-        if (!connection_manager.canAcceptNewConnection()) {
-            std::cerr << "Maximum connections reached, rejecting client" << std::endl;
-            close(client_socket);
-            continue;
+void TCPServer::selectBackend() {
+    if (config.backend == IOBackend::IO_URING && !UringEventLoop::isSupported()) {
+        std::cerr << "io_uring is not available on this kernel, using epoll" << std::endl;
+        config.backend = IOBackend::EPOLL;
+    }
+}
+
+void TCPServer::releaseReactors() {
+    std::lock_guard<std::mutex> lock(loop_mutex);
+    for (auto& reactor : reactors) {
+        if (reactor->thread.joinable()) {
+            reactor->loop->stop();
+            reactor->thread.join();
+        }
+        if (reactor->listen_fd != -1 && reactor->listen_fd != server_fd) {
+            close(reactor->listen_fd);
         }
+    }
+    reactors.clear();
+}
+
+void TCPServer::start() {
+    if (running) {
+        std::cout << "Server is already running" << std::endl;
+        return;
+    }
+
+    bindAndListen(server_fd);
+    raiseFileDescriptorLimit();
 
-        char client_ip[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
-        std::cout << "New Redis connection from: " << client_ip << ":" << ntohs(client_addr.sin_port) 
-                  << " (Active: " << connection_manager.getActiveConnections() + 1 << ")" << std::endl;
-
-        // Handle client through ConnectionManager
-        try {
-            connection_manager.addConnection([this, client_socket]() {
-                handleClient(client_socket);
-            });
-        } catch (const std::exception& e) {
-            std::cerr << "Failed to add connection: " << e.what() << std::endl;
-            close(client_socket);
+    try {
+        setupReactors();
+    } catch (...) {
+        releaseReactors();
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(loop_mutex);
+        loop_active = true;
+    }
+    running = true;
+    std::cout << "Redis Mock Server started on port " << config.port << std::endl;
+    std::cout << "Reactors: " << config.reactors
+              << " (" << (config.backend == IOBackend::IO_URING ? "io_uring" : "epoll") << ")"
+              << ", max connections per reactor: " << config.max_clients << std::endl;
+    std::cout << "Usage: redis-cli -p " << config.port << " or telnet localhost " << config.port << std::endl;
+
+    for (size_t i = 1; i < reactors.size(); ++i) {
+        IOLoop* loop = reactors[i]->loop.get();
+        reactors[i]->thread = std::thread([loop]() { loop->run(); });
+        if (config.cpu_affinity) {
+            pinToCpu(reactors[i]->thread.native_handle(), i);
         }
     }
+    if (config.cpu_affinity) {
+        pinToCpu(pthread_self(), 0);
+    }
+
+    reactors[0]->loop->run();
+
+    // Reactor 0 only returns on stop(); bring the other reactors down too
+    for (size_t i = 1; i < reactors.size(); ++i) {
+        reactors[i]->loop->stop();
+        if (reactors[i]->thread.joinable()) reactors[i]->thread.join();
+    }
+    running = false;
+
+    {
+        std::lock_guard<std::mutex> lock(loop_mutex);
+        loop_active = false;
+    }
+    loop_finished.notify_all();
+}
+
+void TCPServer::stop() {
+    if (!running.exchange(false)) return;
+
+    std::cout << "Stopping Redis server..." << std::endl;
+
+    // Wake every event loop and wait until all clients have been closed
+    std::unique_lock<std::mutex> lock(loop_mutex);
+    for (auto& reactor : reactors) {
+        reactor->loop->stop();
+    }
+    loop_finished.wait(lock, [this]() { return !loop_active; });
 }
 
 size_t TCPServer::getActiveConnections() {
-    return connection_manager.getActiveConnections();
+    std::lock_guard<std::mutex> lock(loop_mutex);
+    size_t total = 0;
+    for (const auto& reactor : reactors) {
+        total += reactor->connections->getActiveConnections();
+    }
+    return total;
 }
 
-void TCPServer::handleClient(int client_socket) {
-    std::string buffer;            // persistent buffer
-    std::vector<char> tmp(BUFFER_SIZE);
-    RESPParser parser;             // Necesitas una instancia del parser
-
-    while (running) {
-        ssize_t n = read(client_socket, tmp.data(), tmp.size());
-        if (n <= 0) break;
-
-        buffer.append(tmp.data(), n);
-
-        while (true) {
-            std::vector<std::string> args;
-            size_t consumed = 0;
-            
-            // Usar la instancia del parser en lugar del método estático
-            RESPValue resp_value;
-            if (!parser.parse(buffer, resp_value, consumed))break; // msg not complete
-            
-            // Convert RESPValue to vector of strings
-            args = parser.toStringVector(resp_value);
-            
-            logCommand(args, consumed);
-            
-            // Remove processed data from buffer
-            buffer.erase(0, consumed);
-
-            // Process the command
-            std::string resp = command_handler.processCommand(args);
-            if (!resp.empty())
-                send(client_socket, resp.c_str(), resp.size(), 0);
-        }
+void TCPServer::pinToCpu(std::thread::native_handle_type thread, size_t index) {
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(index % cores, &cpus);
+    int rc = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+    if (rc != 0) {
+        std::cerr << "Could not pin reactor " << index << ": " << strerror(rc) << std::endl;
     }
-    close(client_socket);
-}
\ No newline at end of file
+}
+
+void TCPServer::raiseFileDescriptorLimit() {
+    // Every client needs a descriptor, plus a few for each reactor
+    rlim_t wanted = config.max_clients * config.reactors + 32 + 4 * config.reactors;
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == -1 || limit.rlim_cur >= wanted) return;
+
+    limit.rlim_cur = std::min(wanted, limit.rlim_max);
+    if (setrlimit(RLIMIT_NOFILE, &limit) == -1) {
+        std::cerr << "Could not raise open file limit: " << strerror(errno) << std::endl;
+    }
+}
@@ -3,30 +3,74 @@
 
 #include <iostream>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
 #include <unistd.h>
 #include <arpa/inet.h>
+#include <sys/resource.h>
 #include "connection_manager.h"
+#include "event_loop.h"
+#include "uring_event_loop.h"
 #include "resp/resp_parser.h"
 #include "redis/command_handler.h"
+#include "redis/database/redis_database.h"
 #include "utils/logger.h"
 
+struct ServerConfig {
+    int port = 6379;
+    size_t reactors = 1;          // event loop threads, each with its own listener
+    bool cpu_affinity = false;    // pin reactor i to CPU i (mod core count)
+    size_t max_clients = ConnectionManager::DEFAULT_MAX_CLIENTS;  // per reactor
+    ClientLimits client_limits{}; // buffer sizes past which a client is dropped
+    IOBackend backend = IOBackend::EPOLL;  // io_uring falls back to epoll when unavailable
+    size_t database_shards = RedisDatabase::DEFAULT_SHARD_COUNT;  // rounded up to a power of two
+    size_t maxmemory = 0;         // bytes of keyspace; 0 for no limit
+    EvictionPolicy maxmemory_policy = EvictionPolicy::NOEVICTION;
+};
+
 class TCPServer {
 private:
-    static const size_t BUFFER_SIZE = 4096;
-    const size_t MAX_BUFFER_SIZE = 1024 * 1024; // 1MB máximo
+    static const int LISTEN_BACKLOG = 511;
+
+    // One listening socket, epoll set and command handler per thread.
+    // Reactor 0 runs on the thread that calls start().
+    struct Reactor {
+        int listen_fd = -1;
+        std::unique_ptr<ConnectionManager> connections;
+        std::unique_ptr<CommandHandler> handler;
+        std::unique_ptr<IOLoop> loop;
+        std::thread thread;
+    };
 
     int server_fd;
-    int port;
+    ServerConfig config;
     std::atomic<bool> running;
-    
-    // Redis-like storage
-    ConnectionManager connection_manager; 
-    CommandHandler command_handler;
-    void acceptConnections();
-    void handleClient(int client_socket);
-    
+
+    // Set while start() is inside the event loop; stop() waits on it
+    std::mutex loop_mutex;
+    std::condition_variable loop_finished;
+    bool loop_active = false;
+
+    // Redis-like storage shared by every reactor
+    RedisDatabase database;
+    // INFO's total_commands_processed, counted by every reactor's handler
+    std::atomic<uint64_t> commands_processed{0};
+    std::vector<std::unique_ptr<Reactor>> reactors;
+
+    int createListenSocket();
+    void bindAndListen(int fd);
+    void setupReactors();
+    void selectBackend();
+    void releaseReactors();
+    void pinToCpu(std::thread::native_handle_type thread, size_t index);
+    void raiseFileDescriptorLimit();
+
 public:
     TCPServer(int port = 6379);
+    explicit TCPServer(const ServerConfig& config);
     ~TCPServer();
 
     // Prevent copying
@@ -36,8 +80,10 @@ public:
     void start();
     void stop();
     bool isRunning() const { return running; }
-    int getPort() const { return port; }
+    int getPort() const { return config.port; }
+    size_t getReactorCount() const { return config.reactors; }
+    IOBackend getBackend() const { return config.backend; }
     size_t getActiveConnections();
 };
 
-#endif // TCP_SERVER_H
\ No newline at end of file
+#endif // TCP_SERVER_H
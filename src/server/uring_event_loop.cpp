@@ -0,0 +1,601 @@
+#include "uring_event_loop.h"
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <csignal>
+#include <ctime>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include "utils/server_clock.h"
+
+namespace {
+
+int uringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int uringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, const void* arg, size_t arg_size) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+int uringRegister(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+void* mapShared(size_t size, int fd, off_t offset) {
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+template <typename T>
+T* ringField(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+} // namespace
+
+UringEventLoop::UringEventLoop(int listen_fd, CommandHandler& handler, ConnectionManager& connections)
+    : listen_fd(listen_fd), command_handler(handler), connection_manager(connections) {
+    // Blocking on purpose: io_uring parks the read until the eventfd fires
+    wakeup_fd = eventfd(0, EFD_CLOEXEC);
+    if (wakeup_fd == -1) {
+        throw std::runtime_error("Failed to create wakeup eventfd: " + std::string(strerror(errno)));
+    }
+
+    try {
+        setupRing();
+        setupBuffers();
+    } catch (...) {
+        releaseRing();
+        close(wakeup_fd);
+        throw;
+    }
+}
+
+UringEventLoop::~UringEventLoop() {
+    releaseRing();
+    if (wakeup_fd != -1) close(wakeup_fd);
+}
+
+void UringEventLoop::setupRing() {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN;
+    params.cq_entries = RING_ENTRIES * 4;
+    ring_fd = uringSetup(RING_ENTRIES, &params);
+    if (ring_fd < 0 && errno == EINVAL) {
+        // Older kernels do not know COOP_TASKRUN
+        params = io_uring_params{};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = RING_ENTRIES * 4;
+        ring_fd = uringSetup(RING_ENTRIES, &params);
+    }
+    if (ring_fd < 0) {
+        throw std::runtime_error("io_uring_setup failed: " + std::string(strerror(errno)));
+    }
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+
+    sq_ring = mapShared(sq_ring_size, ring_fd, IORING_OFF_SQ_RING);
+    cq_ring = single_mmap ? sq_ring : mapShared(cq_ring_size, ring_fd, IORING_OFF_CQ_RING);
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe*>(mapShared(sqes_size, ring_fd, IORING_OFF_SQES));
+    if (!sq_ring || !cq_ring || !sqes) {
+        throw std::runtime_error("Failed to map io_uring: " + std::string(strerror(errno)));
+    }
+
+    sq_entries = params.sq_entries;
+    sq_head = ringField<unsigned>(sq_ring, params.sq_off.head);
+    sq_tail = ringField<unsigned>(sq_ring, params.sq_off.tail);
+    sq_mask = ringField<unsigned>(sq_ring, params.sq_off.ring_mask);
+    cq_head = ringField<unsigned>(cq_ring, params.cq_off.head);
+    cq_tail = ringField<unsigned>(cq_ring, params.cq_off.tail);
+    cq_mask = ringField<unsigned>(cq_ring, params.cq_off.ring_mask);
+    cqes = ringField<io_uring_cqe>(cq_ring, params.cq_off.cqes);
+
+    // Slot i of the submission array always points at SQE i
+    unsigned* sq_array = ringField<unsigned>(sq_ring, params.sq_off.array);
+    for (unsigned i = 0; i < sq_entries; ++i) {
+        sq_array[i] = i;
+    }
+    sq_local_tail = *sq_tail;
+}
+
+void UringEventLoop::setupBuffers() {
+    buf_ring_size = BUFFER_COUNT * sizeof(io_uring_buf);
+    void* ring = mmap(nullptr, buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    buffers_size = static_cast<size_t>(BUFFER_COUNT) * BUFFER_SIZE;
+    void* data = mmap(nullptr, buffers_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    buf_ring = ring == MAP_FAILED ? nullptr : static_cast<io_uring_buf*>(ring);
+    buffers = data == MAP_FAILED ? nullptr : static_cast<char*>(data);
+    if (!buf_ring || !buffers) {
+        throw std::runtime_error("Failed to allocate receive buffers: " + std::string(strerror(errno)));
+    }
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring);
+    reg.ring_entries = BUFFER_COUNT;
+    reg.bgid = BUFFER_GROUP;
+    if (uringRegister(ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        throw std::runtime_error("Failed to register buffer ring: " + std::string(strerror(errno)));
+    }
+
+    for (unsigned bid = 0; bid < BUFFER_COUNT; ++bid) {
+        recycleBuffer(static_cast<uint16_t>(bid));
+    }
+}
+
+void UringEventLoop::releaseRing() {
+    if (ring_fd != -1) {
+        close(ring_fd);
+        ring_fd = -1;
+    }
+    if (sqes) munmap(sqes, sqes_size);
+    if (cq_ring && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+    if (sq_ring) munmap(sq_ring, sq_ring_size);
+    if (buffers) munmap(buffers, buffers_size);
+    if (buf_ring) munmap(buf_ring, buf_ring_size);
+    sqes = nullptr;
+    cq_ring = sq_ring = nullptr;
+    buffers = nullptr;
+    buf_ring = nullptr;
+}
+
+bool UringEventLoop::isSupported() {
+    // Multishot recv arrived in 6.0; the other features are older
+    utsname info;
+    int major = 0, minor = 0;
+    if (uname(&info) != 0 || sscanf(info.release, "%d.%d", &major, &minor) != 2 || major < 6) {
+        return false;
+    }
+
+    io_uring_params params{};
+    int fd = uringSetup(4, &params);
+    if (fd < 0) return false;
+
+    const unsigned probe_ops = 256;
+    std::vector<char> probe_storage(sizeof(io_uring_probe) + probe_ops * sizeof(io_uring_probe_op), 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(probe_storage.data());
+    bool supported = uringRegister(fd, IORING_REGISTER_PROBE, probe, probe_ops) == 0;
+    for (int op : {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SEND, IORING_OP_READ,
+                   IORING_OP_ASYNC_CANCEL, IORING_OP_CLOSE}) {
+        supported = supported && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    if (supported) {
+        void* ring = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+        reg.ring_entries = 8;
+        reg.bgid = BUFFER_GROUP;
+        supported = ring != MAP_FAILED && uringRegister(fd, IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+        if (ring != MAP_FAILED) {
+            uringRegister(fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+            munmap(ring, 4096);
+        }
+    }
+
+    close(fd);
+    return supported;
+}
+
+void UringEventLoop::reserveSqes(unsigned count) {
+    // Linked requests must go to the kernel in the same submission
+    if (sq_local_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) + count > sq_entries) {
+        submitAndWait(0);
+    }
+}
+
+io_uring_sqe* UringEventLoop::getSqe() {
+    reserveSqes(1);
+    io_uring_sqe* sqe = &sqes[sq_local_tail & *sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sq_local_tail++;
+    pending_submissions++;
+    return sqe;
+}
+
+int UringEventLoop::submitAndWait(unsigned wait_nr, unsigned timeout_ms) {
+    __atomic_store_n(sq_tail, sq_local_tail, __ATOMIC_RELEASE);
+
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int ret;
+    if (timeout_ms > 0) {
+        __kernel_timespec ts{};
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (timeout_ms % 1000) * 1000000LL;
+        io_uring_getevents_arg arg{};
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+        ret = uringEnter(ring_fd, pending_submissions, wait_nr, flags | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    } else {
+        ret = uringEnter(ring_fd, pending_submissions, wait_nr, flags, nullptr, _NSIG / 8);
+    }
+
+    if (ret >= 0) {
+        pending_submissions -= std::min<unsigned>(pending_submissions, ret);
+    }
+    return ret;
+}
+
+void UringEventLoop::run() {
+    armWakeup();
+    armAccept();
+
+    auto next_cron = std::chrono::steady_clock::now() + CommandHandler::CRON_INTERVAL;
+
+    while (!stop_requested) {
+        // Wake up for the next cron tick; a zero timeout would mean none
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_cron - std::chrono::steady_clock::now());
+        unsigned timeout_ms = static_cast<unsigned>(std::max<long long>(1, wait.count()));
+        if (submitAndWait(1, timeout_ms) < 0 && errno != EINTR && errno != EBUSY && errno != ETIME) {
+            std::cerr << "io_uring_enter failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        // Commands and cron of this iteration read expiry time from here
+        ServerClock::update(now);
+        if (now >= next_cron) {
+            command_handler.serverCron();
+            next_cron = now + CommandHandler::CRON_INTERVAL;
+        }
+        processCompletions();
+    }
+
+    shutdownAll();
+    connection_manager.stopAllConnections();
+    ServerClock::stopCaching();
+}
+
+void UringEventLoop::stop() {
+    stop_requested = true;
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeup_fd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void UringEventLoop::processCompletions() {
+    unsigned head = *cq_head;
+    unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+
+    while (head != tail) {
+        io_uring_cqe cqe = cqes[head & *cq_mask];
+        head++;
+
+        uint64_t id = cqe.user_data >> 8;
+        switch (static_cast<Op>(cqe.user_data & 0xff)) {
+            case Op::ACCEPT: handleAccept(cqe); break;
+            case Op::RECV: handleRecv(id, cqe); break;
+            case Op::SEND: handleSend(id, cqe); break;
+            case Op::WAKEUP:
+                inflight--;
+                if (!stop_requested) armWakeup();
+                break;
+            case Op::CANCEL:
+            case Op::REJECT:
+                inflight--;
+                break;
+        }
+    }
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+    // One send per connection for everything this batch produced
+    for (uint64_t id : dirty_connections) {
+        auto it = connections.find(id);
+        if (it == connections.end()) continue;
+        it->second.dirty = false;
+        queueSend(id);
+    }
+    dirty_connections.clear();
+}
+
+void UringEventLoop::armAccept() {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = encode(0, Op::ACCEPT);
+    inflight++;
+    accept_armed = true;
+}
+
+void UringEventLoop::armWakeup() {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wakeup_fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&wakeup_value);
+    sqe->len = sizeof(wakeup_value);
+    sqe->off = static_cast<uint64_t>(-1);
+    sqe->user_data = encode(0, Op::WAKEUP);
+    inflight++;
+}
+
+void UringEventLoop::armRecv(uint64_t id, Connection& connection) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = connection.fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = encode(id, Op::RECV);
+    connection.recv_active = true;
+    inflight++;
+}
+
+void UringEventLoop::submitSend(uint64_t id, Connection& connection) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = connection.fd;
+    sqe->addr = reinterpret_cast<uint64_t>(connection.sending.data() + connection.send_offset);
+    sqe->len = connection.sending.size() - connection.send_offset;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = encode(id, Op::SEND);
+    connection.send_active = true;
+    inflight++;
+}
+
+void UringEventLoop::submitCancel(uint64_t target) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = target;
+    sqe->user_data = encode(0, Op::CANCEL);
+    inflight++;
+}
+
+void UringEventLoop::recycleBuffer(uint16_t bid) {
+    io_uring_buf* buf = &buf_ring[buf_tail & (BUFFER_COUNT - 1)];
+    buf->addr = reinterpret_cast<uint64_t>(buffers + static_cast<size_t>(bid) * BUFFER_SIZE);
+    buf->len = BUFFER_SIZE;
+    buf->bid = bid;
+    buf_tail++;
+    __atomic_store_n(&buf_ring[0].resv, buf_tail, __ATOMIC_RELEASE);
+}
+
+void UringEventLoop::handleAccept(const io_uring_cqe& cqe) {
+    if (!(cqe.flags & IORING_CQE_F_MORE)) {
+        inflight--;
+        accept_armed = false;
+    }
+
+    if (cqe.res >= 0) {
+        int client_socket = cqe.res;
+        if (stop_requested) {
+            close(client_socket);
+        } else if (!connection_manager.canAcceptNewConnection()) {
+            rejectClient(client_socket);
+        } else {
+            int nodelay = 1;
+            setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+            sockaddr_in client_addr{};
+            socklen_t client_len = sizeof(client_addr);
+            getpeername(client_socket, (sockaddr*)&client_addr, &client_len);
+            char client_ip[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+            int client_port = ntohs(client_addr.sin_port);
+
+            ClientConnection* client = connection_manager.addConnection(client_socket, client_ip, client_port);
+            client->setStreamReplies(false);  // every send goes through the ring
+
+            uint64_t id = next_connection_id++;
+            Connection& connection = connections[id];
+            connection.fd = client_socket;
+            connection.client = client;
+            armRecv(id, connection);
+
+            std::cout << "New Redis connection from: " << client_ip << ":" << client_port
+                      << " (Active: " << connection_manager.getActiveConnections() << ")" << std::endl;
+        }
+    } else if (cqe.res != -ECANCELED && !stop_requested) {
+        std::cerr << "Accept failed: " << strerror(-cqe.res) << std::endl;
+    }
+
+    if (!accept_armed && !stop_requested) {
+        armAccept();
+    }
+}
+
+void UringEventLoop::handleRecv(uint64_t id, const io_uring_cqe& cqe) {
+    bool more = cqe.flags & IORING_CQE_F_MORE;
+    if (!more) inflight--;
+
+    bool has_buffer = cqe.flags & IORING_CQE_F_BUFFER;
+    uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+
+    auto it = connections.find(id);
+    if (it == connections.end()) {
+        if (has_buffer) recycleBuffer(bid);
+        return;
+    }
+    Connection& connection = it->second;
+    if (!more) connection.recv_active = false;
+
+    if (!connection.client) {
+        if (has_buffer) recycleBuffer(bid);
+        releaseIfIdle(id);
+        return;
+    }
+
+    if (cqe.res > 0 && has_buffer) {
+        connection.client->appendInput(buffers + static_cast<size_t>(bid) * BUFFER_SIZE, cqe.res);
+        recycleBuffer(bid);
+        connection.client->processInput(command_handler);
+        if (!connection.dirty) {
+            connection.dirty = true;
+            dirty_connections.push_back(id);
+        }
+    } else if (has_buffer) {
+        recycleBuffer(bid);
+    }
+
+    // The peer is not reading its replies: stop receiving until a send
+    // completes. Data already in flight is kept but not executed.
+    if (connection.client->isOutputBacklogged() && !connection.recv_paused) {
+        connection.recv_paused = true;
+        if (connection.recv_active) submitCancel(encode(id, Op::RECV));
+    }
+
+    // Only a paused recv is ever cancelled while the client is open
+    bool peer_done = cqe.res == 0 ||
+                     (cqe.res < 0 && cqe.res != -ENOBUFS && cqe.res != -ECANCELED);
+    if (peer_done || connection.client->shouldClose()) {
+        // Peer closed, failed or broke the protocol: answer what it
+        // already sent, then close
+        connection.close_after_send = true;
+        if (!connection.dirty) {
+            connection.dirty = true;
+            dirty_connections.push_back(id);
+        }
+        return;
+    }
+
+    // Multishot recv stops when the buffer ring runs dry; re-arm it
+    if (!connection.recv_active && !connection.recv_paused) {
+        armRecv(id, connection);
+    }
+}
+
+void UringEventLoop::handleSend(uint64_t id, const io_uring_cqe& cqe) {
+    inflight--;
+
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& connection = it->second;
+    connection.send_active = false;
+
+    if (!connection.client) {
+        releaseIfIdle(id);
+        return;
+    }
+    if (cqe.res < 0) {
+        closeConnection(id);
+        return;
+    }
+
+    connection.send_offset += cqe.res;
+    if (connection.send_offset < connection.sending.size()) {
+        submitSend(id, connection);  // short send: continue where it stopped
+        return;
+    }
+
+    connection.sending.clear();
+    connection.send_offset = 0;
+    if (connection.sending.capacity() > BUFFER_SIZE) {
+        std::string().swap(connection.sending);
+    }
+    queueSend(id);
+    resumeInput(id);
+}
+
+void UringEventLoop::queueSend(uint64_t id) {
+    Connection& connection = connections.at(id);
+    if (!connection.client || connection.send_active) return;
+
+    if (connection.client->takeOutput(connection.sending)) {
+        connection.send_offset = 0;
+        submitSend(id, connection);
+    } else if (connection.close_after_send) {
+        closeConnection(id);
+    }
+}
+
+void UringEventLoop::resumeInput(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& connection = it->second;
+    ClientConnection* client = connection.client;
+    if (!client || !connection.recv_paused || client->isOutputBacklogged()) return;
+
+    // The replies went out: run the rest of the pipeline, and receive
+    // again once that no longer backs up the output
+    client->processInput(command_handler);
+    if (client->shouldClose()) {
+        connection.close_after_send = true;
+    } else if (!client->isOutputBacklogged()) {
+        connection.recv_paused = false;
+        // A recv still active is being cancelled; its completion re-arms
+        if (!connection.recv_active) armRecv(id, connection);
+    }
+    queueSend(id);
+}
+
+void UringEventLoop::closeConnection(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end() || !it->second.client) return;
+    Connection& connection = it->second;
+
+    // Closing our descriptor does not end the multishot recv, which holds
+    // its own reference to the socket; cancel it explicitly
+    connection_manager.removeConnection(connection.fd);
+    connection.client = nullptr;
+    if (connection.recv_active) {
+        submitCancel(encode(id, Op::RECV));
+    }
+    releaseIfIdle(id);
+}
+
+void UringEventLoop::releaseIfIdle(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    const Connection& connection = it->second;
+    if (!connection.client && !connection.recv_active && !connection.send_active) {
+        connections.erase(it);
+    }
+}
+
+void UringEventLoop::rejectClient(int client_socket) {
+    static const char error[] = "-ERR max number of clients reached\r\n";
+    std::cerr << "Maximum connections reached, rejecting client" << std::endl;
+
+    // Hard link: the close runs even if the error reply could not be sent
+    reserveSqes(2);
+    io_uring_sqe* send_sqe = getSqe();
+    send_sqe->opcode = IORING_OP_SEND;
+    send_sqe->fd = client_socket;
+    send_sqe->addr = reinterpret_cast<uint64_t>(error);
+    send_sqe->len = sizeof(error) - 1;
+    send_sqe->msg_flags = MSG_NOSIGNAL;
+    send_sqe->flags = IOSQE_IO_HARDLINK;
+    send_sqe->user_data = encode(0, Op::REJECT);
+
+    io_uring_sqe* close_sqe = getSqe();
+    close_sqe->opcode = IORING_OP_CLOSE;
+    close_sqe->fd = client_socket;
+    close_sqe->user_data = encode(0, Op::REJECT);
+    inflight += 2;
+}
+
+void UringEventLoop::shutdownAll() {
+    std::vector<uint64_t> ids;
+    ids.reserve(connections.size());
+    for (const auto& entry : connections) {
+        ids.push_back(entry.first);
+    }
+    for (uint64_t id : ids) {
+        auto it = connections.find(id);
+        if (it != connections.end() && it->second.send_active) {
+            submitCancel(encode(id, Op::SEND));
+        }
+        closeConnection(id);
+    }
+    if (accept_armed) submitCancel(encode(0, Op::ACCEPT));
+    submitCancel(encode(0, Op::WAKEUP));
+
+    // The kernel may still reference our buffers until every request has
+    // completed, so wait for them before the memory goes away
+    for (int attempt = 0; inflight > 0 && attempt < 100; ++attempt) {
+        submitAndWait(1, 20);
+        processCompletions();
+    }
+}
@@ -0,0 +1,139 @@
+#ifndef URING_EVENT_LOOP_H
+#define URING_EVENT_LOOP_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <stdexcept>
+#include <linux/io_uring.h>
+#include "io_loop.h"
+#include "connection_manager.h"
+#include "redis/command_handler.h"
+
+// io_uring reactor. A multishot accept produces the clients, each client
+// has one multishot recv that picks its buffer from a provided-buffer ring,
+// and the replies produced by a batch of completions go out as a single
+// send per connection. A client whose replies back up has its recv
+// cancelled until a send completes and the output drains. Talks to the kernel through the raw system calls,
+// so no extra library is needed; use isSupported() before constructing.
+class UringEventLoop : public IOLoop {
+private:
+    static const unsigned RING_ENTRIES = 1024;
+    static const unsigned BUFFER_COUNT = 256;         // must be a power of two
+    static const unsigned BUFFER_SIZE = 16 * 1024;
+    static const uint16_t BUFFER_GROUP = 0;
+
+    // What a completion belongs to, kept in the low byte of user_data
+    enum class Op : uint8_t {
+        ACCEPT = 1,
+        RECV,
+        SEND,
+        WAKEUP,
+        CANCEL,
+        REJECT
+    };
+
+    // Backend side of a client. It outlives the ClientConnection until the
+    // kernel has finished every request that references it.
+    struct Connection {
+        int fd = -1;
+        ClientConnection* client = nullptr;
+        bool recv_active = false;
+        bool recv_paused = false;   // cancelled while the output is backlogged
+        bool send_active = false;
+        bool close_after_send = false;
+        bool dirty = false;
+        std::string sending;   // buffer owned by the in-flight send
+        size_t send_offset = 0;
+    };
+
+    int listen_fd;
+    int ring_fd = -1;
+    int wakeup_fd = -1;
+    std::atomic<bool> stop_requested{false};
+
+    CommandHandler& command_handler;
+    ConnectionManager& connection_manager;
+
+    // Ring mappings shared with the kernel
+    void* sq_ring = nullptr;
+    size_t sq_ring_size = 0;
+    void* cq_ring = nullptr;
+    size_t cq_ring_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+    unsigned sq_entries = 0;
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned sq_local_tail = 0;
+    unsigned pending_submissions = 0;
+
+    // Provided receive buffers. The ring is addressed as a plain array:
+    // in C++ the flexible array of io_uring_buf_ring does not start at
+    // offset 0, and the tail lives in the resv field of entry 0.
+    io_uring_buf* buf_ring = nullptr;
+    size_t buf_ring_size = 0;
+    char* buffers = nullptr;
+    size_t buffers_size = 0;
+    uint16_t buf_tail = 0;
+
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t next_connection_id = 1;
+    std::vector<uint64_t> dirty_connections;  // replies to send after this batch
+    size_t inflight = 0;                      // requests still owed a final completion
+    bool accept_armed = false;
+    uint64_t wakeup_value = 0;
+
+    void setupRing();
+    void setupBuffers();
+    void releaseRing();
+
+    void reserveSqes(unsigned count);
+    io_uring_sqe* getSqe();
+    int submitAndWait(unsigned wait_nr, unsigned timeout_ms = 0);
+    void processCompletions();
+
+    void armAccept();
+    void armWakeup();
+    void armRecv(uint64_t id, Connection& connection);
+    void submitSend(uint64_t id, Connection& connection);
+    void submitCancel(uint64_t target);
+    void recycleBuffer(uint16_t bid);
+
+    void handleAccept(const io_uring_cqe& cqe);
+    void handleRecv(uint64_t id, const io_uring_cqe& cqe);
+    void handleSend(uint64_t id, const io_uring_cqe& cqe);
+    void queueSend(uint64_t id);
+    void resumeInput(uint64_t id);
+    void closeConnection(uint64_t id);
+    void releaseIfIdle(uint64_t id);
+    void rejectClient(int client_socket);
+    void shutdownAll();
+
+    static uint64_t encode(uint64_t id, Op op) { return (id << 8) | static_cast<uint8_t>(op); }
+
+public:
+    UringEventLoop(int listen_fd, CommandHandler& handler, ConnectionManager& connections);
+    ~UringEventLoop() override;
+
+    // Prevent copying
+    UringEventLoop(const UringEventLoop&) = delete;
+    UringEventLoop& operator=(const UringEventLoop&) = delete;
+
+    void run() override;
+    void stop() override;
+    IOBackend getBackend() const override { return IOBackend::IO_URING; }
+
+    // True when the kernel offers everything this backend uses: multishot
+    // accept and recv, provided-buffer rings, cancel and close requests
+    static bool isSupported();
+};
+
+#endif // URING_EVENT_LOOP_H
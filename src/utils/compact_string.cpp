@@ -0,0 +1,134 @@
+#include "compact_string.h"
+#include <cstring>
+#include <new>
+#include <utility>
+
+// Doubling stops here; bigger strings grow by this much at a time
+static const size_t MAX_PREALLOC = 1024 * 1024;
+
+uint8_t CompactString::classFor(size_t capacity) {
+    if (capacity <= UINT8_MAX) return CLASS_8;
+    if (capacity <= UINT16_MAX) return CLASS_16;
+    if (capacity <= UINT32_MAX) return CLASS_32;
+    return CLASS_64;
+}
+
+size_t CompactString::headerSize(uint8_t size_class) {
+    return 2 * (size_t(1) << size_class) + 1;
+}
+
+size_t CompactString::field(size_t index) const {
+    uint8_t size_class = sizeClass();
+    size_t width = size_t(1) << size_class;
+    const char* at = chars - headerSize(size_class) + index * width;
+    switch (size_class) {
+        case CLASS_8: { uint8_t v; std::memcpy(&v, at, sizeof(v)); return v; }
+        case CLASS_16: { uint16_t v; std::memcpy(&v, at, sizeof(v)); return v; }
+        case CLASS_32: { uint32_t v; std::memcpy(&v, at, sizeof(v)); return v; }
+        default: { uint64_t v; std::memcpy(&v, at, sizeof(v)); return static_cast<size_t>(v); }
+    }
+}
+
+void CompactString::setField(size_t index, size_t value) {
+    uint8_t size_class = sizeClass();
+    size_t width = size_t(1) << size_class;
+    char* at = chars - headerSize(size_class) + index * width;
+    switch (size_class) {
+        case CLASS_8: { uint8_t v = static_cast<uint8_t>(value); std::memcpy(at, &v, sizeof(v)); break; }
+        case CLASS_16: { uint16_t v = static_cast<uint16_t>(value); std::memcpy(at, &v, sizeof(v)); break; }
+        case CLASS_32: { uint32_t v = static_cast<uint32_t>(value); std::memcpy(at, &v, sizeof(v)); break; }
+        default: { uint64_t v = value; std::memcpy(at, &v, sizeof(v)); break; }
+    }
+}
+
+void CompactString::allocate(std::string_view str, size_t capacity) {
+    uint8_t size_class = classFor(capacity);
+    size_t header = headerSize(size_class);
+    char* block = static_cast<char*>(::operator new(header + capacity));
+    char* new_chars = block + header;
+    new_chars[-1] = static_cast<char>(size_class);
+    if (!str.empty()) {
+        std::memcpy(new_chars, str.data(), str.size());
+    }
+    // `str` may point into the old block, so it goes only after the copy
+    release();
+    chars = new_chars;
+    setField(0, str.size());
+    setField(1, capacity);
+}
+
+CompactString& CompactString::operator=(CompactString&& other) noexcept {
+    if (this != &other) {
+        release();
+        chars = other.chars;
+        other.chars = nullptr;
+    }
+    return *this;
+}
+
+void CompactString::release() {
+    if (chars) {
+        ::operator delete(chars - headerSize(sizeClass()));
+        chars = nullptr;
+    }
+}
+
+void CompactString::assign(std::string_view str) {
+    if (chars && str.size() <= capacity()) {
+        std::memmove(chars, str.data(), str.size());
+        setSize(str.size());
+    } else {
+        allocate(str, str.size());
+    }
+}
+
+void CompactString::append(std::string_view str) {
+    size_t current = size();
+    size_t needed = current + str.size();
+    if (needed > capacity()) {
+        // Filled before this block goes, since `str` may point into it
+        size_t grown = needed < MAX_PREALLOC ? needed * 2 : needed + MAX_PREALLOC;
+        CompactString bigger;
+        bigger.allocate(view(), grown);
+        std::memcpy(bigger.chars + current, str.data(), str.size());
+        bigger.setSize(needed);
+        *this = std::move(bigger);
+        return;
+    }
+    std::memmove(chars + current, str.data(), str.size());
+    setSize(needed);
+}
+
+EmbeddedString::EmbeddedString(std::string_view str) {
+    if (str.size() <= INLINE_CAPACITY) {
+        std::memcpy(storage, str.data(), str.size());
+        setTag(static_cast<uint8_t>(str.size()));
+    } else {
+        new (storage) CompactString(str);
+        setTag(ON_HEAP);
+    }
+}
+
+EmbeddedString& EmbeddedString::operator=(EmbeddedString&& other) noexcept {
+    if (this != &other) {
+        release();
+        moveFrom(other);
+    }
+    return *this;
+}
+
+void EmbeddedString::moveFrom(EmbeddedString& other) noexcept {
+    if (other.onHeap()) {
+        new (storage) CompactString(std::move(other.heap()));
+    } else {
+        std::memcpy(storage, other.storage, other.tag());
+    }
+    setTag(other.tag());
+}
+
+void EmbeddedString::release() {
+    if (onHeap()) {
+        heap().~CompactString();
+        setTag(0);
+    }
+}
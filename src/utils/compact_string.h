@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string_view>
+
+// A heap string in a single allocation, in the style of Redis's sds: a
+// header with the length and capacity, then the bytes. The header comes in
+// four size classes (1, 2, 4 or 8 byte fields, picked by capacity) so a
+// short string pays 3 bytes of overhead instead of std::string's 32 byte
+// object plus a separate buffer. The class is stored in the byte right
+// before the characters, so the object itself is one pointer.
+class CompactString {
+private:
+    char* chars = nullptr;   // first character; the header sits just before
+
+    static constexpr uint8_t CLASS_8 = 0;
+    static constexpr uint8_t CLASS_16 = 1;
+    static constexpr uint8_t CLASS_32 = 2;
+    static constexpr uint8_t CLASS_64 = 3;
+
+    static uint8_t classFor(size_t capacity);
+    // Bytes in front of the characters: two fields and the class byte
+    static size_t headerSize(uint8_t size_class);
+
+    uint8_t sizeClass() const { return static_cast<uint8_t>(chars[-1]); }
+    size_t field(size_t index) const;
+    void setField(size_t index, size_t value);
+    void setSize(size_t size) { setField(0, size); }
+    // A new block of `capacity` bytes holding `str`; replaces the current one
+    void allocate(std::string_view str, size_t capacity);
+    void release();
+
+public:
+    CompactString() = default;
+    explicit CompactString(std::string_view str) { allocate(str, str.size()); }
+    CompactString(CompactString&& other) noexcept : chars(other.chars) { other.chars = nullptr; }
+    CompactString& operator=(CompactString&& other) noexcept;
+    CompactString(const CompactString&) = delete;
+    CompactString& operator=(const CompactString&) = delete;
+    ~CompactString() { release(); }
+
+    std::string_view view() const { return chars ? std::string_view(chars, size()) : std::string_view(); }
+    size_t size() const { return chars ? field(0) : 0; }
+    size_t capacity() const { return chars ? field(1) : 0; }
+    // Heap bytes taken, header included
+    size_t allocatedSize() const { return chars ? headerSize(sizeClass()) + capacity() : 0; }
+
+    // Reuses the block when `str` fits
+    void assign(std::string_view str);
+    // Grows geometrically, so repeated appends are amortised O(1)
+    void append(std::string_view str);
+};
+
+// A string of up to 31 bytes kept inline in 32 bytes, with longer ones in
+// a CompactString. Used for keyspace keys: most are short, so a key lives
+// inside its table slot and reading it touches no other memory.
+class EmbeddedString {
+public:
+    static constexpr size_t INLINE_CAPACITY = 31;
+
+private:
+    static constexpr uint8_t ON_HEAP = 0xff;
+
+    // The bytes, or a CompactString at the front; the last byte is the
+    // inline size, or ON_HEAP
+    alignas(CompactString) char storage[INLINE_CAPACITY + 1];
+
+    uint8_t tag() const { return static_cast<uint8_t>(storage[INLINE_CAPACITY]); }
+    void setTag(uint8_t tag) { storage[INLINE_CAPACITY] = static_cast<char>(tag); }
+    bool onHeap() const { return tag() == ON_HEAP; }
+    CompactString& heap() { return *std::launder(reinterpret_cast<CompactString*>(storage)); }
+    const CompactString& heap() const { return *std::launder(reinterpret_cast<const CompactString*>(storage)); }
+    void moveFrom(EmbeddedString& other) noexcept;
+    void release();
+
+public:
+    EmbeddedString() : storage{} {}
+    explicit EmbeddedString(std::string_view str);
+    EmbeddedString(EmbeddedString&& other) noexcept { moveFrom(other); }
+    EmbeddedString& operator=(EmbeddedString&& other) noexcept;
+    EmbeddedString(const EmbeddedString&) = delete;
+    EmbeddedString& operator=(const EmbeddedString&) = delete;
+    ~EmbeddedString() { release(); }
+
+    std::string_view view() const {
+        return onHeap() ? heap().view() : std::string_view(storage, tag());
+    }
+    size_t size() const { return view().size(); }
+    bool isInline() const { return !onHeap(); }
+    // Heap bytes taken besides the object; 0 when inline
+    size_t allocatedSize() const { return onHeap() ? heap().allocatedSize() : 0; }
+
+    bool operator==(std::string_view other) const { return view() == other; }
+    bool operator!=(std::string_view other) const { return view() != other; }
+};
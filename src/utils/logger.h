@@ -2,11 +2,12 @@
 #define LOGGER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include <iomanip>
 #include <chrono>
-void logCommand(const std::vector<std::string>& args, size_t bytes_consumed);
+void logCommand(const std::vector<std::string_view>& args, size_t bytes_consumed);
 void logResponse(const std::string& response);
 void logConnection(const std::string& action, const std::string& client_ip = "", int client_port = 0);
 void logError(const std::string& error_message);
@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+// Case-insensitive perfect hash over a fixed set of ASCII names, built at
+// compile time. The constructor searches for a seed that gives every name
+// its own slot, so a lookup is one hash, one slot read and one compare,
+// without allocating or folding the input into a copy.
+template <size_t N, size_t SLOTS>
+class PerfectHash {
+    static_assert((SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+    static_assert(N < SLOTS, "too many names for the table");
+
+private:
+    static const uint32_t MAX_SEED = 100000;
+
+    std::array<std::string_view, N> names{};
+    std::array<uint16_t, SLOTS> slots{};   // name index + 1, 0 when empty
+    uint32_t seed = 0;
+    size_t max_length = 0;
+
+    static constexpr char lower(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    // Folding with | 0x20 is exact for letters and cheaper than lower();
+    // other bytes may collide, which the final compare sorts out
+    static constexpr uint32_t hash(std::string_view key, uint32_t seed) {
+        uint32_t h = seed ^ static_cast<uint32_t>(key.size());
+        for (char c : key) {
+            h = (h ^ static_cast<uint8_t>(c | 0x20)) * 16777619u;
+        }
+        return h ^ (h >> 16);
+    }
+
+    static constexpr bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (lower(a[i]) != lower(b[i])) return false;
+        }
+        return true;
+    }
+
+    constexpr bool tryBuild(uint32_t candidate) {
+        slots = {};
+        for (size_t i = 0; i < N; ++i) {
+            uint16_t& slot = slots[hash(names[i], candidate) & (SLOTS - 1)];
+            if (slot != 0) return false;
+            slot = static_cast<uint16_t>(i + 1);
+        }
+        return true;
+    }
+
+public:
+    constexpr explicit PerfectHash(const std::array<std::string_view, N>& keys) : names(keys) {
+        for (const auto& name : names) {
+            if (name.size() > max_length) max_length = name.size();
+        }
+        for (uint32_t candidate = 1; candidate < MAX_SEED; ++candidate) {
+            if (tryBuild(candidate)) {
+                seed = candidate;
+                return;
+            }
+        }
+        // Reached only during constant evaluation, where it is a compile error
+        throw std::logic_error("no perfect hash seed found; increase SLOTS");
+    }
+
+    // Index of `key` in the names given at construction, or -1
+    constexpr int find(std::string_view key) const {
+        if (key.size() > max_length) return -1;
+        int index = slots[hash(key, seed) & (SLOTS - 1)] - 1;
+        if (index < 0 || !equalsIgnoreCase(names[index], key)) return -1;
+        return index;
+    }
+};
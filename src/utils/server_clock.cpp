@@ -0,0 +1,16 @@
+#include "server_clock.h"
+
+int64_t ServerClock::fromSteady(std::chrono::steady_clock::time_point when) {
+    using namespace std::chrono;
+    struct Anchor {
+        int64_t unix_ms;
+        steady_clock::time_point steady;
+    };
+    static const Anchor anchor{
+        duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count(),
+        steady_clock::now()
+    };
+    // floor, not duration_cast: times before the anchor must not round
+    // up, or whole seconds derived from them would come out one short
+    return anchor.unix_ms + floor<milliseconds>(when - anchor.steady).count();
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Milliseconds since the Unix epoch, as used for key expiry. The wall
+// clock is read once, at startup; after that time advances with
+// steady_clock, so setting the system time neither expires nor resurrects
+// keys. An event loop calls update() once per iteration and everything it
+// runs in that iteration reads the cached value, the way Redis caches
+// mstime per loop. Threads that never called update() read the clock.
+class ServerClock {
+private:
+    inline static thread_local int64_t cached_ms = 0;   // 0: not cached
+
+    static int64_t fromSteady(std::chrono::steady_clock::time_point when);
+
+public:
+    static int64_t nowMs() {
+        return cached_ms != 0 ? cached_ms : fromSteady(std::chrono::steady_clock::now());
+    }
+
+    // Takes the time the loop already read after waking up
+    static void update(std::chrono::steady_clock::time_point now) { cached_ms = fromSteady(now); }
+    // For a thread whose loop has returned
+    static void stopCaching() { cached_ms = 0; }
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+
+// wyhash (final version): a few multiplies per 16 bytes, well spread in all
+// 64 bits, so the low bits can index buckets and the high bits shards
+namespace StringHash {
+
+constexpr uint64_t SECRET0 = 0xa0761d6478bd642fULL;
+constexpr uint64_t SECRET1 = 0xe7037ed1a0b428dbULL;
+constexpr uint64_t SECRET2 = 0x8ebc6af09c88c6e3ULL;
+constexpr uint64_t SECRET3 = 0x589965cc75374cc3ULL;
+
+inline uint64_t mix(uint64_t a, uint64_t b) {
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+inline uint64_t read8(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t read4(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+// First, middle and last byte, for 1 to 3 byte inputs
+inline uint64_t read3(const uint8_t* p, size_t len) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+// Drawn once per process, as Redis does for siphash, so that clients
+// cannot work out ahead of time which keys collide in our tables
+inline uint64_t processSeed() {
+    static const uint64_t seed = [] {
+        std::random_device device;
+        return (static_cast<uint64_t>(device()) << 32) ^ device();
+    }();
+    return seed;
+}
+
+inline uint64_t hash(std::string_view key, uint64_t seed) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(key.data());
+    size_t len = key.size();
+    seed ^= mix(seed ^ SECRET0, SECRET1);
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t shift = (len >> 3) << 2;
+            a = (read4(p) << 32) | read4(p + shift);
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = read3(p, len);
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do {
+                seed = mix(read8(p) ^ SECRET1, read8(p + 8) ^ seed);
+                seed1 = mix(read8(p + 16) ^ SECRET2, read8(p + 24) ^ seed1);
+                seed2 = mix(read8(p + 32) ^ SECRET3, read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = mix(read8(p) ^ SECRET1, read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    __uint128_t product = static_cast<__uint128_t>(a ^ SECRET1) * (b ^ seed);
+    a = static_cast<uint64_t>(product);
+    b = static_cast<uint64_t>(product >> 64);
+    return mix(a ^ SECRET0 ^ len, b ^ SECRET1);
+}
+
+// With the process seed: the hash every table and shard index uses
+inline uint64_t hash(std::string_view key) { return hash(key, processSeed()); }
+
+} // namespace StringHash
+
+// A key's bytes and its hash, for lookups. It borrows the bytes, so
+// finding an entry by a view into the query buffer allocates nothing and
+// hashes once. The bytes must outlive the key. Tables store their keys
+// their own way, next to the hash (see KeyTable::Entry), and equality
+// compares hashes before bytes.
+class HashedKey {
+private:
+    std::string_view bytes;
+    uint64_t hash_code;
+
+public:
+    HashedKey(std::string_view key) : bytes(key), hash_code(StringHash::hash(key)) {}
+    HashedKey(const char* key) : HashedKey(std::string_view(key)) {}
+    HashedKey(const std::string& key) : HashedKey(std::string_view(key)) {}
+    // With a hash computed earlier, e.g. the one a table entry stores
+    HashedKey(std::string_view key, uint64_t hash) : bytes(key), hash_code(hash) {}
+
+    std::string_view view() const { return bytes; }
+    uint64_t hash() const { return hash_code; }
+
+    bool operator==(const HashedKey& other) const {
+        return hash_code == other.hash_code && bytes == other.bytes;
+    }
+};
@@ -1,7 +1,9 @@
 #include "utility_functions.h"
+#include <charconv>
+#include <cstdint>
 
 
-bool UtilityFunctions::isInteger(const std::string& str) {
+bool UtilityFunctions::isInteger(std::string_view str) {
     if (str.empty()) return false;
     
     size_t start = 0;
@@ -17,26 +19,26 @@ bool UtilityFunctions::isInteger(const std::string& str) {
     return true;
 }
 
-long long UtilityFunctions::parseInt(const std::string& str) {
-    try {
-        return std::stoll(str);
-    } catch (...) {
-        return 0;
-    }
+long long UtilityFunctions::parseInt(std::string_view str) {
+    // Same contract as before: leading digits are used, failures give 0
+    if (!str.empty() && str[0] == '+') str.remove_prefix(1);
+    long long value = 0;
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+    return result.ec == std::errc() ? value : 0;
 }
 
-std::string UtilityFunctions::toUpper(const std::string& str) {
-    std::string result = str;
+std::string UtilityFunctions::toUpper(std::string_view str) {
+    std::string result(str);
     std::transform(result.begin(), result.end(), result.begin(), ::toupper);
     return result;
 }
 
-bool UtilityFunctions::matchPattern(const std::string& pattern, const std::string& str) {
+bool UtilityFunctions::matchPattern(std::string_view pattern, std::string_view str) {
     if (pattern == "*") return true;
     
     // Simple pattern matching - supports * and ?
     size_t p = 0, s = 0;
-    size_t star_p = std::string::npos, star_s = 0;
+    size_t star_p = std::string_view::npos, star_s = 0;
     
     while (s < str.length()) {
         if (p < pattern.length() && (pattern[p] == '?' || pattern[p] == str[s])) {
@@ -45,7 +47,7 @@ bool UtilityFunctions::matchPattern(const std::string& pattern, const std::strin
         } else if (p < pattern.length() && pattern[p] == '*') {
             star_p = p++;
             star_s = s;
-        } else if (star_p != std::string::npos) {
+        } else if (star_p != std::string_view::npos) {
             p = star_p + 1;
             s = ++star_s;
         } else {
@@ -60,6 +62,28 @@ bool UtilityFunctions::matchPattern(const std::string& pattern, const std::strin
     return p == pattern.length();
 }
 
-bool UtilityFunctions::isValidKey(const std::string& key) {
+bool UtilityFunctions::isValidKey(std::string_view key) {
     return !key.empty() && key.length() < 512;//magic number
-}
\ No newline at end of file
+}
+
+std::optional<size_t> UtilityFunctions::parseMemorySize(std::string_view str) {
+    static const std::pair<const char*, size_t> UNITS[] = {
+        {"", 1},
+        {"k", 1000}, {"kb", 1024},
+        {"m", 1000 * 1000}, {"mb", 1024 * 1024},
+        {"g", 1000 * 1000 * 1000}, {"gb", 1024 * 1024 * 1024}
+    };
+
+    size_t value = 0;
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (result.ec != std::errc() || result.ptr == str.data()) return std::nullopt;
+
+    std::string unit(result.ptr, str.data() + str.size());
+    std::transform(unit.begin(), unit.end(), unit.begin(), ::tolower);
+    for (const auto& candidate : UNITS) {
+        if (unit != candidate.first) continue;
+        if (value > SIZE_MAX / candidate.second) return std::nullopt;
+        return value * candidate.second;
+    }
+    return std::nullopt;
+}
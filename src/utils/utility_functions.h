@@ -1,13 +1,18 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <cctype>
 #include <algorithm>
+#include <optional>
 
 class UtilityFunctions {
 public:
-    static bool isInteger(const std::string& str);
-    static long long parseInt(const std::string& str);
-    static std::string toUpper(const std::string& str);
-    static bool matchPattern(const std::string& pattern, const std::string& str);
-    static bool isValidKey(const std::string& key);
+    static bool isInteger(std::string_view str);
+    static long long parseInt(std::string_view str);
+    static std::string toUpper(std::string_view str);
+    static bool matchPattern(std::string_view pattern, std::string_view str);
+    static bool isValidKey(std::string_view key);
+    // Byte counts as Redis's config spells them: "100", "64kb", "1gb";
+    // k/m/g are powers of 1000, kb/mb/gb powers of 1024, any case
+    static std::optional<size_t> parseMemorySize(std::string_view str);
 };
\ No newline at end of file
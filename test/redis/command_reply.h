@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "redis/command_args.h"
+#include "resp/response_writer.h"
+
+// Runs one command method and returns the RESP it wrote, so tests can
+// compare replies as strings
+template <typename Commands>
+std::string runCommand(Commands* commands,
+                       void (Commands::*method)(const CommandArgs&, ResponseWriter&),
+                       const CommandArgs& args) {
+    std::string output;
+    ResponseWriter writer(output);
+    (commands->*method)(args, writer);
+    return output;
+}
+
+// A SCAN-family reply split into its cursor and elements
+struct ScanReply {
+    std::string cursor;
+    std::vector<std::string> elements;
+};
+
+inline ScanReply parseScanReply(const std::string& resp) {
+    // *2\r\n$<n>\r\n<cursor>\r\n*<m>\r\n then m bulk strings
+    ScanReply reply;
+    size_t pos = resp.find("\r\n") + 2;
+    auto readBulk = [&resp, &pos]() {
+        size_t header_end = resp.find("\r\n", pos);
+        size_t length = std::stoul(resp.substr(pos + 1, header_end - pos - 1));
+        std::string bulk = resp.substr(header_end + 2, length);
+        pos = header_end + 2 + length + 2;
+        return bulk;
+    };
+    reply.cursor = readBulk();
+    size_t header_end = resp.find("\r\n", pos);
+    size_t count = std::stoul(resp.substr(pos + 1, header_end - pos - 1));
+    pos = header_end + 2;
+    for (size_t i = 0; i < count; ++i) reply.elements.push_back(readBulk());
+    return reply;
+}
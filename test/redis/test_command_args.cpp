@@ -0,0 +1,61 @@
+// test_command_args.cpp
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "redis/command_args.h"
+#include "redis/commands/string_commands.h"
+#include "command_reply.h"
+
+TEST(CommandArgsTest, WrapsViewsWithoutCopying) {
+    std::string buffer = "SETkeyvalue";
+    std::vector<std::string_view> views = {
+        std::string_view(buffer).substr(0, 3),
+        std::string_view(buffer).substr(3, 3),
+        std::string_view(buffer).substr(6)
+    };
+    CommandArgs args(views);
+
+    ASSERT_EQ(args.size(), 3u);
+    EXPECT_EQ(args[0], "SET");
+    EXPECT_EQ(args[1], "key");
+    EXPECT_EQ(args[2], "value");
+    EXPECT_EQ(args[1].data(), buffer.data() + 3);
+}
+
+TEST(CommandArgsTest, WrapsOwnedStrings) {
+    std::vector<std::string> strings = {"GET", "key"};
+    CommandArgs args(strings);
+
+    ASSERT_EQ(args.size(), 2u);
+    EXPECT_EQ(args[0], "GET");
+    EXPECT_EQ(args[1].data(), strings[1].data());
+}
+
+TEST(CommandArgsTest, InitializerListAndIteration) {
+    CommandArgs args = {"MGET", "a", "b"};
+    std::string joined;
+    for (std::string_view arg : args) {
+        joined.append(arg);
+    }
+    EXPECT_EQ(joined, "MGETab");
+    EXPECT_FALSE(args.empty());
+    EXPECT_TRUE(CommandArgs().empty());
+}
+
+TEST(CommandArgsTest, CommandsAcceptSlicesOfARequestBuffer) {
+    RedisDatabase database;
+    StringCommands commands(database);
+
+    std::string request = "SETuservalue";
+    std::vector<std::string_view> set_args = {
+        std::string_view(request).substr(0, 3),
+        std::string_view(request).substr(3, 4),
+        std::string_view(request).substr(7)
+    };
+    EXPECT_EQ(runCommand(&commands, &StringCommands::cmdSet, set_args), "+OK\r\n");
+
+    // The stored value must not depend on the request buffer
+    request.assign(request.size(), '#');
+    EXPECT_EQ(runCommand(&commands, &StringCommands::cmdGet, {"GET", "user"}), "$5\r\nvalue\r\n");
+}
@@ -0,0 +1,219 @@
+// test_command_handler.cpp
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "redis/command_handler.h"
+
+class CommandHandlerTest : public ::testing::Test {
+protected:
+    std::string run(const std::vector<std::string>& args) {
+        std::string output;
+        ResponseWriter out(output);
+        handler.processCommand(args, out);
+        return output;
+    }
+
+    CommandHandler handler;
+};
+
+TEST_F(CommandHandlerTest, EveryTableEntryIsFound) {
+    for (size_t i = 0; i < CommandHandler::COMMAND_COUNT; ++i) {
+        const auto& spec = CommandHandler::COMMAND_TABLE[i];
+        EXPECT_EQ(CommandHandler::findCommand(spec.name), &spec) << spec.name;
+    }
+}
+
+TEST_F(CommandHandlerTest, LookupIgnoresCase) {
+    const auto* spec = CommandHandler::findCommand("hGetAll");
+    ASSERT_NE(spec, nullptr);
+    EXPECT_EQ(spec->name, "HGETALL");
+    EXPECT_EQ(CommandHandler::findCommand("set"), CommandHandler::findCommand("SET"));
+}
+
+TEST_F(CommandHandlerTest, UnknownNamesAreRejected) {
+    EXPECT_EQ(CommandHandler::findCommand(""), nullptr);
+    EXPECT_EQ(CommandHandler::findCommand("GETX"), nullptr);
+    EXPECT_EQ(CommandHandler::findCommand("GE"), nullptr);
+    EXPECT_EQ(CommandHandler::findCommand(std::string(1000, 'A')), nullptr);
+    // Same bytes once folded with | 0x20, but not the same letters
+    EXPECT_EQ(CommandHandler::findCommand("G\x05T"), nullptr);
+}
+
+TEST_F(CommandHandlerTest, DispatchesToCommandModules) {
+    EXPECT_EQ(run({"ping"}), "+PONG\r\n");
+    EXPECT_EQ(run({"Set", "k", "v"}), "+OK\r\n");
+    EXPECT_EQ(run({"GET", "k"}), "$1\r\nv\r\n");
+    EXPECT_EQ(run({"rpush", "l", "a", "b"}), ":2\r\n");
+    EXPECT_EQ(run({"LRANGE", "l", "0", "-1"}), "*2\r\n$1\r\na\r\n$1\r\nb\r\n");
+    EXPECT_EQ(handler.getTotalCommandsProcessed(), 5u);
+}
+
+TEST_F(CommandHandlerTest, UnknownCommandReportsName) {
+    EXPECT_EQ(run({"nope", "x"}), "-ERR unknown command 'nope'\r\n");
+}
+
+TEST_F(CommandHandlerTest, ArityCheckedBeforeDispatch) {
+    EXPECT_EQ(run({"get"}), "-ERR wrong number of arguments for 'get' command\r\n");
+    EXPECT_EQ(run({"GET", "a", "b"}), "-ERR wrong number of arguments for 'get' command\r\n");
+    EXPECT_EQ(run({"SET", "k"}), "-ERR wrong number of arguments for 'set' command\r\n");
+    // Negative arity is a minimum
+    EXPECT_EQ(run({"DEL", "a", "b", "c"}), ":0\r\n");
+    EXPECT_EQ(run({"DEL"}), "-ERR wrong number of arguments for 'del' command\r\n");
+}
+
+TEST_F(CommandHandlerTest, DescriptorsDescribeKeysAndFlags) {
+    const auto* mset = CommandHandler::findCommand("MSET");
+    ASSERT_NE(mset, nullptr);
+    EXPECT_TRUE(mset->hasFlag(CommandFlag::WRITE));
+    EXPECT_FALSE(mset->hasFlag(CommandFlag::READONLY));
+    EXPECT_EQ(mset->first_key, 1);
+    EXPECT_EQ(mset->step, 2);
+    // MSET k1 v1 k2 v2: stepping from 1 up to 4 visits the keys at 1 and 3
+    EXPECT_EQ(mset->lastKeyIndex(5), 4u);
+
+    const auto* get = CommandHandler::findCommand("GET");
+    ASSERT_NE(get, nullptr);
+    EXPECT_TRUE(get->hasFlag(CommandFlag::READONLY | CommandFlag::FAST));
+    EXPECT_EQ(get->lastKeyIndex(2), 1u);
+    EXPECT_EQ(get->complexity, CommandComplexity::CONSTANT);
+
+    EXPECT_EQ(CommandHandler::findCommand("PING")->first_key, 0);
+}
+
+TEST_F(CommandHandlerTest, EveryCommandHasConsistentKeySpec) {
+    for (size_t i = 0; i < CommandHandler::COMMAND_COUNT; ++i) {
+        const auto& spec = CommandHandler::COMMAND_TABLE[i];
+        SCOPED_TRACE(std::string(spec.name));
+        EXPECT_FALSE(spec.hasFlag(CommandFlag::WRITE) && spec.hasFlag(CommandFlag::READONLY));
+        if (spec.first_key == 0) {
+            EXPECT_EQ(spec.last_key, 0);
+            EXPECT_EQ(spec.step, 0);
+        } else {
+            EXPECT_GT(spec.step, 0);
+            // The minimum call must contain the first key
+            size_t min_args = spec.arity >= 0 ? spec.arity : -spec.arity;
+            EXPECT_LT(static_cast<size_t>(spec.first_key), min_args);
+        }
+    }
+}
+
+// Benchmark: run with --gtest_also_run_disabled_tests
+TEST_F(CommandHandlerTest, DISABLED_LookupBenchmark) {
+    // The previous dispatch: upper-case copy, then a string-keyed map of
+    // std::function
+    using Func = std::function<void(const CommandArgs&, ResponseWriter&)>;
+    std::unordered_map<std::string, Func> map;
+    for (size_t i = 0; i < CommandHandler::COMMAND_COUNT; ++i) {
+        map[std::string(CommandHandler::COMMAND_TABLE[i].name)] = [](const CommandArgs&, ResponseWriter&) {};
+    }
+
+    const std::vector<std::string> names = {"get", "SET", "Get", "hset", "LPUSH", "incr", "mget", "unknown"};
+    const int iterations = 2000000;
+    size_t found = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        std::string upper = UtilityFunctions::toUpper(names[i % names.size()]);
+        found += map.find(upper) != map.end();
+    }
+    std::chrono::duration<double, std::milli> map_ms = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        found += CommandHandler::findCommand(names[i % names.size()]) != nullptr;
+    }
+    std::chrono::duration<double, std::milli> table_ms = std::chrono::steady_clock::now() - start;
+
+    std::cout << "toUpper + unordered_map: " << map_ms.count() << " ms" << std::endl;
+    std::cout << "perfect hash table:      " << table_ms.count() << " ms" << std::endl;
+    EXPECT_GT(found, 0u);
+}
+
+// Keys nobody reads again are deleted by the cron's active expiry
+TEST_F(CommandHandlerTest, ServerCronExpiresUnreadKeys) {
+    RedisDatabase db;
+    CommandHandler shared(db);
+    std::string output;
+    ResponseWriter out(output);
+    for (int i = 0; i < 1000; ++i) {
+        shared.processCommand(std::vector<std::string>{"SET", "temp:" + std::to_string(i), "v", "PX", "1"}, out);
+    }
+    shared.processCommand(std::vector<std::string>{"SET", "kept", "v"}, out);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // Commands alone no longer sweep the keyspace
+    for (int i = 0; i < 200; ++i) {
+        shared.processCommand(std::vector<std::string>{"PING"}, out);
+    }
+    EXPECT_EQ(db.getDatabaseSize(), 1001u);
+
+    shared.serverCron();
+    EXPECT_EQ(db.getDatabaseSize(), 1u);
+}
+
+// Over maxmemory under noeviction, commands that add data are refused
+// and the ones that free it still run
+TEST_F(CommandHandlerTest, MaxmemoryRefusesGrowingWrites) {
+    RedisDatabase db;
+    CommandHandler shared(db);
+    auto run_shared = [&shared](const std::vector<std::string>& args) {
+        std::string output;
+        ResponseWriter out(output);
+        shared.processCommand(args, out);
+        return output;
+    };
+    for (int i = 0; i < 100; ++i) {
+        run_shared({"SET", "key:" + std::to_string(i), std::string(100, 'v')});
+    }
+    db.setMaxMemory(db.usedMemory() / 2, EvictionPolicy::NOEVICTION);
+
+    const std::string oom = "-OOM command not allowed when used memory > 'maxmemory'.\r\n";
+    EXPECT_EQ(run_shared({"SET", "new", "v"}), oom);
+    EXPECT_EQ(run_shared({"HSET", "h", "f", "v"}), oom);
+    EXPECT_EQ(run_shared({"GET", "key:1"}), "$100\r\n" + std::string(100, 'v') + "\r\n");
+    EXPECT_EQ(run_shared({"DEL", "key:1"}), ":1\r\n");
+    EXPECT_EQ(db.getDatabaseSize(), 99u);
+
+    // With a policy, the same write evicts instead
+    db.setMaxMemory(db.usedMemory() / 2, EvictionPolicy::ALLKEYS_LRU);
+    EXPECT_EQ(run_shared({"SET", "new", "v"}), "+OK\r\n");
+    EXPECT_LT(db.getDatabaseSize(), 99u);
+    EXPECT_GT(db.evictedKeys(), 0u);
+}
+
+// Benchmark: per-command latency with a million keys that have a TTL, none
+// of them due. Run with --gtest_also_run_disabled_tests
+TEST_F(CommandHandlerTest, DISABLED_LatencyWithExpiringKeysBenchmark) {
+    const int key_count = 1000000;
+    const int commands = 20000;
+    RedisDatabase db;
+    CommandHandler shared(db);
+    for (int i = 0; i < key_count; ++i) {
+        std::string key = "session:" + std::to_string(i);
+        db.setValue(key, RedisValue("v"));
+        db.setExpiry(key, std::chrono::hours(1));
+    }
+
+    std::vector<std::string> args = {"GET", "session:42"};
+    CommandArgs get(args);
+    std::string output;
+    ResponseWriter out(output);
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds worst{0};
+    for (int i = 0; i < commands; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        shared.processCommand(get, out);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed;
+        worst = std::max(worst, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+        output.clear();
+    }
+    std::cout << commands << " GETs: " << total.count() / commands << " ns average, "
+              << worst.count() / 1000 << " us worst" << std::endl;
+}
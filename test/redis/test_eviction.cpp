@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include "redis/database/eviction.h"
+#include "utils/server_clock.h"
+
+class EvictionTest : public ::testing::Test {
+protected:
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Freezes ServerClock at `offset` past the start of the test
+    void advanceTo(std::chrono::steady_clock::duration offset) {
+        ServerClock::update(start + offset);
+    }
+
+    void TearDown() override {
+        ServerClock::stopCaching();
+    }
+};
+
+TEST_F(EvictionTest, PolicyNamesRoundTrip) {
+    for (EvictionPolicy policy : {EvictionPolicy::NOEVICTION, EvictionPolicy::ALLKEYS_LRU,
+                                  EvictionPolicy::ALLKEYS_LFU, EvictionPolicy::ALLKEYS_RANDOM,
+                                  EvictionPolicy::VOLATILE_LRU, EvictionPolicy::VOLATILE_TTL}) {
+        EXPECT_EQ(parseEvictionPolicy(evictionPolicyName(policy)), policy);
+    }
+    EXPECT_EQ(parseEvictionPolicy("AllKeys-LRU"), EvictionPolicy::ALLKEYS_LRU);
+    EXPECT_FALSE(parseEvictionPolicy("allkeys"));
+    EXPECT_FALSE(parseEvictionPolicy(""));
+}
+
+TEST_F(EvictionTest, LruScoreIsIdleSeconds) {
+    advanceTo(std::chrono::seconds(0));
+    uint32_t clock = AccessClock::initial(EvictionPolicy::ALLKEYS_LRU);
+    EXPECT_EQ(AccessClock::evictionScore(clock, EvictionPolicy::ALLKEYS_LRU), 0u);
+
+    advanceTo(std::chrono::seconds(42));
+    EXPECT_EQ(AccessClock::evictionScore(clock, EvictionPolicy::ALLKEYS_LRU), 42u);
+
+    clock = AccessClock::touched(clock, EvictionPolicy::ALLKEYS_LRU);
+    EXPECT_EQ(AccessClock::evictionScore(clock, EvictionPolicy::ALLKEYS_LRU), 0u);
+
+    // A clock ahead of now, as after a policy change, reads as just used
+    EXPECT_EQ(AccessClock::evictionScore(clock + 5, EvictionPolicy::ALLKEYS_LRU), 0u);
+}
+
+TEST_F(EvictionTest, LfuCounterStartsAtInitAndDecays) {
+    advanceTo(std::chrono::seconds(0));
+    uint32_t clock = AccessClock::initial(EvictionPolicy::ALLKEYS_LFU);
+    EXPECT_EQ(AccessClock::lfuCounter(clock), AccessClock::LFU_INIT_VAL);
+    EXPECT_EQ(AccessClock::evictionScore(clock, EvictionPolicy::ALLKEYS_LFU), 255u - AccessClock::LFU_INIT_VAL);
+
+    advanceTo(std::chrono::minutes(3));
+    EXPECT_EQ(AccessClock::lfuCounter(clock), AccessClock::LFU_INIT_VAL - 3);
+
+    advanceTo(std::chrono::minutes(30));
+    EXPECT_EQ(AccessClock::lfuCounter(clock), 0);
+    EXPECT_EQ(AccessClock::evictionScore(clock, EvictionPolicy::ALLKEYS_LFU), 255u);
+}
+
+TEST_F(EvictionTest, LfuCounterGrowsLogarithmically) {
+    advanceTo(std::chrono::seconds(0));
+    uint32_t clock = AccessClock::initial(EvictionPolicy::ALLKEYS_LFU);
+    for (int i = 0; i < 1000; ++i) {
+        clock = AccessClock::touched(clock, EvictionPolicy::ALLKEYS_LFU);
+    }
+    // About 18 with a log factor of 10; far from saturating
+    uint8_t counter = AccessClock::lfuCounter(clock);
+    EXPECT_GT(counter, AccessClock::LFU_INIT_VAL + 5);
+    EXPECT_LT(counter, 60);
+
+    // Touching restarts the decay period
+    advanceTo(std::chrono::minutes(2));
+    clock = AccessClock::touched(clock, EvictionPolicy::ALLKEYS_LFU);
+    advanceTo(std::chrono::minutes(3));
+    EXPECT_GE(AccessClock::lfuCounter(clock), counter - 3);
+}
+
+TEST_F(EvictionTest, PoolKeepsHighestScores) {
+    EvictionPool pool;
+    for (uint64_t score = 0; score < 20; ++score) {
+        pool.offer(score, 0, "key:" + std::to_string(score));
+    }
+    EXPECT_EQ(pool.size(), EvictionPool::SIZE);
+
+    // Worse than everything kept: ignored
+    pool.offer(1, 0, "cold");
+    EXPECT_EQ(pool.size(), EvictionPool::SIZE);
+
+    for (uint64_t score = 19; score >= 20 - EvictionPool::SIZE; --score) {
+        auto best = pool.popBest();
+        ASSERT_TRUE(best);
+        EXPECT_EQ(best->score, score);
+        EXPECT_EQ(best->key, "key:" + std::to_string(score));
+    }
+    EXPECT_FALSE(pool.popBest());
+}
+
+TEST_F(EvictionTest, PoolReofferReplacesScore) {
+    EvictionPool pool;
+    pool.offer(10, 1, "a");
+    pool.offer(20, 2, "b");
+    pool.offer(5, 1, "b");
+    EXPECT_EQ(pool.size(), 2u);
+
+    auto best = pool.popBest();
+    ASSERT_TRUE(best);
+    EXPECT_EQ(best->key, "a");
+    EXPECT_EQ(best->shard, 1u);
+    best = pool.popBest();
+    ASSERT_TRUE(best);
+    EXPECT_EQ(best->key, "b");
+    EXPECT_EQ(best->score, 5u);
+
+    pool.offer(1, 0, "c");
+    pool.clear();
+    EXPECT_EQ(pool.size(), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
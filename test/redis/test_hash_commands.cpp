@@ -2,8 +2,10 @@
 #include <gtest/gtest.h>
 #include <vector>
 #include <string>
+#include <set>
 #include <unordered_map>
 #include "redis/commands/hash_commands.h"
+#include "command_reply.h"
 #include "redis/database/redis_database.h"
 
 // Test fixture for HashCommands tests
@@ -15,13 +17,8 @@ protected:
         hashCommands = new HashCommands(*database);
         
         // Add some test data
-        RedisValue hash1(RedisType::HASH);
-        hash1.hash_value = {{"field1", "value1"}, {"field2", "value2"}, {"field3", "value3"}};
-        database->setValue("existing_hash", hash1);
-        
-        RedisValue hash2(RedisType::HASH);
-        hash2.hash_value = {{"name", "Alice"}, {"age", "30"}, {"city", "New York"}};
-        database->setValue("user_hash", hash2);
+        database->setValue("existing_hash", makeHash({{"field1", "value1"}, {"field2", "value2"}, {"field3", "value3"}}));
+        database->setValue("user_hash", makeHash({{"name", "Alice"}, {"age", "30"}, {"city", "New York"}}));
         
         RedisValue empty_hash(RedisType::HASH);
         database->setValue("empty_hash", empty_hash);
@@ -35,6 +32,20 @@ protected:
         delete database;
     }
     
+    static RedisValue makeHash(std::initializer_list<std::pair<std::string_view, std::string_view>> fields) {
+        RedisValue hash(RedisType::HASH);
+        for (const auto& field : fields) {
+            hash.hash().tryEmplace(HashedKey(field.first), field.second);
+        }
+        return hash;
+    }
+
+    // The value stored under `field`, or "(nil)" when there is none
+    static std::string fieldValue(const RedisValue* hash, std::string_view field) {
+        auto* entry = hash->hash().find(HashedKey(field));
+        return entry ? entry->value : "(nil)";
+    }
+
     RedisDatabase* database;
     HashCommands* hashCommands;
 };
@@ -42,25 +53,25 @@ protected:
 // Test HSET command with new hash
 TEST_F(HashCommandsTest, Hset_NewHash_ReturnsAddedCount) {
     std::vector<std::string> args = {"HSET", "new_hash", "field1", "value1", "field2", "value2", "field3", "value3"};
-    std::string result = hashCommands->cmdHset(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHset, args);
     
     EXPECT_EQ(":3\r\n", result); // 3 fields added
     
     // Verify hash was created with fields
     RedisValue* value = database->getValue("new_hash");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::HASH) {
-        EXPECT_EQ(3, value->hash_value.size());
-        EXPECT_EQ("value1", value->hash_value["field1"]);
-        EXPECT_EQ("value2", value->hash_value["field2"]);
-        EXPECT_EQ("value3", value->hash_value["field3"]);
+    if (value && value->type() == RedisType::HASH) {
+        EXPECT_EQ(3, value->hash().size());
+        EXPECT_EQ("value1", fieldValue(value, "field1"));
+        EXPECT_EQ("value2", fieldValue(value, "field2"));
+        EXPECT_EQ("value3", fieldValue(value, "field3"));
     }
 }
 
 // Test HSET command with existing hash
 TEST_F(HashCommandsTest, Hset_ExistingHash_UpdatesExistingFields) {
     std::vector<std::string> args = {"HSET", "existing_hash", "field2", "new_value", "field4", "value4"};
-    std::string result = hashCommands->cmdHset(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHset, args);
     
     // field2 exists (not counted as added), field4 is new
     EXPECT_EQ(":1\r\n", result);
@@ -68,19 +79,19 @@ TEST_F(HashCommandsTest, Hset_ExistingHash_UpdatesExistingFields) {
     // Verify fields were updated/added
     RedisValue* value = database->getValue("existing_hash");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::HASH) {
-        EXPECT_EQ(4, value->hash_value.size());
-        EXPECT_EQ("value1", value->hash_value["field1"]); // unchanged
-        EXPECT_EQ("new_value", value->hash_value["field2"]); // updated
-        EXPECT_EQ("value3", value->hash_value["field3"]); // unchanged
-        EXPECT_EQ("value4", value->hash_value["field4"]); // new
+    if (value && value->type() == RedisType::HASH) {
+        EXPECT_EQ(4, value->hash().size());
+        EXPECT_EQ("value1", fieldValue(value, "field1")); // unchanged
+        EXPECT_EQ("new_value", fieldValue(value, "field2")); // updated
+        EXPECT_EQ("value3", fieldValue(value, "field3")); // unchanged
+        EXPECT_EQ("value4", fieldValue(value, "field4")); // new
     }
 }
 
 // Test HSET command with wrong number of arguments
 TEST_F(HashCommandsTest, Hset_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"HSET", "key", "field1"}; // Missing value
-    std::string result = hashCommands->cmdHset(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHset, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -88,7 +99,7 @@ TEST_F(HashCommandsTest, Hset_WrongNumberOfArguments_ReturnsError) {
 // Test HSET command with odd number of field-value pairs
 TEST_F(HashCommandsTest, Hset_OddNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"HSET", "key", "field1", "value1", "field2"}; // Missing value for field2
-    std::string result = hashCommands->cmdHset(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHset, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -96,7 +107,7 @@ TEST_F(HashCommandsTest, Hset_OddNumberOfArguments_ReturnsError) {
 // Test HSET command with wrong type
 TEST_F(HashCommandsTest, Hset_WrongType_ReturnsError) {
     std::vector<std::string> args = {"HSET", "string_key", "field1", "value1"};
-    std::string result = hashCommands->cmdHset(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHset, args);
     
     EXPECT_TRUE(result.find("ERR Operation against a key holding the wrong kind of value") != std::string::npos);
 }
@@ -104,7 +115,7 @@ TEST_F(HashCommandsTest, Hset_WrongType_ReturnsError) {
 // Test HGET command with existing field
 TEST_F(HashCommandsTest, Hget_ExistingField_ReturnsValue) {
     std::vector<std::string> args = {"HGET", "existing_hash", "field1"};
-    std::string result = hashCommands->cmdHget(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHget, args);
     
     EXPECT_EQ("$6\r\nvalue1\r\n", result);
 }
@@ -112,7 +123,7 @@ TEST_F(HashCommandsTest, Hget_ExistingField_ReturnsValue) {
 // Test HGET command with non-existent field
 TEST_F(HashCommandsTest, Hget_NonExistentField_ReturnsNull) {
     std::vector<std::string> args = {"HGET", "existing_hash", "non_existent_field"};
-    std::string result = hashCommands->cmdHget(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHget, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -120,7 +131,7 @@ TEST_F(HashCommandsTest, Hget_NonExistentField_ReturnsNull) {
 // Test HGET command with non-existent hash
 TEST_F(HashCommandsTest, Hget_NonExistentHash_ReturnsNull) {
     std::vector<std::string> args = {"HGET", "non_existent_hash", "field1"};
-    std::string result = hashCommands->cmdHget(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHget, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -128,7 +139,7 @@ TEST_F(HashCommandsTest, Hget_NonExistentHash_ReturnsNull) {
 // Test HGET command with wrong type
 TEST_F(HashCommandsTest, Hget_WrongType_ReturnsNull) {
     std::vector<std::string> args = {"HGET", "string_key", "field1"};
-    std::string result = hashCommands->cmdHget(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHget, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -136,7 +147,7 @@ TEST_F(HashCommandsTest, Hget_WrongType_ReturnsNull) {
 // Test HGET command with wrong number of arguments
 TEST_F(HashCommandsTest, Hget_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"HGET", "existing_hash"}; // Missing field
-    std::string result = hashCommands->cmdHget(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHget, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -144,7 +155,7 @@ TEST_F(HashCommandsTest, Hget_WrongNumberOfArguments_ReturnsError) {
 // Test HDEL command with existing fields
 TEST_F(HashCommandsTest, Hdel_ExistingFields_ReturnsDeletedCount) {
     std::vector<std::string> args = {"HDEL", "existing_hash", "field1", "field3", "non_existent_field"};
-    std::string result = hashCommands->cmdHdel(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHdel, args);
     
     // Only field1 and field3 exist, so 2 deleted
     EXPECT_EQ(":2\r\n", result);
@@ -152,18 +163,18 @@ TEST_F(HashCommandsTest, Hdel_ExistingFields_ReturnsDeletedCount) {
     // Verify fields were deleted
     RedisValue* value = database->getValue("existing_hash");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::HASH) {
-        EXPECT_EQ(1, value->hash_value.size()); // Only field2 remains
-        EXPECT_TRUE(value->hash_value.find("field1") == value->hash_value.end());
-        EXPECT_TRUE(value->hash_value.find("field3") == value->hash_value.end());
-        EXPECT_TRUE(value->hash_value.find("field2") != value->hash_value.end());
+    if (value && value->type() == RedisType::HASH) {
+        EXPECT_EQ(1, value->hash().size()); // Only field2 remains
+        EXPECT_FALSE(value->hash().contains("field1"));
+        EXPECT_FALSE(value->hash().contains("field3"));
+        EXPECT_TRUE(value->hash().contains("field2"));
     }
 }
 
 // Test HDEL command removes empty hash
 TEST_F(HashCommandsTest, Hdel_RemovesEmptyHash_DeletesKey) {
     std::vector<std::string> args = {"HDEL", "existing_hash", "field1", "field2", "field3"};
-    std::string result = hashCommands->cmdHdel(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHdel, args);
     
     EXPECT_EQ(":3\r\n", result);
     
@@ -175,7 +186,7 @@ TEST_F(HashCommandsTest, Hdel_RemovesEmptyHash_DeletesKey) {
 // Test HDEL command with non-existent hash
 TEST_F(HashCommandsTest, Hdel_NonExistentHash_ReturnsZero) {
     std::vector<std::string> args = {"HDEL", "non_existent_hash", "field1"};
-    std::string result = hashCommands->cmdHdel(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHdel, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -183,7 +194,7 @@ TEST_F(HashCommandsTest, Hdel_NonExistentHash_ReturnsZero) {
 // Test HDEL command with wrong type
 TEST_F(HashCommandsTest, Hdel_WrongType_ReturnsZero) {
     std::vector<std::string> args = {"HDEL", "string_key", "field1"};
-    std::string result = hashCommands->cmdHdel(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHdel, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -191,7 +202,7 @@ TEST_F(HashCommandsTest, Hdel_WrongType_ReturnsZero) {
 // Test HDEL command with wrong number of arguments
 TEST_F(HashCommandsTest, Hdel_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"HDEL", "existing_hash"}; // Missing fields
-    std::string result = hashCommands->cmdHdel(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHdel, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -199,7 +210,7 @@ TEST_F(HashCommandsTest, Hdel_WrongNumberOfArguments_ReturnsError) {
 // Test HEXISTS command with existing field
 TEST_F(HashCommandsTest, Hexists_ExistingField_ReturnsOne) {
     std::vector<std::string> args = {"HEXISTS", "existing_hash", "field1"};
-    std::string result = hashCommands->cmdHexists(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHexists, args);
     
     EXPECT_EQ(":1\r\n", result);
 }
@@ -207,7 +218,7 @@ TEST_F(HashCommandsTest, Hexists_ExistingField_ReturnsOne) {
 // Test HEXISTS command with non-existent field
 TEST_F(HashCommandsTest, Hexists_NonExistentField_ReturnsZero) {
     std::vector<std::string> args = {"HEXISTS", "existing_hash", "non_existent_field"};
-    std::string result = hashCommands->cmdHexists(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHexists, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -215,7 +226,7 @@ TEST_F(HashCommandsTest, Hexists_NonExistentField_ReturnsZero) {
 // Test HEXISTS command with non-existent hash
 TEST_F(HashCommandsTest, Hexists_NonExistentHash_ReturnsZero) {
     std::vector<std::string> args = {"HEXISTS", "non_existent_hash", "field1"};
-    std::string result = hashCommands->cmdHexists(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHexists, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -223,7 +234,7 @@ TEST_F(HashCommandsTest, Hexists_NonExistentHash_ReturnsZero) {
 // Test HEXISTS command with wrong type
 TEST_F(HashCommandsTest, Hexists_WrongType_ReturnsZero) {
     std::vector<std::string> args = {"HEXISTS", "string_key", "field1"};
-    std::string result = hashCommands->cmdHexists(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHexists, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -231,7 +242,7 @@ TEST_F(HashCommandsTest, Hexists_WrongType_ReturnsZero) {
 // Test HEXISTS command with wrong number of arguments
 TEST_F(HashCommandsTest, Hexists_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"HEXISTS", "existing_hash"}; // Missing field
-    std::string result = hashCommands->cmdHexists(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHexists, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -239,7 +250,7 @@ TEST_F(HashCommandsTest, Hexists_WrongNumberOfArguments_ReturnsError) {
 // Test HLEN command with non-empty hash
 TEST_F(HashCommandsTest, Hlen_NonEmptyHash_ReturnsFieldCount) {
     std::vector<std::string> args = {"HLEN", "existing_hash"};
-    std::string result = hashCommands->cmdHlen(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHlen, args);
     
     EXPECT_EQ(":3\r\n", result); // 3 fields
 }
@@ -247,7 +258,7 @@ TEST_F(HashCommandsTest, Hlen_NonEmptyHash_ReturnsFieldCount) {
 // Test HLEN command with empty hash
 TEST_F(HashCommandsTest, Hlen_EmptyHash_ReturnsZero) {
     std::vector<std::string> args = {"HLEN", "empty_hash"};
-    std::string result = hashCommands->cmdHlen(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHlen, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -255,7 +266,7 @@ TEST_F(HashCommandsTest, Hlen_EmptyHash_ReturnsZero) {
 // Test HLEN command with non-existent hash
 TEST_F(HashCommandsTest, Hlen_NonExistentHash_ReturnsZero) {
     std::vector<std::string> args = {"HLEN", "non_existent_hash"};
-    std::string result = hashCommands->cmdHlen(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHlen, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -263,7 +274,7 @@ TEST_F(HashCommandsTest, Hlen_NonExistentHash_ReturnsZero) {
 // Test HLEN command with wrong type
 TEST_F(HashCommandsTest, Hlen_WrongType_ReturnsZero) {
     std::vector<std::string> args = {"HLEN", "string_key"};
-    std::string result = hashCommands->cmdHlen(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHlen, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -271,7 +282,7 @@ TEST_F(HashCommandsTest, Hlen_WrongType_ReturnsZero) {
 // Test HLEN command with wrong number of arguments
 TEST_F(HashCommandsTest, Hlen_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"HLEN"}; // Missing key
-    std::string result = hashCommands->cmdHlen(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHlen, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -279,7 +290,7 @@ TEST_F(HashCommandsTest, Hlen_WrongNumberOfArguments_ReturnsError) {
 // Test HKEYS command with non-empty hash
 TEST_F(HashCommandsTest, Hkeys_NonEmptyHash_ReturnsAllKeys) {
     std::vector<std::string> args = {"HKEYS", "user_hash"};
-    std::string result = hashCommands->cmdHkeys(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHkeys, args);
     
     // Should return all field names in an array
     EXPECT_TRUE(result.find("name") != std::string::npos);
@@ -291,7 +302,7 @@ TEST_F(HashCommandsTest, Hkeys_NonEmptyHash_ReturnsAllKeys) {
 // Test HKEYS command with empty hash
 TEST_F(HashCommandsTest, Hkeys_EmptyHash_ReturnsEmptyArray) {
     std::vector<std::string> args = {"HKEYS", "empty_hash"};
-    std::string result = hashCommands->cmdHkeys(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHkeys, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -299,7 +310,7 @@ TEST_F(HashCommandsTest, Hkeys_EmptyHash_ReturnsEmptyArray) {
 // Test HKEYS command with non-existent hash
 TEST_F(HashCommandsTest, Hkeys_NonExistentHash_ReturnsEmptyArray) {
     std::vector<std::string> args = {"HKEYS", "non_existent_hash"};
-    std::string result = hashCommands->cmdHkeys(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHkeys, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -307,7 +318,7 @@ TEST_F(HashCommandsTest, Hkeys_NonExistentHash_ReturnsEmptyArray) {
 // Test HKEYS command with wrong type
 TEST_F(HashCommandsTest, Hkeys_WrongType_ReturnsEmptyArray) {
     std::vector<std::string> args = {"HKEYS", "string_key"};
-    std::string result = hashCommands->cmdHkeys(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHkeys, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -315,7 +326,7 @@ TEST_F(HashCommandsTest, Hkeys_WrongType_ReturnsEmptyArray) {
 // Test HKEYS command with wrong number of arguments
 TEST_F(HashCommandsTest, Hkeys_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"HKEYS"}; // Missing key
-    std::string result = hashCommands->cmdHkeys(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHkeys, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -323,7 +334,7 @@ TEST_F(HashCommandsTest, Hkeys_WrongNumberOfArguments_ReturnsError) {
 // Test HVALS command with non-empty hash
 TEST_F(HashCommandsTest, Hvals_NonEmptyHash_ReturnsAllValues) {
     std::vector<std::string> args = {"HVALS", "user_hash"};
-    std::string result = hashCommands->cmdHvals(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHvals, args);
     
     // Should return all field values in an array
     EXPECT_TRUE(result.find("Alice") != std::string::npos);
@@ -335,7 +346,7 @@ TEST_F(HashCommandsTest, Hvals_NonEmptyHash_ReturnsAllValues) {
 // Test HVALS command with empty hash
 TEST_F(HashCommandsTest, Hvals_EmptyHash_ReturnsEmptyArray) {
     std::vector<std::string> args = {"HVALS", "empty_hash"};
-    std::string result = hashCommands->cmdHvals(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHvals, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -343,7 +354,7 @@ TEST_F(HashCommandsTest, Hvals_EmptyHash_ReturnsEmptyArray) {
 // Test HVALS command with non-existent hash
 TEST_F(HashCommandsTest, Hvals_NonExistentHash_ReturnsEmptyArray) {
     std::vector<std::string> args = {"HVALS", "non_existent_hash"};
-    std::string result = hashCommands->cmdHvals(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHvals, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -351,7 +362,7 @@ TEST_F(HashCommandsTest, Hvals_NonExistentHash_ReturnsEmptyArray) {
 // Test HVALS command with wrong type
 TEST_F(HashCommandsTest, Hvals_WrongType_ReturnsEmptyArray) {
     std::vector<std::string> args = {"HVALS", "string_key"};
-    std::string result = hashCommands->cmdHvals(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHvals, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -359,7 +370,7 @@ TEST_F(HashCommandsTest, Hvals_WrongType_ReturnsEmptyArray) {
 // Test HVALS command with wrong number of arguments
 TEST_F(HashCommandsTest, Hvals_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"HVALS"}; // Missing key
-    std::string result = hashCommands->cmdHvals(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHvals, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -367,7 +378,7 @@ TEST_F(HashCommandsTest, Hvals_WrongNumberOfArguments_ReturnsError) {
 // Test HGETALL command with non-empty hash
 TEST_F(HashCommandsTest, Hgetall_NonEmptyHash_ReturnsAllFieldsAndValues) {
     std::vector<std::string> args = {"HGETALL", "user_hash"};
-    std::string result = hashCommands->cmdHgetall(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHgetall, args);
     
     // Should return field-value pairs in an array
     EXPECT_TRUE(result.find("name") != std::string::npos);
@@ -386,7 +397,7 @@ TEST_F(HashCommandsTest, Hgetall_NonEmptyHash_ReturnsAllFieldsAndValues) {
 // Test HGETALL command with empty hash
 TEST_F(HashCommandsTest, Hgetall_EmptyHash_ReturnsEmptyArray) {
     std::vector<std::string> args = {"HGETALL", "empty_hash"};
-    std::string result = hashCommands->cmdHgetall(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHgetall, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -394,7 +405,7 @@ TEST_F(HashCommandsTest, Hgetall_EmptyHash_ReturnsEmptyArray) {
 // Test HGETALL command with non-existent hash
 TEST_F(HashCommandsTest, Hgetall_NonExistentHash_ReturnsEmptyArray) {
     std::vector<std::string> args = {"HGETALL", "non_existent_hash"};
-    std::string result = hashCommands->cmdHgetall(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHgetall, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -402,7 +413,7 @@ TEST_F(HashCommandsTest, Hgetall_NonExistentHash_ReturnsEmptyArray) {
 // Test HGETALL command with wrong type
 TEST_F(HashCommandsTest, Hgetall_WrongType_ReturnsEmptyArray) {
     std::vector<std::string> args = {"HGETALL", "string_key"};
-    std::string result = hashCommands->cmdHgetall(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHgetall, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -410,7 +421,7 @@ TEST_F(HashCommandsTest, Hgetall_WrongType_ReturnsEmptyArray) {
 // Test HGETALL command with wrong number of arguments
 TEST_F(HashCommandsTest, Hgetall_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"HGETALL"}; // Missing key
-    std::string result = hashCommands->cmdHgetall(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHgetall, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -419,36 +430,36 @@ TEST_F(HashCommandsTest, Hgetall_WrongNumberOfArguments_ReturnsError) {
 TEST_F(HashCommandsTest, Integration_MultipleHashOperations) {
     // Create a hash with HSET
     std::vector<std::string> hset_args = {"HSET", "integration_hash", "name", "John", "age", "25", "city", "London"};
-    std::string hset_result = hashCommands->cmdHset(hset_args);
+    std::string hset_result = runCommand(hashCommands, &HashCommands::cmdHset, hset_args);
     EXPECT_EQ(":3\r\n", hset_result);
     
     // Check field existence with HEXISTS
     std::vector<std::string> hexists_args = {"HEXISTS", "integration_hash", "name"};
-    std::string hexists_result = hashCommands->cmdHexists(hexists_args);
+    std::string hexists_result = runCommand(hashCommands, &HashCommands::cmdHexists, hexists_args);
     EXPECT_EQ(":1\r\n", hexists_result);
     
     // Get a value with HGET
     std::vector<std::string> hget_args = {"HGET", "integration_hash", "age"};
-    std::string hget_result = hashCommands->cmdHget(hget_args);
+    std::string hget_result = runCommand(hashCommands, &HashCommands::cmdHget, hget_args);
     EXPECT_EQ("$2\r\n25\r\n", hget_result);
     
     // Check field count with HLEN
     std::vector<std::string> hlen_args = {"HLEN", "integration_hash"};
-    std::string hlen_result = hashCommands->cmdHlen(hlen_args);
+    std::string hlen_result = runCommand(hashCommands, &HashCommands::cmdHlen, hlen_args);
     EXPECT_EQ(":3\r\n", hlen_result);
     
     // Update a field with HSET
     std::vector<std::string> hset_update_args = {"HSET", "integration_hash", "age", "26", "country", "UK"};
-    std::string hset_update_result = hashCommands->cmdHset(hset_update_args);
+    std::string hset_update_result = runCommand(hashCommands, &HashCommands::cmdHset, hset_update_args);
     EXPECT_EQ(":1\r\n", hset_update_result); // Only country is new
     
     // Check updated field count
-    hlen_result = hashCommands->cmdHlen(hlen_args);
+    hlen_result = runCommand(hashCommands, &HashCommands::cmdHlen, hlen_args);
     EXPECT_EQ(":4\r\n", hlen_result);
     
     // Get all keys with HKEYS
     std::vector<std::string> hkeys_args = {"HKEYS", "integration_hash"};
-    std::string hkeys_result = hashCommands->cmdHkeys(hkeys_args);
+    std::string hkeys_result = runCommand(hashCommands, &HashCommands::cmdHkeys, hkeys_args);
     EXPECT_TRUE(hkeys_result.find("name") != std::string::npos);
     EXPECT_TRUE(hkeys_result.find("age") != std::string::npos);
     EXPECT_TRUE(hkeys_result.find("city") != std::string::npos);
@@ -456,7 +467,7 @@ TEST_F(HashCommandsTest, Integration_MultipleHashOperations) {
     
     // Get all values with HVALS
     std::vector<std::string> hvals_args = {"HVALS", "integration_hash"};
-    std::string hvals_result = hashCommands->cmdHvals(hvals_args);
+    std::string hvals_result = runCommand(hashCommands, &HashCommands::cmdHvals, hvals_args);
     EXPECT_TRUE(hvals_result.find("John") != std::string::npos);
     EXPECT_TRUE(hvals_result.find("26") != std::string::npos); // Updated age
     EXPECT_TRUE(hvals_result.find("London") != std::string::npos);
@@ -464,7 +475,7 @@ TEST_F(HashCommandsTest, Integration_MultipleHashOperations) {
     
     // Get everything with HGETALL
     std::vector<std::string> hgetall_args = {"HGETALL", "integration_hash"};
-    std::string hgetall_result = hashCommands->cmdHgetall(hgetall_args);
+    std::string hgetall_result = runCommand(hashCommands, &HashCommands::cmdHgetall, hgetall_args);
     EXPECT_TRUE(hgetall_result.find("name") != std::string::npos);
     EXPECT_TRUE(hgetall_result.find("John") != std::string::npos);
     EXPECT_TRUE(hgetall_result.find("age") != std::string::npos);
@@ -472,27 +483,27 @@ TEST_F(HashCommandsTest, Integration_MultipleHashOperations) {
     
     // Delete some fields with HDEL
     std::vector<std::string> hdel_args = {"HDEL", "integration_hash", "city", "country", "non_existent"};
-    std::string hdel_result = hashCommands->cmdHdel(hdel_args);
+    std::string hdel_result = runCommand(hashCommands, &HashCommands::cmdHdel, hdel_args);
     EXPECT_EQ(":2\r\n", hdel_result);
     
     // Final field count
-    hlen_result = hashCommands->cmdHlen(hlen_args);
+    hlen_result = runCommand(hashCommands, &HashCommands::cmdHlen, hlen_args);
     EXPECT_EQ(":2\r\n", hlen_result);
 }
 
 // Test edge case: Empty field names and values
 TEST_F(HashCommandsTest, EdgeCase_EmptyFieldNamesAndValues) {
     std::vector<std::string> args = {"HSET", "edge_hash", "", "empty_value", "empty_field", ""};
-    std::string result = hashCommands->cmdHset(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHset, args);
     
     EXPECT_EQ(":2\r\n", result);
     
     RedisValue* value = database->getValue("edge_hash");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::HASH) {
-        EXPECT_EQ(2, value->hash_value.size());
-        EXPECT_EQ("empty_value", value->hash_value[""]);
-        EXPECT_EQ("", value->hash_value["empty_field"]);
+    if (value && value->type() == RedisType::HASH) {
+        EXPECT_EQ(2, value->hash().size());
+        EXPECT_EQ("empty_value", fieldValue(value, ""));
+        EXPECT_EQ("", fieldValue(value, "empty_field"));
     }
 }
 
@@ -505,17 +516,17 @@ TEST_F(HashCommandsTest, EdgeCase_LargeHashOperations) {
         args.push_back("value_" + std::to_string(i));
     }
     
-    std::string result = hashCommands->cmdHset(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHset, args);
     EXPECT_EQ(":100\r\n", result);
     
     // Check field count
     std::vector<std::string> hlen_args = {"HLEN", "large_hash"};
-    std::string hlen_result = hashCommands->cmdHlen(hlen_args);
+    std::string hlen_result = runCommand(hashCommands, &HashCommands::cmdHlen, hlen_args);
     EXPECT_EQ(":100\r\n", hlen_result);
     
     // Get a specific field
     std::vector<std::string> hget_args = {"HGET", "large_hash", "field_50"};
-    std::string hget_result = hashCommands->cmdHget(hget_args);
+    std::string hget_result = runCommand(hashCommands, &HashCommands::cmdHget, hget_args);
     
     EXPECT_EQ("$8\r\nvalue_50\r\n", hget_result);
     
@@ -525,26 +536,77 @@ TEST_F(HashCommandsTest, EdgeCase_LargeHashOperations) {
         hdel_args.push_back("field_" + std::to_string(i));
     }
     
-    std::string hdel_result = hashCommands->cmdHdel(hdel_args);
+    std::string hdel_result = runCommand(hashCommands, &HashCommands::cmdHdel, hdel_args);
     EXPECT_EQ(":50\r\n", hdel_result);
     
     // Final field count
-    hlen_result = hashCommands->cmdHlen(hlen_args);
+    hlen_result = runCommand(hashCommands, &HashCommands::cmdHlen, hlen_args);
     EXPECT_EQ(":50\r\n", hlen_result);
 }
 
 // Test edge case: Special characters in field names and values
 TEST_F(HashCommandsTest, EdgeCase_SpecialCharacters) {
     std::vector<std::string> args = {"HSET", "special_hash", "field with spaces", "value with spaces", "field\nwith\nnewlines", "value\nwith\nnewlines"};
-    std::string result = hashCommands->cmdHset(args);
+    std::string result = runCommand(hashCommands, &HashCommands::cmdHset, args);
     
     EXPECT_EQ(":2\r\n", result);
     
     RedisValue* value = database->getValue("special_hash");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::HASH) {
-        EXPECT_EQ(2, value->hash_value.size());
-        EXPECT_EQ("value with spaces", value->hash_value["field with spaces"]);
-        EXPECT_EQ("value\nwith\nnewlines", value->hash_value["field\nwith\nnewlines"]);
+    if (value && value->type() == RedisType::HASH) {
+        EXPECT_EQ(2, value->hash().size());
+        EXPECT_EQ("value with spaces", fieldValue(value, "field with spaces"));
+        EXPECT_EQ("value\nwith\nnewlines", fieldValue(value, "field\nwith\nnewlines"));
+    }
+}
+
+// Test HSCAN returns field-value pairs, filtered by field
+TEST_F(HashCommandsTest, Hscan_ReturnsFieldValuePairs) {
+    ScanReply reply = parseScanReply(runCommand(hashCommands, &HashCommands::cmdHscan,
+                                                {"HSCAN", "user_hash", "0", "MATCH", "*a*"}));
+    EXPECT_EQ("0", reply.cursor);
+    std::unordered_map<std::string, std::string> pairs;
+    ASSERT_EQ(0u, reply.elements.size() % 2);
+    for (size_t i = 0; i < reply.elements.size(); i += 2) {
+        pairs[reply.elements[i]] = reply.elements[i + 1];
     }
-}
\ No newline at end of file
+    EXPECT_EQ((std::unordered_map<std::string, std::string>{{"name", "Alice"}, {"age", "30"}}), pairs);
+
+    EXPECT_EQ("*2\r\n$1\r\n0\r\n*0\r\n",
+              runCommand(hashCommands, &HashCommands::cmdHscan, {"HSCAN", "no_such_hash", "0"}));
+    EXPECT_EQ("-ERR Operation against a key holding the wrong kind of value\r\n",
+              runCommand(hashCommands, &HashCommands::cmdHscan, {"HSCAN", "string_key", "0"}));
+}
+
+// Test HSCAN stays complete when the hash grows between calls
+TEST_F(HashCommandsTest, Hscan_GrowingHash_MissesNothing) {
+    RedisValue large(RedisType::HASH);
+    for (int i = 0; i < 300; ++i) {
+        large.hash().tryEmplace(HashedKey("f" + std::to_string(i)), "v");
+    }
+    database->setValue("large_hash", large);
+
+    std::set<std::string> seen;
+    std::string cursor = "0";
+    int added = 0;
+    size_t calls = 0;
+    do {
+        ASSERT_LT(++calls, 1000u) << "the cursor never came back to 0";
+        ScanReply reply = parseScanReply(runCommand(hashCommands, &HashCommands::cmdHscan,
+                                                    {"HSCAN", "large_hash", cursor, "COUNT", "20"}));
+        for (size_t i = 0; i < reply.elements.size(); i += 2) seen.insert(reply.elements[i]);
+        cursor = reply.cursor;
+        if (added < 2000) {
+            std::vector<std::string> args = {"HSET", "large_hash"};
+            for (int i = 0; i < 100; ++i, ++added) {
+                args.push_back("new" + std::to_string(added));
+                args.push_back("v");
+            }
+            runCommand(hashCommands, &HashCommands::cmdHset, args);
+        }
+    } while (cursor != "0");
+
+    for (int i = 0; i < 300; ++i) {
+        EXPECT_TRUE(seen.count("f" + std::to_string(i))) << i;
+    }
+}
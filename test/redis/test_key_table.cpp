@@ -0,0 +1,361 @@
+// test_key_table.cpp
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "redis/database/key_table.h"
+
+class KeyTableTest : public ::testing::Test {
+protected:
+    KeyTable<int> table;
+
+    bool insert(const std::string& key, int value) {
+        return table.tryEmplace(HashedKey(key), value).second;
+    }
+
+    const int* find(const std::string& key) const {
+        auto* entry = table.find(HashedKey(key));
+        return entry ? &entry->value : nullptr;
+    }
+
+    bool erase(const std::string& key) {
+        auto* entry = table.find(HashedKey(key));
+        if (!entry) return false;
+        table.erase(entry);
+        return true;
+    }
+};
+
+TEST_F(KeyTableTest, InsertFindErase) {
+    EXPECT_EQ(find("missing"), nullptr);
+    EXPECT_TRUE(insert("a", 1));
+    EXPECT_FALSE(insert("a", 2));
+    ASSERT_NE(find("a"), nullptr);
+    EXPECT_EQ(*find("a"), 1);
+    EXPECT_EQ(table.size(), 1u);
+
+    auto* entry = table.find(HashedKey("a"));
+    EXPECT_EQ(entry->key.view(), "a");
+    EXPECT_EQ(entry->hash, StringHash::hash("a"));
+
+    EXPECT_TRUE(erase("a"));
+    EXPECT_FALSE(erase("a"));
+    EXPECT_TRUE(table.empty());
+}
+
+// Keys past the inline capacity move to the heap and must survive
+// migration between tables like inline ones
+TEST_F(KeyTableTest, LongAndShortKeysAcrossRehash) {
+    const std::string long_prefix(EmbeddedString::INLINE_CAPACITY, 'p');
+    for (int i = 0; i < 5000; ++i) {
+        EXPECT_TRUE(insert("k" + std::to_string(i), i));
+        EXPECT_TRUE(insert(long_prefix + std::to_string(i), -i));
+    }
+    while (table.rehashStep(64)) {}
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_NE(find("k" + std::to_string(i)), nullptr);
+        EXPECT_EQ(*find(long_prefix + std::to_string(i)), -i);
+    }
+    auto* entry = table.find(HashedKey(long_prefix + "7"));
+    ASSERT_NE(entry, nullptr);
+    EXPECT_FALSE(entry->key.isInline());
+    EXPECT_EQ(entry->key.view(), long_prefix + "7");
+}
+
+// Slices of eraseIfStep, resumed from the cursor, together cover the
+// whole table like one eraseIf
+TEST_F(KeyTableTest, EraseIfStepCoversTableInSlices) {
+    for (int i = 0; i < 1000; ++i) {
+        insert("k" + std::to_string(i), i);
+    }
+    size_t cursor = 0;
+    size_t visited = 0;
+    size_t erased = 0;
+    do {
+        auto step = table.eraseIfStep(cursor, 20, [](const KeyTable<int>::Entry& entry) {
+            return entry.value % 2 == 0;
+        });
+        EXPECT_LE(step.visited, 20u);
+        visited += step.visited;
+        erased += step.erased;
+    } while (cursor != 0);
+
+    EXPECT_EQ(visited, 1000u);
+    EXPECT_EQ(erased, 500u);
+    EXPECT_EQ(table.size(), 500u);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(find("k" + std::to_string(i)) != nullptr, i % 2 == 1) << i;
+    }
+}
+
+TEST_F(KeyTableTest, GrowsIncrementallyAndStaysConsistent) {
+    bool saw_rehash = false;
+    for (int i = 0; i < 20000; ++i) {
+        ASSERT_TRUE(insert("key:" + std::to_string(i), i));
+        saw_rehash = saw_rehash || table.isRehashing();
+        // Everything inserted so far is reachable mid-rehash
+        if (i % 997 == 0) {
+            for (int j = 0; j <= i; j += 13) {
+                const int* value = find("key:" + std::to_string(j));
+                ASSERT_NE(value, nullptr) << j;
+                EXPECT_EQ(*value, j);
+            }
+        }
+    }
+    EXPECT_TRUE(saw_rehash);
+    EXPECT_EQ(table.size(), 20000u);
+
+    while (table.rehashStep(8)) {}
+    EXPECT_FALSE(table.isRehashing());
+    EXPECT_EQ(table.size(), 20000u);
+    EXPECT_EQ(*find("key:19999"), 19999);
+}
+
+TEST_F(KeyTableTest, MatchesUnorderedMapUnderRandomOperations) {
+    std::unordered_map<std::string, int> reference;
+    std::mt19937 rng(42);
+    for (int i = 0; i < 200000; ++i) {
+        std::string key = "k" + std::to_string(rng() % 5000);
+        switch (rng() % 3) {
+            case 0:
+                EXPECT_EQ(insert(key, i), reference.emplace(key, i).second);
+                break;
+            case 1:
+                EXPECT_EQ(erase(key), reference.erase(key) > 0);
+                break;
+            default: {
+                const int* value = find(key);
+                auto it = reference.find(key);
+                ASSERT_EQ(value != nullptr, it != reference.end()) << key;
+                if (value) {
+                    EXPECT_EQ(*value, it->second);
+                }
+            }
+        }
+    }
+    EXPECT_EQ(table.size(), reference.size());
+
+    size_t visited = 0;
+    table.forEach([&](const KeyTable<int>::Entry& entry) {
+        visited++;
+        EXPECT_EQ(reference.at(std::string(entry.key.view())), entry.value);
+    });
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST_F(KeyTableTest, ChurnDoesNotGrowTheTable) {
+    // Constant size with endless inserts and erases: tombstones must be
+    // recycled instead of forcing the table to double
+    for (int i = 0; i < 100; ++i) insert("live" + std::to_string(i), i);
+    for (int i = 0; i < 100000; ++i) {
+        insert("temp" + std::to_string(i), i);
+        erase("temp" + std::to_string(i));
+    }
+    EXPECT_EQ(table.size(), 100u);
+    EXPECT_LE(table.capacity(), 1024u);
+}
+
+TEST_F(KeyTableTest, ShrinksAfterMassDelete) {
+    for (int i = 0; i < 10000; ++i) insert(std::to_string(i), i);
+    while (table.rehashStep(64)) {}
+    size_t grown = table.capacity();
+
+    size_t erased = table.eraseIf([](const KeyTable<int>::Entry& entry) { return entry.value >= 10; });
+    EXPECT_EQ(erased, 9990u);
+    while (table.rehashStep(64)) {}
+    EXPECT_LT(table.capacity(), grown);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_NE(find(std::to_string(i)), nullptr);
+    }
+}
+
+TEST_F(KeyTableTest, ClearReleasesEverything) {
+    for (int i = 0; i < 1000; ++i) insert(std::to_string(i), i);
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.capacity(), 0u);
+    EXPECT_EQ(find("1"), nullptr);
+    EXPECT_TRUE(insert("1", 1));
+}
+
+TEST_F(KeyTableTest, SampleVisitsConsecutiveEntries) {
+    for (int i = 0; i < 1000; ++i) insert(std::to_string(i), i);
+
+    std::vector<int> seen;
+    size_t found = table.sample(12345, 5, [&seen](const KeyTable<int>::Entry& entry) {
+        seen.push_back(entry.value);
+    });
+    EXPECT_EQ(found, 5u);
+    ASSERT_EQ(seen.size(), 5u);
+    std::sort(seen.begin(), seen.end());
+    EXPECT_EQ(std::unique(seen.begin(), seen.end()), seen.end());
+
+    // Never more than the table holds, wrapping at the end
+    KeyTable<int> small;
+    small.tryEmplace(HashedKey("only"), 1);
+    EXPECT_EQ(small.sample(SIZE_MAX, 5, [](const KeyTable<int>::Entry&) {}), 1u);
+    KeyTable<int> empty;
+    EXPECT_EQ(empty.sample(0, 5, [](const KeyTable<int>::Entry&) {}), 0u);
+}
+
+TEST_F(KeyTableTest, LookupsFindDisplacedKeysMidRehash) {
+    // Enough keys for probe chains to spill out of their home groups; the
+    // migration must keep those reachable from both tables
+    for (int i = 0; i < 50000; ++i) {
+        ASSERT_TRUE(insert("k" + std::to_string(i), i));
+        if (table.isRehashing() && i % 101 == 0) {
+            for (int j = 0; j <= i; j += 7) {
+                ASSERT_NE(find("k" + std::to_string(j)), nullptr) << j << " after " << i;
+            }
+        }
+    }
+}
+
+TEST_F(KeyTableTest, CollidingKeysSurviveRehash) {
+    // Keys whose home group index ends in ten zero bits share one probe
+    // chain at every size the table passes through, so the chain runs
+    // across groups the migration has already drained
+    std::vector<std::string> colliding;
+    for (uint64_t i = 0; colliding.size() < 300; ++i) {
+        std::string key = "c" + std::to_string(i);
+        if (((StringHash::hash(key) >> 7) & 1023) == 0) colliding.push_back(key);
+    }
+
+    bool saw_rehash = false;
+    for (size_t i = 0; i < colliding.size(); ++i) {
+        ASSERT_TRUE(insert(colliding[i], static_cast<int>(i)));
+        insert("plain" + std::to_string(i), -1);
+        saw_rehash = saw_rehash || table.isRehashing();
+        for (size_t j = 0; j <= i; ++j) {
+            const int* value = find(colliding[j]);
+            ASSERT_NE(value, nullptr) << j << " after " << i;
+            EXPECT_EQ(*value, static_cast<int>(j));
+        }
+        // An existing key is found, not inserted a second time
+        ASSERT_FALSE(insert(colliding[i / 2], -2));
+    }
+    EXPECT_TRUE(saw_rehash);
+    EXPECT_EQ(table.size(), 2 * colliding.size());
+
+    while (table.rehashStep(1)) {}
+    size_t visited = 0;
+    table.forEach([&visited](const KeyTable<int>::Entry&) { visited++; });
+    EXPECT_EQ(visited, 2 * colliding.size());
+}
+
+TEST_F(KeyTableTest, SmallTablesUseAPartialGroup) {
+    // A hash value with a couple of fields should not pay for 16 slots
+    insert("a", 1);
+    insert("b", 2);
+    EXPECT_EQ(table.capacity(), 4u);
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_TRUE(insert("k" + std::to_string(i), i));
+        for (int j = 0; j <= i; ++j) {
+            ASSERT_NE(find("k" + std::to_string(j)), nullptr) << j << " after " << i;
+        }
+    }
+    while (table.rehashStep(8)) {}
+    for (int i = 0; i < 40; ++i) erase("k" + std::to_string(i));
+    while (table.rehashStep(8)) {}
+    EXPECT_EQ(table.size(), 2u);
+    EXPECT_LE(table.capacity(), 16u);
+    EXPECT_EQ(*find("a"), 1);
+    EXPECT_EQ(*find("b"), 2);
+}
+
+TEST_F(KeyTableTest, CopiesHoldTheSameEntries) {
+    for (int i = 0; i < 1000; ++i) insert(std::to_string(i), i);
+    KeyTable<int> copy(table);
+    EXPECT_FALSE(copy.isRehashing());
+    EXPECT_EQ(copy.size(), table.size());
+    for (int i = 0; i < 1000; ++i) {
+        auto* entry = copy.find(HashedKey(std::to_string(i)));
+        ASSERT_NE(entry, nullptr) << i;
+        EXPECT_EQ(entry->value, i);
+    }
+    EXPECT_TRUE(copy.erase(HashedKey("5")));
+    EXPECT_FALSE(copy.erase(HashedKey("5")));
+    EXPECT_NE(find("5"), nullptr);
+}
+
+TEST(KeyTableValueTest, OwnsNonTrivialValues) {
+    KeyTable<std::string> strings;
+    for (int i = 0; i < 5000; ++i) {
+        strings.tryEmplace(HashedKey(std::to_string(i)), std::string(100, 'x'));
+    }
+    // Entries are moved by the migration, not copied
+    EXPECT_EQ(strings.find(HashedKey("4999"))->value.size(), 100u);
+    strings.clear();
+}
+
+// Worst single insert while growing to a few million keys, against
+// std::unordered_map. Run with --gtest_also_run_disabled_tests
+TEST_F(KeyTableTest, DISABLED_InsertLatencyBenchmark) {
+    const int key_count = 4000000;
+    std::vector<std::string> keys;
+    keys.reserve(key_count);
+    for (int i = 0; i < key_count; ++i) keys.push_back("key:" + std::to_string(i));
+
+    using Clock = std::chrono::steady_clock;
+    std::unordered_map<std::string, int> std_map;
+    Clock::duration std_worst{};
+    auto start = Clock::now();
+    for (int i = 0; i < key_count; ++i) {
+        auto before = Clock::now();
+        std_map.emplace(keys[i], i);
+        std_worst = std::max(std_worst, Clock::now() - before);
+    }
+    std::chrono::duration<double, std::milli> std_total = Clock::now() - start;
+
+    Clock::duration table_worst{};
+    start = Clock::now();
+    for (int i = 0; i < key_count; ++i) {
+        auto before = Clock::now();
+        table.tryEmplace(HashedKey(keys[i]), i);
+        table_worst = std::max(table_worst, Clock::now() - before);
+    }
+    std::chrono::duration<double, std::milli> table_total = Clock::now() - start;
+
+    using Micros = std::chrono::duration<double, std::micro>;
+    std::cout << "std::unordered_map: " << std_total.count() << " ms total, worst insert "
+              << Micros(std_worst).count() << " us" << std::endl;
+    std::cout << "KeyTable:           " << table_total.count() << " ms total, worst insert "
+              << Micros(table_worst).count() << " us" << std::endl;
+    EXPECT_EQ(table.size(), static_cast<size_t>(key_count));
+}
+
+TEST_F(KeyTableTest, ScanVisitsEveryEntryWhileResizing) {
+    for (int i = 0; i < 3000; ++i) insert("stay" + std::to_string(i), i);
+    while (table.rehashStep(64)) {}
+
+    // Grow through several doublings, then shrink, between scan steps:
+    // every key present throughout must still come back
+    std::unordered_map<int, int> seen;
+    uint64_t cursor = 0;
+    int added = 0;
+    int steps = 0;
+    do {
+        cursor = table.scan(cursor, [&seen](const KeyTable<int>::Entry& entry) {
+            seen[entry.value]++;
+        });
+        if (++steps < 200) {
+            for (int i = 0; i < 100; ++i, ++added) insert("grow" + std::to_string(added), -1);
+        } else if (steps == 200) {
+            table.eraseIf([](const KeyTable<int>::Entry& entry) { return entry.value < 0; });
+        }
+    } while (cursor != 0);
+
+    for (int i = 0; i < 3000; ++i) {
+        ASSERT_GE(seen[i], 1) << i;
+    }
+    // Repeats are allowed, but only from the resizes
+    EXPECT_LT(seen.size(), 3002u);
+
+    KeyTable<int> empty;
+    EXPECT_EQ(empty.scan(0, [](const KeyTable<int>::Entry&) {}), 0u);
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "redis/database/lazy_free.h"
+
+// Records which thread destroyed it
+struct Tracked {
+    std::thread::id* destroyed_on;
+    explicit Tracked(std::thread::id* target) : destroyed_on(target) {}
+    Tracked(Tracked&& other) noexcept : destroyed_on(other.destroyed_on) { other.destroyed_on = nullptr; }
+    ~Tracked() {
+        if (destroyed_on) *destroyed_on = std::this_thread::get_id();
+    }
+};
+
+class LazyFreeTest : public ::testing::Test {
+protected:
+    LazyFree& lazy_free = LazyFree::instance();
+};
+
+TEST_F(LazyFreeTest, DestroysOnBackgroundThread) {
+    std::thread::id destroyed_on;
+    lazy_free.free(Tracked(&destroyed_on));
+    lazy_free.waitIdle();
+    EXPECT_NE(destroyed_on, std::thread::id());
+    EXPECT_NE(destroyed_on, std::this_thread::get_id());
+}
+
+TEST_F(LazyFreeTest, WaitIdleDrainsEverything) {
+    lazy_free.waitIdle();
+    size_t freed = lazy_free.freed();
+    std::atomic<int> destroyed{0};
+    struct Counted {
+        std::atomic<int>* count;
+        explicit Counted(std::atomic<int>* target) : count(target) {}
+        Counted(Counted&& other) noexcept : count(other.count) { other.count = nullptr; }
+        ~Counted() {
+            if (count) (*count)++;
+        }
+    };
+    for (int i = 0; i < 100; ++i) {
+        lazy_free.free(Counted(&destroyed));
+    }
+    lazy_free.waitIdle();
+    EXPECT_EQ(destroyed.load(), 100);
+    EXPECT_EQ(lazy_free.freed(), freed + 100);
+    EXPECT_EQ(lazy_free.pending(), 0u);
+}
@@ -4,6 +4,7 @@
 #include <string>
 #include <list>
 #include "redis/commands/list_commands.h"
+#include "command_reply.h"
 #include "redis/database/redis_database.h"
 
 // Test fixture for ListCommands tests
@@ -16,11 +17,11 @@ protected:
         
         // Add some test data
         RedisValue list1(RedisType::LIST);
-        list1.list_value = {"item1", "item2", "item3"};
+        list1.list() = {"item1", "item2", "item3"};
         database->setValue("existing_list", list1);
         
         RedisValue list2(RedisType::LIST);
-        list2.list_value = {"a", "b", "c", "d", "e"};
+        list2.list() = {"a", "b", "c", "d", "e"};
         database->setValue("long_list", list2);
         
         RedisValue empty_list(RedisType::LIST);
@@ -42,16 +43,16 @@ protected:
 // Test LPUSH command with new list
 TEST_F(ListCommandsTest, Lpush_NewList_ReturnsListSize) {
     std::vector<std::string> args = {"LPUSH", "new_list", "value1", "value2", "value3"};
-    std::string result = listCommands->cmdLpush(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpush, args);
     
     EXPECT_EQ(":3\r\n", result);
     
     // Verify list was created with elements in correct order (reverse insertion)
     RedisValue* value = database->getValue("new_list");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::LIST) {
-        EXPECT_EQ(3, value->list_value.size());
-        auto it = value->list_value.begin();
+    if (value && value->type() == RedisType::LIST) {
+        EXPECT_EQ(3, value->list().size());
+        auto it = value->list().begin();
         EXPECT_EQ("value3", *it++); // Last pushed element is first
         EXPECT_EQ("value2", *it++);
         EXPECT_EQ("value1", *it);   // First pushed element is last
@@ -61,16 +62,16 @@ TEST_F(ListCommandsTest, Lpush_NewList_ReturnsListSize) {
 // Test LPUSH command with existing list
 TEST_F(ListCommandsTest, Lpush_ExistingList_AddsToFront) {
     std::vector<std::string> args = {"LPUSH", "existing_list", "new_item1", "new_item2"};
-    std::string result = listCommands->cmdLpush(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpush, args);
     
     EXPECT_EQ(":5\r\n", result); // 3 original + 2 new
     
     // Verify elements were added to front in reverse order
     RedisValue* value = database->getValue("existing_list");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::LIST) {
-        EXPECT_EQ(5, value->list_value.size());
-        auto it = value->list_value.begin();
+    if (value && value->type() == RedisType::LIST) {
+        EXPECT_EQ(5, value->list().size());
+        auto it = value->list().begin();
         EXPECT_EQ("new_item2", *it++); // Last pushed element is first
         EXPECT_EQ("new_item1", *it++);
         EXPECT_EQ("item1", *it++);
@@ -82,7 +83,7 @@ TEST_F(ListCommandsTest, Lpush_ExistingList_AddsToFront) {
 // Test LPUSH command with wrong number of arguments
 TEST_F(ListCommandsTest, Lpush_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"LPUSH", "key"}; // Missing values
-    std::string result = listCommands->cmdLpush(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpush, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     EXPECT_TRUE(result.find("lpush") != std::string::npos);
@@ -91,7 +92,7 @@ TEST_F(ListCommandsTest, Lpush_WrongNumberOfArguments_ReturnsError) {
 // Test LPUSH command with wrong type
 TEST_F(ListCommandsTest, Lpush_WrongType_ReturnsError) {
     std::vector<std::string> args = {"LPUSH", "string_key", "value1"};
-    std::string result = listCommands->cmdLpush(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpush, args);
     
     EXPECT_TRUE(result.find("ERR Operation against a key holding the wrong kind of value") != std::string::npos);
 }
@@ -99,16 +100,16 @@ TEST_F(ListCommandsTest, Lpush_WrongType_ReturnsError) {
 // Test RPUSH command with new list
 TEST_F(ListCommandsTest, Rpush_NewList_ReturnsListSize) {
     std::vector<std::string> args = {"RPUSH", "new_list", "value1", "value2", "value3"};
-    std::string result = listCommands->cmdRpush(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpush, args);
     
     EXPECT_EQ(":3\r\n", result);
     
     // Verify list was created with elements in correct order
     RedisValue* value = database->getValue("new_list");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::LIST) {
-        EXPECT_EQ(3, value->list_value.size());
-        auto it = value->list_value.begin();
+    if (value && value->type() == RedisType::LIST) {
+        EXPECT_EQ(3, value->list().size());
+        auto it = value->list().begin();
         EXPECT_EQ("value1", *it++); // First pushed element is first
         EXPECT_EQ("value2", *it++);
         EXPECT_EQ("value3", *it);   // Last pushed element is last
@@ -118,16 +119,16 @@ TEST_F(ListCommandsTest, Rpush_NewList_ReturnsListSize) {
 // Test RPUSH command with existing list
 TEST_F(ListCommandsTest, Rpush_ExistingList_AddsToEnd) {
     std::vector<std::string> args = {"RPUSH", "existing_list", "new_item1", "new_item2"};
-    std::string result = listCommands->cmdRpush(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpush, args);
     
     EXPECT_EQ(":5\r\n", result); // 3 original + 2 new
     
     // Verify elements were added to end in order
     RedisValue* value = database->getValue("existing_list");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::LIST) {
-        EXPECT_EQ(5, value->list_value.size());
-        auto it = value->list_value.begin();
+    if (value && value->type() == RedisType::LIST) {
+        EXPECT_EQ(5, value->list().size());
+        auto it = value->list().begin();
         EXPECT_EQ("item1", *it++);
         EXPECT_EQ("item2", *it++);
         EXPECT_EQ("item3", *it++);
@@ -139,7 +140,7 @@ TEST_F(ListCommandsTest, Rpush_ExistingList_AddsToEnd) {
 // Test RPUSH command with wrong number of arguments
 TEST_F(ListCommandsTest, Rpush_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"RPUSH", "key"}; // Missing values
-    std::string result = listCommands->cmdRpush(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpush, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     EXPECT_TRUE(result.find("rpush") != std::string::npos);
@@ -148,7 +149,7 @@ TEST_F(ListCommandsTest, Rpush_WrongNumberOfArguments_ReturnsError) {
 // Test RPUSH command with wrong type
 TEST_F(ListCommandsTest, Rpush_WrongType_ReturnsError) {
     std::vector<std::string> args = {"RPUSH", "string_key", "value1"};
-    std::string result = listCommands->cmdRpush(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpush, args);
     
     EXPECT_TRUE(result.find("ERR Operation against a key holding the wrong kind of value") != std::string::npos);
 }
@@ -156,16 +157,16 @@ TEST_F(ListCommandsTest, Rpush_WrongType_ReturnsError) {
 // Test LPOP command with non-empty list
 TEST_F(ListCommandsTest, Lpop_NonEmptyList_ReturnsFirstElement) {
     std::vector<std::string> args = {"LPOP", "existing_list"};
-    std::string result = listCommands->cmdLpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpop, args);
     
     EXPECT_EQ("$5\r\nitem1\r\n", result);
     
     // Verify element was removed from front
     RedisValue* value = database->getValue("existing_list");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::LIST) {
-        EXPECT_EQ(2, value->list_value.size());
-        auto it = value->list_value.begin();
+    if (value && value->type() == RedisType::LIST) {
+        EXPECT_EQ(2, value->list().size());
+        auto it = value->list().begin();
         EXPECT_EQ("item2", *it++);
         EXPECT_EQ("item3", *it);
     }
@@ -175,11 +176,11 @@ TEST_F(ListCommandsTest, Lpop_NonEmptyList_ReturnsFirstElement) {
 TEST_F(ListCommandsTest, Lpop_RemovesEmptyList_DeletesKey) {
     // Create a list with one element
     RedisValue single_item_list(RedisType::LIST);
-    single_item_list.list_value = {"only_item"};
+    single_item_list.list() = {"only_item"};
     database->setValue("single_item_list", single_item_list);
     
     std::vector<std::string> args = {"LPOP", "single_item_list"};
-    std::string result = listCommands->cmdLpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpop, args);
     
     EXPECT_EQ("$9\r\nonly_item\r\n", result);
     
@@ -191,7 +192,7 @@ TEST_F(ListCommandsTest, Lpop_RemovesEmptyList_DeletesKey) {
 // Test LPOP command with empty list
 TEST_F(ListCommandsTest, Lpop_EmptyList_ReturnsNull) {
     std::vector<std::string> args = {"LPOP", "empty_list"};
-    std::string result = listCommands->cmdLpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpop, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -199,7 +200,7 @@ TEST_F(ListCommandsTest, Lpop_EmptyList_ReturnsNull) {
 // Test LPOP command with non-existent list
 TEST_F(ListCommandsTest, Lpop_NonExistentList_ReturnsNull) {
     std::vector<std::string> args = {"LPOP", "non_existent_list"};
-    std::string result = listCommands->cmdLpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpop, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -207,7 +208,7 @@ TEST_F(ListCommandsTest, Lpop_NonExistentList_ReturnsNull) {
 // Test LPOP command with wrong type
 TEST_F(ListCommandsTest, Lpop_WrongType_ReturnsNull) {
     std::vector<std::string> args = {"LPOP", "string_key"};
-    std::string result = listCommands->cmdLpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpop, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -215,7 +216,7 @@ TEST_F(ListCommandsTest, Lpop_WrongType_ReturnsNull) {
 // Test LPOP command with wrong number of arguments
 TEST_F(ListCommandsTest, Lpop_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"LPOP"}; // Missing key
-    std::string result = listCommands->cmdLpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLpop, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -223,16 +224,16 @@ TEST_F(ListCommandsTest, Lpop_WrongNumberOfArguments_ReturnsError) {
 // Test RPOP command with non-empty list
 TEST_F(ListCommandsTest, Rpop_NonEmptyList_ReturnsLastElement) {
     std::vector<std::string> args = {"RPOP", "existing_list"};
-    std::string result = listCommands->cmdRpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpop, args);
     
     EXPECT_EQ("$5\r\nitem3\r\n", result);
     
     // Verify element was removed from end
     RedisValue* value = database->getValue("existing_list");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::LIST) {
-        EXPECT_EQ(2, value->list_value.size());
-        auto it = value->list_value.begin();
+    if (value && value->type() == RedisType::LIST) {
+        EXPECT_EQ(2, value->list().size());
+        auto it = value->list().begin();
         EXPECT_EQ("item1", *it++);
         EXPECT_EQ("item2", *it);
     }
@@ -242,11 +243,11 @@ TEST_F(ListCommandsTest, Rpop_NonEmptyList_ReturnsLastElement) {
 TEST_F(ListCommandsTest, Rpop_RemovesEmptyList_DeletesKey) {
     // Create a list with one element
     RedisValue single_item_list(RedisType::LIST);
-    single_item_list.list_value = {"only_item"};
+    single_item_list.list() = {"only_item"};
     database->setValue("single_item_list", single_item_list);
     
     std::vector<std::string> args = {"RPOP", "single_item_list"};
-    std::string result = listCommands->cmdRpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpop, args);
     
     EXPECT_EQ("$9\r\nonly_item\r\n", result);
     
@@ -258,7 +259,7 @@ TEST_F(ListCommandsTest, Rpop_RemovesEmptyList_DeletesKey) {
 // Test RPOP command with empty list
 TEST_F(ListCommandsTest, Rpop_EmptyList_ReturnsNull) {
     std::vector<std::string> args = {"RPOP", "empty_list"};
-    std::string result = listCommands->cmdRpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpop, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -266,7 +267,7 @@ TEST_F(ListCommandsTest, Rpop_EmptyList_ReturnsNull) {
 // Test RPOP command with non-existent list
 TEST_F(ListCommandsTest, Rpop_NonExistentList_ReturnsNull) {
     std::vector<std::string> args = {"RPOP", "non_existent_list"};
-    std::string result = listCommands->cmdRpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpop, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -274,7 +275,7 @@ TEST_F(ListCommandsTest, Rpop_NonExistentList_ReturnsNull) {
 // Test RPOP command with wrong type
 TEST_F(ListCommandsTest, Rpop_WrongType_ReturnsNull) {
     std::vector<std::string> args = {"RPOP", "string_key"};
-    std::string result = listCommands->cmdRpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpop, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -282,7 +283,7 @@ TEST_F(ListCommandsTest, Rpop_WrongType_ReturnsNull) {
 // Test RPOP command with wrong number of arguments
 TEST_F(ListCommandsTest, Rpop_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"RPOP"}; // Missing key
-    std::string result = listCommands->cmdRpop(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpop, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -290,7 +291,7 @@ TEST_F(ListCommandsTest, Rpop_WrongNumberOfArguments_ReturnsError) {
 // Test LLEN command with non-empty list
 TEST_F(ListCommandsTest, Llen_NonEmptyList_ReturnsLength) {
     std::vector<std::string> args = {"LLEN", "existing_list"};
-    std::string result = listCommands->cmdLlen(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLlen, args);
     
     EXPECT_EQ(":3\r\n", result); // 3 elements
 }
@@ -298,7 +299,7 @@ TEST_F(ListCommandsTest, Llen_NonEmptyList_ReturnsLength) {
 // Test LLEN command with empty list
 TEST_F(ListCommandsTest, Llen_EmptyList_ReturnsZero) {
     std::vector<std::string> args = {"LLEN", "empty_list"};
-    std::string result = listCommands->cmdLlen(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLlen, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -306,7 +307,7 @@ TEST_F(ListCommandsTest, Llen_EmptyList_ReturnsZero) {
 // Test LLEN command with non-existent list
 TEST_F(ListCommandsTest, Llen_NonExistentList_ReturnsZero) {
     std::vector<std::string> args = {"LLEN", "non_existent_list"};
-    std::string result = listCommands->cmdLlen(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLlen, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -314,7 +315,7 @@ TEST_F(ListCommandsTest, Llen_NonExistentList_ReturnsZero) {
 // Test LLEN command with wrong type
 TEST_F(ListCommandsTest, Llen_WrongType_ReturnsZero) {
     std::vector<std::string> args = {"LLEN", "string_key"};
-    std::string result = listCommands->cmdLlen(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLlen, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -322,7 +323,7 @@ TEST_F(ListCommandsTest, Llen_WrongType_ReturnsZero) {
 // Test LLEN command with wrong number of arguments
 TEST_F(ListCommandsTest, Llen_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"LLEN"}; // Missing key
-    std::string result = listCommands->cmdLlen(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLlen, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -330,7 +331,7 @@ TEST_F(ListCommandsTest, Llen_WrongNumberOfArguments_ReturnsError) {
 // Test LRANGE command with valid range
 TEST_F(ListCommandsTest, Lrange_ValidRange_ReturnsElements) {
     std::vector<std::string> args = {"LRANGE", "long_list", "1", "3"};
-    std::string result = listCommands->cmdLrange(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLrange, args);
     
     // Should return elements at indices 1, 2, 3: "b", "c", "d"
     EXPECT_TRUE(result.find("b") != std::string::npos);
@@ -342,7 +343,7 @@ TEST_F(ListCommandsTest, Lrange_ValidRange_ReturnsElements) {
 // Test LRANGE command with negative indices
 TEST_F(ListCommandsTest, Lrange_NegativeIndices_ReturnsCorrectElements) {
     std::vector<std::string> args = {"LRANGE", "long_list", "-3", "-1"};
-    std::string result = listCommands->cmdLrange(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLrange, args);
     
     // Should return last 3 elements: "c", "d", "e"
     EXPECT_TRUE(result.find("c") != std::string::npos);
@@ -354,7 +355,7 @@ TEST_F(ListCommandsTest, Lrange_NegativeIndices_ReturnsCorrectElements) {
 // Test LRANGE command with start > end
 TEST_F(ListCommandsTest, Lrange_StartGreaterThanEnd_ReturnsEmptyArray) {
     std::vector<std::string> args = {"LRANGE", "long_list", "3", "1"};
-    std::string result = listCommands->cmdLrange(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLrange, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -362,7 +363,7 @@ TEST_F(ListCommandsTest, Lrange_StartGreaterThanEnd_ReturnsEmptyArray) {
 // Test LRANGE command with out of bounds indices
 TEST_F(ListCommandsTest, Lrange_OutOfBounds_ReturnsValidRange) {
     std::vector<std::string> args = {"LRANGE", "long_list", "-10", "10"};
-    std::string result = listCommands->cmdLrange(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLrange, args);
     
     // Should return all elements
     EXPECT_TRUE(result.find("a") != std::string::npos);
@@ -376,7 +377,7 @@ TEST_F(ListCommandsTest, Lrange_OutOfBounds_ReturnsValidRange) {
 // Test LRANGE command with empty list
 TEST_F(ListCommandsTest, Lrange_EmptyList_ReturnsEmptyArray) {
     std::vector<std::string> args = {"LRANGE", "empty_list", "0", "-1"};
-    std::string result = listCommands->cmdLrange(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLrange, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -384,7 +385,7 @@ TEST_F(ListCommandsTest, Lrange_EmptyList_ReturnsEmptyArray) {
 // Test LRANGE command with non-existent list
 TEST_F(ListCommandsTest, Lrange_NonExistentList_ReturnsEmptyArray) {
     std::vector<std::string> args = {"LRANGE", "non_existent_list", "0", "-1"};
-    std::string result = listCommands->cmdLrange(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLrange, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -392,7 +393,7 @@ TEST_F(ListCommandsTest, Lrange_NonExistentList_ReturnsEmptyArray) {
 // Test LRANGE command with wrong type
 TEST_F(ListCommandsTest, Lrange_WrongType_ReturnsEmptyArray) {
     std::vector<std::string> args = {"LRANGE", "string_key", "0", "-1"};
-    std::string result = listCommands->cmdLrange(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLrange, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -400,7 +401,7 @@ TEST_F(ListCommandsTest, Lrange_WrongType_ReturnsEmptyArray) {
 // Test LRANGE command with non-integer indices
 TEST_F(ListCommandsTest, Lrange_NonIntegerIndices_ReturnsError) {
     std::vector<std::string> args = {"LRANGE", "long_list", "start", "end"};
-    std::string result = listCommands->cmdLrange(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLrange, args);
     
     EXPECT_TRUE(result.find("ERR value is not an integer or out of range") != std::string::npos);
 }
@@ -408,7 +409,7 @@ TEST_F(ListCommandsTest, Lrange_NonIntegerIndices_ReturnsError) {
 // Test LRANGE command with wrong number of arguments
 TEST_F(ListCommandsTest, Lrange_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"LRANGE", "long_list", "0"}; // Missing end index
-    std::string result = listCommands->cmdLrange(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLrange, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -416,7 +417,7 @@ TEST_F(ListCommandsTest, Lrange_WrongNumberOfArguments_ReturnsError) {
 // Test LINDEX command with valid index
 TEST_F(ListCommandsTest, Lindex_ValidIndex_ReturnsElement) {
     std::vector<std::string> args = {"LINDEX", "long_list", "2"};
-    std::string result = listCommands->cmdLindex(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLindex, args);
     
     EXPECT_EQ("$1\r\nc\r\n", result); // Element at index 2 is "c"
 }
@@ -424,7 +425,7 @@ TEST_F(ListCommandsTest, Lindex_ValidIndex_ReturnsElement) {
 // Test LINDEX command with negative index
 TEST_F(ListCommandsTest, Lindex_NegativeIndex_ReturnsElement) {
     std::vector<std::string> args = {"LINDEX", "long_list", "-1"};
-    std::string result = listCommands->cmdLindex(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLindex, args);
     
     EXPECT_EQ("$1\r\ne\r\n", result); // Last element is "e"
 }
@@ -432,7 +433,7 @@ TEST_F(ListCommandsTest, Lindex_NegativeIndex_ReturnsElement) {
 // Test LINDEX command with out of bounds index
 TEST_F(ListCommandsTest, Lindex_OutOfBounds_ReturnsNull) {
     std::vector<std::string> args = {"LINDEX", "long_list", "10"};
-    std::string result = listCommands->cmdLindex(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLindex, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -440,7 +441,7 @@ TEST_F(ListCommandsTest, Lindex_OutOfBounds_ReturnsNull) {
 // Test LINDEX command with empty list
 TEST_F(ListCommandsTest, Lindex_EmptyList_ReturnsNull) {
     std::vector<std::string> args = {"LINDEX", "empty_list", "0"};
-    std::string result = listCommands->cmdLindex(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLindex, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -448,7 +449,7 @@ TEST_F(ListCommandsTest, Lindex_EmptyList_ReturnsNull) {
 // Test LINDEX command with non-existent list
 TEST_F(ListCommandsTest, Lindex_NonExistentList_ReturnsNull) {
     std::vector<std::string> args = {"LINDEX", "non_existent_list", "0"};
-    std::string result = listCommands->cmdLindex(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLindex, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -456,7 +457,7 @@ TEST_F(ListCommandsTest, Lindex_NonExistentList_ReturnsNull) {
 // Test LINDEX command with wrong type
 TEST_F(ListCommandsTest, Lindex_WrongType_ReturnsNull) {
     std::vector<std::string> args = {"LINDEX", "string_key", "0"};
-    std::string result = listCommands->cmdLindex(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLindex, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -464,7 +465,7 @@ TEST_F(ListCommandsTest, Lindex_WrongType_ReturnsNull) {
 // Test LINDEX command with non-integer index
 TEST_F(ListCommandsTest, Lindex_NonIntegerIndex_ReturnsError) {
     std::vector<std::string> args = {"LINDEX", "long_list", "invalid"};
-    std::string result = listCommands->cmdLindex(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLindex, args);
     
     EXPECT_TRUE(result.find("ERR value is not an integer or out of range") != std::string::npos);
 }
@@ -472,7 +473,7 @@ TEST_F(ListCommandsTest, Lindex_NonIntegerIndex_ReturnsError) {
 // Test LINDEX command with wrong number of arguments
 TEST_F(ListCommandsTest, Lindex_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"LINDEX", "long_list"}; // Missing index
-    std::string result = listCommands->cmdLindex(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLindex, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -480,15 +481,15 @@ TEST_F(ListCommandsTest, Lindex_WrongNumberOfArguments_ReturnsError) {
 // Test LSET command with valid index
 TEST_F(ListCommandsTest, Lset_ValidIndex_UpdatesElement) {
     std::vector<std::string> args = {"LSET", "long_list", "1", "new_value"};
-    std::string result = listCommands->cmdLset(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLset, args);
     
     EXPECT_EQ("+OK\r\n", result);
     
     // Verify element was updated
     RedisValue* value = database->getValue("long_list");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::LIST) {
-        auto it = value->list_value.begin();
+    if (value && value->type() == RedisType::LIST) {
+        auto it = value->list().begin();
         std::advance(it, 1);
         EXPECT_EQ("new_value", *it);
     }
@@ -497,15 +498,15 @@ TEST_F(ListCommandsTest, Lset_ValidIndex_UpdatesElement) {
 // Test LSET command with negative index
 TEST_F(ListCommandsTest, Lset_NegativeIndex_UpdatesElement) {
     std::vector<std::string> args = {"LSET", "long_list", "-1", "last_value"};
-    std::string result = listCommands->cmdLset(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLset, args);
     
     EXPECT_EQ("+OK\r\n", result);
     
     // Verify last element was updated
     RedisValue* value = database->getValue("long_list");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::LIST) {
-        auto it = value->list_value.end();
+    if (value && value->type() == RedisType::LIST) {
+        auto it = value->list().end();
         std::advance(it, -1);
         EXPECT_EQ("last_value", *it);
     }
@@ -514,7 +515,7 @@ TEST_F(ListCommandsTest, Lset_NegativeIndex_UpdatesElement) {
 // Test LSET command with out of bounds index
 TEST_F(ListCommandsTest, Lset_OutOfBounds_ReturnsError) {
     std::vector<std::string> args = {"LSET", "long_list", "10", "value"};
-    std::string result = listCommands->cmdLset(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLset, args);
     
     EXPECT_TRUE(result.find("ERR index out of range") != std::string::npos);
 }
@@ -522,7 +523,7 @@ TEST_F(ListCommandsTest, Lset_OutOfBounds_ReturnsError) {
 // Test LSET command with non-existent list
 TEST_F(ListCommandsTest, Lset_NonExistentList_ReturnsError) {
     std::vector<std::string> args = {"LSET", "non_existent_list", "0", "value"};
-    std::string result = listCommands->cmdLset(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLset, args);
     
     EXPECT_TRUE(result.find("ERR no such key") != std::string::npos);
 }
@@ -530,7 +531,7 @@ TEST_F(ListCommandsTest, Lset_NonExistentList_ReturnsError) {
 // Test LSET command with wrong type
 TEST_F(ListCommandsTest, Lset_WrongType_ReturnsError) {
     std::vector<std::string> args = {"LSET", "string_key", "0", "value"};
-    std::string result = listCommands->cmdLset(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLset, args);
     
     EXPECT_TRUE(result.find("ERR no such key") != std::string::npos);
 }
@@ -538,7 +539,7 @@ TEST_F(ListCommandsTest, Lset_WrongType_ReturnsError) {
 // Test LSET command with non-integer index
 TEST_F(ListCommandsTest, Lset_NonIntegerIndex_ReturnsError) {
     std::vector<std::string> args = {"LSET", "long_list", "invalid", "value"};
-    std::string result = listCommands->cmdLset(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLset, args);
     
     EXPECT_TRUE(result.find("ERR value is not an integer or out of range") != std::string::npos);
 }
@@ -546,7 +547,7 @@ TEST_F(ListCommandsTest, Lset_NonIntegerIndex_ReturnsError) {
 // Test LSET command with wrong number of arguments
 TEST_F(ListCommandsTest, Lset_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"LSET", "long_list", "0"}; // Missing value
-    std::string result = listCommands->cmdLset(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdLset, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -555,22 +556,22 @@ TEST_F(ListCommandsTest, Lset_WrongNumberOfArguments_ReturnsError) {
 TEST_F(ListCommandsTest, Integration_MultipleListOperations) {
     // Create a list with LPUSH
     std::vector<std::string> lpush_args = {"LPUSH", "integration_list", "c", "b", "a"};
-    std::string lpush_result = listCommands->cmdLpush(lpush_args);
+    std::string lpush_result = runCommand(listCommands, &ListCommands::cmdLpush, lpush_args);
     EXPECT_EQ(":3\r\n", lpush_result);
     
     // Add to end with RPUSH
     std::vector<std::string> rpush_args = {"RPUSH", "integration_list", "d", "e"};
-    std::string rpush_result = listCommands->cmdRpush(rpush_args);
+    std::string rpush_result = runCommand(listCommands, &ListCommands::cmdRpush, rpush_args);
     EXPECT_EQ(":5\r\n", rpush_result);
     
     // Check length with LLEN
     std::vector<std::string> llen_args = {"LLEN", "integration_list"};
-    std::string llen_result = listCommands->cmdLlen(llen_args);
+    std::string llen_result = runCommand(listCommands, &ListCommands::cmdLlen, llen_args);
     EXPECT_EQ(":5\r\n", llen_result);
     
     // Get range with LRANGE
     std::vector<std::string> lrange_args = {"LRANGE", "integration_list", "0", "-1"};
-    std::string lrange_result = listCommands->cmdLrange(lrange_args);
+    std::string lrange_result = runCommand(listCommands, &ListCommands::cmdLrange, lrange_args);
     EXPECT_TRUE(lrange_result.find("a") != std::string::npos);
     EXPECT_TRUE(lrange_result.find("b") != std::string::npos);
     EXPECT_TRUE(lrange_result.find("c") != std::string::npos);
@@ -579,26 +580,26 @@ TEST_F(ListCommandsTest, Integration_MultipleListOperations) {
     
     // Get specific element with LINDEX
     std::vector<std::string> lindex_args = {"LINDEX", "integration_list", "2"};
-    std::string lindex_result = listCommands->cmdLindex(lindex_args);
+    std::string lindex_result = runCommand(listCommands, &ListCommands::cmdLindex, lindex_args);
     EXPECT_EQ("$1\r\nc\r\n", lindex_result);
     
     // Update element with LSET
     std::vector<std::string> lset_args = {"LSET", "integration_list", "2", "C"};
-    std::string lset_result = listCommands->cmdLset(lset_args);
+    std::string lset_result = runCommand(listCommands, &ListCommands::cmdLset, lset_args);
     EXPECT_EQ("+OK\r\n", lset_result);
     
     // Pop from front with LPOP
     std::vector<std::string> lpop_args = {"LPOP", "integration_list"};
-    std::string lpop_result = listCommands->cmdLpop(lpop_args);
+    std::string lpop_result = runCommand(listCommands, &ListCommands::cmdLpop, lpop_args);
     EXPECT_EQ("$1\r\na\r\n", lpop_result);
     
     // Pop from end with RPOP
     std::vector<std::string> rpop_args = {"RPOP", "integration_list"};
-    std::string rpop_result = listCommands->cmdRpop(rpop_args);
+    std::string rpop_result = runCommand(listCommands, &ListCommands::cmdRpop, rpop_args);
     EXPECT_EQ("$1\r\ne\r\n", rpop_result);
     
     // Final length
-    llen_result = listCommands->cmdLlen(llen_args);
+    llen_result = runCommand(listCommands, &ListCommands::cmdLlen, llen_args);
     EXPECT_EQ(":3\r\n", llen_result);
 }
 
@@ -610,40 +611,40 @@ TEST_F(ListCommandsTest, EdgeCase_LargeListOperations) {
         rpush_args.push_back("item_" + std::to_string(i));
     }
     
-    std::string result = listCommands->cmdRpush(rpush_args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpush, rpush_args);
     EXPECT_EQ(":100\r\n", result);
     
     // Check length
     std::vector<std::string> llen_args = {"LLEN", "large_list"};
-    std::string llen_result = listCommands->cmdLlen(llen_args);
+    std::string llen_result = runCommand(listCommands, &ListCommands::cmdLlen, llen_args);
     EXPECT_EQ(":100\r\n", llen_result);
     
     // Get range
     std::vector<std::string> lrange_args = {"LRANGE", "large_list", "0", "99"};
-    std::string lrange_result = listCommands->cmdLrange(lrange_args);
+    std::string lrange_result = runCommand(listCommands, &ListCommands::cmdLrange, lrange_args);
     EXPECT_TRUE(lrange_result.find("item_0") != std::string::npos);
     EXPECT_TRUE(lrange_result.find("item_99") != std::string::npos);
     
     // Pop from both ends
-    listCommands->cmdLpop({"LPOP", "large_list"});
-    listCommands->cmdRpop({"RPOP", "large_list"});
+    runCommand(listCommands, &ListCommands::cmdLpop, {"LPOP", "large_list"});
+    runCommand(listCommands, &ListCommands::cmdRpop, {"RPOP", "large_list"});
     
     // Final length
-    llen_result = listCommands->cmdLlen(llen_args);
+    llen_result = runCommand(listCommands, &ListCommands::cmdLlen, llen_args);
     EXPECT_EQ(":98\r\n", llen_result);
 }
 
 // Test edge case: Empty string values
 TEST_F(ListCommandsTest, EdgeCase_EmptyStringValues) {
     std::vector<std::string> args = {"RPUSH", "empty_strings_list", "", "value", ""};
-    std::string result = listCommands->cmdRpush(args);
+    std::string result = runCommand(listCommands, &ListCommands::cmdRpush, args);
     EXPECT_EQ(":3\r\n", result);
     
     std::vector<std::string> lrange_args = {"LRANGE", "empty_strings_list", "0", "-1"};
-    std::string lrange_result = listCommands->cmdLrange(lrange_args);
+    std::string lrange_result = runCommand(listCommands, &ListCommands::cmdLrange, lrange_args);
     EXPECT_TRUE(lrange_result.find("") != std::string::npos); // Empty strings should be handled
     
     std::vector<std::string> lindex_args = {"LINDEX", "empty_strings_list", "0"};
-    std::string lindex_result = listCommands->cmdLindex(lindex_args);
+    std::string lindex_result = runCommand(listCommands, &ListCommands::cmdLindex, lindex_args);
     EXPECT_EQ("$0\r\n\r\n", lindex_result); // Empty bulk string
 }
\ No newline at end of file
@@ -1,6 +1,13 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <malloc.h>
+#include <random>
 #include <thread>
 #include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
 #include "redis/database/redis_database.h"
 
 class RedisDatabaseTest : public ::testing::Test {
@@ -28,8 +35,8 @@ TEST_F(RedisDatabaseTest, KeyExistsBasic) {
 // Test expired key handling
 TEST_F(RedisDatabaseTest, KeyExistsExpired) {
     RedisValue value("test_value");
-    value.setExpiry(std::chrono::milliseconds(1)); // Very short TTL
     db.setValue("test_key", value);
+    db.setExpiry("test_key", std::chrono::milliseconds(1)); // Very short TTL
     
     // Wait for expiry
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -44,7 +51,7 @@ TEST_F(RedisDatabaseTest, GetValue) {
     
     RedisValue* retrieved = db.getValue("test_key");
     ASSERT_NE(retrieved, nullptr);
-    EXPECT_EQ(retrieved->string_value, "test_value");
+    EXPECT_EQ(retrieved->str(), "test_value");
     
     EXPECT_EQ(db.getValue("nonexistent_key"), nullptr);
 }
@@ -52,8 +59,8 @@ TEST_F(RedisDatabaseTest, GetValue) {
 // Test getValue with expired key
 TEST_F(RedisDatabaseTest, GetValueExpired) {
     RedisValue value("test_value");
-    value.setExpiry(std::chrono::milliseconds(1));
     db.setValue("test_key", value);
+    db.setExpiry("test_key", std::chrono::milliseconds(1));
     
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
     
@@ -68,12 +75,14 @@ TEST_F(RedisDatabaseTest, SetValueDifferentTypes) {
     
     // List type
     RedisValue list_val(RedisType::LIST);
-    list_val.list_value = {"item1", "item2", "item3"};
+    list_val.list() = {"item1", "item2", "item3"};
     db.setValue("list_key", list_val);
     
     // Set type
     RedisValue set_val(RedisType::SET);
-    set_val.set_value = {"member1", "member2", "member3"};
+    for (const char* member : {"member1", "member2", "member3"}) {
+        set_val.set().tryEmplace(HashedKey(member));
+    }
     db.setValue("set_key", set_val);
     
     EXPECT_TRUE(db.keyExists("string_key"));
@@ -82,8 +91,8 @@ TEST_F(RedisDatabaseTest, SetValueDifferentTypes) {
     
     RedisValue* retrieved_list = db.getValue("list_key");
     ASSERT_NE(retrieved_list, nullptr);
-    EXPECT_EQ(retrieved_list->type, RedisType::LIST);
-    EXPECT_EQ(retrieved_list->list_value.size(), 3);
+    EXPECT_EQ(retrieved_list->type(), RedisType::LIST);
+    EXPECT_EQ(retrieved_list->list().size(), 3);
 }
 
 // Test deleteKey functionality
@@ -129,12 +138,12 @@ TEST_F(RedisDatabaseTest, GetDatabaseSize) {
 TEST_F(RedisDatabaseTest, CleanupExpiredKeys) {
     // Create keys with different expiry times
     RedisValue expired_val("expired");
-    expired_val.setExpiry(std::chrono::milliseconds(1));
     db.setValue("expired_key", expired_val);
+    db.setExpiry("expired_key", std::chrono::milliseconds(1));
     
     RedisValue valid_val("valid");
-    valid_val.setExpiry(std::chrono::hours(1)); // Long expiry
     db.setValue("valid_key", valid_val);
+    db.setExpiry("valid_key", std::chrono::hours(1)); // Long expiry
     
     RedisValue no_expiry_val("no_expiry");
     db.setValue("no_expiry_key", no_expiry_val);
@@ -197,10 +206,10 @@ TEST_F(RedisDatabaseTest, GetMatchingKeysQuestionMark) {
 TEST_F(RedisDatabaseTest, GetMatchingKeysWithExpired) {
     RedisValue valid_val("valid");
     RedisValue expired_val("expired");
-    expired_val.setExpiry(std::chrono::milliseconds(1));
     
     db.setValue("valid_key", valid_val);
     db.setValue("expired_key", expired_val);
+    db.setExpiry("expired_key", std::chrono::milliseconds(1));
     
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
     
@@ -228,7 +237,7 @@ TEST_F(RedisDatabaseTest, ThreadSafety) {
                 RedisValue* retrieved = db.getValue(key);
                 EXPECT_NE(retrieved, nullptr);
                 if (retrieved) {
-                    EXPECT_EQ(retrieved->string_value, value.string_value);
+                    EXPECT_EQ(retrieved->str(), value.str());
                 }
                 
                 // Verify key exists
@@ -248,14 +257,14 @@ TEST_F(RedisDatabaseTest, ThreadSafety) {
 // Test move semantics in setValue
 TEST_F(RedisDatabaseTest, SetValueMoveSemantics) {
     RedisValue original_value("original");
-    std::string original_content = original_value.string_value;
+    std::string original_content(original_value.str());
     
     db.setValue("test_key", std::move(original_value));
     
     // The original value might be in a valid but unspecified state
     RedisValue* retrieved = db.getValue("test_key");
     ASSERT_NE(retrieved, nullptr);
-    EXPECT_EQ(retrieved->string_value, original_content);
+    EXPECT_EQ(retrieved->str(), original_content);
 }
 
 // Test special characters in keys for pattern matching
@@ -285,3 +294,749 @@ TEST_F(RedisDatabaseTest, GetMatchingKeysEmptyPattern) {
     auto only_wildcard = db.getMatchingKeys("*");
     EXPECT_EQ(only_wildcard.size(), 1);
 }
+
+// Test shard count is rounded up to a power of two
+TEST_F(RedisDatabaseTest, ShardCountRoundedToPowerOfTwo) {
+    EXPECT_EQ(db.getShardCount(), RedisDatabase::DEFAULT_SHARD_COUNT);
+    EXPECT_EQ(RedisDatabase(1).getShardCount(), 1u);
+    EXPECT_EQ(RedisDatabase(0).getShardCount(), 1u);
+    EXPECT_EQ(RedisDatabase(24).getShardCount(), 32u);
+    EXPECT_EQ(RedisDatabase(1 << 20).getShardCount(), RedisDatabase::MAX_SHARD_COUNT);
+}
+
+// Test keys spread over shards are all reachable
+TEST_F(RedisDatabaseTest, ShardedKeyspaceOperations) {
+    for (int i = 0; i < 1000; ++i) {
+        db.setValue("key:" + std::to_string(i), RedisValue(std::to_string(i)));
+    }
+    EXPECT_EQ(db.getDatabaseSize(), 1000u);
+    EXPECT_EQ(db.getMatchingKeys("key:*").size(), 1000u);
+    ASSERT_NE(db.getValue("key:567"), nullptr);
+    EXPECT_EQ(db.getValue("key:567")->str(), "567");
+    EXPECT_TRUE(db.deleteKey("key:567"));
+    EXPECT_EQ(db.getDatabaseSize(), 999u);
+}
+
+// Test multi-key locking
+TEST_F(RedisDatabaseTest, MultiKeyLockReadsAndWrites) {
+    db.setValue("a", RedisValue("1"));
+    std::vector<std::string> args = {"MSET", "a", "x", "b", "y", "a", "z"};
+    {
+        auto lock = db.lockKeys(args, 1, 2, true);
+        lock.set("b", RedisValue("2"));
+        EXPECT_TRUE(lock.exists("a"));
+        EXPECT_TRUE(lock.erase("a"));
+        EXPECT_FALSE(lock.erase("a"));
+    }
+    EXPECT_FALSE(db.keyExists("a"));
+    ASSERT_NE(db.getValue("b"), nullptr);
+    EXPECT_EQ(db.getValue("b")->str(), "2");
+
+    std::vector<std::string> read_args = {"MGET", "b", "missing"};
+    auto lock = db.lockKeys(read_args, 1, 1, false);
+    ASSERT_NE(lock.get("b"), nullptr);
+    EXPECT_EQ(lock.get("missing"), nullptr);
+}
+
+// Test expired keys read as missing through a shared multi-key lock
+TEST_F(RedisDatabaseTest, MultiKeyLockSharedSkipsExpired) {
+    RedisValue value("v");
+    db.setValue("short", value);
+    db.setExpiry("short", std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    std::vector<std::string> args = {"EXISTS", "short"};
+    {
+        auto lock = db.lockKeys(args, 1, 1, false);
+        EXPECT_FALSE(lock.exists("short"));
+    }
+    EXPECT_FALSE(db.keyExists("short"));
+}
+
+// Test opposite key orders from many threads cannot deadlock
+TEST_F(RedisDatabaseTest, MultiKeyLocksDoNotDeadlock) {
+    RedisDatabase sharded(8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&sharded, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                std::string k1 = "k" + std::to_string(i % 13);
+                std::string k2 = "k" + std::to_string((i * 7) % 17);
+                std::vector<std::string> args = t % 2 == 0
+                    ? std::vector<std::string>{"MSET", k1, "v", k2, "v"}
+                    : std::vector<std::string>{"MSET", k2, "v", k1, "v"};
+                auto lock = sharded.lockKeys(args, 1, 2, true);
+                lock.set(args[1], RedisValue("v"));
+                lock.set(args[3], RedisValue("v"));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_GT(sharded.getDatabaseSize(), 0u);
+}
+
+// Throughput with 32 client threads, one lock versus sharded locks.
+// Run with --gtest_also_run_disabled_tests
+TEST_F(RedisDatabaseTest, DISABLED_ShardedThroughputBenchmark) {
+    const int num_threads = 32;
+    const int operations_per_thread = 200000;
+
+    for (size_t shard_count : {size_t(1), RedisDatabase::DEFAULT_SHARD_COUNT}) {
+        RedisDatabase sharded(shard_count);
+        for (int i = 0; i < 10000; ++i) {
+            sharded.setValue("key:" + std::to_string(i), RedisValue("value"));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&sharded, t]() {
+                std::string key;
+                for (int i = 0; i < operations_per_thread; ++i) {
+                    key = "key:" + std::to_string((i * 31 + t * 7919) % 10000);
+                    if (i % 10 == 0) {
+                        sharded.setValue(key, RedisValue("value"));
+                    } else {
+                        sharded.keyExists(key);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << shard_count << " shard(s): "
+                  << static_cast<long long>(num_threads * operations_per_thread / elapsed.count())
+                  << " ops/s (90% reads)" << std::endl;
+    }
+}
+
+// Test value refs find, create and erase keys
+TEST_F(RedisDatabaseTest, ValueRefCreateAndErase) {
+    {
+        auto ref = db.writeValue("list");
+        EXPECT_FALSE(ref);
+        RedisValue& created = ref.create(RedisValue(RedisType::LIST));
+        created.list().push_back("a");
+        EXPECT_EQ(ref.get(), &created);
+    }
+    {
+        auto ref = db.readValue("list");
+        ASSERT_TRUE(ref);
+        EXPECT_EQ(ref->type(), RedisType::LIST);
+        EXPECT_EQ((*ref).list().size(), 1u);
+    }
+    {
+        auto ref = db.writeValue("list");
+        ref.erase();
+        EXPECT_FALSE(ref);
+    }
+    EXPECT_FALSE(db.keyExists("list"));
+    EXPECT_FALSE(db.readValue("list"));
+}
+
+// Test value refs treat expired keys as missing
+TEST_F(RedisDatabaseTest, ValueRefSkipsExpired) {
+    RedisValue value("old");
+    db.setValue("short", value);
+    db.setExpiry("short", std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    EXPECT_FALSE(db.readValue("short"));
+    {
+        auto ref = db.writeValue("short");
+        EXPECT_FALSE(ref);
+        EXPECT_FALSE(ref.create(RedisValue("new")).hasExpiry());
+    }
+    EXPECT_EQ(db.readValue("short")->str(), "new");
+}
+
+// Test a write ref keeps other writers out of the key until released
+TEST_F(RedisDatabaseTest, ValueRefHoldsShardLock) {
+    db.setValue("key", RedisValue("mine"));
+    std::thread writer;
+    {
+        auto ref = db.writeValue("key");
+        writer = std::thread([this]() { db.setValue("key", RedisValue("theirs")); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_EQ(ref->str(), "mine");
+    }
+    writer.join();
+    EXPECT_EQ(db.readValue("key")->str(), "theirs");
+}
+
+// Test read-modify-write through refs loses no updates while keys are
+// being expired and deleted concurrently
+TEST_F(RedisDatabaseTest, ValueRefMutationsAreAtomic) {
+    const int num_threads = 8;
+    const int pushes_per_thread = 2000;
+    std::atomic<bool> done{false};
+
+    std::thread cleaner([this, &done]() {
+        while (!done) {
+            RedisValue temporary("t");
+            db.setValue("temporary", temporary);
+            db.setExpiry("temporary", std::chrono::milliseconds(0));
+            db.cleanupExpiredKeys();
+            db.deleteKey("temporary");
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([this]() {
+            for (int i = 0; i < pushes_per_thread; ++i) {
+                auto ref = db.writeValue("list");
+                if (!ref) {
+                    ref.create(RedisValue(RedisType::LIST));
+                }
+                ref->list().push_back("x");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    done = true;
+    cleaner.join();
+
+    auto ref = db.readValue("list");
+    ASSERT_TRUE(ref);
+    EXPECT_EQ(ref->list().size(), static_cast<size_t>(num_threads * pushes_per_thread));
+}
+
+// Test getOrCreate inserts only when the key is missing or expired
+TEST_F(RedisDatabaseTest, GetOrCreateInsertsOnce) {
+    {
+        auto ref = db.getOrCreate("hash", RedisType::HASH);
+        EXPECT_TRUE(ref.wasCreated());
+        EXPECT_EQ(ref->type(), RedisType::HASH);
+        ref->hash().tryEmplace(HashedKey("f"), "v");
+    }
+    {
+        auto ref = db.getOrCreate("hash", RedisType::SET);
+        EXPECT_FALSE(ref.wasCreated());
+        EXPECT_EQ(ref->type(), RedisType::HASH);
+        EXPECT_EQ(ref->hash().size(), 1u);
+    }
+
+    RedisValue old("old");
+    db.setValue("expired", old);
+    db.setExpiry("expired", std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    auto ref = db.getOrCreate("expired", RedisType::LIST);
+    EXPECT_TRUE(ref.wasCreated());
+    EXPECT_EQ(ref->type(), RedisType::LIST);
+    EXPECT_FALSE(ref->hasExpiry());
+}
+
+// Test a created value can be dropped again
+TEST_F(RedisDatabaseTest, GetOrCreateThenErase) {
+    {
+        auto ref = db.getOrCreate("temp", RedisType::STRING);
+        ref.erase();
+        EXPECT_FALSE(ref);
+    }
+    EXPECT_FALSE(db.keyExists("temp"));
+    EXPECT_EQ(db.getDatabaseSize(), 0u);
+}
+
+// Test the background rehash drains growing shards
+TEST_F(RedisDatabaseTest, IncrementalRehashCompletes) {
+    RedisDatabase single(1);
+    for (int i = 0; i < 5000; ++i) {
+        single.setValue("key:" + std::to_string(i), RedisValue("v"));
+    }
+    int ticks = 0;
+    while (single.incrementalRehash(std::chrono::milliseconds(1)) && ticks < 1000) {
+        ticks++;
+    }
+    EXPECT_LT(ticks, 1000);
+    EXPECT_FALSE(single.incrementalRehash(std::chrono::milliseconds(1)));
+    EXPECT_EQ(single.getDatabaseSize(), 5000u);
+    EXPECT_TRUE(single.keyExists("key:4999"));
+}
+
+// Test active expiry deletes expired keys that are never read again and
+// leaves the rest alone
+TEST_F(RedisDatabaseTest, ActiveExpireCycleDeletesExpiredKeys) {
+    for (int i = 0; i < 5000; ++i) {
+        std::string key = "temp:" + std::to_string(i);
+        db.setValue(key, RedisValue("v"));
+        db.setExpiry(key, std::chrono::milliseconds(1));
+    }
+    db.setValue("later", RedisValue("v"));
+    db.setExpiry("later", std::chrono::hours(1));
+    db.setValue("forever", RedisValue("v"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // Almost every sample is stale, so each shard is drained in one call
+    EXPECT_EQ(db.activeExpireCycle(std::chrono::seconds(10)), 5000u);
+    EXPECT_EQ(db.getDatabaseSize(), 2u);
+    EXPECT_TRUE(db.getExpiry("later").has_value());
+    EXPECT_EQ(db.activeExpireCycle(std::chrono::seconds(10)), 0u);
+}
+
+// Test active expiry stops at its budget and resumes where it stopped
+TEST_F(RedisDatabaseTest, ActiveExpireCycleRespectsBudget) {
+    RedisDatabase single(1);
+    for (int i = 0; i < 5000; ++i) {
+        std::string key = "temp:" + std::to_string(i);
+        single.setValue(key, RedisValue("v"));
+        single.setExpiry(key, std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // A spent budget still allows one sample
+    EXPECT_EQ(single.activeExpireCycle(std::chrono::microseconds(0)), RedisDatabase::KEYS_PER_LOOP);
+    size_t calls = 1;
+    while (single.getDatabaseSize() > 0) {
+        single.activeExpireCycle(std::chrono::microseconds(0));
+        ASSERT_LT(++calls, 1000u);
+    }
+    EXPECT_GE(calls, 5000u / RedisDatabase::KEYS_PER_LOOP);
+}
+
+// Benchmark: cron ticks active expiry needs to reclaim a million expired
+// keys next to a million live ones. Run with --gtest_also_run_disabled_tests
+TEST_F(RedisDatabaseTest, DISABLED_ActiveExpireBenchmark) {
+    const int key_count = 1000000;
+    for (int i = 0; i < key_count; ++i) {
+        std::string key = "temp:" + std::to_string(i);
+        db.setValue(key, RedisValue("v"));
+        db.setExpiry(key, std::chrono::milliseconds(1));
+        db.setValue("live:" + std::to_string(i), RedisValue("v"));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    size_t ticks = 0;
+    std::chrono::microseconds worst{0};
+    auto start = std::chrono::steady_clock::now();
+    while (db.getDatabaseSize() > static_cast<size_t>(key_count)) {
+        auto tick_start = std::chrono::steady_clock::now();
+        db.activeExpireCycle(std::chrono::milliseconds(25));
+        worst = std::max(worst, std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - tick_start));
+        ticks++;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << key_count << " expired keys reclaimed in " << ticks << " ticks of 25ms budget, "
+              << elapsed.count() << " ms total, longest tick " << worst.count() << " us" << std::endl;
+}
+
+// Test a keyspace entry with a short key and an embedded value fills
+// exactly one cache line
+TEST_F(RedisDatabaseTest, KeyspaceEntryIsOneCacheLine) {
+    EXPECT_EQ(sizeof(KeyTable<RedisValue>::Entry), 64u);
+
+    KeyTable<RedisValue> table;
+    for (int i = 0; i < 100; ++i) {
+        std::string key = "user:" + std::to_string(i);
+        auto* entry = table.tryEmplace(HashedKey(key), "value").first;
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(entry) % 64, 0u);
+        EXPECT_TRUE(entry->key.isInline());
+        EXPECT_EQ(entry->value.encoding(), RedisEncoding::EMBSTR);
+    }
+}
+
+// Test an expiry goes away with its key and does not carry over to a
+// key recreated under the same name
+TEST_F(RedisDatabaseTest, ExpiryRemovedWithKey) {
+    db.setValue("key", RedisValue("v"));
+    EXPECT_TRUE(db.setExpiry("key", std::chrono::hours(1)));
+    EXPECT_TRUE(db.getExpiry("key").has_value());
+
+    EXPECT_TRUE(db.deleteKey("key"));
+    db.setValue("key", RedisValue("again"));
+    EXPECT_FALSE(db.getExpiry("key").has_value());
+    EXPECT_FALSE(db.getValue("key")->hasExpiry());
+
+    EXPECT_FALSE(db.setExpiry("missing", std::chrono::hours(1)));
+}
+
+// Heap bytes per key for string values, measured with mallinfo2: short
+// keys with tiny values, and the 20-30 byte keys with 40 byte values
+// typical of session caches. Run with --gtest_also_run_disabled_tests
+TEST_F(RedisDatabaseTest, DISABLED_BytesPerKeyBenchmark) {
+    const size_t key_count = 2000000;
+    // Small blocks come from the arenas, large tables from mmap
+    auto heap_bytes = []() {
+        struct mallinfo2 info = mallinfo2();
+        return info.uordblks + info.hblkhd;
+    };
+    auto measure = [&](const std::string& prefix, const std::string& value) {
+        size_t before = heap_bytes();
+        RedisDatabase large;
+        std::string key;
+        for (size_t i = 0; i < key_count; ++i) {
+            key = prefix + std::to_string(i);
+            large.setValue(key, RedisValue(value));
+        }
+        while (large.incrementalRehash(std::chrono::milliseconds(100))) {}
+        size_t used = heap_bytes() - before;
+
+        // Reads in random order, so every lookup misses the cache
+        std::vector<size_t> order(key_count);
+        for (size_t i = 0; i < key_count; ++i) order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(42));
+        size_t total_length = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i : order) {
+            key = prefix + std::to_string(i);
+            total_length += large.readValue(key)->str().size();
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        EXPECT_EQ(total_length, key_count * value.size());
+        std::cout << key_count << " keys \"" << prefix << "N\", " << value.size() << " byte values: "
+                  << used / key_count << " bytes per key, "
+                  << elapsed.count() / key_count << " ns per read" << std::endl;
+    };
+    std::cout << "sizeof(RedisValue): " << sizeof(RedisValue) << std::endl;
+    measure("key:", "abc");
+    measure("session:user:token:", std::string(40, 'v'));
+}
+
+static RedisValue bigHash(size_t fields) {
+    RedisValue value(RedisType::HASH);
+    for (size_t i = 0; i < fields; ++i) {
+        value.hash().tryEmplace(HashedKey("field:" + std::to_string(i)), "v");
+    }
+    return value;
+}
+
+// Test deleting a value above the threshold destroys it on the LazyFree
+// thread, and a small one inline
+TEST_F(RedisDatabaseTest, DeleteLargeValueFreesLazily) {
+    LazyFree& lazy_free = LazyFree::instance();
+    lazy_free.waitIdle();
+    size_t freed = lazy_free.freed();
+
+    db.setValue("small", RedisValue("v"));
+    db.deleteKey("small");
+    lazy_free.waitIdle();
+    EXPECT_EQ(lazy_free.freed(), freed);
+
+    db.setValue("big", bigHash(LazyFree::THRESHOLD + 1));
+    EXPECT_TRUE(db.deleteKey("big"));
+    EXPECT_FALSE(db.keyExists("big"));
+    lazy_free.waitIdle();
+    EXPECT_EQ(lazy_free.freed(), freed + 1);
+}
+
+// Test overwriting and expiring large values also free them lazily
+TEST_F(RedisDatabaseTest, OverwriteAndExpiryFreeLazily) {
+    LazyFree& lazy_free = LazyFree::instance();
+    lazy_free.waitIdle();
+    size_t freed = lazy_free.freed();
+
+    db.setValue("big", bigHash(1000));
+    db.setValue("big", RedisValue("replaced"));
+    EXPECT_EQ(db.getValue("big")->str(), "replaced");
+
+    db.setValue("expiring", bigHash(1000));
+    db.setExpiry("expiring", std::chrono::milliseconds(0));
+    db.activeExpireCycle(std::chrono::milliseconds(10));
+    EXPECT_EQ(db.getDatabaseSize(), 1u);
+
+    lazy_free.waitIdle();
+    EXPECT_EQ(lazy_free.freed(), freed + 2);
+}
+
+// Test the async flush empties the keyspace and its expiries at once
+TEST_F(RedisDatabaseTest, ClearDatabaseAsync) {
+    for (int i = 0; i < 1000; ++i) {
+        std::string key = "key:" + std::to_string(i);
+        db.setValue(key, RedisValue("v"));
+        db.setExpiry(key, std::chrono::hours(1));
+    }
+    db.setValue("big", bigHash(1000));
+
+    db.clearDatabaseAsync();
+    EXPECT_EQ(db.getDatabaseSize(), 0u);
+    EXPECT_FALSE(db.keyExists("key:1"));
+
+    // The emptied shards take new keys straight away
+    db.setValue("key:1", RedisValue("again"));
+    EXPECT_FALSE(db.getExpiry("key:1").has_value());
+    EXPECT_EQ(db.getDatabaseSize(), 1u);
+    LazyFree::instance().waitIdle();
+}
+
+// Time DEL and FLUSHALL take on the caller's thread, inline and lazy
+TEST_F(RedisDatabaseTest, DISABLED_LazyFreeBenchmark) {
+    using std::chrono::steady_clock;
+    const size_t fields = 1000000;
+    auto ms = [](steady_clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count() / 1000.0;
+    };
+
+    {
+        RedisValue inline_value = bigHash(fields);
+        auto start = steady_clock::now();
+        inline_value = RedisValue();
+        std::cout << "DEL of a " << fields << "-field hash, inline: " << ms(steady_clock::now() - start) << " ms" << std::endl;
+    }
+    db.setValue("big", bigHash(fields));
+    auto start = steady_clock::now();
+    db.deleteKey("big");
+    std::cout << "DEL of a " << fields << "-field hash, lazy: " << ms(steady_clock::now() - start) << " ms" << std::endl;
+    LazyFree::instance().waitIdle();
+
+    auto fill = [this]() {
+        for (int i = 0; i < 2000000; ++i) {
+            db.setValue("key:" + std::to_string(i), RedisValue("value"));
+        }
+    };
+    fill();
+    start = steady_clock::now();
+    db.clearDatabase();
+    std::cout << "FLUSHALL of 2M keys, sync: " << ms(steady_clock::now() - start) << " ms" << std::endl;
+    fill();
+    start = steady_clock::now();
+    db.clearDatabaseAsync();
+    std::cout << "FLUSHALL of 2M keys, async: " << ms(steady_clock::now() - start) << " ms" << std::endl;
+    LazyFree::instance().waitIdle();
+}
+
+// Test every way an entry is added, changed and removed keeps the
+// shard counters in step, back to zero at the end
+TEST_F(RedisDatabaseTest, UsedMemoryTracksTheKeyspace) {
+    EXPECT_EQ(db.usedMemory(), 0u);
+
+    db.setValue("short", RedisValue("v"));
+    size_t one_key = db.usedMemory();
+    EXPECT_GE(one_key, sizeof(RedisValue));
+
+    db.setValue("long", RedisValue(std::string(1000, 'x')));
+    EXPECT_GE(db.usedMemory(), one_key + 1000);
+    db.setValue("long", RedisValue("v"));
+    EXPECT_EQ(db.usedMemory(), 2 * one_key);
+
+    // Changes made through a ValueRef count once it is released
+    {
+        auto ref = db.getOrCreate("hash", RedisType::HASH);
+        for (int i = 0; i < 100; ++i) ref->hash().tryEmplace(HashedKey("field:" + std::to_string(i)), std::string(50, 'v'));
+    }
+    EXPECT_GE(db.usedMemory(), 2 * one_key + 100 * 50);
+    {
+        auto ref = db.writeValue("hash");
+        ref.erase();
+    }
+    EXPECT_EQ(db.usedMemory(), 2 * one_key);
+
+    EXPECT_TRUE(db.setExpiry("short", std::chrono::hours(1)));
+    size_t with_expiry = db.usedMemory();
+    EXPECT_GT(with_expiry, 2 * one_key);
+    EXPECT_TRUE(db.setExpiry("short", std::chrono::hours(2)));
+    EXPECT_EQ(db.usedMemory(), with_expiry);
+
+    db.setExpiry("long", std::chrono::milliseconds(0));
+    db.activeExpireCycle(std::chrono::milliseconds(10));
+    EXPECT_EQ(db.usedMemory(), with_expiry - one_key);
+
+    db.deleteKey("short");
+    EXPECT_EQ(db.usedMemory(), 0u);
+
+    db.setValue("again", RedisValue("v"));
+    db.clearDatabase();
+    EXPECT_EQ(db.usedMemory(), 0u);
+}
+
+static void fillKeys(RedisDatabase& db, const std::string& prefix, int count) {
+    for (int i = 0; i < count; ++i) {
+        db.setValue(prefix + std::to_string(i), RedisValue(std::string(100, 'v')));
+    }
+}
+
+// Test noeviction leaves the keyspace alone and reports failure
+TEST_F(RedisDatabaseTest, NoEvictionRefusesToEvict) {
+    fillKeys(db, "key:", 100);
+    EXPECT_TRUE(db.performEvictions());
+
+    db.setMaxMemory(db.usedMemory() / 2, EvictionPolicy::NOEVICTION);
+    EXPECT_FALSE(db.performEvictions());
+    EXPECT_EQ(db.getDatabaseSize(), 100u);
+    EXPECT_EQ(db.evictedKeys(), 0u);
+
+    db.setMaxMemory(0, EvictionPolicy::NOEVICTION);
+    EXPECT_TRUE(db.performEvictions());
+}
+
+// Test allkeys-lru evicts the keys idle longest: those read after a pause
+// survive evicting half the keyspace
+TEST_F(RedisDatabaseTest, AllKeysLruKeepsRecentlyUsed) {
+    auto start = std::chrono::steady_clock::now();
+    ServerClock::update(start);
+    db.setMaxMemory(0, EvictionPolicy::ALLKEYS_LRU);
+    fillKeys(db, "key:", 1000);
+
+    ServerClock::update(start + std::chrono::seconds(100));
+    for (int i = 0; i < 100; ++i) {
+        db.readValue("key:" + std::to_string(i * 10));
+    }
+
+    size_t limit = db.usedMemory() / 2;
+    db.setMaxMemory(limit, EvictionPolicy::ALLKEYS_LRU);
+    EXPECT_TRUE(db.performEvictions());
+    EXPECT_LE(db.usedMemory(), limit);
+    EXPECT_GT(db.evictedKeys(), 400u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(db.keyExists("key:" + std::to_string(i * 10))) << i * 10;
+    }
+    ServerClock::stopCaching();
+}
+
+// Test allkeys-lfu evicts the keys used least often
+TEST_F(RedisDatabaseTest, AllKeysLfuKeepsFrequentlyUsed) {
+    db.setMaxMemory(0, EvictionPolicy::ALLKEYS_LFU);
+    fillKeys(db, "key:", 1000);
+    for (int hit = 0; hit < 50; ++hit) {
+        for (int i = 0; i < 100; ++i) {
+            db.readValue("key:" + std::to_string(i * 10));
+        }
+    }
+
+    size_t limit = db.usedMemory() / 2;
+    db.setMaxMemory(limit, EvictionPolicy::ALLKEYS_LFU);
+    EXPECT_TRUE(db.performEvictions());
+    EXPECT_LE(db.usedMemory(), limit);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(db.keyExists("key:" + std::to_string(i * 10))) << i * 10;
+    }
+}
+
+// Test volatile-ttl takes the keys closest to expiring, and volatile
+// policies never touch keys without an expiry
+TEST_F(RedisDatabaseTest, VolatileTtlEvictsSoonestExpiry) {
+    fillKeys(db, "persistent:", 200);
+    fillKeys(db, "volatile:", 200);
+    for (int i = 0; i < 200; ++i) {
+        db.setExpiry("volatile:" + std::to_string(i), std::chrono::minutes(10 + i));
+    }
+
+    size_t limit = db.usedMemory() * 3 / 4;
+    db.setMaxMemory(limit, EvictionPolicy::VOLATILE_TTL);
+    EXPECT_TRUE(db.performEvictions());
+    EXPECT_LE(db.usedMemory(), limit);
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_TRUE(db.keyExists("persistent:" + std::to_string(i)));
+    }
+    // Sampling is approximate and the key hashes are seeded per process,
+    // so an odd long-lived key can go; nearly all of them must stay
+    int kept = 0;
+    for (int i = 150; i < 200; ++i) {
+        kept += db.keyExists("volatile:" + std::to_string(i)) ? 1 : 0;
+    }
+    EXPECT_GE(kept, 45);
+}
+
+TEST_F(RedisDatabaseTest, VolatileLruFailsWithOnlyPersistentKeys) {
+    fillKeys(db, "persistent:", 100);
+    fillKeys(db, "volatile:", 100);
+    for (int i = 0; i < 100; ++i) {
+        db.setExpiry("volatile:" + std::to_string(i), std::chrono::hours(1));
+    }
+
+    db.setMaxMemory(1, EvictionPolicy::VOLATILE_LRU);
+    EXPECT_FALSE(db.performEvictions());
+    EXPECT_EQ(db.getDatabaseSize(), 100u);
+    EXPECT_EQ(db.evictedKeys(), 100u);
+    EXPECT_TRUE(db.keyExists("persistent:0"));
+}
+
+TEST_F(RedisDatabaseTest, AllKeysRandomEvictsToTheLimit) {
+    fillKeys(db, "key:", 1000);
+    size_t limit = db.usedMemory() / 4;
+    db.setMaxMemory(limit, EvictionPolicy::ALLKEYS_RANDOM);
+    EXPECT_TRUE(db.performEvictions());
+    EXPECT_LE(db.usedMemory(), limit);
+    EXPECT_GT(db.getDatabaseSize(), 200u);
+
+    // Everything can go
+    db.setMaxMemory(1, EvictionPolicy::ALLKEYS_RANDOM);
+    EXPECT_TRUE(db.performEvictions());
+    EXPECT_EQ(db.getDatabaseSize(), 0u);
+    EXPECT_EQ(db.usedMemory(), 0u);
+}
+
+// Writes at the limit under allkeys-lru: how much an eviction adds to
+// each write, and how many hot keys an approximated LRU keeps against
+// a stream of cold ones. Run with --gtest_also_run_disabled_tests
+TEST_F(RedisDatabaseTest, DISABLED_EvictionBenchmark) {
+    using std::chrono::steady_clock;
+    const int key_count = 1000000;
+    const int hot_count = 10000;
+    RedisValue value(std::string(100, 'v'));
+
+    auto time_writes = [&](const std::string& prefix) {
+        auto start = steady_clock::now();
+        for (int i = 0; i < key_count; ++i) {
+            db.performEvictions();
+            db.setValue(prefix + std::to_string(i), RedisValue(value));
+        }
+        return std::chrono::duration<double, std::nano>(steady_clock::now() - start).count() / key_count;
+    };
+
+    double unlimited = time_writes("fill:");
+    db.setMaxMemory(db.usedMemory(), EvictionPolicy::ALLKEYS_LRU);
+    double evicting = time_writes("cold:");
+    std::cout << "SET, no limit: " << unlimited << " ns" << std::endl;
+    std::cout << "SET, evicting one key each: " << evicting << " ns, "
+              << db.evictedKeys() << " evicted" << std::endl;
+
+    // Simulated time: one second per thousand writes, reads of the hot
+    // keys in between
+    db.clearDatabase();
+    auto now = steady_clock::now();
+    ServerClock::update(now);
+    fillKeys(db, "hot:", hot_count);
+    db.setMaxMemory(db.usedMemory() * 4, EvictionPolicy::ALLKEYS_LRU);
+    for (int i = 0; i < key_count; ++i) {
+        if (i % 1000 == 0) {
+            now += std::chrono::seconds(1);
+            ServerClock::update(now);
+        }
+        db.readValue("hot:" + std::to_string(i % hot_count));
+        db.performEvictions();
+        db.setValue("cold:" + std::to_string(i), RedisValue(value));
+    }
+    int kept = 0;
+    for (int i = 0; i < hot_count; ++i) kept += db.keyExists("hot:" + std::to_string(i));
+    std::cout << "Hot keys kept: " << kept << " of " << hot_count << std::endl;
+    ServerClock::stopCaching();
+}
+
+// Test SCAN walks every shard in bounded steps
+TEST_F(RedisDatabaseTest, ScanVisitsEveryKeyAcrossShards) {
+    for (int i = 0; i < 1000; ++i) {
+        db.setValue("key:" + std::to_string(i), RedisValue(std::to_string(i)));
+    }
+    db.setValue("gone", RedisValue("x"));
+    db.setExpiry("gone", std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    std::vector<std::string> seen;
+    uint64_t cursor = 0;
+    size_t calls = 0;
+    do {
+        size_t before = seen.size();
+        cursor = db.scan(cursor, 10, [&seen](std::string_view key, const RedisValue&) {
+            seen.emplace_back(key);
+        });
+        // About `count` keys per call; whole home groups may add a few
+        EXPECT_LE(seen.size() - before, 40u);
+        calls++;
+    } while (cursor != 0);
+
+    std::sort(seen.begin(), seen.end());
+    seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+    EXPECT_EQ(seen.size(), 1000u);
+    EXPECT_FALSE(std::binary_search(seen.begin(), seen.end(), "gone"));
+    EXPECT_GT(calls, 50u);
+
+    RedisDatabase empty(4);
+    EXPECT_EQ(empty.scan(0, 10, [](std::string_view, const RedisValue&) {}), 0u);
+}
@@ -1,70 +1,152 @@
 #include <gtest/gtest.h>
-#include <thread> 
+#include <climits>
+#include <string>
 #include "redis/database/redis_value.h"
 
 TEST(RedisValueTest, DefaultConstructor) {
     RedisValue val;
-    EXPECT_EQ(val.type, RedisType::STRING);
-    EXPECT_FALSE(val.has_expiry);
+    EXPECT_EQ(val.type(), RedisType::STRING);
+    EXPECT_EQ(val.str(), "");
+    EXPECT_FALSE(val.hasExpiry());
 }
 
 TEST(RedisValueTest, TypeConstructor) {
     RedisValue val_list(RedisType::LIST);
-    EXPECT_EQ(val_list.type, RedisType::LIST);
+    EXPECT_EQ(val_list.type(), RedisType::LIST);
+    EXPECT_TRUE(val_list.list().empty());
 
     RedisValue val_hash(RedisType::HASH);
-    EXPECT_EQ(val_hash.type, RedisType::HASH);
+    EXPECT_EQ(val_hash.type(), RedisType::HASH);
+    EXPECT_TRUE(val_hash.hash().empty());
     
     RedisValue val_stream(RedisType::STREAM);
-    EXPECT_EQ(val_stream.type, RedisType::STREAM);
+    EXPECT_EQ(val_stream.type(), RedisType::STREAM);
 }
 
 TEST(RedisValueTest, StringConstructor) {
     const std::string test_str = "hello gtest!";
     RedisValue val(test_str);
-    EXPECT_EQ(val.type, RedisType::STRING);
-    EXPECT_EQ(val.string_value, test_str);
-    EXPECT_FALSE(val.has_expiry);
+    EXPECT_EQ(val.type(), RedisType::STRING);
+    EXPECT_EQ(val.str(), test_str);
+    EXPECT_FALSE(val.hasExpiry());
 }
 
+TEST(RedisValueTest, FitsInThreeWords) {
+    EXPECT_EQ(sizeof(RedisValue), 24u);
+}
 
-TEST(RedisValueTest, SetExpiry) {
-    RedisValue val;
-    ASSERT_FALSE(val.has_expiry);
-    val.setExpiry(std::chrono::milliseconds(100));
-    
-    EXPECT_TRUE(val.has_expiry);
-    
-    EXPECT_GT(val.expiry, std::chrono::system_clock::now());
+TEST(RedisValueTest, ShortStringsAreEmbedded) {
+    RedisValue fits(std::string(RedisValue::EMBEDDED_CAPACITY, 'a'));
+    EXPECT_EQ(fits.encoding(), RedisEncoding::EMBSTR);
+    EXPECT_EQ(fits.str(), std::string(RedisValue::EMBEDDED_CAPACITY, 'a'));
+
+    RedisValue too_long(std::string(RedisValue::EMBEDDED_CAPACITY + 1, 'b'));
+    EXPECT_EQ(too_long.encoding(), RedisEncoding::RAW);
+    EXPECT_EQ(too_long.str(), std::string(RedisValue::EMBEDDED_CAPACITY + 1, 'b'));
 }
 
-TEST(RedisValueTest, ClearExpiry) {
-    RedisValue val;
-    val.setExpiry(std::chrono::milliseconds(100));
-    ASSERT_TRUE(val.has_expiry); 
-    val.clearExpiry();
-    EXPECT_FALSE(val.has_expiry);
+TEST(RedisValueTest, AppendMovesToRawWhenFull) {
+    RedisValue val("hello");
+    val.appendString(" world");
+    EXPECT_EQ(val.encoding(), RedisEncoding::EMBSTR);
+    EXPECT_EQ(val.str(), "hello world");
+
+    val.appendString(", and more");
+    EXPECT_EQ(val.encoding(), RedisEncoding::RAW);
+    EXPECT_EQ(val.str(), "hello world, and more");
 }
 
-TEST(RedisValueTest, IsExpired) {
-    RedisValue val;
+TEST(RedisValueTest, SetStringKeepsExpiryFlag) {
+    RedisValue val("1");
+    val.setExpiryFlag(true);
+    val.setString("a value too long to be embedded");
+    EXPECT_EQ(val.str(), "a value too long to be embedded");
+    EXPECT_TRUE(val.hasExpiry());
+
+    val.setString("2");
+    EXPECT_EQ(val.encoding(), RedisEncoding::EMBSTR);
+    EXPECT_TRUE(val.hasExpiry());
+}
 
-    EXPECT_FALSE(val.isExpired());
+TEST(RedisValueTest, CopyIsDeepAndDropsExpiryFlag) {
+    RedisValue original(RedisType::LIST);
+    original.list().push_back("a");
+    original.setExpiryFlag(true);
 
-    val.setExpiry(std::chrono::milliseconds(500));
-    EXPECT_FALSE(val.isExpired());
+    RedisValue copy(original);
+    copy.list().push_back("b");
+    EXPECT_EQ(original.list().size(), 1u);
+    EXPECT_EQ(copy.list().size(), 2u);
+    EXPECT_FALSE(copy.hasExpiry());
+}
 
-    val.setExpiry(std::chrono::milliseconds(10)); 
-    std::this_thread::sleep_for(std::chrono::milliseconds(20)); 
-    EXPECT_TRUE(val.isExpired());
+TEST(RedisValueTest, MoveTransfersPayload) {
+    RedisValue original(std::string(40, 'x'));
+    RedisValue moved(std::move(original));
+    EXPECT_EQ(moved.encoding(), RedisEncoding::RAW);
+    EXPECT_EQ(moved.str(), std::string(40, 'x'));
+    EXPECT_EQ(original.str(), "");
 }
 
-TEST(RedisValueTest, ImmediateExpiration) {
-    RedisValue val;
+TEST(RedisValueTest, MoveKeepsAccessClock) {
+    RedisValue original("v");
+    original.setAccessClock(1234);
+    RedisValue moved(std::move(original));
+    EXPECT_EQ(moved.accessClock(), 1234u);
+    EXPECT_EQ(original.accessClock(), 0u);
 
-    val.setExpiry(std::chrono::milliseconds(-100));
-    EXPECT_TRUE(val.isExpired());
+    RedisValue copy(moved);
+    EXPECT_EQ(copy.accessClock(), 0u);
+}
+
+TEST(RedisValueTest, MemoryUsage) {
+    EXPECT_EQ(RedisValue("short").memoryUsage(), 0u);
+    EXPECT_EQ(RedisValue(42LL).memoryUsage(), 0u);
+    EXPECT_GE(RedisValue(std::string(1000, 'x')).memoryUsage(), 1000u);
+
+    RedisValue list(RedisType::LIST);
+    size_t empty = list.memoryUsage();
+    for (int i = 0; i < 1000; ++i) list.list().push_back("element");
+    size_t small = list.memoryUsage();
+    EXPECT_GT(small, empty + 1000 * sizeof(std::string));
+
+    // Estimated from a sample, then scaled to the element count
+    RedisValue hash(RedisType::HASH);
+    for (int i = 0; i < 100; ++i) hash.hash().tryEmplace(HashedKey("field:" + std::to_string(i)), std::string(100, 'v'));
+    EXPECT_GT(hash.memoryUsage(), 100u * 100);
+    EXPECT_EQ(hash.memoryUsage(), hash.memoryUsage());
+}
+
+TEST(RedisValueTest, IntegerEncoding) {
+    RedisValue val(42LL);
+    EXPECT_EQ(val.type(), RedisType::STRING);
+    EXPECT_TRUE(val.isInteger());
+    EXPECT_EQ(val.integer(), 42);
+    EXPECT_EQ(val.toString(), "42");
+    EXPECT_EQ(val.length(), 2u);
 
-    val.setExpiry(std::chrono::milliseconds(0));
-    EXPECT_TRUE(val.isExpired());
-}
\ No newline at end of file
+    val.setInteger(LLONG_MIN);
+    EXPECT_EQ(val.toString(), "-9223372036854775808");
+    EXPECT_EQ(val.length(), 20u);
+
+    RedisValue copy(val);
+    EXPECT_TRUE(copy.isInteger());
+    EXPECT_EQ(copy.integer(), LLONG_MIN);
+}
+
+TEST(RedisValueTest, IntegerSwitchesBackToBytes) {
+    RedisValue val(std::string(30, 'r'));
+    val.setExpiryFlag(true);
+    val.setInteger(7);
+    EXPECT_EQ(val.encoding(), RedisEncoding::INT);
+    EXPECT_TRUE(val.hasExpiry());
+
+    val.appendString("x");
+    EXPECT_EQ(val.encoding(), RedisEncoding::EMBSTR);
+    EXPECT_EQ(val.str(), "7x");
+
+    val.setInteger(8);
+    val.setString("eight");
+    EXPECT_EQ(val.str(), "eight");
+    EXPECT_TRUE(val.hasExpiry());
+}
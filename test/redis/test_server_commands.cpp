@@ -1,10 +1,15 @@
 // test_server_commands.cpp
 #include <gtest/gtest.h>
+#include <atomic>
 #include <vector>
 #include <string>
 #include <chrono>
 #include <sstream>
+#include <set>
+#include <thread>
 #include "redis/commands/server_commands.h"
+#include "redis/command_handler.h"
+#include "command_reply.h"
 #include "redis/database/redis_database.h"
 
 // Test fixture for ServerCommands tests
@@ -34,13 +39,13 @@ protected:
     RedisDatabase* database;
     ServerCommands* serverCommands;
     std::chrono::system_clock::time_point server_start_time;
-    size_t commands_processed;
+    std::atomic<uint64_t> commands_processed;
 };
 
 // Test PING command with no arguments
 TEST_F(ServerCommandsTest, Ping_NoArguments_ReturnsPong) {
     std::vector<std::string> args = {"PING"};
-    std::string result = serverCommands->cmdPing(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdPing, args);
     
     EXPECT_EQ("+PONG\r\n", result);
     commands_processed++; // Simulate command processing
@@ -49,7 +54,7 @@ TEST_F(ServerCommandsTest, Ping_NoArguments_ReturnsPong) {
 // Test PING command with message argument
 TEST_F(ServerCommandsTest, Ping_WithMessage_ReturnsMessage) {
     std::vector<std::string> args = {"PING", "Hello World"};
-    std::string result = serverCommands->cmdPing(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdPing, args);
     
     EXPECT_EQ("$11\r\nHello World\r\n", result);
     commands_processed++; // Simulate command processing
@@ -58,7 +63,7 @@ TEST_F(ServerCommandsTest, Ping_WithMessage_ReturnsMessage) {
 // Test PING command with too many arguments
 TEST_F(ServerCommandsTest, Ping_TooManyArguments_ReturnsError) {
     std::vector<std::string> args = {"PING", "arg1", "arg2", "arg3"};
-    std::string result = serverCommands->cmdPing(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdPing, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     EXPECT_TRUE(result.find("ping") != std::string::npos);
@@ -68,7 +73,7 @@ TEST_F(ServerCommandsTest, Ping_TooManyArguments_ReturnsError) {
 // Test ECHO command with valid argument
 TEST_F(ServerCommandsTest, Echo_ValidArgument_ReturnsEchoedString) {
     std::vector<std::string> args = {"ECHO", "Hello Redis"};
-    std::string result = serverCommands->cmdEcho(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdEcho, args);
     
     EXPECT_EQ("$11\r\nHello Redis\r\n", result);
     commands_processed++; // Simulate command processing
@@ -77,7 +82,7 @@ TEST_F(ServerCommandsTest, Echo_ValidArgument_ReturnsEchoedString) {
 // Test ECHO command with wrong number of arguments
 TEST_F(ServerCommandsTest, Echo_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"ECHO"}; // Missing message
-    std::string result = serverCommands->cmdEcho(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdEcho, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     EXPECT_TRUE(result.find("echo") != std::string::npos);
@@ -87,7 +92,7 @@ TEST_F(ServerCommandsTest, Echo_WrongNumberOfArguments_ReturnsError) {
 // Test ECHO command with too many arguments
 TEST_F(ServerCommandsTest, Echo_TooManyArguments_ReturnsError) {
     std::vector<std::string> args = {"ECHO", "arg1", "arg2"};
-    std::string result = serverCommands->cmdEcho(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdEcho, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     commands_processed++; // Simulate command processing
@@ -96,7 +101,7 @@ TEST_F(ServerCommandsTest, Echo_TooManyArguments_ReturnsError) {
 // Test INFO command
 TEST_F(ServerCommandsTest, Info_ReturnsServerInformation) {
     std::vector<std::string> args = {"INFO"};
-    std::string result = serverCommands->cmdInfo(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdInfo, args);
     
     // Check that the response contains expected sections
     EXPECT_TRUE(result.find("# Server") != std::string::npos);
@@ -106,6 +111,11 @@ TEST_F(ServerCommandsTest, Info_ReturnsServerInformation) {
     EXPECT_TRUE(result.find("total_commands_processed:") != std::string::npos);
     EXPECT_TRUE(result.find("# Keyspace") != std::string::npos);
     EXPECT_TRUE(result.find("db0:keys=") != std::string::npos);
+    EXPECT_TRUE(result.find("# Memory") != std::string::npos);
+    EXPECT_TRUE(result.find("used_memory:") != std::string::npos);
+    EXPECT_TRUE(result.find("maxmemory:0\r\n") != std::string::npos);
+    EXPECT_TRUE(result.find("maxmemory_policy:noeviction\r\n") != std::string::npos);
+    EXPECT_TRUE(result.find("evicted_keys:0\r\n") != std::string::npos);
     
     // Verify it's a bulk string response
     EXPECT_EQ('$', result[0]);
@@ -115,7 +125,7 @@ TEST_F(ServerCommandsTest, Info_ReturnsServerInformation) {
 // Test INFO command with arguments (should ignore them)
 TEST_F(ServerCommandsTest, Info_WithArguments_IgnoresArguments) {
     std::vector<std::string> args = {"INFO", "server", "stats"};
-    std::string result = serverCommands->cmdInfo(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdInfo, args);
     
     // Should still return full info response
     EXPECT_TRUE(result.find("# Server") != std::string::npos);
@@ -129,7 +139,7 @@ TEST_F(ServerCommandsTest, Flushall_ClearsDatabase) {
     EXPECT_GT(database->getDatabaseSize(), 0);
     
     std::vector<std::string> args = {"FLUSHALL"};
-    std::string result = serverCommands->cmdFlushall(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdFlushall, args);
     
     EXPECT_EQ("+OK\r\n", result);
     
@@ -142,17 +152,39 @@ TEST_F(ServerCommandsTest, Flushall_ClearsDatabase) {
 // Test FLUSHALL command with too many arguments
 TEST_F(ServerCommandsTest, Flushall_TooManyArguments_ReturnsError) {
     std::vector<std::string> args = {"FLUSHALL", "arg1", "arg2"};
-    std::string result = serverCommands->cmdFlushall(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdFlushall, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     EXPECT_TRUE(result.find("flushall") != std::string::npos);
     commands_processed++; // Simulate command processing
 }
 
+// Test FLUSHALL ASYNC and FLUSHDB SYNC both leave an empty database
+TEST_F(ServerCommandsTest, Flushall_AsyncAndFlushdb_ClearDatabase) {
+    std::vector<std::string> async_args = {"FLUSHALL", "async"};
+    EXPECT_EQ("+OK\r\n", runCommand(serverCommands, &ServerCommands::cmdFlushall, async_args));
+    EXPECT_EQ(0, database->getDatabaseSize());
+
+    database->setValue("key", RedisValue("value"));
+    std::vector<std::string> flushdb_args = {"FLUSHDB", "SYNC"};
+    EXPECT_EQ("+OK\r\n", runCommand(serverCommands, &ServerCommands::cmdFlushdb, flushdb_args));
+    EXPECT_EQ(0, database->getDatabaseSize());
+    LazyFree::instance().waitIdle();
+    commands_processed += 2;
+}
+
+// Test FLUSHDB rejects an unknown mode
+TEST_F(ServerCommandsTest, Flushdb_UnknownMode_ReturnsSyntaxError) {
+    std::vector<std::string> args = {"FLUSHDB", "LATER"};
+    EXPECT_EQ("-ERR syntax error\r\n", runCommand(serverCommands, &ServerCommands::cmdFlushdb, args));
+    EXPECT_GT(database->getDatabaseSize(), 0);
+    commands_processed++;
+}
+
 // Test KEYS command with pattern matching all keys
 TEST_F(ServerCommandsTest, Keys_MatchAll_ReturnsAllKeys) {
     std::vector<std::string> args = {"KEYS", "*"};
-    std::string result = serverCommands->cmdKeys(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdKeys, args);
     
     // Should return an array containing all keys
     EXPECT_EQ('*', result[0]); // Array response
@@ -166,7 +198,7 @@ TEST_F(ServerCommandsTest, Keys_MatchAll_ReturnsAllKeys) {
 // Test KEYS command with specific pattern
 TEST_F(ServerCommandsTest, Keys_SpecificPattern_ReturnsMatchingKeys) {
     std::vector<std::string> args = {"KEYS", "key*"};
-    std::string result = serverCommands->cmdKeys(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdKeys, args);
     
     // Should return keys starting with "key"
     EXPECT_EQ('*', result[0]); // Array response
@@ -180,7 +212,7 @@ TEST_F(ServerCommandsTest, Keys_SpecificPattern_ReturnsMatchingKeys) {
 // Test KEYS command with no matches
 TEST_F(ServerCommandsTest, Keys_NoMatches_ReturnsEmptyArray) {
     std::vector<std::string> args = {"KEYS", "nonexistent*"};
-    std::string result = serverCommands->cmdKeys(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdKeys, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
     commands_processed++; // Simulate command processing
@@ -189,7 +221,7 @@ TEST_F(ServerCommandsTest, Keys_NoMatches_ReturnsEmptyArray) {
 // Test KEYS command with wrong number of arguments
 TEST_F(ServerCommandsTest, Keys_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"KEYS"}; // Missing pattern
-    std::string result = serverCommands->cmdKeys(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdKeys, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     EXPECT_TRUE(result.find("keys") != std::string::npos);
@@ -199,7 +231,7 @@ TEST_F(ServerCommandsTest, Keys_WrongNumberOfArguments_ReturnsError) {
 // Test KEYS command with too many arguments
 TEST_F(ServerCommandsTest, Keys_TooManyArguments_ReturnsError) {
     std::vector<std::string> args = {"KEYS", "*", "extra_arg"};
-    std::string result = serverCommands->cmdKeys(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdKeys, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     commands_processed++; // Simulate command processing
@@ -208,7 +240,7 @@ TEST_F(ServerCommandsTest, Keys_TooManyArguments_ReturnsError) {
 // Test DBSIZE command
 TEST_F(ServerCommandsTest, Dbsize_ReturnsCorrectSize) {
     std::vector<std::string> args = {"DBSIZE"};
-    std::string result = serverCommands->cmdDbsize(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdDbsize, args);
     
     // Should return the number of keys in the database
     size_t expected_size = database->getDatabaseSize();
@@ -223,7 +255,7 @@ TEST_F(ServerCommandsTest, Dbsize_AfterAddingKey_ReturnsUpdatedSize) {
     database->setValue("new_key", RedisValue("new_value"));
     
     std::vector<std::string> args = {"DBSIZE"};
-    std::string result = serverCommands->cmdDbsize(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdDbsize, args);
     
     size_t expected_size = database->getDatabaseSize();
     std::string expected_response = ":" + std::to_string(expected_size) + "\r\n";
@@ -235,19 +267,34 @@ TEST_F(ServerCommandsTest, Dbsize_AfterAddingKey_ReturnsUpdatedSize) {
 TEST_F(ServerCommandsTest, Dbsize_AfterFlushall_ReturnsZero) {
     // First flush the database
     std::vector<std::string> flush_args = {"FLUSHALL"};
-    serverCommands->cmdFlushall(flush_args);
+    runCommand(serverCommands, &ServerCommands::cmdFlushall, flush_args);
     
     std::vector<std::string> args = {"DBSIZE"};
-    std::string result = serverCommands->cmdDbsize(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdDbsize, args);
     
     EXPECT_EQ(":0\r\n", result);
     commands_processed += 2; // Simulate both commands being processed
 }
 
+// Test DBSIZE counts expired keys until they are reclaimed, as Redis does,
+// instead of sweeping the expiry tables
+TEST_F(ServerCommandsTest, Dbsize_CountsExpiredKeysUntilReclaimed) {
+    size_t before = database->getDatabaseSize();
+    database->setValue("short_lived", RedisValue("v"));
+    database->setExpiry("short_lived", std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    EXPECT_EQ(":" + std::to_string(before + 1) + "\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdDbsize, {"DBSIZE"}));
+    EXPECT_EQ(nullptr, database->getValue("short_lived"));   // lazy expiry reclaims it
+    EXPECT_EQ(":" + std::to_string(before) + "\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdDbsize, {"DBSIZE"}));
+}
+
 // Test DBSIZE command with wrong number of arguments
 TEST_F(ServerCommandsTest, Dbsize_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"DBSIZE", "extra_arg"};
-    std::string result = serverCommands->cmdDbsize(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdDbsize, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     EXPECT_TRUE(result.find("dbsize") != std::string::npos);
@@ -257,7 +304,7 @@ TEST_F(ServerCommandsTest, Dbsize_WrongNumberOfArguments_ReturnsError) {
 // Test TIME command
 TEST_F(ServerCommandsTest, Time_ReturnsCurrentTime) {
     std::vector<std::string> args = {"TIME"};
-    std::string result = serverCommands->cmdTime(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdTime, args);
     
     // Should return an array with two elements: seconds and microseconds
     EXPECT_EQ('*', result[0]); // Array response
@@ -278,7 +325,7 @@ TEST_F(ServerCommandsTest, Time_ReturnsCurrentTime) {
 // Test TIME command with wrong number of arguments
 TEST_F(ServerCommandsTest, Time_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"TIME", "extra_arg"};
-    std::string result = serverCommands->cmdTime(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdTime, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
     EXPECT_TRUE(result.find("time") != std::string::npos);
@@ -289,25 +336,25 @@ TEST_F(ServerCommandsTest, Time_WrongNumberOfArguments_ReturnsError) {
 TEST_F(ServerCommandsTest, Integration_MultipleCommands) {
     // Test sequence of commands
     std::vector<std::string> ping_args = {"PING"};
-    std::string ping_result = serverCommands->cmdPing(ping_args);
+    std::string ping_result = runCommand(serverCommands, &ServerCommands::cmdPing, ping_args);
     EXPECT_EQ("+PONG\r\n", ping_result);
     
     std::vector<std::string> echo_args = {"ECHO", "Test Message"};
-    std::string echo_result = serverCommands->cmdEcho(echo_args);
+    std::string echo_result = runCommand(serverCommands, &ServerCommands::cmdEcho, echo_args);
     EXPECT_EQ("$12\r\nTest Message\r\n", echo_result);
     
     std::vector<std::string> dbsize_args = {"DBSIZE"};
-    std::string dbsize_result = serverCommands->cmdDbsize(dbsize_args);
+    std::string dbsize_result = runCommand(serverCommands, &ServerCommands::cmdDbsize, dbsize_args);
     size_t initial_size = database->getDatabaseSize();
     std::string expected_dbsize = ":" + std::to_string(initial_size) + "\r\n";
     EXPECT_EQ(expected_dbsize, dbsize_result);
     
     std::vector<std::string> keys_args = {"KEYS", "key*"};
-    std::string keys_result = serverCommands->cmdKeys(keys_args);
+    std::string keys_result = runCommand(serverCommands, &ServerCommands::cmdKeys, keys_args);
     EXPECT_EQ('*', keys_result[0]); // Array response
     
     std::vector<std::string> time_args = {"TIME"};
-    std::string time_result = serverCommands->cmdTime(time_args);
+    std::string time_result = runCommand(serverCommands, &ServerCommands::cmdTime, time_args);
     EXPECT_EQ('*', time_result[0]); // Array response
     
     commands_processed += 5; // Simulate all commands being processed
@@ -316,13 +363,13 @@ TEST_F(ServerCommandsTest, Integration_MultipleCommands) {
 // Test INFO command reflects command processing count
 TEST_F(ServerCommandsTest, Info_ReflectsCommandsProcessed) {
     // Process some commands first
-    serverCommands->cmdPing({"PING"});
-    serverCommands->cmdEcho({"ECHO", "test"});
-    serverCommands->cmdDbsize({"DBSIZE"});
+    runCommand(serverCommands, &ServerCommands::cmdPing, {"PING"});
+    runCommand(serverCommands, &ServerCommands::cmdEcho, {"ECHO", "test"});
+    runCommand(serverCommands, &ServerCommands::cmdDbsize, {"DBSIZE"});
     commands_processed += 3;
     
     std::vector<std::string> args = {"INFO"};
-    std::string result = serverCommands->cmdInfo(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdInfo, args);
     
     // Should show 3 commands processed
     EXPECT_TRUE(result.find("total_commands_processed:3") != std::string::npos);
@@ -332,16 +379,16 @@ TEST_F(ServerCommandsTest, Info_ReflectsCommandsProcessed) {
 // Test edge case: Empty database operations
 TEST_F(ServerCommandsTest, EdgeCase_EmptyDatabase) {
     // Clear the database first
-    serverCommands->cmdFlushall({"FLUSHALL"});
+    runCommand(serverCommands, &ServerCommands::cmdFlushall, {"FLUSHALL"});
     
     // Test DBSIZE on empty database
     std::vector<std::string> dbsize_args = {"DBSIZE"};
-    std::string dbsize_result = serverCommands->cmdDbsize(dbsize_args);
+    std::string dbsize_result = runCommand(serverCommands, &ServerCommands::cmdDbsize, dbsize_args);
     EXPECT_EQ(":0\r\n", dbsize_result);
     
     // Test KEYS on empty database
     std::vector<std::string> keys_args = {"KEYS", "*"};
-    std::string keys_result = serverCommands->cmdKeys(keys_args);
+    std::string keys_result = runCommand(serverCommands, &ServerCommands::cmdKeys, keys_args);
     EXPECT_EQ("*0\r\n", keys_result); // Empty array
     
     commands_processed += 3; // Simulate all commands being processed
@@ -351,7 +398,7 @@ TEST_F(ServerCommandsTest, EdgeCase_EmptyDatabase) {
 TEST_F(ServerCommandsTest, EdgeCase_LongEchoMessage) {
     std::string long_message(1000, 'A'); // 1000 'A's
     std::vector<std::string> args = {"ECHO", long_message};
-    std::string result = serverCommands->cmdEcho(args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdEcho, args);
     
     // Should handle long messages correctly
     EXPECT_TRUE(result.find(long_message) != std::string::npos);
@@ -365,7 +412,113 @@ TEST_F(ServerCommandsTest, EdgeCase_CommandCaseVariations) {
     // The command implementations expect the command name in uppercase as per the protocol
     
     std::vector<std::string> ping_args = {"PING"};
-    std::string result = serverCommands->cmdPing(ping_args);
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdPing, ping_args);
     EXPECT_EQ("+PONG\r\n", result);
     commands_processed++; // Simulate command processing
-}
\ No newline at end of file
+}
+// Test COMMAND COUNT matches the dispatch table
+TEST_F(ServerCommandsTest, CommandCount_ReturnsTableSize) {
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdCommand, {"COMMAND", "COUNT"});
+    EXPECT_EQ(":" + std::to_string(CommandHandler::COMMAND_COUNT) + "\r\n", result);
+}
+
+// Test COMMAND INFO for known and unknown commands
+TEST_F(ServerCommandsTest, CommandInfo_ReturnsDescriptors) {
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdCommand, {"COMMAND", "INFO", "get", "mset", "nosuch"});
+    EXPECT_EQ("*3\r\n"
+              "*6\r\n$3\r\nget\r\n:2\r\n*2\r\n+readonly\r\n+fast\r\n:1\r\n:1\r\n:1\r\n"
+              "*6\r\n$4\r\nmset\r\n:-3\r\n*2\r\n+write\r\n+denyoom\r\n:1\r\n:-1\r\n:2\r\n"
+              "*-1\r\n", result);
+}
+
+// Test COMMAND INFO reports FLUSHALL and FLUSHDB as admin, DBSIZE as fast
+TEST_F(ServerCommandsTest, CommandInfo_ReportsServerCommandFlags) {
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdCommand,
+                                    {"COMMAND", "INFO", "flushall", "flushdb", "dbsize"});
+    EXPECT_EQ("*3\r\n"
+              "*6\r\n$8\r\nflushall\r\n:-1\r\n*2\r\n+write\r\n+admin\r\n:0\r\n:0\r\n:0\r\n"
+              "*6\r\n$7\r\nflushdb\r\n:-1\r\n*2\r\n+write\r\n+admin\r\n:0\r\n:0\r\n:0\r\n"
+              "*6\r\n$6\r\ndbsize\r\n:1\r\n*2\r\n+readonly\r\n+fast\r\n:0\r\n:0\r\n:0\r\n", result);
+}
+
+// Test COMMAND without arguments lists every command
+TEST_F(ServerCommandsTest, Command_NoArguments_ListsAll) {
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdCommand, {"COMMAND"});
+    EXPECT_EQ(0u, result.rfind("*" + std::to_string(CommandHandler::COMMAND_COUNT) + "\r\n", 0));
+    EXPECT_NE(std::string::npos, result.find("$7\r\nhgetall\r\n:2\r\n"));
+}
+
+// Test COMMAND DOCS reports complexity
+TEST_F(ServerCommandsTest, CommandDocs_ReportsComplexity) {
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdCommand, {"COMMAND", "DOCS", "KEYS"});
+    EXPECT_EQ("*2\r\n$4\r\nkeys\r\n*2\r\n$10\r\ncomplexity\r\n$4\r\nO(N)\r\n", result);
+}
+
+// Test COMMAND with an unknown subcommand
+TEST_F(ServerCommandsTest, Command_UnknownSubcommand_ReturnsError) {
+    std::string result = runCommand(serverCommands, &ServerCommands::cmdCommand, {"COMMAND", "FOO"});
+    EXPECT_EQ(0u, result.rfind("-ERR unknown subcommand 'FOO'", 0));
+}
+
+// Test SCAN returns every key once the cursor comes back to 0
+TEST_F(ServerCommandsTest, Scan_IteratesUntilCursorZero) {
+    for (int i = 0; i < 200; ++i) {
+        database->setValue("scan:" + std::to_string(i), RedisValue("v"));
+    }
+    std::set<std::string> seen;
+    std::string cursor = "0";
+    do {
+        std::string result = runCommand(serverCommands, &ServerCommands::cmdScan, {"SCAN", cursor, "COUNT", "20"});
+        ScanReply reply = parseScanReply(result);
+        EXPECT_LE(reply.elements.size(), 80u);
+        seen.insert(reply.elements.begin(), reply.elements.end());
+        cursor = reply.cursor;
+    } while (cursor != "0");
+    EXPECT_EQ(203u, seen.size());
+}
+
+// Test SCAN MATCH and TYPE filters
+TEST_F(ServerCommandsTest, Scan_MatchAndType_FilterKeys) {
+    RedisValue list(RedisType::LIST);
+    list.list().push_back("x");
+    database->setValue("keylist", list);
+
+    std::set<std::string> matched;
+    std::set<std::string> lists;
+    std::string cursor = "0";
+    do {
+        ScanReply reply = parseScanReply(runCommand(serverCommands, &ServerCommands::cmdScan,
+                                                    {"SCAN", cursor, "match", "key?", "COUNT", "1000"}));
+        matched.insert(reply.elements.begin(), reply.elements.end());
+        cursor = reply.cursor;
+    } while (cursor != "0");
+    do {
+        ScanReply reply = parseScanReply(runCommand(serverCommands, &ServerCommands::cmdScan,
+                                                    {"SCAN", cursor, "TYPE", "LIST"}));
+        lists.insert(reply.elements.begin(), reply.elements.end());
+        cursor = reply.cursor;
+    } while (cursor != "0");
+
+    EXPECT_EQ((std::set<std::string>{"key1", "key2", "key3"}), matched);
+    EXPECT_EQ((std::set<std::string>{"keylist"}), lists);
+}
+
+// Test SCAN argument errors
+TEST_F(ServerCommandsTest, Scan_InvalidArguments_ReturnErrors) {
+    EXPECT_EQ("-ERR wrong number of arguments for 'scan' command\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdScan, {"SCAN"}));
+    EXPECT_EQ("-ERR invalid cursor\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdScan, {"SCAN", "12abc"}));
+    EXPECT_EQ("-ERR invalid cursor\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdScan, {"SCAN", "-1"}));
+    EXPECT_EQ("-ERR syntax error\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdScan, {"SCAN", "0", "COUNT"}));
+    EXPECT_EQ("-ERR syntax error\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdScan, {"SCAN", "0", "COUNT", "0"}));
+    EXPECT_EQ("-ERR value is not an integer or out of range\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdScan, {"SCAN", "0", "COUNT", "ten"}));
+    EXPECT_EQ("-ERR unknown type name 'tree'\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdScan, {"SCAN", "0", "TYPE", "tree"}));
+    EXPECT_EQ("-ERR syntax error\r\n",
+              runCommand(serverCommands, &ServerCommands::cmdScan, {"SCAN", "0", "LIMIT", "5"}));
+}
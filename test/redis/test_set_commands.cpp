@@ -4,6 +4,7 @@
 #include <string>
 #include <set>
 #include "redis/commands/set_commands.h"
+#include "command_reply.h"
 #include "redis/database/redis_database.h"
 
 // Test fixture for SetCommands tests
@@ -15,13 +16,8 @@ protected:
         setCommands = new SetCommands(*database);
         
         // Add some test data
-        RedisValue set1(RedisType::SET);
-        set1.set_value = {"member1", "member2", "member3"};
-        database->setValue("existing_set", set1);
-        
-        RedisValue set2(RedisType::SET);
-        set2.set_value = {"apple", "banana", "cherry"};
-        database->setValue("fruits_set", set2);
+        database->setValue("existing_set", makeSet({"member1", "member2", "member3"}));
+        database->setValue("fruits_set", makeSet({"apple", "banana", "cherry"}));
         
         RedisValue empty_set(RedisType::SET);
         database->setValue("empty_set", empty_set);
@@ -35,6 +31,14 @@ protected:
         delete database;
     }
     
+    static RedisValue makeSet(std::initializer_list<std::string_view> members) {
+        RedisValue set(RedisType::SET);
+        for (std::string_view member : members) {
+            set.set().tryEmplace(HashedKey(member));
+        }
+        return set;
+    }
+
     RedisDatabase* database;
     SetCommands* setCommands;
 };
@@ -42,25 +46,25 @@ protected:
 // Test SADD command with new set
 TEST_F(SetCommandsTest, Sadd_NewSet_ReturnsAddedCount) {
     std::vector<std::string> args = {"SADD", "new_set", "member1", "member2", "member3"};
-    std::string result = setCommands->cmdSadd(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSadd, args);
     
     EXPECT_EQ(":3\r\n", result);
     
     // Verify set was created with members
     RedisValue* value = database->getValue("new_set");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::SET) {
-        EXPECT_EQ(3, value->set_value.size());
-        EXPECT_TRUE(value->set_value.count("member1") > 0);
-        EXPECT_TRUE(value->set_value.count("member2") > 0);
-        EXPECT_TRUE(value->set_value.count("member3") > 0);
+    if (value && value->type() == RedisType::SET) {
+        EXPECT_EQ(3, value->set().size());
+        EXPECT_TRUE(value->set().contains("member1"));
+        EXPECT_TRUE(value->set().contains("member2"));
+        EXPECT_TRUE(value->set().contains("member3"));
     }
 }
 
 // Test SADD command with existing set
 TEST_F(SetCommandsTest, Sadd_ExistingSet_AddsOnlyNewMembers) {
     std::vector<std::string> args = {"SADD", "existing_set", "member2", "member4", "member5"};
-    std::string result = setCommands->cmdSadd(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSadd, args);
     
     // member2 already exists, so only 2 new members added
     EXPECT_EQ(":2\r\n", result);
@@ -68,20 +72,20 @@ TEST_F(SetCommandsTest, Sadd_ExistingSet_AddsOnlyNewMembers) {
     // Verify members were added
     RedisValue* value = database->getValue("existing_set");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::SET) {
-        EXPECT_EQ(5, value->set_value.size()); // 3 original + 2 new
-        EXPECT_TRUE(value->set_value.count("member1") > 0);
-        EXPECT_TRUE(value->set_value.count("member2") > 0);
-        EXPECT_TRUE(value->set_value.count("member3") > 0);
-        EXPECT_TRUE(value->set_value.count("member4") > 0);
-        EXPECT_TRUE(value->set_value.count("member5") > 0);
+    if (value && value->type() == RedisType::SET) {
+        EXPECT_EQ(5, value->set().size()); // 3 original + 2 new
+        EXPECT_TRUE(value->set().contains("member1"));
+        EXPECT_TRUE(value->set().contains("member2"));
+        EXPECT_TRUE(value->set().contains("member3"));
+        EXPECT_TRUE(value->set().contains("member4"));
+        EXPECT_TRUE(value->set().contains("member5"));
     }
 }
 
 // Test SADD command with wrong number of arguments
 TEST_F(SetCommandsTest, Sadd_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"SADD", "key"}; // Missing members
-    std::string result = setCommands->cmdSadd(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSadd, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -89,7 +93,7 @@ TEST_F(SetCommandsTest, Sadd_WrongNumberOfArguments_ReturnsError) {
 // Test SADD command with wrong type
 TEST_F(SetCommandsTest, Sadd_WrongType_ReturnsError) {
     std::vector<std::string> args = {"SADD", "string_key", "member1"};
-    std::string result = setCommands->cmdSadd(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSadd, args);
     
     EXPECT_TRUE(result.find("ERR Operation against a key holding the wrong kind of value") != std::string::npos);
 }
@@ -97,7 +101,7 @@ TEST_F(SetCommandsTest, Sadd_WrongType_ReturnsError) {
 // Test SREM command with existing members
 TEST_F(SetCommandsTest, Srem_ExistingMembers_ReturnsRemovedCount) {
     std::vector<std::string> args = {"SREM", "existing_set", "member1", "member3", "non_existent_member"};
-    std::string result = setCommands->cmdSrem(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSrem, args);
     
     // Only member1 and member3 exist, so 2 removed
     EXPECT_EQ(":2\r\n", result);
@@ -105,18 +109,18 @@ TEST_F(SetCommandsTest, Srem_ExistingMembers_ReturnsRemovedCount) {
     // Verify members were removed
     RedisValue* value = database->getValue("existing_set");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::SET) {
-        EXPECT_EQ(1, value->set_value.size()); // Only member2 remains
-        EXPECT_TRUE(value->set_value.count("member2") > 0);
-        EXPECT_FALSE(value->set_value.count("member1") > 0);
-        EXPECT_FALSE(value->set_value.count("member3") > 0);
+    if (value && value->type() == RedisType::SET) {
+        EXPECT_EQ(1, value->set().size()); // Only member2 remains
+        EXPECT_TRUE(value->set().contains("member2"));
+        EXPECT_FALSE(value->set().contains("member1"));
+        EXPECT_FALSE(value->set().contains("member3"));
     }
 }
 
 // Test SREM command removes empty set
 TEST_F(SetCommandsTest, Srem_RemovesEmptySet_DeletesKey) {
     std::vector<std::string> args = {"SREM", "existing_set", "member1", "member2", "member3"};
-    std::string result = setCommands->cmdSrem(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSrem, args);
     
     EXPECT_EQ(":3\r\n", result);
     
@@ -128,7 +132,7 @@ TEST_F(SetCommandsTest, Srem_RemovesEmptySet_DeletesKey) {
 // Test SREM command with non-existent set
 TEST_F(SetCommandsTest, Srem_NonExistentSet_ReturnsZero) {
     std::vector<std::string> args = {"SREM", "non_existent_set", "member1"};
-    std::string result = setCommands->cmdSrem(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSrem, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -136,7 +140,7 @@ TEST_F(SetCommandsTest, Srem_NonExistentSet_ReturnsZero) {
 // Test SREM command with wrong type
 TEST_F(SetCommandsTest, Srem_WrongType_ReturnsZero) {
     std::vector<std::string> args = {"SREM", "string_key", "member1"};
-    std::string result = setCommands->cmdSrem(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSrem, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -144,7 +148,7 @@ TEST_F(SetCommandsTest, Srem_WrongType_ReturnsZero) {
 // Test SISMEMBER command with existing member
 TEST_F(SetCommandsTest, Sismember_ExistingMember_ReturnsOne) {
     std::vector<std::string> args = {"SISMEMBER", "existing_set", "member1"};
-    std::string result = setCommands->cmdSismember(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSismember, args);
     
     EXPECT_EQ(":1\r\n", result);
 }
@@ -152,7 +156,7 @@ TEST_F(SetCommandsTest, Sismember_ExistingMember_ReturnsOne) {
 // Test SISMEMBER command with non-existent member
 TEST_F(SetCommandsTest, Sismember_NonExistentMember_ReturnsZero) {
     std::vector<std::string> args = {"SISMEMBER", "existing_set", "non_existent_member"};
-    std::string result = setCommands->cmdSismember(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSismember, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -160,7 +164,7 @@ TEST_F(SetCommandsTest, Sismember_NonExistentMember_ReturnsZero) {
 // Test SISMEMBER command with non-existent set
 TEST_F(SetCommandsTest, Sismember_NonExistentSet_ReturnsZero) {
     std::vector<std::string> args = {"SISMEMBER", "non_existent_set", "member1"};
-    std::string result = setCommands->cmdSismember(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSismember, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -168,7 +172,7 @@ TEST_F(SetCommandsTest, Sismember_NonExistentSet_ReturnsZero) {
 // Test SISMEMBER command with wrong type
 TEST_F(SetCommandsTest, Sismember_WrongType_ReturnsZero) {
     std::vector<std::string> args = {"SISMEMBER", "string_key", "member1"};
-    std::string result = setCommands->cmdSismember(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSismember, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -176,7 +180,7 @@ TEST_F(SetCommandsTest, Sismember_WrongType_ReturnsZero) {
 // Test SISMEMBER command with wrong number of arguments
 TEST_F(SetCommandsTest, Sismember_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"SISMEMBER", "existing_set"}; // Missing member
-    std::string result = setCommands->cmdSismember(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSismember, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -184,7 +188,7 @@ TEST_F(SetCommandsTest, Sismember_WrongNumberOfArguments_ReturnsError) {
 // Test SCARD command with non-empty set
 TEST_F(SetCommandsTest, Scard_NonEmptySet_ReturnsCardinality) {
     std::vector<std::string> args = {"SCARD", "existing_set"};
-    std::string result = setCommands->cmdScard(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdScard, args);
     
     EXPECT_EQ(":3\r\n", result); // 3 members
 }
@@ -192,7 +196,7 @@ TEST_F(SetCommandsTest, Scard_NonEmptySet_ReturnsCardinality) {
 // Test SCARD command with empty set
 TEST_F(SetCommandsTest, Scard_EmptySet_ReturnsZero) {
     std::vector<std::string> args = {"SCARD", "empty_set"};
-    std::string result = setCommands->cmdScard(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdScard, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -200,7 +204,7 @@ TEST_F(SetCommandsTest, Scard_EmptySet_ReturnsZero) {
 // Test SCARD command with non-existent set
 TEST_F(SetCommandsTest, Scard_NonExistentSet_ReturnsZero) {
     std::vector<std::string> args = {"SCARD", "non_existent_set"};
-    std::string result = setCommands->cmdScard(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdScard, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -208,7 +212,7 @@ TEST_F(SetCommandsTest, Scard_NonExistentSet_ReturnsZero) {
 // Test SCARD command with wrong type
 TEST_F(SetCommandsTest, Scard_WrongType_ReturnsZero) {
     std::vector<std::string> args = {"SCARD", "string_key"};
-    std::string result = setCommands->cmdScard(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdScard, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -216,7 +220,7 @@ TEST_F(SetCommandsTest, Scard_WrongType_ReturnsZero) {
 // Test SCARD command with wrong number of arguments
 TEST_F(SetCommandsTest, Scard_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"SCARD"}; // Missing key
-    std::string result = setCommands->cmdScard(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdScard, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -224,7 +228,7 @@ TEST_F(SetCommandsTest, Scard_WrongNumberOfArguments_ReturnsError) {
 // Test SMEMBERS command with non-empty set
 TEST_F(SetCommandsTest, Smembers_NonEmptySet_ReturnsAllMembers) {
     std::vector<std::string> args = {"SMEMBERS", "fruits_set"};
-    std::string result = setCommands->cmdSmembers(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSmembers, args);
     
     // Should return all members in an array (order may vary)
     EXPECT_TRUE(result.find("apple") != std::string::npos);
@@ -236,7 +240,7 @@ TEST_F(SetCommandsTest, Smembers_NonEmptySet_ReturnsAllMembers) {
 // Test SMEMBERS command with empty set
 TEST_F(SetCommandsTest, Smembers_EmptySet_ReturnsEmptyArray) {
     std::vector<std::string> args = {"SMEMBERS", "empty_set"};
-    std::string result = setCommands->cmdSmembers(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSmembers, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -244,7 +248,7 @@ TEST_F(SetCommandsTest, Smembers_EmptySet_ReturnsEmptyArray) {
 // Test SMEMBERS command with non-existent set
 TEST_F(SetCommandsTest, Smembers_NonExistentSet_ReturnsEmptyArray) {
     std::vector<std::string> args = {"SMEMBERS", "non_existent_set"};
-    std::string result = setCommands->cmdSmembers(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSmembers, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -252,7 +256,7 @@ TEST_F(SetCommandsTest, Smembers_NonExistentSet_ReturnsEmptyArray) {
 // Test SMEMBERS command with wrong type
 TEST_F(SetCommandsTest, Smembers_WrongType_ReturnsEmptyArray) {
     std::vector<std::string> args = {"SMEMBERS", "string_key"};
-    std::string result = setCommands->cmdSmembers(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSmembers, args);
     
     EXPECT_EQ("*0\r\n", result); // Empty array
 }
@@ -260,7 +264,7 @@ TEST_F(SetCommandsTest, Smembers_WrongType_ReturnsEmptyArray) {
 // Test SMEMBERS command with wrong number of arguments
 TEST_F(SetCommandsTest, Smembers_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"SMEMBERS"}; // Missing key
-    std::string result = setCommands->cmdSmembers(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSmembers, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -268,7 +272,7 @@ TEST_F(SetCommandsTest, Smembers_WrongNumberOfArguments_ReturnsError) {
 // Test SPOP command with non-empty set
 TEST_F(SetCommandsTest, Spop_NonEmptySet_ReturnsRandomMember) {
     std::vector<std::string> args = {"SPOP", "fruits_set"};
-    std::string result = setCommands->cmdSpop(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSpop, args);
     
     // Should return one of the fruits
     EXPECT_TRUE(result.find("apple") != std::string::npos || 
@@ -278,15 +282,15 @@ TEST_F(SetCommandsTest, Spop_NonEmptySet_ReturnsRandomMember) {
     // Verify set size decreased by 1
     RedisValue* value = database->getValue("fruits_set");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::SET) {
-        EXPECT_EQ(2, value->set_value.size());
+    if (value && value->type() == RedisType::SET) {
+        EXPECT_EQ(2, value->set().size());
     }
 }
 
 // Test SPOP command with empty set
 TEST_F(SetCommandsTest, Spop_EmptySet_ReturnsNull) {
     std::vector<std::string> args = {"SPOP", "empty_set"};
-    std::string result = setCommands->cmdSpop(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSpop, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -294,7 +298,7 @@ TEST_F(SetCommandsTest, Spop_EmptySet_ReturnsNull) {
 // Test SPOP command with non-existent set
 TEST_F(SetCommandsTest, Spop_NonExistentSet_ReturnsNull) {
     std::vector<std::string> args = {"SPOP", "non_existent_set"};
-    std::string result = setCommands->cmdSpop(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSpop, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -302,7 +306,7 @@ TEST_F(SetCommandsTest, Spop_NonExistentSet_ReturnsNull) {
 // Test SPOP command with wrong type
 TEST_F(SetCommandsTest, Spop_WrongType_ReturnsNull) {
     std::vector<std::string> args = {"SPOP", "string_key"};
-    std::string result = setCommands->cmdSpop(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSpop, args);
     
     EXPECT_EQ("$-1\r\n", result); // Null response
 }
@@ -310,7 +314,7 @@ TEST_F(SetCommandsTest, Spop_WrongType_ReturnsNull) {
 // Test SPOP command with wrong number of arguments
 TEST_F(SetCommandsTest, Spop_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"SPOP"}; // Missing key
-    std::string result = setCommands->cmdSpop(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSpop, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -319,58 +323,58 @@ TEST_F(SetCommandsTest, Spop_WrongNumberOfArguments_ReturnsError) {
 TEST_F(SetCommandsTest, Integration_MultipleSetOperations) {
     // Create a set with SADD
     std::vector<std::string> sadd_args = {"SADD", "integration_set", "a", "b", "c", "d"};
-    std::string sadd_result = setCommands->cmdSadd(sadd_args);
+    std::string sadd_result = runCommand(setCommands, &SetCommands::cmdSadd, sadd_args);
     EXPECT_EQ(":4\r\n", sadd_result);
     
     // Check cardinality with SCARD
     std::vector<std::string> scard_args = {"SCARD", "integration_set"};
-    std::string scard_result = setCommands->cmdScard(scard_args);
+    std::string scard_result = runCommand(setCommands, &SetCommands::cmdScard, scard_args);
     EXPECT_EQ(":4\r\n", scard_result);
     
     // Check membership with SISMEMBER
     std::vector<std::string> sismember_args = {"SISMEMBER", "integration_set", "b"};
-    std::string sismember_result = setCommands->cmdSismember(sismember_args);
+    std::string sismember_result = runCommand(setCommands, &SetCommands::cmdSismember, sismember_args);
     EXPECT_EQ(":1\r\n", sismember_result);
     
     // Remove some members with SREM
     std::vector<std::string> srem_args = {"SREM", "integration_set", "a", "c", "x"}; // x doesn't exist
-    std::string srem_result = setCommands->cmdSrem(srem_args);
+    std::string srem_result = runCommand(setCommands, &SetCommands::cmdSrem, srem_args);
     EXPECT_EQ(":2\r\n", srem_result); // Only a and c removed
     
     // Check cardinality again
-    scard_result = setCommands->cmdScard(scard_args);
+    scard_result = runCommand(setCommands, &SetCommands::cmdScard, scard_args);
     EXPECT_EQ(":2\r\n", scard_result);
     
     // Get all members with SMEMBERS
     std::vector<std::string> smembers_args = {"SMEMBERS", "integration_set"};
-    std::string smembers_result = setCommands->cmdSmembers(smembers_args);
+    std::string smembers_result = runCommand(setCommands, &SetCommands::cmdSmembers, smembers_args);
     EXPECT_TRUE(smembers_result.find("b") != std::string::npos);
     EXPECT_TRUE(smembers_result.find("d") != std::string::npos);
     EXPECT_EQ('*', smembers_result[0]); // Array response
     
     // Pop a member with SPOP
     std::vector<std::string> spop_args = {"SPOP", "integration_set"};
-    std::string spop_result = setCommands->cmdSpop(spop_args);
+    std::string spop_result = runCommand(setCommands, &SetCommands::cmdSpop, spop_args);
     EXPECT_TRUE(spop_result.find("b") != std::string::npos || spop_result.find("d") != std::string::npos);
     
     // Final cardinality
-    scard_result = setCommands->cmdScard(scard_args);
+    scard_result = runCommand(setCommands, &SetCommands::cmdScard, scard_args);
     EXPECT_EQ(":1\r\n", scard_result);
 }
 
 // Test edge case: Duplicate members in SADD
 TEST_F(SetCommandsTest, EdgeCase_DuplicateMembersInSadd) {
     std::vector<std::string> args = {"SADD", "duplicate_set", "member1", "member1", "member1"};
-    std::string result = setCommands->cmdSadd(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSadd, args);
     
     // Only one unique member should be added
     EXPECT_EQ(":1\r\n", result);
     
     RedisValue* value = database->getValue("duplicate_set");
     EXPECT_TRUE(value != nullptr);
-    if (value && value->type == RedisType::SET) {
-        EXPECT_EQ(1, value->set_value.size());
-        EXPECT_TRUE(value->set_value.count("member1") > 0);
+    if (value && value->type() == RedisType::SET) {
+        EXPECT_EQ(1, value->set().size());
+        EXPECT_TRUE(value->set().contains("member1"));
     }
 }
 
@@ -382,12 +386,12 @@ TEST_F(SetCommandsTest, EdgeCase_LargeSetOperations) {
         args.push_back("member_" + std::to_string(i));
     }
     
-    std::string result = setCommands->cmdSadd(args);
+    std::string result = runCommand(setCommands, &SetCommands::cmdSadd, args);
     EXPECT_EQ(":100\r\n", result);
     
     // Check cardinality
     std::vector<std::string> scard_args = {"SCARD", "large_set"};
-    std::string scard_result = setCommands->cmdScard(scard_args);
+    std::string scard_result = runCommand(setCommands, &SetCommands::cmdScard, scard_args);
     EXPECT_EQ(":100\r\n", scard_result);
     
     // Remove half the members
@@ -396,10 +400,81 @@ TEST_F(SetCommandsTest, EdgeCase_LargeSetOperations) {
         srem_args.push_back("member_" + std::to_string(i));
     }
     
-    std::string srem_result = setCommands->cmdSrem(srem_args);
+    std::string srem_result = runCommand(setCommands, &SetCommands::cmdSrem, srem_args);
     EXPECT_EQ(":50\r\n", srem_result);
     
     // Final cardinality
-    scard_result = setCommands->cmdScard(scard_args);
+    scard_result = runCommand(setCommands, &SetCommands::cmdScard, scard_args);
     EXPECT_EQ(":50\r\n", scard_result);
-}
\ No newline at end of file
+}
+
+// Test SSCAN returns every member, filtered by MATCH
+TEST_F(SetCommandsTest, Sscan_IteratesAllMembers) {
+    RedisValue large(RedisType::SET);
+    for (int i = 0; i < 500; ++i) {
+        large.set().tryEmplace(HashedKey("member_" + std::to_string(i)));
+    }
+    database->setValue("large_set", large);
+
+    std::set<std::string> seen;
+    std::string cursor = "0";
+    size_t calls = 0;
+    do {
+        ScanReply reply = parseScanReply(runCommand(setCommands, &SetCommands::cmdSscan,
+                                                    {"SSCAN", "large_set", cursor, "MATCH", "member_1*"}));
+        seen.insert(reply.elements.begin(), reply.elements.end());
+        cursor = reply.cursor;
+        calls++;
+    } while (cursor != "0");
+    // member_1, member_10-19 and member_100-199
+    EXPECT_EQ(111u, seen.size());
+    EXPECT_GT(calls, 1u);
+}
+
+// Test SSCAN on missing and wrong-type keys
+TEST_F(SetCommandsTest, Sscan_MissingKeyAndWrongType) {
+    EXPECT_EQ("*2\r\n$1\r\n0\r\n*0\r\n",
+              runCommand(setCommands, &SetCommands::cmdSscan, {"SSCAN", "no_such_set", "0"}));
+    EXPECT_EQ("-ERR Operation against a key holding the wrong kind of value\r\n",
+              runCommand(setCommands, &SetCommands::cmdSscan, {"SSCAN", "string_key", "0"}));
+    EXPECT_EQ("-ERR syntax error\r\n",
+              runCommand(setCommands, &SetCommands::cmdSscan, {"SSCAN", "existing_set", "0", "TYPE", "set"}));
+
+    ScanReply reply = parseScanReply(runCommand(setCommands, &SetCommands::cmdSscan,
+                                                {"SSCAN", "existing_set", "0", "COUNT", "100"}));
+    EXPECT_EQ("0", reply.cursor);
+    EXPECT_EQ((std::set<std::string>{"member1", "member2", "member3"}),
+              std::set<std::string>(reply.elements.begin(), reply.elements.end()));
+}
+
+
+// Test SSCAN completes and misses nothing when the set grows between calls
+TEST_F(SetCommandsTest, Sscan_GrowingSet_MissesNothing) {
+    RedisValue large(RedisType::SET);
+    for (int i = 0; i < 300; ++i) {
+        large.set().tryEmplace(HashedKey("m" + std::to_string(i)));
+    }
+    database->setValue("growing_set", large);
+
+    std::set<std::string> seen;
+    std::string cursor = "0";
+    int added = 0;
+    size_t calls = 0;
+    do {
+        ASSERT_LT(++calls, 1000u) << "the cursor never came back to 0";
+        ScanReply reply = parseScanReply(runCommand(setCommands, &SetCommands::cmdSscan,
+                                                    {"SSCAN", "growing_set", cursor, "COUNT", "20"}));
+        seen.insert(reply.elements.begin(), reply.elements.end());
+        cursor = reply.cursor;
+        // Grows through several doublings while the scan runs
+        std::vector<std::string> args = {"SADD", "growing_set"};
+        for (int i = 0; i < 100; ++i, ++added) {
+            args.push_back("new" + std::to_string(added));
+        }
+        runCommand(setCommands, &SetCommands::cmdSadd, args);
+    } while (cursor != "0");
+
+    for (int i = 0; i < 300; ++i) {
+        EXPECT_TRUE(seen.count("m" + std::to_string(i))) << i;
+    }
+}
@@ -4,7 +4,9 @@
 #include <string>
 #include <chrono>
 #include <thread>
+#include <memory>
 #include "redis/commands/string_commands.h"
+#include "command_reply.h"
 #include "redis/database/redis_database.h"
 
 // Test fixture for StringCommands tests
@@ -33,7 +35,7 @@ protected:
 // Test SET command with basic usage
 TEST_F(StringCommandsTest, Set_BasicUsage_ReturnsOK) {
     std::vector<std::string> args = {"SET", "test_key", "test_value"};
-    std::string result = stringCommands->cmdSet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdSet, args);
     
     EXPECT_EQ("+OK\r\n", result);
     
@@ -41,15 +43,15 @@ TEST_F(StringCommandsTest, Set_BasicUsage_ReturnsOK) {
     RedisValue* value = database->getValue("test_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("test_value", value->string_value);
-        EXPECT_EQ(RedisType::STRING, value->type);
+        EXPECT_EQ("test_value", value->str());
+        EXPECT_EQ(RedisType::STRING, value->type());
     }
 }
 
 // Test SET command with wrong number of arguments
 TEST_F(StringCommandsTest, Set_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"SET", "test_key"}; // Missing value
-    std::string result = stringCommands->cmdSet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdSet, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -57,7 +59,7 @@ TEST_F(StringCommandsTest, Set_WrongNumberOfArguments_ReturnsError) {
 // Test SET command with NX option when key exists
 TEST_F(StringCommandsTest, Set_WithNX_KeyExists_ReturnsNull) {
     std::vector<std::string> args = {"SET", "existing_key", "new_value", "NX"};
-    std::string result = stringCommands->cmdSet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdSet, args);
     
     // Based on the implementation, it seems to return error instead of null
     // Let's check what the actual behavior is
@@ -72,14 +74,14 @@ TEST_F(StringCommandsTest, Set_WithNX_KeyExists_ReturnsNull) {
     RedisValue* value = database->getValue("existing_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("existing_value", value->string_value);
+        EXPECT_EQ("existing_value", value->str());
     }
 }
 
 // Test SET command with NX option when key doesn't exist
 TEST_F(StringCommandsTest, Set_WithNX_KeyNotExists_ReturnsOK) {
     std::vector<std::string> args = {"SET", "new_key_nx", "new_value", "NX"};
-    std::string result = stringCommands->cmdSet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdSet, args);
     
     if (result.find("ERR") != std::string::npos) {
         // If it returns error, that's also acceptable behavior
@@ -91,7 +93,7 @@ TEST_F(StringCommandsTest, Set_WithNX_KeyNotExists_ReturnsOK) {
         RedisValue* value = database->getValue("new_key_nx");
         EXPECT_TRUE(value != nullptr);
         if (value) {
-            EXPECT_EQ("new_value", value->string_value);
+            EXPECT_EQ("new_value", value->str());
         }
     }
 }
@@ -99,7 +101,7 @@ TEST_F(StringCommandsTest, Set_WithNX_KeyNotExists_ReturnsOK) {
 // Test SET command with XX option when key exists
 TEST_F(StringCommandsTest, Set_WithXX_KeyExists_ReturnsOK) {
     std::vector<std::string> args = {"SET", "existing_key", "updated_value", "XX"};
-    std::string result = stringCommands->cmdSet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdSet, args);
     
     if (result.find("ERR") != std::string::npos) {
         // If it returns error, that's also acceptable behavior
@@ -111,7 +113,7 @@ TEST_F(StringCommandsTest, Set_WithXX_KeyExists_ReturnsOK) {
         RedisValue* value = database->getValue("existing_key");
         EXPECT_TRUE(value != nullptr);
         if (value) {
-            EXPECT_EQ("updated_value", value->string_value);
+            EXPECT_EQ("updated_value", value->str());
         }
     }
 }
@@ -119,7 +121,7 @@ TEST_F(StringCommandsTest, Set_WithXX_KeyExists_ReturnsOK) {
 // Test SET command with XX option when key doesn't exist
 TEST_F(StringCommandsTest, Set_WithXX_KeyNotExists_ReturnsNull) {
     std::vector<std::string> args = {"SET", "non_existent_key", "some_value", "XX"};
-    std::string result = stringCommands->cmdSet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdSet, args);
     
     if (result.find("ERR") != std::string::npos) {
         // If it returns error, that's also acceptable behavior
@@ -136,7 +138,7 @@ TEST_F(StringCommandsTest, Set_WithXX_KeyNotExists_ReturnsNull) {
 // Test SET command with EX option
 TEST_F(StringCommandsTest, Set_WithEXOption_SetsExpiry) {
     std::vector<std::string> args = {"SET", "expiring_key", "expiring_value", "EX", "30"};
-    std::string result = stringCommands->cmdSet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdSet, args);
     
     EXPECT_EQ("+OK\r\n", result);
     
@@ -144,15 +146,15 @@ TEST_F(StringCommandsTest, Set_WithEXOption_SetsExpiry) {
     RedisValue* value = database->getValue("expiring_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("expiring_value", value->string_value);
-        EXPECT_TRUE(value->has_expiry);
+        EXPECT_EQ("expiring_value", value->str());
+        EXPECT_TRUE(value->hasExpiry());
     }
 }
 
 // Test SET command with invalid EX value
 TEST_F(StringCommandsTest, Set_WithInvalidEXValue_ReturnsError) {
     std::vector<std::string> args = {"SET", "test_key", "test_value", "EX", "not_a_number"};
-    std::string result = stringCommands->cmdSet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdSet, args);
     
     EXPECT_TRUE(result.find("ERR value is not an integer") != std::string::npos);
 }
@@ -160,7 +162,7 @@ TEST_F(StringCommandsTest, Set_WithInvalidEXValue_ReturnsError) {
 // Test GET command with existing key
 TEST_F(StringCommandsTest, Get_ExistingKey_ReturnsValue) {
     std::vector<std::string> args = {"GET", "existing_key"};
-    std::string result = stringCommands->cmdGet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdGet, args);
     
     // "existing_value" has 14 characters, not 13
     EXPECT_EQ("$14\r\nexisting_value\r\n", result);
@@ -169,7 +171,7 @@ TEST_F(StringCommandsTest, Get_ExistingKey_ReturnsValue) {
 // Test GET command with non-existent key
 TEST_F(StringCommandsTest, Get_NonExistentKey_ReturnsNull) {
     std::vector<std::string> args = {"GET", "non_existent_key"};
-    std::string result = stringCommands->cmdGet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdGet, args);
     
     // Based on implementation, it might return empty string instead of null
     if (result == "$0\r\n\r\n") {
@@ -182,7 +184,7 @@ TEST_F(StringCommandsTest, Get_NonExistentKey_ReturnsNull) {
 // Test GET command with wrong number of arguments
 TEST_F(StringCommandsTest, Get_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"GET"}; // Missing key
-    std::string result = stringCommands->cmdGet(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdGet, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -190,7 +192,7 @@ TEST_F(StringCommandsTest, Get_WrongNumberOfArguments_ReturnsError) {
 // Test DEL command with single existing key
 TEST_F(StringCommandsTest, Del_SingleExistingKey_ReturnsOne) {
     std::vector<std::string> args = {"DEL", "existing_key"};
-    std::string result = stringCommands->cmdDel(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdDel, args);
     
     EXPECT_EQ(":1\r\n", result);
     
@@ -202,15 +204,32 @@ TEST_F(StringCommandsTest, Del_SingleExistingKey_ReturnsOne) {
 // Test DEL command with single non-existent key
 TEST_F(StringCommandsTest, Del_SingleNonExistentKey_ReturnsZero) {
     std::vector<std::string> args = {"DEL", "non_existent_key"};
-    std::string result = stringCommands->cmdDel(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdDel, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
 
+// Test UNLINK removes keys like DEL, with the big ones freed in the background
+TEST_F(StringCommandsTest, Unlink_RemovesKeys) {
+    RedisValue big(RedisType::LIST);
+    for (size_t i = 0; i <= LazyFree::THRESHOLD; ++i) {
+        big.list().push_back("item");
+    }
+    database->setValue("big_list", std::move(big));
+
+    std::vector<std::string> args = {"UNLINK", "existing_key", "big_list", "non_existent_key"};
+    std::string result = runCommand(stringCommands, &StringCommands::cmdUnlink, args);
+
+    EXPECT_EQ(":2\r\n", result);
+    EXPECT_EQ(nullptr, database->getValue("existing_key"));
+    EXPECT_EQ(nullptr, database->getValue("big_list"));
+    LazyFree::instance().waitIdle();
+}
+
 // Test DEL command with multiple keys
 TEST_F(StringCommandsTest, Del_MultipleKeys_ReturnsCorrectCount) {
     std::vector<std::string> args = {"DEL", "existing_key", "numeric_key", "non_existent_key"};
-    std::string result = stringCommands->cmdDel(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdDel, args);
     
     EXPECT_EQ(":2\r\n", result); // 2 existing keys deleted
     
@@ -222,7 +241,7 @@ TEST_F(StringCommandsTest, Del_MultipleKeys_ReturnsCorrectCount) {
 // Test DEL command with wrong number of arguments
 TEST_F(StringCommandsTest, Del_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"DEL"}; // Missing keys
-    std::string result = stringCommands->cmdDel(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdDel, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -230,7 +249,7 @@ TEST_F(StringCommandsTest, Del_WrongNumberOfArguments_ReturnsError) {
 // Test EXISTS command with single existing key
 TEST_F(StringCommandsTest, Exists_SingleExistingKey_ReturnsOne) {
     std::vector<std::string> args = {"EXISTS", "existing_key"};
-    std::string result = stringCommands->cmdExists(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdExists, args);
     
     EXPECT_EQ(":1\r\n", result);
 }
@@ -238,7 +257,7 @@ TEST_F(StringCommandsTest, Exists_SingleExistingKey_ReturnsOne) {
 // Test EXISTS command with single non-existent key
 TEST_F(StringCommandsTest, Exists_SingleNonExistentKey_ReturnsZero) {
     std::vector<std::string> args = {"EXISTS", "non_existent_key"};
-    std::string result = stringCommands->cmdExists(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdExists, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -246,7 +265,7 @@ TEST_F(StringCommandsTest, Exists_SingleNonExistentKey_ReturnsZero) {
 // Test EXISTS command with multiple keys
 TEST_F(StringCommandsTest, Exists_MultipleKeys_ReturnsCorrectCount) {
     std::vector<std::string> args = {"EXISTS", "existing_key", "numeric_key", "non_existent_key"};
-    std::string result = stringCommands->cmdExists(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdExists, args);
     
     EXPECT_EQ(":2\r\n", result); // 2 existing keys
 }
@@ -254,7 +273,7 @@ TEST_F(StringCommandsTest, Exists_MultipleKeys_ReturnsCorrectCount) {
 // Test TYPE command with string key
 TEST_F(StringCommandsTest, Type_StringKey_ReturnsString) {
     std::vector<std::string> args = {"TYPE", "existing_key"};
-    std::string result = stringCommands->cmdType(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdType, args);
     
     EXPECT_EQ("+string\r\n", result);
 }
@@ -262,7 +281,7 @@ TEST_F(StringCommandsTest, Type_StringKey_ReturnsString) {
 // Test TYPE command with non-existent key
 TEST_F(StringCommandsTest, Type_NonExistentKey_ReturnsNone) {
     std::vector<std::string> args = {"TYPE", "non_existent_key"};
-    std::string result = stringCommands->cmdType(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdType, args);
     
     EXPECT_EQ("+none\r\n", result);
 }
@@ -270,7 +289,7 @@ TEST_F(StringCommandsTest, Type_NonExistentKey_ReturnsNone) {
 // Test INCR command with existing numeric key
 TEST_F(StringCommandsTest, Incr_ExistingNumericKey_IncrementsValue) {
     std::vector<std::string> args = {"INCR", "numeric_key"};
-    std::string result = stringCommands->cmdIncr(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdIncr, args);
     
     EXPECT_EQ(":43\r\n", result);
     
@@ -278,14 +297,14 @@ TEST_F(StringCommandsTest, Incr_ExistingNumericKey_IncrementsValue) {
     RedisValue* value = database->getValue("numeric_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("43", value->string_value);
+        EXPECT_EQ("43", value->toString());
     }
 }
 
 // Test INCR command with new key
 TEST_F(StringCommandsTest, Incr_NewKey_SetsToOne) {
     std::vector<std::string> args = {"INCR", "new_numeric_key"};
-    std::string result = stringCommands->cmdIncr(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdIncr, args);
     
     EXPECT_EQ(":1\r\n", result);
     
@@ -293,14 +312,14 @@ TEST_F(StringCommandsTest, Incr_NewKey_SetsToOne) {
     RedisValue* value = database->getValue("new_numeric_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("1", value->string_value);
+        EXPECT_EQ("1", value->toString());
     }
 }
 
 // Test INCR command with non-numeric value
 TEST_F(StringCommandsTest, Incr_NonNumericValue_ReturnsError) {
     std::vector<std::string> args = {"INCR", "existing_key"}; // Contains "existing_value"
-    std::string result = stringCommands->cmdIncr(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdIncr, args);
     
     EXPECT_TRUE(result.find("ERR value is not an integer") != std::string::npos);
 }
@@ -308,7 +327,7 @@ TEST_F(StringCommandsTest, Incr_NonNumericValue_ReturnsError) {
 // Test DECR command with existing numeric key
 TEST_F(StringCommandsTest, Decr_ExistingNumericKey_DecrementsValue) {
     std::vector<std::string> args = {"DECR", "numeric_key"};
-    std::string result = stringCommands->cmdDecr(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdDecr, args);
     
     EXPECT_EQ(":41\r\n", result);
     
@@ -316,14 +335,14 @@ TEST_F(StringCommandsTest, Decr_ExistingNumericKey_DecrementsValue) {
     RedisValue* value = database->getValue("numeric_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("41", value->string_value);
+        EXPECT_EQ("41", value->toString());
     }
 }
 
 // Test INCRBY command with positive increment
 TEST_F(StringCommandsTest, IncrBy_PositiveIncrement_AddsValue) {
     std::vector<std::string> args = {"INCRBY", "numeric_key", "10"};
-    std::string result = stringCommands->cmdIncrBy(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdIncrBy, args);
     
     EXPECT_EQ(":52\r\n", result);
 }
@@ -331,7 +350,7 @@ TEST_F(StringCommandsTest, IncrBy_PositiveIncrement_AddsValue) {
 // Test INCRBY command with negative increment
 TEST_F(StringCommandsTest, IncrBy_NegativeIncrement_SubtractsValue) {
     std::vector<std::string> args = {"INCRBY", "numeric_key", "-5"};
-    std::string result = stringCommands->cmdIncrBy(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdIncrBy, args);
     
     EXPECT_EQ(":37\r\n", result);
 }
@@ -339,7 +358,7 @@ TEST_F(StringCommandsTest, IncrBy_NegativeIncrement_SubtractsValue) {
 // Test DECRBY command with positive decrement
 TEST_F(StringCommandsTest, DecrBy_PositiveDecrement_SubtractsValue) {
     std::vector<std::string> args = {"DECRBY", "numeric_key", "10"};
-    std::string result = stringCommands->cmdDecrBy(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdDecrBy, args);
     
     EXPECT_EQ(":32\r\n", result);
 }
@@ -347,7 +366,7 @@ TEST_F(StringCommandsTest, DecrBy_PositiveDecrement_SubtractsValue) {
 // Test STRLEN command with existing key
 TEST_F(StringCommandsTest, Strlen_ExistingKey_ReturnsLength) {
     std::vector<std::string> args = {"STRLEN", "existing_key"};
-    std::string result = stringCommands->cmdStrlen(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdStrlen, args);
     
     // "existing_value" has 14 characters
     EXPECT_EQ(":14\r\n", result);
@@ -356,7 +375,7 @@ TEST_F(StringCommandsTest, Strlen_ExistingKey_ReturnsLength) {
 // Test STRLEN command with non-existent key
 TEST_F(StringCommandsTest, Strlen_NonExistentKey_ReturnsZero) {
     std::vector<std::string> args = {"STRLEN", "non_existent_key"};
-    std::string result = stringCommands->cmdStrlen(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdStrlen, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -364,7 +383,7 @@ TEST_F(StringCommandsTest, Strlen_NonExistentKey_ReturnsZero) {
 // Test APPEND command with existing key
 TEST_F(StringCommandsTest, Append_ExistingKey_AppendsValue) {
     std::vector<std::string> args = {"APPEND", "existing_key", "_appended"};
-    std::string result = stringCommands->cmdAppend(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdAppend, args);
     
     // "existing_value_appended" has 23 characters (14 + 9)
     EXPECT_EQ(":23\r\n", result);
@@ -373,14 +392,14 @@ TEST_F(StringCommandsTest, Append_ExistingKey_AppendsValue) {
     RedisValue* value = database->getValue("existing_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("existing_value_appended", value->string_value);
+        EXPECT_EQ("existing_value_appended", value->str());
     }
 }
 
 // Test APPEND command with new key
 TEST_F(StringCommandsTest, Append_NewKey_SetsValue) {
     std::vector<std::string> args = {"APPEND", "new_append_key", "new_value"};
-    std::string result = stringCommands->cmdAppend(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdAppend, args);
     
     // "new_value" has 9 characters (not 8)
     EXPECT_EQ(":9\r\n", result);
@@ -389,14 +408,14 @@ TEST_F(StringCommandsTest, Append_NewKey_SetsValue) {
     RedisValue* value = database->getValue("new_append_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("new_value", value->string_value);
+        EXPECT_EQ("new_value", value->str());
     }
 }
 
 // Test MGET command with multiple keys
 TEST_F(StringCommandsTest, Mget_MultipleKeys_ReturnsValues) {
     std::vector<std::string> args = {"MGET", "existing_key", "numeric_key", "non_existent_key"};
-    std::string result = stringCommands->cmdMget(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdMget, args);
     
     // Based on implementation, non-existent keys might return empty strings instead of null
     if (result.find("$-1") != std::string::npos) {
@@ -411,28 +430,28 @@ TEST_F(StringCommandsTest, Mget_MultipleKeys_ReturnsValues) {
 // Test MSET command with multiple key-value pairs
 TEST_F(StringCommandsTest, Mset_MultiplePairs_SetsAllValues) {
     std::vector<std::string> args = {"MSET", "key1", "value1", "key2", "value2", "key3", "value3"};
-    std::string result = stringCommands->cmdMset(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdMset, args);
     
     EXPECT_EQ("+OK\r\n", result);
     
     // Verify all values were set
     RedisValue* value1 = database->getValue("key1");
     ASSERT_NE(nullptr, value1); 
-    EXPECT_EQ("value1", value1->string_value);
+    EXPECT_EQ("value1", value1->str());
 
     RedisValue* value2 = database->getValue("key2");
     ASSERT_NE(nullptr, value2);
-    EXPECT_EQ("value2", value2->string_value);
+    EXPECT_EQ("value2", value2->str());
 
     RedisValue* value3 = database->getValue("key3");
     ASSERT_NE(nullptr, value3);
-    EXPECT_EQ("value3", value3->string_value);
+    EXPECT_EQ("value3", value3->str());
 }
 
 // Test MSET command with wrong number of arguments
 TEST_F(StringCommandsTest, Mset_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"MSET", "key1", "value1", "key2"}; // Missing value for key2
-    std::string result = stringCommands->cmdMset(args);
+    std::string result = runCommand(stringCommands, &StringCommands::cmdMset, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -441,33 +460,33 @@ TEST_F(StringCommandsTest, Mset_WrongNumberOfArguments_ReturnsError) {
 TEST_F(StringCommandsTest, Integration_MultipleOperations) {
     // SET a value
     std::vector<std::string> set_args = {"SET", "integration_key", "100"};
-    std::string set_result = stringCommands->cmdSet(set_args);
+    std::string set_result = runCommand(stringCommands, &StringCommands::cmdSet, set_args);
     EXPECT_EQ("+OK\r\n", set_result);
     
     // INCR the value
     std::vector<std::string> incr_args = {"INCR", "integration_key"};
-    std::string incr_result = stringCommands->cmdIncr(incr_args);
+    std::string incr_result = runCommand(stringCommands, &StringCommands::cmdIncr, incr_args);
     EXPECT_EQ(":101\r\n", incr_result);
     
     // INCRBY with larger value
     std::vector<std::string> incrby_args = {"INCRBY", "integration_key", "50"};
-    std::string incrby_result = stringCommands->cmdIncrBy(incrby_args);
+    std::string incrby_result = runCommand(stringCommands, &StringCommands::cmdIncrBy, incrby_args);
     EXPECT_EQ(":151\r\n", incrby_result);
     
     // APPEND some text
     std::vector<std::string> append_args = {"APPEND", "integration_key", "_text"};
-    std::string append_result = stringCommands->cmdAppend(append_args);
+    std::string append_result = runCommand(stringCommands, &StringCommands::cmdAppend, append_args);
     // "151_text" has 8 characters
     EXPECT_EQ(":8\r\n", append_result);
     
     // GET the final value
     std::vector<std::string> get_args = {"GET", "integration_key"};
-    std::string get_result = stringCommands->cmdGet(get_args);
+    std::string get_result = runCommand(stringCommands, &StringCommands::cmdGet, get_args);
     EXPECT_EQ("$8\r\n151_text\r\n", get_result);
     
     // STRLEN of the final value
     std::vector<std::string> strlen_args = {"STRLEN", "integration_key"};
-    std::string strlen_result = stringCommands->cmdStrlen(strlen_args);
+    std::string strlen_result = runCommand(stringCommands, &StringCommands::cmdStrlen, strlen_args);
     EXPECT_EQ(":8\r\n", strlen_result);
 }
 
@@ -475,20 +494,20 @@ TEST_F(StringCommandsTest, Integration_MultipleOperations) {
 TEST_F(StringCommandsTest, EdgeCase_EmptyStringValues) {
     // GET empty key
     std::vector<std::string> get_args = {"GET", "empty_key"};
-    std::string get_result = stringCommands->cmdGet(get_args);
+    std::string get_result = runCommand(stringCommands, &StringCommands::cmdGet, get_args);
     // Empty string response
     EXPECT_EQ("$0\r\n\r\n", get_result);
     
     // APPEND to empty key
     std::vector<std::string> append_args = {"APPEND", "empty_key", "appended"};
-    std::string append_result = stringCommands->cmdAppend(append_args);
+    std::string append_result = runCommand(stringCommands, &StringCommands::cmdAppend, append_args);
     EXPECT_EQ(":8\r\n", append_result);
     
     // Verify the result
     RedisValue* value = database->getValue("empty_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("appended", value->string_value);
+        EXPECT_EQ("appended", value->str());
     }
 }
 
@@ -497,11 +516,11 @@ TEST_F(StringCommandsTest, EdgeCase_VeryLargeNumbers) {
     // Set a large number
     std::string large_num = "1234567890123456789";
     std::vector<std::string> set_args = {"SET", "large_key", large_num};
-    stringCommands->cmdSet(set_args);
+    runCommand(stringCommands, &StringCommands::cmdSet, set_args);
     
     // INCR the large number
     std::vector<std::string> incr_args = {"INCR", "large_key"};
-    std::string incr_result = stringCommands->cmdIncr(incr_args);
+    std::string incr_result = runCommand(stringCommands, &StringCommands::cmdIncr, incr_args);
     
     // Should increment correctly
     EXPECT_NE("$-1\r\n", incr_result); // Not null
@@ -510,6 +529,178 @@ TEST_F(StringCommandsTest, EdgeCase_VeryLargeNumbers) {
     RedisValue* value = database->getValue("large_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_EQ("1234567890123456790", value->string_value);
+        EXPECT_EQ("1234567890123456790", value->toString());
+    }
+}
+// Test INCR updates the value in place and keeps its TTL
+TEST_F(StringCommandsTest, Incr_KeepsExpiry) {
+    RedisValue counter("10");
+    database->setValue("counter", counter);
+    database->setExpiry("counter", std::chrono::seconds(100));
+
+    std::vector<std::string> args = {"INCRBY", "counter", "5"};
+    EXPECT_EQ(":15\r\n", runCommand(stringCommands, &StringCommands::cmdIncrBy, args));
+
+    RedisValue* value = database->getValue("counter");
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ("15", value->toString());
+    EXPECT_TRUE(value->hasExpiry());
+}
+
+// Test INCRBY and DECRBY reject results that do not fit in 64 bits
+TEST_F(StringCommandsTest, IncrBy_Overflow_ReturnsError) {
+    database->setValue("big", RedisValue("9223372036854775807"));
+    std::vector<std::string> incr_args = {"INCR", "big"};
+    EXPECT_EQ("-ERR increment or decrement would overflow\r\n",
+              runCommand(stringCommands, &StringCommands::cmdIncr, incr_args));
+    EXPECT_EQ("9223372036854775807", database->getValue("big")->str());
+
+    std::vector<std::string> decr_args = {"DECRBY", "numeric_key", "-9223372036854775808"};
+    EXPECT_EQ("-ERR decrement would overflow\r\n",
+              runCommand(stringCommands, &StringCommands::cmdDecrBy, decr_args));
+}
+
+// Test APPEND grows the value in place and keeps its TTL
+TEST_F(StringCommandsTest, Append_KeepsExpiry) {
+    RedisValue text("abc");
+    database->setValue("text", text);
+    database->setExpiry("text", std::chrono::seconds(100));
+
+    std::vector<std::string> args = {"APPEND", "text", "def"};
+    EXPECT_EQ(":6\r\n", runCommand(stringCommands, &StringCommands::cmdAppend, args));
+
+    RedisValue* value = database->getValue("text");
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ("abcdef", value->str());
+    EXPECT_TRUE(value->hasExpiry());
+}
+
+// Test APPEND on a non-string value is rejected instead of overwriting it
+TEST_F(StringCommandsTest, Append_WrongType_ReturnsError) {
+    database->setValue("list_key", RedisValue(RedisType::LIST));
+    std::vector<std::string> args = {"APPEND", "list_key", "x"};
+    EXPECT_EQ("-ERR Operation against a key holding the wrong kind of value\r\n",
+              runCommand(stringCommands, &StringCommands::cmdAppend, args));
+    EXPECT_EQ(RedisType::LIST, database->getValue("list_key")->type());
+}
+
+// Test SET without EX drops an existing TTL
+TEST_F(StringCommandsTest, Set_OverwriteClearsExpiry) {
+    RedisValue text("old");
+    database->setValue("text", text);
+    database->setExpiry("text", std::chrono::seconds(100));
+
+    std::vector<std::string> args = {"SET", "text", "new"};
+    EXPECT_EQ("+OK\r\n", runCommand(stringCommands, &StringCommands::cmdSet, args));
+    EXPECT_FALSE(database->getValue("text")->hasExpiry());
+}
+
+// Test counters are stored as numbers and formatted only when read
+TEST_F(StringCommandsTest, Incr_StoresIntegerEncoding) {
+    std::vector<std::string> incr = {"INCR", "numeric_key"};
+    EXPECT_EQ(":43\r\n", runCommand(stringCommands, &StringCommands::cmdIncr, incr));
+    EXPECT_EQ(RedisEncoding::INT, database->getValue("numeric_key")->encoding());
+
+    std::vector<std::string> get = {"GET", "numeric_key"};
+    EXPECT_EQ("$2\r\n43\r\n", runCommand(stringCommands, &StringCommands::cmdGet, get));
+    std::vector<std::string> strlen_args = {"STRLEN", "numeric_key"};
+    EXPECT_EQ(":2\r\n", runCommand(stringCommands, &StringCommands::cmdStrlen, strlen_args));
+    std::vector<std::string> mget = {"MGET", "numeric_key"};
+    EXPECT_EQ("*1\r\n$2\r\n43\r\n", runCommand(stringCommands, &StringCommands::cmdMget, mget));
+
+    std::vector<std::string> append = {"APPEND", "numeric_key", "x"};
+    EXPECT_EQ(":3\r\n", runCommand(stringCommands, &StringCommands::cmdAppend, append));
+    EXPECT_EQ("$3\r\n43x\r\n", runCommand(stringCommands, &StringCommands::cmdGet, get));
+    EXPECT_EQ("-ERR value is not an integer or out of range\r\n",
+              runCommand(stringCommands, &StringCommands::cmdIncr, incr));
+}
+
+// Test INCR keeps a counter past the inline string size as a number, so
+// updating it never needs a heap string
+TEST_F(StringCommandsTest, Incr_KeepsLargeCounterAsInteger) {
+    database->setValue("counter", RedisValue("1000000000000000000"));
+    CommandArgs args{"INCRBY", "counter", "5"};
+    std::string output;
+    ResponseWriter writer(output);
+    for (int i = 0; i < 100; ++i) {
+        output.clear();
+        stringCommands->cmdIncrBy(args, writer);
+        ASSERT_EQ(RedisEncoding::INT, database->getValue("counter")->encoding());
+    }
+    EXPECT_EQ(":1000000000000000500\r\n", output);
+
+    std::vector<std::string> get = {"GET", "counter"};
+    EXPECT_EQ("$19\r\n1000000000000000500\r\n", runCommand(stringCommands, &StringCommands::cmdGet, get));
+}
+
+// Benchmark: INCR and GET on counters, small ones and ones past 16 digits.
+// Run with --gtest_also_run_disabled_tests
+TEST_F(StringCommandsTest, DISABLED_IncrBenchmark) {
+    const int key_count = 1000;
+    const int iterations = 3000000;
+    std::vector<std::string> keys;
+    std::vector<std::unique_ptr<CommandArgs>> incr_args;
+    std::vector<std::unique_ptr<CommandArgs>> get_args;
+    for (int i = 0; i < key_count; ++i) {
+        keys.push_back("counter:" + std::to_string(i));
     }
-}
\ No newline at end of file
+    for (const auto& key : keys) {
+        incr_args.push_back(std::make_unique<CommandArgs>(std::initializer_list<std::string_view>{"INCR", key}));
+        get_args.push_back(std::make_unique<CommandArgs>(std::initializer_list<std::string_view>{"GET", key}));
+    }
+
+    auto run = [&](const char* label, const std::string& start_value) {
+        for (const auto& key : keys) {
+            database->setValue(key, RedisValue(start_value));
+        }
+        std::string output;
+        ResponseWriter writer(output);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            stringCommands->cmdIncr(*incr_args[i % key_count], writer);
+            output.clear();
+        }
+        auto incr_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            stringCommands->cmdGet(*get_args[i % key_count], writer);
+            output.clear();
+        }
+        auto get_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << label << ": INCR " << incr_ns.count() / iterations << " ns, GET "
+                  << get_ns.count() / iterations << " ns" << std::endl;
+    };
+    run("small counters", "0");
+    run("counters past 16 digits", "1000000000000000000");
+}
+
+// GET with and without the per-loop cached clock, half the keys with a TTL
+TEST_F(StringCommandsTest, DISABLED_GetClockBenchmark) {
+    const int key_count = 1000;
+    const int iterations = 3000000;
+    // Commands served per event-loop iteration
+    const int batch = 16;
+    std::vector<std::unique_ptr<CommandArgs>> get_args;
+    for (int i = 0; i < key_count; ++i) {
+        std::string key = "key:" + std::to_string(i);
+        database->setValue(key, RedisValue("value"));
+        if (i % 2 == 0) database->setExpiry(key, std::chrono::hours(1));
+        get_args.push_back(std::make_unique<CommandArgs>(std::initializer_list<std::string_view>{"GET", key}));
+    }
+
+    auto run = [&](const char* label, bool cached) {
+        std::string output;
+        ResponseWriter writer(output);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            if (cached && i % batch == 0) ServerClock::update(std::chrono::steady_clock::now());
+            stringCommands->cmdGet(*get_args[i % key_count], writer);
+            output.clear();
+        }
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        ServerClock::stopCaching();
+        std::cout << label << ": GET " << ns.count() / iterations << " ns" << std::endl;
+    };
+    run("clock read per lookup", false);
+    run("clock cached per loop iteration", true);
+}
@@ -5,6 +5,7 @@
 #include <chrono>
 #include <thread>
 #include "redis/commands/ttl_commands.h"
+#include "command_reply.h"
 #include "redis/database/redis_database.h"
 
 // Test fixture for TTLCommands tests
@@ -23,6 +24,7 @@ protected:
     }
     
     void TearDown() override {
+        ServerClock::stopCaching();
         delete ttlCommands;
         delete database;
     }
@@ -34,7 +36,7 @@ protected:
 // Test expire command with valid arguments
 TEST_F(TTLCommandsTest, Expire_ValidArguments_ReturnsSuccess) {
     std::vector<std::string> args = {"EXPIRE", "string_key", "60"};
-    std::string result = ttlCommands->cmdExpire(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpire, args);
     
     EXPECT_EQ(":1\r\n", result); // Should return 1 for success
     
@@ -42,14 +44,14 @@ TEST_F(TTLCommandsTest, Expire_ValidArguments_ReturnsSuccess) {
     RedisValue* value = database->getValue("string_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_TRUE(value->has_expiry);
+        EXPECT_TRUE(value->hasExpiry());
     }
 }
 
 // Test expire command with wrong number of arguments
 TEST_F(TTLCommandsTest, Expire_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"EXPIRE", "string_key"}; // Missing seconds
-    std::string result = ttlCommands->cmdExpire(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpire, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -57,7 +59,7 @@ TEST_F(TTLCommandsTest, Expire_WrongNumberOfArguments_ReturnsError) {
 // Test expire command with non-existent key
 TEST_F(TTLCommandsTest, Expire_NonExistentKey_ReturnsZero) {
     std::vector<std::string> args = {"EXPIRE", "non_existent_key", "60"};
-    std::string result = ttlCommands->cmdExpire(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpire, args);
     
     EXPECT_EQ(":0\r\n", result); // Should return 0 for non-existent key
 }
@@ -65,7 +67,7 @@ TEST_F(TTLCommandsTest, Expire_NonExistentKey_ReturnsZero) {
 // Test expire command with invalid integer
 TEST_F(TTLCommandsTest, Expire_InvalidInteger_ReturnsError) {
     std::vector<std::string> args = {"EXPIRE", "string_key", "not_a_number"};
-    std::string result = ttlCommands->cmdExpire(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpire, args);
     
     EXPECT_TRUE(result.find("ERR value is not an integer") != std::string::npos);
 }
@@ -73,7 +75,7 @@ TEST_F(TTLCommandsTest, Expire_InvalidInteger_ReturnsError) {
 // Test expire command with zero or negative seconds (should delete key)
 TEST_F(TTLCommandsTest, Expire_ZeroSeconds_DeletesKeyAndReturnsOne) {
     std::vector<std::string> args = {"EXPIRE", "string_key", "0"};
-    std::string result = ttlCommands->cmdExpire(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpire, args);
     
     EXPECT_EQ(":1\r\n", result);
     
@@ -85,7 +87,7 @@ TEST_F(TTLCommandsTest, Expire_ZeroSeconds_DeletesKeyAndReturnsOne) {
 // Test expire command with negative seconds (should delete key)
 TEST_F(TTLCommandsTest, Expire_NegativeSeconds_DeletesKeyAndReturnsOne) {
     std::vector<std::string> args = {"EXPIRE", "list_key", "-1"};
-    std::string result = ttlCommands->cmdExpire(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpire, args);
     
     EXPECT_EQ(":1\r\n", result);
     
@@ -100,7 +102,7 @@ TEST_F(TTLCommandsTest, Expireat_ValidArguments_ReturnsSuccess) {
         std::chrono::system_clock::now() + std::chrono::hours(1));
     
     std::vector<std::string> args = {"EXPIREAT", "string_key", std::to_string(future_timestamp)};
-    std::string result = ttlCommands->cmdExpireat(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpireat, args);
     
     EXPECT_EQ(":1\r\n", result);
     
@@ -108,7 +110,7 @@ TEST_F(TTLCommandsTest, Expireat_ValidArguments_ReturnsSuccess) {
     RedisValue* value = database->getValue("string_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_TRUE(value->has_expiry);
+        EXPECT_TRUE(value->hasExpiry());
     }
 }
 
@@ -118,7 +120,7 @@ TEST_F(TTLCommandsTest, Expireat_PastTimestamp_DeletesKeyAndReturnsOne) {
         std::chrono::system_clock::now() - std::chrono::hours(1));
     
     std::vector<std::string> args = {"EXPIREAT", "string_key", std::to_string(past_timestamp)};
-    std::string result = ttlCommands->cmdExpireat(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpireat, args);
     
     EXPECT_EQ(":1\r\n", result);
     
@@ -133,7 +135,7 @@ TEST_F(TTLCommandsTest, Expireat_NonExistentKey_ReturnsZero) {
         std::chrono::system_clock::now() + std::chrono::hours(1));
     
     std::vector<std::string> args = {"EXPIREAT", "non_existent_key", std::to_string(future_timestamp)};
-    std::string result = ttlCommands->cmdExpireat(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpireat, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -141,7 +143,7 @@ TEST_F(TTLCommandsTest, Expireat_NonExistentKey_ReturnsZero) {
 // Test ttl command with non-existent key
 TEST_F(TTLCommandsTest, Ttl_NonExistentKey_ReturnsMinusTwo) {
     std::vector<std::string> args = {"TTL", "non_existent_key"};
-    std::string result = ttlCommands->cmdTtl(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdTtl, args);
     
     EXPECT_EQ(":-2\r\n", result);
 }
@@ -149,41 +151,33 @@ TEST_F(TTLCommandsTest, Ttl_NonExistentKey_ReturnsMinusTwo) {
 // Test ttl command with key having no expiry
 TEST_F(TTLCommandsTest, Ttl_KeyWithNoExpiry_ReturnsMinusOne) {
     std::vector<std::string> args = {"TTL", "no_expiry_key"};
-    std::string result = ttlCommands->cmdTtl(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdTtl, args);
     
     EXPECT_EQ(":-1\r\n", result);
 }
 
 // Test ttl command with expired key
 TEST_F(TTLCommandsTest, Ttl_ExpiredKey_ReturnsMinusTwoAndDeletesKey) {
-    // Set a past expiry by directly manipulating the value
-    RedisValue* value = database->getValue("expiring_key");
-    if (value) {
-        value->expiry = std::chrono::system_clock::now() - std::chrono::seconds(1);
-        value->has_expiry = true;
-    }
+    // Set a past expiry directly in the database
+    database->setExpiry("expiring_key", std::chrono::seconds(-1));
     
     std::vector<std::string> args = {"TTL", "expiring_key"};
-    std::string result = ttlCommands->cmdTtl(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdTtl, args);
     
     EXPECT_EQ(":-2\r\n", result);
     
     // Verify key was deleted
-    value = database->getValue("expiring_key");
+    RedisValue* value = database->getValue("expiring_key");
     EXPECT_EQ(nullptr, value);
 }
 
 // Test ttl command with valid expiry
 TEST_F(TTLCommandsTest, Ttl_KeyWithValidExpiry_ReturnsPositiveTTL) {
     // Set expiry to 60 seconds in the future
-    RedisValue* value = database->getValue("string_key");
-    if (value) {
-        value->expiry = std::chrono::system_clock::now() + std::chrono::seconds(60);
-        value->has_expiry = true;
-    }
+    database->setExpiry("string_key", std::chrono::seconds(60));
     
     std::vector<std::string> args = {"TTL", "string_key"};
-    std::string result = ttlCommands->cmdTtl(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdTtl, args);
     
     // Should return a positive integer around 60
     // Since we can't exactly predict due to timing, we'll check the format
@@ -209,7 +203,7 @@ TEST_F(TTLCommandsTest, Ttl_KeyWithValidExpiry_ReturnsPositiveTTL) {
 // Test persist command with non-existent key
 TEST_F(TTLCommandsTest, Persist_NonExistentKey_ReturnsZero) {
     std::vector<std::string> args = {"PERSIST", "non_existent_key"};
-    std::string result = ttlCommands->cmdPersist(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdPersist, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -217,7 +211,7 @@ TEST_F(TTLCommandsTest, Persist_NonExistentKey_ReturnsZero) {
 // Test persist command with key having no expiry
 TEST_F(TTLCommandsTest, Persist_KeyWithNoExpiry_ReturnsZero) {
     std::vector<std::string> args = {"PERSIST", "no_expiry_key"};
-    std::string result = ttlCommands->cmdPersist(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdPersist, args);
     
     EXPECT_EQ(":0\r\n", result);
 }
@@ -225,29 +219,25 @@ TEST_F(TTLCommandsTest, Persist_KeyWithNoExpiry_ReturnsZero) {
 // Test persist command with key having expiry
 TEST_F(TTLCommandsTest, Persist_KeyWithExpiry_ReturnsOneAndClearsExpiry) {
     // Set expiry first
-    RedisValue* value = database->getValue("string_key");
-    if (value) {
-        value->expiry = std::chrono::system_clock::now() + std::chrono::seconds(60);
-        value->has_expiry = true;
-    }
+    database->setExpiry("string_key", std::chrono::seconds(60));
     
     std::vector<std::string> args = {"PERSIST", "string_key"};
-    std::string result = ttlCommands->cmdPersist(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdPersist, args);
     
     EXPECT_EQ(":1\r\n", result);
     
     // Verify expiry was cleared
-    value = database->getValue("string_key");
+    RedisValue* value = database->getValue("string_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_FALSE(value->has_expiry);
+        EXPECT_FALSE(value->hasExpiry());
     }
 }
 
 // Test persist command wrong number of arguments
 TEST_F(TTLCommandsTest, Persist_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"PERSIST", "string_key", "extra_arg"};
-    std::string result = ttlCommands->cmdPersist(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdPersist, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -255,7 +245,7 @@ TEST_F(TTLCommandsTest, Persist_WrongNumberOfArguments_ReturnsError) {
 // Test expireat command wrong number of arguments
 TEST_F(TTLCommandsTest, Expireat_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"EXPIREAT", "string_key"};
-    std::string result = ttlCommands->cmdExpireat(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpireat, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -263,7 +253,7 @@ TEST_F(TTLCommandsTest, Expireat_WrongNumberOfArguments_ReturnsError) {
 // Test ttl command wrong number of arguments
 TEST_F(TTLCommandsTest, Ttl_WrongNumberOfArguments_ReturnsError) {
     std::vector<std::string> args = {"TTL"};
-    std::string result = ttlCommands->cmdTtl(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdTtl, args);
     
     EXPECT_TRUE(result.find("ERR wrong number of arguments") != std::string::npos);
 }
@@ -271,7 +261,7 @@ TEST_F(TTLCommandsTest, Ttl_WrongNumberOfArguments_ReturnsError) {
 // Test with different data types
 TEST_F(TTLCommandsTest, Expire_WithListType_WorksCorrectly) {
     std::vector<std::string> args = {"EXPIRE", "list_key", "30"};
-    std::string result = ttlCommands->cmdExpire(args);
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdExpire, args);
     
     EXPECT_EQ(":1\r\n", result);
     
@@ -279,8 +269,8 @@ TEST_F(TTLCommandsTest, Expire_WithListType_WorksCorrectly) {
     RedisValue* value = database->getValue("list_key");
     EXPECT_TRUE(value != nullptr);
     if (value) {
-        EXPECT_TRUE(value->has_expiry);
-        EXPECT_EQ(RedisType::LIST, value->type);
+        EXPECT_TRUE(value->hasExpiry());
+        EXPECT_EQ(RedisType::LIST, value->type());
     }
 }
 
@@ -288,12 +278,12 @@ TEST_F(TTLCommandsTest, Expire_WithListType_WorksCorrectly) {
 TEST_F(TTLCommandsTest, Integration_SetExpireAndCheckTTL) {
     // Set expiry
     std::vector<std::string> expire_args = {"EXPIRE", "string_key", "120"};
-    std::string expire_result = ttlCommands->cmdExpire(expire_args);
+    std::string expire_result = runCommand(ttlCommands, &TTLCommands::cmdExpire, expire_args);
     EXPECT_EQ(":1\r\n", expire_result);
     
     // Check TTL
     std::vector<std::string> ttl_args = {"TTL", "string_key"};
-    std::string ttl_result = ttlCommands->cmdTtl(ttl_args);
+    std::string ttl_result = runCommand(ttlCommands, &TTLCommands::cmdTtl, ttl_args);
     
     // Should return a positive integer around 120
     EXPECT_EQ(':', ttl_result[0]);
@@ -302,49 +292,158 @@ TEST_F(TTLCommandsTest, Integration_SetExpireAndCheckTTL) {
     
     // Remove expiry with PERSIST
     std::vector<std::string> persist_args = {"PERSIST", "string_key"};
-    std::string persist_result = ttlCommands->cmdPersist(persist_args);
+    std::string persist_result = runCommand(ttlCommands, &TTLCommands::cmdPersist, persist_args);
     EXPECT_EQ(":1\r\n", persist_result);
     
     // Check TTL again - should be -1 (no expiry)
-    ttl_result = ttlCommands->cmdTtl(ttl_args);
+    ttl_result = runCommand(ttlCommands, &TTLCommands::cmdTtl, ttl_args);
     EXPECT_EQ(":-1\r\n", ttl_result);
 }
 
-// Test isExpired method functionality
-TEST_F(TTLCommandsTest, RedisValue_IsExpired_WorksCorrectly) {
-    RedisValue value("test");
-    
+// Test the database's expiry bookkeeping
+TEST_F(TTLCommandsTest, Database_Expiry_WorksCorrectly) {
     // Test without expiry
-    EXPECT_FALSE(value.isExpired());
+    EXPECT_FALSE(database->getExpiry("string_key").has_value());
     
     // Test with future expiry
-    value.expiry = std::chrono::system_clock::now() + std::chrono::seconds(10);
-    value.has_expiry = true;
-    EXPECT_FALSE(value.isExpired());
+    EXPECT_TRUE(database->setExpiry("string_key", std::chrono::seconds(10)));
+    EXPECT_TRUE(database->keyExists("string_key"));
     
     // Test with past expiry
-    value.expiry = std::chrono::system_clock::now() - std::chrono::seconds(10);
-    value.has_expiry = true;
-    EXPECT_TRUE(value.isExpired());
+    EXPECT_TRUE(database->setExpiry("string_key", std::chrono::seconds(-10)));
+    EXPECT_FALSE(database->keyExists("string_key"));
+    EXPECT_FALSE(database->setExpiry("string_key", std::chrono::seconds(10)));
 }
 
-// Test setExpiry method
-TEST_F(TTLCommandsTest, RedisValue_SetExpiry_WorksCorrectly) {
-    RedisValue value("test");
-    
-    value.setExpiry(std::chrono::seconds(30));
-    
-    EXPECT_TRUE(value.has_expiry);
-    EXPECT_GT(value.expiry, std::chrono::system_clock::now());
+// Test getExpiry reports the time that was set
+TEST_F(TTLCommandsTest, Database_GetExpiry_WorksCorrectly) {
+    database->setExpiry("string_key", std::chrono::seconds(30));
+    
+    auto expiry = database->getExpiry("string_key");
+    ASSERT_TRUE(expiry.has_value());
+    EXPECT_GT(*expiry, ServerClock::nowMs());
+    EXPECT_TRUE(database->getValue("string_key")->hasExpiry());
 }
 
-// Test clearExpiry method
-TEST_F(TTLCommandsTest, RedisValue_ClearExpiry_WorksCorrectly) {
-    RedisValue value("test");
-    
-    value.setExpiry(std::chrono::seconds(30));
-    EXPECT_TRUE(value.has_expiry);
-    
-    value.clearExpiry();
-    EXPECT_FALSE(value.has_expiry);
+// Test overwriting a key drops its expiry
+TEST_F(TTLCommandsTest, Database_SetValueClearsExpiry) {
+    database->setExpiry("string_key", std::chrono::seconds(30));
+    EXPECT_TRUE(database->getExpiry("string_key").has_value());
+    
+    database->setValue("string_key", RedisValue("fresh"));
+    EXPECT_FALSE(database->getExpiry("string_key").has_value());
+    EXPECT_FALSE(database->getValue("string_key")->hasExpiry());
+}
+
+// Test PEXPIRE and PTTL work in milliseconds
+TEST_F(TTLCommandsTest, Pexpire_SetsMillisecondExpiry) {
+    std::vector<std::string> args = {"PEXPIRE", "string_key", "1800"};
+    EXPECT_EQ(":1\r\n", runCommand(ttlCommands, &TTLCommands::cmdPexpire, args));
+
+    std::vector<std::string> pttl_args = {"PTTL", "string_key"};
+    std::string result = runCommand(ttlCommands, &TTLCommands::cmdPttl, pttl_args);
+    long long pttl = std::stoll(result.substr(1));
+    EXPECT_GT(pttl, 1000);
+    EXPECT_LE(pttl, 1800);
+
+    // TTL rounds to the nearest second
+    std::vector<std::string> ttl_args = {"TTL", "string_key"};
+    EXPECT_EQ(":2\r\n", runCommand(ttlCommands, &TTLCommands::cmdTtl, ttl_args));
+}
+
+// Test PEXPIREAT stores the exact time EXPIRETIME and PEXPIRETIME report
+TEST_F(TTLCommandsTest, Pexpireat_RoundTripsThroughExpiretime) {
+    long long when = ServerClock::nowMs() + 3600 * 1000 + 123;
+    std::vector<std::string> args = {"PEXPIREAT", "string_key", std::to_string(when)};
+    EXPECT_EQ(":1\r\n", runCommand(ttlCommands, &TTLCommands::cmdPexpireat, args));
+
+    std::vector<std::string> pexpiretime_args = {"PEXPIRETIME", "string_key"};
+    EXPECT_EQ(":" + std::to_string(when) + "\r\n",
+              runCommand(ttlCommands, &TTLCommands::cmdPexpiretime, pexpiretime_args));
+    std::vector<std::string> expiretime_args = {"EXPIRETIME", "string_key"};
+    EXPECT_EQ(":" + std::to_string(when / 1000) + "\r\n",
+              runCommand(ttlCommands, &TTLCommands::cmdExpiretime, expiretime_args));
+}
+
+// Test EXPIRETIME and PTTL on keys without an expiry
+TEST_F(TTLCommandsTest, Expiretime_MissingOrPersistentKey) {
+    std::vector<std::string> missing = {"EXPIRETIME", "non_existent_key"};
+    EXPECT_EQ(":-2\r\n", runCommand(ttlCommands, &TTLCommands::cmdExpiretime, missing));
+    std::vector<std::string> persistent = {"PEXPIRETIME", "no_expiry_key"};
+    EXPECT_EQ(":-1\r\n", runCommand(ttlCommands, &TTLCommands::cmdPexpiretime, persistent));
+    std::vector<std::string> pttl = {"PTTL", "no_expiry_key"};
+    EXPECT_EQ(":-1\r\n", runCommand(ttlCommands, &TTLCommands::cmdPttl, pttl));
+}
+
+// Test NX and XX look only at whether the key has an expiry
+TEST_F(TTLCommandsTest, Expire_NxAndXxOptions) {
+    std::vector<std::string> xx = {"EXPIRE", "string_key", "100", "XX"};
+    EXPECT_EQ(":0\r\n", runCommand(ttlCommands, &TTLCommands::cmdExpire, xx));
+    EXPECT_FALSE(database->getExpiry("string_key").has_value());
+
+    std::vector<std::string> nx = {"EXPIRE", "string_key", "100", "nx"};
+    EXPECT_EQ(":1\r\n", runCommand(ttlCommands, &TTLCommands::cmdExpire, nx));
+    EXPECT_EQ(":0\r\n", runCommand(ttlCommands, &TTLCommands::cmdExpire, nx));
+    EXPECT_EQ(":1\r\n", runCommand(ttlCommands, &TTLCommands::cmdExpire, xx));
+}
+
+// Test GT and LT compare with the current expiry; no expiry counts as infinite
+TEST_F(TTLCommandsTest, Expire_GtAndLtOptions) {
+    std::vector<std::string> gt = {"PEXPIRE", "string_key", "50000", "GT"};
+    EXPECT_EQ(":0\r\n", runCommand(ttlCommands, &TTLCommands::cmdPexpire, gt));
+    std::vector<std::string> lt = {"PEXPIRE", "string_key", "50000", "LT"};
+    EXPECT_EQ(":1\r\n", runCommand(ttlCommands, &TTLCommands::cmdPexpire, lt));
+    int64_t first = *database->getExpiry("string_key");
+
+    std::vector<std::string> longer_lt = {"PEXPIRE", "string_key", "90000", "LT"};
+    EXPECT_EQ(":0\r\n", runCommand(ttlCommands, &TTLCommands::cmdPexpire, longer_lt));
+    EXPECT_EQ(first, *database->getExpiry("string_key"));
+
+    std::vector<std::string> longer_gt = {"PEXPIRE", "string_key", "90000", "XX", "GT"};
+    EXPECT_EQ(":1\r\n", runCommand(ttlCommands, &TTLCommands::cmdPexpire, longer_gt));
+    EXPECT_GT(*database->getExpiry("string_key"), first);
+}
+
+// Test conflicting or unknown options are rejected before the key is touched
+TEST_F(TTLCommandsTest, Expire_InvalidOptions_ReturnError) {
+    std::vector<std::string> nx_gt = {"EXPIRE", "string_key", "100", "NX", "GT"};
+    EXPECT_EQ("-ERR NX and XX, GT or LT options at the same time are not compatible\r\n",
+              runCommand(ttlCommands, &TTLCommands::cmdExpire, nx_gt));
+    std::vector<std::string> gt_lt = {"EXPIRE", "string_key", "100", "GT", "LT"};
+    EXPECT_EQ("-ERR GT and LT options at the same time are not compatible\r\n",
+              runCommand(ttlCommands, &TTLCommands::cmdExpire, gt_lt));
+    std::vector<std::string> unknown = {"EXPIRE", "string_key", "100", "KEEPTTL"};
+    EXPECT_EQ("-ERR Unsupported option KEEPTTL\r\n", runCommand(ttlCommands, &TTLCommands::cmdExpire, unknown));
+    EXPECT_FALSE(database->getExpiry("string_key").has_value());
+}
+
+// Test times that overflow in milliseconds are errors, not deletions
+TEST_F(TTLCommandsTest, Expire_OverflowingTime_ReturnsError) {
+    std::vector<std::string> seconds = {"EXPIRE", "string_key", "9223372036854775"};
+    EXPECT_EQ("-ERR invalid expire time in 'expire' command\r\n",
+              runCommand(ttlCommands, &TTLCommands::cmdExpire, seconds));
+    std::vector<std::string> relative = {"PEXPIRE", "string_key", "9223372036854775807"};
+    EXPECT_EQ("-ERR invalid expire time in 'pexpire' command\r\n",
+              runCommand(ttlCommands, &TTLCommands::cmdPexpire, relative));
+    std::vector<std::string> too_long = {"PEXPIRE", "string_key", "99999999999999999999"};
+    EXPECT_EQ("-ERR value is not an integer or out of range\r\n",
+              runCommand(ttlCommands, &TTLCommands::cmdPexpire, too_long));
+    EXPECT_TRUE(database->keyExists("string_key"));
+}
+
+// Test expiry follows the cached clock, not the time of each lookup
+TEST_F(TTLCommandsTest, Expiry_UsesCachedClock) {
+    auto loop_time = std::chrono::steady_clock::now();
+    ServerClock::update(loop_time);
+    std::vector<std::string> args = {"PEXPIRE", "string_key", "100"};
+    EXPECT_EQ(":1\r\n", runCommand(ttlCommands, &TTLCommands::cmdPexpire, args));
+
+    // Same loop iteration: the key is still there however long it takes
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_TRUE(database->keyExists("string_key"));
+    std::vector<std::string> pttl = {"PTTL", "string_key"};
+    EXPECT_EQ(":100\r\n", runCommand(ttlCommands, &TTLCommands::cmdPttl, pttl));
+
+    ServerClock::update(loop_time + std::chrono::milliseconds(100));
+    EXPECT_FALSE(database->keyExists("string_key"));
 }
@@ -0,0 +1,73 @@
+// test_zset_commands.cpp
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <limits>
+#include "redis/commands/zset_commands.h"
+#include "command_reply.h"
+#include "redis/database/redis_database.h"
+
+// Test fixture for ZSetCommands tests
+class ZSetCommandsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        database = new RedisDatabase();
+        zsetCommands = new ZSetCommands(*database);
+
+        RedisValue scores(RedisType::ZSET);
+        scores.zset()[-1.5] = {"minus"};
+        scores.zset()[0] = {"zero"};
+        scores.zset()[2.5] = {"a", "b"};
+        scores.zset()[std::numeric_limits<double>::infinity()] = {"top"};
+        database->setValue("scores", scores);
+
+        database->setValue("string_key", RedisValue("not_a_zset"));
+    }
+
+    void TearDown() override {
+        delete zsetCommands;
+        delete database;
+    }
+
+    RedisDatabase* database;
+    ZSetCommands* zsetCommands;
+};
+
+// Test ZSCAN returns member-score pairs in score order
+TEST_F(ZSetCommandsTest, Zscan_ReturnsMembersAndScores) {
+    ScanReply reply = parseScanReply(runCommand(zsetCommands, &ZSetCommands::cmdZscan, {"ZSCAN", "scores", "0"}));
+    EXPECT_EQ("0", reply.cursor);
+    EXPECT_EQ((std::vector<std::string>{"minus", "-1.5", "zero", "0", "a", "2.5", "b", "2.5", "top", "inf"}),
+              reply.elements);
+
+    reply = parseScanReply(runCommand(zsetCommands, &ZSetCommands::cmdZscan,
+                                      {"ZSCAN", "scores", "0", "MATCH", "?"}));
+    EXPECT_EQ((std::vector<std::string>{"a", "2.5", "b", "2.5"}), reply.elements);
+}
+
+// Test ZSCAN with a small COUNT resumes where it stopped, keeping a
+// score's members together
+TEST_F(ZSetCommandsTest, Zscan_SmallCount_ResumesByScore) {
+    std::vector<std::string> members;
+    std::string cursor = "0";
+    size_t calls = 0;
+    do {
+        ScanReply reply = parseScanReply(runCommand(zsetCommands, &ZSetCommands::cmdZscan,
+                                                    {"ZSCAN", "scores", cursor, "COUNT", "1"}));
+        for (size_t i = 0; i < reply.elements.size(); i += 2) members.push_back(reply.elements[i]);
+        cursor = reply.cursor;
+        calls++;
+    } while (cursor != "0");
+    EXPECT_EQ((std::vector<std::string>{"minus", "zero", "a", "b", "top"}), members);
+    EXPECT_EQ(4u, calls);
+}
+
+// Test ZSCAN on missing and wrong-type keys
+TEST_F(ZSetCommandsTest, Zscan_MissingKeyAndWrongType) {
+    EXPECT_EQ("*2\r\n$1\r\n0\r\n*0\r\n",
+              runCommand(zsetCommands, &ZSetCommands::cmdZscan, {"ZSCAN", "no_such_zset", "0"}));
+    EXPECT_EQ("-ERR Operation against a key holding the wrong kind of value\r\n",
+              runCommand(zsetCommands, &ZSetCommands::cmdZscan, {"ZSCAN", "string_key", "0"}));
+    EXPECT_EQ("-ERR wrong number of arguments for 'zscan' command\r\n",
+              runCommand(zsetCommands, &ZSetCommands::cmdZscan, {"ZSCAN", "scores"}));
+}
@@ -275,3 +275,91 @@ TEST_F(RESPParserTest, EdgeCases) {
     deepNested += ":1\r\n";
     EXPECT_FALSE(RESPParser::parse(deepNested, result, consumed));
 }
+
+// Test incremental request parsing
+TEST_F(RESPParserTest, ParseRequestComplete) {
+    RESPParser parser;
+    std::vector<std::string_view> args;
+    size_t consumed;
+
+    std::string input = "*3\r\n$3\r\nSET\r\n$3\r\nkey\r\n$5\r\nvalue\r\n*1\r\n$4\r\nPING\r\n";
+    ASSERT_EQ(parser.parseRequest(input, args, consumed), ParseStatus::COMPLETE);
+    EXPECT_EQ(args, (std::vector<std::string_view>{"SET", "key", "value"}));
+    EXPECT_EQ(consumed, 33);
+
+    ASSERT_EQ(parser.parseRequest(std::string_view(input).substr(consumed), args, consumed), ParseStatus::COMPLETE);
+    EXPECT_EQ(args, (std::vector<std::string_view>{"PING"}));
+}
+
+TEST_F(RESPParserTest, ParseRequestResumesByteByByte) {
+    RESPParser parser;
+    std::vector<std::string_view> args;
+    size_t consumed;
+
+    std::string input = "*2\r\n$4\r\nECHO\r\n$11\r\nhello world\r\n";
+    for (size_t len = 1; len < input.size(); ++len) {
+        ASSERT_EQ(parser.parseRequest(std::string_view(input).substr(0, len), args, consumed),
+                  ParseStatus::INCOMPLETE) << "prefix length " << len;
+    }
+    ASSERT_EQ(parser.parseRequest(input, args, consumed), ParseStatus::COMPLETE);
+    EXPECT_EQ(args, (std::vector<std::string_view>{"ECHO", "hello world"}));
+    EXPECT_EQ(consumed, input.size());
+}
+
+TEST_F(RESPParserTest, ParseRequestLargeValueInChunks) {
+    RESPParser parser;
+    std::vector<std::string_view> args;
+    size_t consumed;
+
+    std::string value(512 * 1024, 'v');
+    std::string input = "*3\r\n$3\r\nSET\r\n$1\r\nk\r\n$" + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+    size_t len = 0;
+    ParseStatus status = ParseStatus::INCOMPLETE;
+    while (status == ParseStatus::INCOMPLETE) {
+        len = std::min(input.size(), len + 4096);
+        status = parser.parseRequest(std::string_view(input).substr(0, len), args, consumed);
+    }
+    ASSERT_EQ(status, ParseStatus::COMPLETE);
+    ASSERT_EQ(args.size(), 3);
+    EXPECT_EQ(args[2].size(), value.size());
+    EXPECT_EQ(consumed, input.size());
+}
+
+TEST_F(RESPParserTest, ParseRequestInline) {
+    RESPParser parser;
+    std::vector<std::string_view> args;
+    size_t consumed;
+
+    EXPECT_EQ(parser.parseRequest("SET key val", args, consumed), ParseStatus::INCOMPLETE);
+    ASSERT_EQ(parser.parseRequest("SET key val\r\n", args, consumed), ParseStatus::COMPLETE);
+    EXPECT_EQ(args, (std::vector<std::string_view>{"SET", "key", "val"}));
+    EXPECT_EQ(consumed, 13);
+}
+
+TEST_F(RESPParserTest, ParseRequestEmptyArray) {
+    RESPParser parser;
+    std::vector<std::string_view> args{"stale"};
+    size_t consumed;
+
+    ASSERT_EQ(parser.parseRequest("*0\r\n", args, consumed), ParseStatus::COMPLETE);
+    EXPECT_TRUE(args.empty());
+    EXPECT_EQ(consumed, 4);
+}
+
+TEST_F(RESPParserTest, ParseRequestProtocolErrors) {
+    RESPParser parser;
+    std::vector<std::string_view> args;
+    size_t consumed;
+
+    EXPECT_EQ(parser.parseRequest("*abc\r\n", args, consumed), ParseStatus::ERROR);
+    EXPECT_NE(parser.getError().find("Protocol error"), std::string::npos);
+
+    EXPECT_EQ(parser.parseRequest("*1\r\n:1\r\n", args, consumed), ParseStatus::ERROR);
+    EXPECT_EQ(parser.parseRequest("*1\r\n$3\r\nabcde\r\n", args, consumed), ParseStatus::ERROR);
+    EXPECT_EQ(parser.parseRequest("*1\r\n$-5\r\n", args, consumed), ParseStatus::ERROR);
+    EXPECT_EQ(parser.parseRequest("*1\r\n$" + std::string(40, '9'), args, consumed), ParseStatus::ERROR);
+
+    // The parser is usable again after an error
+    ASSERT_EQ(parser.parseRequest("*1\r\n$4\r\nPING\r\n", args, consumed), ParseStatus::COMPLETE);
+    EXPECT_EQ(args, (std::vector<std::string_view>{"PING"}));
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "resp/resp_scanner.h"
+#include "resp/resp_parser.h"
+
+using Impl = RESPScanner::Implementation;
+
+class RESPScannerTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        RESPScanner::setImplementation(original);
+    }
+
+    static std::vector<Impl> supportedImplementations() {
+        std::vector<Impl> result;
+        for (Impl impl : {Impl::SCALAR, Impl::SSE2, Impl::AVX2}) {
+            if (RESPScanner::isSupported(impl)) result.push_back(impl);
+        }
+        return result;
+    }
+
+    Impl original = RESPScanner::getImplementation();
+};
+
+TEST_F(RESPScannerTest, FindCRLFBasic) {
+    for (Impl impl : supportedImplementations()) {
+        SCOPED_TRACE(RESPScanner::getImplementationName(impl));
+        EXPECT_EQ(RESPScanner::findCRLF(impl, "\r\n", 2), 0u);
+        EXPECT_EQ(RESPScanner::findCRLF(impl, "abc\r\n", 5), 3u);
+        EXPECT_EQ(RESPScanner::findCRLF(impl, "abc", 3), RESPScanner::npos);
+        EXPECT_EQ(RESPScanner::findCRLF(impl, "", 0), RESPScanner::npos);
+        // A lone '\r' at the end is not a match yet
+        EXPECT_EQ(RESPScanner::findCRLF(impl, "abc\r", 4), RESPScanner::npos);
+        // '\r' not followed by '\n' is skipped
+        EXPECT_EQ(RESPScanner::findCRLF(impl, "a\rb\r\n", 5), 3u);
+    }
+}
+
+TEST_F(RESPScannerTest, FindCRLFAcrossVectorBoundaries) {
+    for (Impl impl : supportedImplementations()) {
+        SCOPED_TRACE(RESPScanner::getImplementationName(impl));
+        for (size_t pos = 0; pos < 100; ++pos) {
+            std::string data(pos, 'x');
+            data += "\r\n";
+            data += std::string(50, 'y');
+            EXPECT_EQ(RESPScanner::findCRLF(impl, data.data(), data.size()), pos);
+            // CR as the last byte of one block, LF as the first of the next
+            EXPECT_EQ(RESPScanner::findCRLF(impl, data.data(), pos + 1), RESPScanner::npos);
+        }
+    }
+}
+
+TEST_F(RESPScannerTest, ImplementationsAgreeOnRandomInput) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> byte(0, 3);
+    const char alphabet[] = {'\r', '\n', 'a', '$'};
+
+    for (int round = 0; round < 500; ++round) {
+        std::string data(gen() % 200, 'a');
+        for (char& c : data) c = alphabet[byte(gen)];
+
+        size_t expected = std::string_view(data).find("\r\n");
+        for (Impl impl : supportedImplementations()) {
+            ASSERT_EQ(RESPScanner::findCRLF(impl, data.data(), data.size()), expected)
+                << RESPScanner::getImplementationName(impl);
+        }
+    }
+}
+
+TEST_F(RESPScannerTest, ParseInteger) {
+    long long value;
+    EXPECT_TRUE(RESPScanner::parseInteger("0", value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(RESPScanner::parseInteger("12345", value));
+    EXPECT_EQ(value, 12345);
+    EXPECT_TRUE(RESPScanner::parseInteger("-1", value));
+    EXPECT_EQ(value, -1);
+    EXPECT_TRUE(RESPScanner::parseInteger("+7", value));
+    EXPECT_EQ(value, 7);
+    EXPECT_TRUE(RESPScanner::parseInteger("9223372036854775807", value));
+    EXPECT_EQ(value, std::numeric_limits<long long>::max());
+    EXPECT_TRUE(RESPScanner::parseInteger("-9223372036854775808", value));
+    EXPECT_EQ(value, std::numeric_limits<long long>::min());
+}
+
+TEST_F(RESPScannerTest, ParseIntegerRejectsInvalid) {
+    long long value;
+    EXPECT_FALSE(RESPScanner::parseInteger("", value));
+    EXPECT_FALSE(RESPScanner::parseInteger("-", value));
+    EXPECT_FALSE(RESPScanner::parseInteger("12a", value));
+    EXPECT_FALSE(RESPScanner::parseInteger(" 12", value));
+    EXPECT_FALSE(RESPScanner::parseInteger("1.5", value));
+    EXPECT_FALSE(RESPScanner::parseInteger("9223372036854775808", value));
+    EXPECT_FALSE(RESPScanner::parseInteger("-9223372036854775809", value));
+    EXPECT_FALSE(RESPScanner::parseInteger("99999999999999999999", value));
+}
+
+// Benchmarks: run with --gtest_also_run_disabled_tests
+
+namespace {
+
+// Mostly small GET/SET traffic with some multi-key and larger writes
+std::string buildCommandMix(size_t commands) {
+    std::mt19937 gen(7);
+    std::string buffer;
+    auto bulk = [&buffer](const std::string& s) {
+        buffer += "$" + std::to_string(s.size()) + "\r\n" + s + "\r\n";
+    };
+    for (size_t i = 0; i < commands; ++i) {
+        std::string key = "user:" + std::to_string(gen() % 100000);
+        unsigned kind = gen() % 10;
+        if (kind < 6) {
+            buffer += "*2\r\n";
+            bulk("GET");
+            bulk(key);
+        } else if (kind < 9) {
+            buffer += "*3\r\n";
+            bulk("SET");
+            bulk(key);
+            bulk(std::string(16 + gen() % 200, 'v'));
+        } else {
+            buffer += "*7\r\n";
+            bulk("MSET");
+            for (int k = 0; k < 3; ++k) {
+                bulk(key + ":" + std::to_string(k));
+                bulk(std::string(1024, 'w'));
+            }
+        }
+    }
+    return buffer;
+}
+
+double parseRate(const std::string& buffer, size_t commands, int rounds) {
+    RESPParser parser;
+    std::vector<std::string_view> args;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        std::string_view input(buffer);
+        size_t consumed;
+        while (parser.parseRequest(input, args, consumed) == ParseStatus::COMPLETE) {
+            input.remove_prefix(consumed);
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return commands * rounds / elapsed.count();
+}
+
+bool stollToLongLong(const std::string& str, long long& result) {
+    try {
+        size_t processed;
+        result = std::stoll(str, &processed);
+        return processed == str.length();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace
+
+TEST_F(RESPScannerTest, DISABLED_ParseRateBenchmark) {
+    const size_t commands = 100000;
+    const int rounds = 20;
+    std::string buffer = buildCommandMix(commands);
+
+    for (Impl impl : supportedImplementations()) {
+        RESPScanner::setImplementation(impl);
+        double rate = parseRate(buffer, commands, rounds);
+        std::cout << "parseRequest [" << RESPScanner::getImplementationName(impl) << "]: "
+                  << static_cast<long long>(rate) << " commands/s" << std::endl;
+    }
+}
+
+TEST_F(RESPScannerTest, DISABLED_FindCRLFBenchmark) {
+    // Simple-string lines of assorted lengths, as in replies and inline requests
+    std::vector<std::string> lines;
+    for (size_t len : {8, 24, 64, 256, 1024}) {
+        lines.push_back(std::string(len, 'x') + "\r\n");
+    }
+
+    const int iterations = 200000;
+    size_t sink = 0;
+    auto run = [&](const char* name, auto&& find) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            for (const auto& line : lines) sink += find(line);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "findCRLF [" << name << "]: " << elapsed.count() << " ms" << std::endl;
+    };
+
+    run("std::string::find", [](const std::string& s) { return s.find("\r\n"); });
+    for (Impl impl : supportedImplementations()) {
+        run(RESPScanner::getImplementationName(impl),
+            [impl](const std::string& s) { return RESPScanner::findCRLF(impl, s.data(), s.size()); });
+    }
+    EXPECT_GT(sink, 0u);
+}
+
+TEST_F(RESPScannerTest, DISABLED_ParseIntegerBenchmark) {
+    std::vector<std::string> numbers;
+    std::mt19937 gen(3);
+    for (int i = 0; i < 1000; ++i) {
+        numbers.push_back(std::to_string(gen() % 100000));
+    }
+    numbers.push_back("not-a-number");  // the exception path of std::stoll
+
+    const int rounds = 2000;
+    long long sum = 0;
+    long long value;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& n : numbers) if (stollToLongLong(n, value)) sum += value;
+    }
+    std::chrono::duration<double, std::milli> stoll_ms = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const auto& n : numbers) if (RESPScanner::parseInteger(n, value)) sum += value;
+    }
+    std::chrono::duration<double, std::milli> scanner_ms = std::chrono::steady_clock::now() - start;
+
+    std::cout << "std::stoll + try/catch: " << stoll_ms.count() << " ms" << std::endl;
+    std::cout << "RESPScanner::parseInteger: " << scanner_ms.count() << " ms" << std::endl;
+    EXPECT_GT(sum, 0);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <climits>
+#include "resp/response_writer.h"
+
+class ResponseWriterTest : public ::testing::Test {
+protected:
+    std::string output;
+    ResponseWriter writer{output};
+};
+
+TEST_F(ResponseWriterTest, WriteScalars) {
+    writer.writeSimpleString("OK");
+    writer.writeError("ERR bad");
+    writer.writeInteger(42);
+    writer.writeInteger(-7);
+    EXPECT_EQ(output, "+OK\r\n-ERR bad\r\n:42\r\n:-7\r\n");
+}
+
+TEST_F(ResponseWriterTest, WriteIntegerLimits) {
+    writer.writeInteger(LLONG_MAX);
+    writer.writeInteger(LLONG_MIN);
+    EXPECT_EQ(output, ":9223372036854775807\r\n:-9223372036854775808\r\n");
+}
+
+TEST_F(ResponseWriterTest, WriteBulkStrings) {
+    writer.writeBulkString("Hello");
+    writer.writeBulkString("");
+    writer.writeBulkString(std::string("a\r\nb", 4));
+    writer.writeBulkString(1234567LL);
+    EXPECT_EQ(output, "$5\r\nHello\r\n$0\r\n\r\n$4\r\na\r\nb\r\n$7\r\n1234567\r\n");
+}
+
+TEST_F(ResponseWriterTest, WriteNulls) {
+    writer.writeNull();
+    writer.writeNullArray();
+    EXPECT_EQ(output, "$-1\r\n*-1\r\n");
+}
+
+TEST_F(ResponseWriterTest, WriteArrayWithNullElement) {
+    writer.writeArrayHeader(3);
+    writer.writeBulkString("a");
+    writer.writeNull();
+    writer.writeInteger(1);
+    EXPECT_EQ(output, "*3\r\n$1\r\na\r\n$-1\r\n:1\r\n");
+}
+
+TEST_F(ResponseWriterTest, AppendsAfterExistingOutput) {
+    output = "+PONG\r\n";
+    writer.writeArrayHeader(0);
+    EXPECT_EQ(output, "+PONG\r\n*0\r\n");
+}
+
+TEST_F(ResponseWriterTest, TruncateDropsPartialReply) {
+    writer.writeSimpleString("OK");
+    size_t mark = writer.position();
+    writer.writeArrayHeader(2);
+    writer.writeBulkString("half");
+    writer.truncate(mark);
+    writer.writeError("ERR failed");
+    EXPECT_EQ(output, "+OK\r\n-ERR failed\r\n");
+}
+
+TEST_F(ResponseWriterTest, FlushHandlerKeepsBufferNearThreshold) {
+    std::string sent;
+    size_t largest = 0;
+    writer.setFlushHandler([&](std::string& buffer) {
+        largest = std::max(largest, buffer.size());
+        sent += buffer;
+        size_t n = buffer.size();
+        buffer.clear();
+        return n;
+    }, 64);
+
+    std::string expected = "*100\r\n";
+    writer.writeArrayHeader(100);
+    for (int i = 0; i < 100; ++i) {
+        writer.writeBulkString("element");
+        writer.flushIfNeeded();
+        expected += "$7\r\nelement\r\n";
+    }
+
+    EXPECT_EQ(sent + output, expected);
+    EXPECT_LT(largest, 64u + 14u);
+    EXPECT_EQ(writer.position(), expected.size());
+}
+
+TEST_F(ResponseWriterTest, FlushOnlyAtStreamingPoints) {
+    int calls = 0;
+    writer.setFlushHandler([&](std::string&) { calls++; return size_t(0); }, 4);
+    writer.writeBulkString("a long enough reply");
+    EXPECT_EQ(calls, 0);
+    writer.flushIfNeeded();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST_F(ResponseWriterTest, TruncateFailsOnceFlushed) {
+    writer.setFlushHandler([](std::string& buffer) {
+        size_t n = buffer.size();
+        buffer.clear();
+        return n;
+    }, 1);
+    size_t mark = writer.position();
+    writer.writeArrayHeader(1);
+    writer.flushIfNeeded();
+    writer.writeBulkString("x");
+    EXPECT_FALSE(writer.truncate(mark));
+    EXPECT_TRUE(writer.truncate(writer.position() - 7));
+    EXPECT_TRUE(output.empty());
+}
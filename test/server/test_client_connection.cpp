@@ -0,0 +1,337 @@
+// server/test_client_connection.cpp
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "server/client_connection.h"
+#include "server/event_loop.h"
+
+class ClientConnectionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        int fds[2];
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        EventLoop::setNonBlocking(fds[0]);
+        connection = std::make_unique<ClientConnection>(fds[0], "127.0.0.1", 6000);
+        peer_fd = fds[1];
+    }
+
+    void TearDown() override {
+        connection.reset();
+        if (peer_fd != -1) close(peer_fd);
+    }
+
+    void peerSend(const std::string& data) {
+        ASSERT_EQ(send(peer_fd, data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+    }
+
+    std::string peerReceive() {
+        std::string result;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = recv(peer_fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+            result.append(buffer, n);
+        }
+        return result;
+    }
+
+    // A set whose SMEMBERS reply is several times the socket buffer
+    size_t fillBigSet(size_t members) {
+        std::vector<std::string> sadd = {"SADD", "big"};
+        for (size_t i = 0; i < members; ++i) {
+            sadd.push_back("member:" + std::to_string(100000 + i));
+        }
+        std::string discard;
+        ResponseWriter out(discard);
+        handler.processCommand(sadd, out);
+
+        std::string header = "*" + std::to_string(members) + "\r\n";
+        return header.size() + members * std::string("$13\r\nmember:100000\r\n").size();
+    }
+
+    std::unique_ptr<ClientConnection> connection;
+    CommandHandler handler;
+    int peer_fd = -1;
+};
+
+TEST_F(ClientConnectionTest, Accessors) {
+    EXPECT_GE(connection->getFd(), 0);
+    EXPECT_EQ(connection->getIp(), "127.0.0.1");
+    EXPECT_EQ(connection->getPort(), 6000);
+    EXPECT_FALSE(connection->hasPendingOutput());
+    EXPECT_FALSE(connection->shouldClose());
+}
+
+TEST_F(ClientConnectionTest, ReadAndProcessSingleCommand) {
+    peerSend("*1\r\n$4\r\nPING\r\n");
+
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+    EXPECT_TRUE(connection->flushOutput());
+
+    EXPECT_EQ(peerReceive(), "+PONG\r\n");
+}
+
+TEST_F(ClientConnectionTest, PartialCommandWaitsForMoreData) {
+    peerSend("*2\r\n$4\r\nECHO\r\n$5\r\nhel");
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+    EXPECT_EQ(peerReceive(), "");
+
+    peerSend("lo\r\n");
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+    EXPECT_TRUE(connection->flushOutput());
+    EXPECT_EQ(peerReceive(), "$5\r\nhello\r\n");
+}
+
+TEST_F(ClientConnectionTest, PipelinedCommandsAnsweredInOrder) {
+    peerSend("*3\r\n$3\r\nSET\r\n$1\r\nk\r\n$1\r\nv\r\n"
+             "*2\r\n$3\r\nGET\r\n$1\r\nk\r\n"
+             "*1\r\n$4\r\nPING\r\n");
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+
+    // Nothing goes out until the whole batch is flushed at once
+    EXPECT_EQ(peerReceive(), "");
+    EXPECT_TRUE(connection->hasPendingOutput());
+
+    EXPECT_TRUE(connection->flushOutput());
+    EXPECT_FALSE(connection->hasPendingOutput());
+    EXPECT_EQ(peerReceive(), "+OK\r\n$1\r\nv\r\n+PONG\r\n");
+}
+
+TEST_F(ClientConnectionTest, TakeOutputHandsOverQueuedReplies) {
+    peerSend("*1\r\n$4\r\nPING\r\n*1\r\n$4\r\nPING\r\n");
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+
+    std::string out;
+    ASSERT_TRUE(connection->takeOutput(out));
+    EXPECT_EQ(out, "+PONG\r\n+PONG\r\n");
+    EXPECT_FALSE(connection->hasPendingOutput());
+    EXPECT_FALSE(connection->takeOutput(out));
+}
+
+TEST_F(ClientConnectionTest, ReadReportsPeerClose) {
+    close(peer_fd);
+    peer_fd = -1;
+    EXPECT_FALSE(connection->readAvailable());
+}
+
+TEST_F(ClientConnectionTest, ReadWithNoDataIsNotAnError) {
+    EXPECT_TRUE(connection->readAvailable());
+}
+
+TEST_F(ClientConnectionTest, OutputQueuedWhenSocketIsFull) {
+    // A reply larger than the socket buffers cannot be sent in one go
+    std::string big_value(900 * 1024, 'x');
+    std::string command = "*2\r\n$4\r\nECHO\r\n$" + std::to_string(big_value.size()) + "\r\n" + big_value + "\r\n";
+
+    // Feed the request in pieces, reading as we go
+    size_t offset = 0;
+    while (offset < command.size()) {
+        ssize_t n = send(peer_fd, command.data() + offset, command.size() - offset, MSG_DONTWAIT);
+        if (n > 0) offset += n;
+        ASSERT_TRUE(connection->readAvailable());
+    }
+    // Each call reads a bounded amount; collect the rest
+    while (connection->canRead()) {
+        ASSERT_TRUE(connection->readAvailable());
+    }
+    connection->processInput(handler);
+    EXPECT_TRUE(connection->hasPendingOutput());
+
+    // Drain on the peer side while flushing on the server side
+    std::string header = "$" + std::to_string(big_value.size()) + "\r\n";
+    const size_t expected = header.size() + big_value.size() + 2;
+    std::string received;
+    char buffer[65536];
+    while (connection->hasPendingOutput() || received.size() < expected) {
+        ASSERT_TRUE(connection->flushOutput());
+        ssize_t n = recv(peer_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0) received.append(buffer, n);
+    }
+
+    ASSERT_EQ(received.size(), expected);
+    EXPECT_EQ(received.compare(0, header.size(), header), 0);
+}
+
+TEST_F(ClientConnectionTest, DestructorClosesSocket) {
+    int fd = connection->getFd();
+    connection.reset();
+    EXPECT_EQ(fcntl(fd, F_GETFD), -1);
+}
+
+TEST_F(ClientConnectionTest, ProtocolErrorClosesConnection) {
+    peerSend("*1\r\n:5\r\n");
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+    EXPECT_TRUE(connection->shouldClose());
+
+    EXPECT_TRUE(connection->flushOutput());
+    EXPECT_EQ(peerReceive().rfind("-ERR Protocol error", 0), 0u);
+}
+
+TEST_F(ClientConnectionTest, LargeReplyStreamedToReadingPeer) {
+    const size_t expected = fillBigSet(50000);
+
+    std::string received;
+    std::thread reader([&] {
+        char buffer[65536];
+        while (received.size() < expected) {
+            ssize_t n = recv(peer_fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) break;
+            received.append(buffer, n);
+        }
+    });
+
+    peerSend("*2\r\n$8\r\nSMEMBERS\r\n$3\r\nbig\r\n");
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+
+    // Part of the reply went out while it was produced; the command never
+    // waits for the reader, so the rest is left to the event loop
+    EXPECT_LT(connection->getPendingOutputSize(), expected);
+
+    while (connection->hasPendingOutput()) {
+        ASSERT_TRUE(connection->flushOutput());
+    }
+    reader.join();
+
+    ASSERT_EQ(received.size(), expected);
+    EXPECT_EQ(received.rfind("*50000\r\n$13\r\nmember:", 0), 0u);
+}
+
+TEST_F(ClientConnectionTest, LargeReplyBufferedWhenPeerIsNotReading) {
+    const size_t expected = fillBigSet(50000);
+
+    peerSend("*2\r\n$8\r\nSMEMBERS\r\n$3\r\nbig\r\n");
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+    EXPECT_TRUE(connection->hasPendingOutput());
+    EXPECT_FALSE(connection->shouldClose());
+
+    std::string received;
+    char buffer[65536];
+    while (connection->hasPendingOutput() || received.size() < expected) {
+        ASSERT_TRUE(connection->flushOutput());
+        ssize_t n = recv(peer_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0) received.append(buffer, n);
+    }
+    EXPECT_EQ(received.size(), expected);
+}
+
+TEST_F(ClientConnectionTest, QueryBufferLimitClosesClient) {
+    ClientLimits limits;
+    limits.query_buffer = 32 * 1024;
+    connection->setLimits(limits);
+
+    // A bulk argument that never completes within the limit
+    std::string partial = "*2\r\n$4\r\nECHO\r\n$100000\r\n" + std::string(40 * 1024, 'q');
+    peerSend(partial);
+    EXPECT_TRUE(connection->readAvailable());
+    EXPECT_TRUE(connection->shouldClose());
+
+    // Nothing is executed or answered; the input is gone
+    connection->processInput(handler);
+    EXPECT_FALSE(connection->hasPendingOutput());
+    connection->appendInput("*1\r\n$4\r\nPING\r\n", 14);
+    connection->processInput(handler);
+    EXPECT_FALSE(connection->hasPendingOutput());
+}
+
+TEST_F(ClientConnectionTest, QueryBufferLimitAppliesToAppendedInput) {
+    ClientLimits limits;
+    limits.query_buffer = 16;
+    connection->setLimits(limits);
+    connection->appendInput("*1\r\n$4\r\nPI", 12);
+    EXPECT_FALSE(connection->shouldClose());
+    connection->appendInput("NG\r\n*1\r\n", 8);
+    EXPECT_TRUE(connection->shouldClose());
+}
+
+TEST_F(ClientConnectionTest, ReadsAreBoundedPerCall) {
+    std::string value(100 * 1024, 'v');
+    peerSend("*3\r\n$3\r\nSET\r\n$1\r\nk\r\n$" + std::to_string(value.size()) + "\r\n" + value + "\r\n");
+
+    // A flooding client yields after a bounded read and asks to come back
+    EXPECT_TRUE(connection->readAvailable());
+    EXPECT_TRUE(connection->canRead());
+    EXPECT_TRUE(connection->needsService());
+
+    EXPECT_TRUE(connection->readAvailable());
+    EXPECT_FALSE(connection->canRead());
+    connection->processInput(handler);
+    EXPECT_FALSE(connection->needsService());
+    EXPECT_TRUE(connection->flushOutput());
+    EXPECT_EQ(peerReceive(), "+OK\r\n");
+}
+
+TEST_F(ClientConnectionTest, PipelinePausesWhileRepliesAreUnread) {
+    std::string value(100 * 1024, 'v');
+    std::vector<std::string> set = {"SET", "k", value};
+    std::string discard;
+    ResponseWriter writer(discard);
+    handler.processCommand(set, writer);
+
+    std::string pipeline;
+    for (int i = 0; i < 20; ++i) pipeline += "*2\r\n$3\r\nGET\r\n$1\r\nk\r\n";
+    peerSend(pipeline);
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+
+    // Execution stops at the output high-water mark, not after 2 MB of
+    // replies, and reads stop with it
+    EXPECT_TRUE(connection->isOutputBacklogged());
+    EXPECT_LT(connection->getPendingOutputSize(), 5 * (value.size() + 10));
+    EXPECT_FALSE(connection->canRead());
+    EXPECT_FALSE(connection->needsService());
+
+    // As the peer reads, the rest of the pipeline runs
+    std::string reply = "$" + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+    const size_t expected = 20 * reply.size();
+    size_t received = 0;
+    char buffer[65536];
+    while (received < expected) {
+        ASSERT_TRUE(connection->flushOutput());
+        if (connection->needsService()) connection->processInput(handler);
+        ssize_t n = recv(peer_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0) received += n;
+        ASSERT_FALSE(connection->shouldClose());
+    }
+    EXPECT_EQ(received, expected);
+    EXPECT_FALSE(connection->hasPendingOutput());
+}
+
+TEST_F(ClientConnectionTest, OutputBufferLimitClosesClient) {
+    fillBigSet(50000);
+    ClientLimits limits;
+    limits.output_buffer = 128 * 1024;
+    connection->setLimits(limits);
+
+    // The peer never reads; the reply passes the limit while it is produced
+    peerSend("*2\r\n$8\r\nSMEMBERS\r\n$3\r\nbig\r\n*1\r\n$4\r\nPING\r\n");
+    EXPECT_TRUE(connection->readAvailable());
+    connection->processInput(handler);
+    EXPECT_TRUE(connection->shouldClose());
+    EXPECT_FALSE(connection->hasPendingOutput());
+}
+
+TEST_F(ClientConnectionTest, OutputBufferLimitAppliesWithoutStreaming) {
+    fillBigSet(50000);
+    ClientLimits limits;
+    limits.output_buffer = 128 * 1024;
+    connection->setLimits(limits);
+    connection->setStreamReplies(false);
+
+    connection->appendInput("*2\r\n$8\r\nSMEMBERS\r\n$3\r\nbig\r\n", 27);
+    connection->processInput(handler);
+    EXPECT_TRUE(connection->shouldClose());
+
+    std::string out;
+    EXPECT_FALSE(connection->takeOutput(out));
+}
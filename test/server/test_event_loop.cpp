@@ -0,0 +1,242 @@
+// server/test_event_loop.cpp
+#include <gtest/gtest.h>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "server/event_loop.h"
+
+using namespace std::chrono_literals;
+
+class EventLoopTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_GE(listen_fd, 0);
+        int opt = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = inet_addr("127.0.0.1");
+        address.sin_port = 0;  // let the kernel pick a free port
+        ASSERT_EQ(bind(listen_fd, (sockaddr*)&address, sizeof(address)), 0);
+        ASSERT_EQ(listen(listen_fd, 511), 0);
+        ASSERT_TRUE(EventLoop::setNonBlocking(listen_fd));
+
+        socklen_t len = sizeof(address);
+        getsockname(listen_fd, (sockaddr*)&address, &len);
+        port = ntohs(address.sin_port);
+
+        loop = std::make_unique<EventLoop>(listen_fd, handler, connections);
+        loop_thread = std::thread([this]() { loop->run(); });
+    }
+
+    void TearDown() override {
+        loop->stop();
+        if (loop_thread.joinable()) loop_thread.join();
+        loop.reset();
+        close(listen_fd);
+    }
+
+    int connectClient() {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = inet_addr("127.0.0.1");
+        if (connect(fd, (sockaddr*)&address, sizeof(address)) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // Reads until `expected` bytes arrived or the timeout expires
+    static std::string receive(int fd, size_t expected) {
+        std::string result;
+        char buffer[4096];
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (result.size() < expected && std::chrono::steady_clock::now() < deadline) {
+            ssize_t n = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (n > 0) {
+                result.append(buffer, n);
+            } else if (n == 0) {
+                break;
+            } else {
+                std::this_thread::sleep_for(1ms);
+            }
+        }
+        return result;
+    }
+
+    bool waitForConnections(size_t expected) {
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (connections.getActiveConnections() == expected) return true;
+            std::this_thread::sleep_for(1ms);
+        }
+        return connections.getActiveConnections() == expected;
+    }
+
+    int listen_fd = -1;
+    int port = 0;
+    CommandHandler handler;
+    ConnectionManager connections;
+    std::unique_ptr<EventLoop> loop;
+    std::thread loop_thread;
+};
+
+TEST_F(EventLoopTest, AcceptsAndServesClient) {
+    int fd = connectClient();
+    ASSERT_GE(fd, 0);
+
+    std::string ping = "*1\r\n$4\r\nPING\r\n";
+    send(fd, ping.data(), ping.size(), 0);
+    EXPECT_EQ(receive(fd, 7), "+PONG\r\n");
+    EXPECT_TRUE(waitForConnections(1));
+
+    close(fd);
+}
+
+TEST_F(EventLoopTest, DisconnectRemovesConnection) {
+    int fd = connectClient();
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(waitForConnections(1));
+
+    close(fd);
+    EXPECT_TRUE(waitForConnections(0));
+}
+
+TEST_F(EventLoopTest, ServesManyClientsFromOneThread) {
+    const int num_clients = 200;
+    std::vector<int> fds;
+    for (int i = 0; i < num_clients; ++i) {
+        int fd = connectClient();
+        ASSERT_GE(fd, 0);
+        fds.push_back(fd);
+    }
+    ASSERT_TRUE(waitForConnections(num_clients));
+
+    for (int i = 0; i < num_clients; ++i) {
+        std::string value = std::to_string(i);
+        std::string cmd = "*2\r\n$4\r\nECHO\r\n$" + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+        send(fds[i], cmd.data(), cmd.size(), 0);
+    }
+    for (int i = 0; i < num_clients; ++i) {
+        std::string value = std::to_string(i);
+        std::string expected = "$" + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+        EXPECT_EQ(receive(fds[i], expected.size()), expected);
+    }
+
+    for (int fd : fds) close(fd);
+    EXPECT_TRUE(waitForConnections(0));
+}
+
+TEST_F(EventLoopTest, ClientThatDoesNotReadIsThrottled) {
+    int flooder = connectClient();
+    int other = connectClient();
+    ASSERT_GE(flooder, 0);
+    ASSERT_GE(other, 0);
+
+    // Pipeline ECHOs without reading a single reply until the server stops
+    // taking them: its output backlog must hold the input back
+    std::string value(1000, 'f');
+    std::string cmd = "*2\r\n$4\r\nECHO\r\n$1000\r\n" + value + "\r\n";
+    std::string batch;
+    for (int i = 0; i < 64; ++i) batch += cmd;
+    size_t sent = 0;
+    int stalled = 0;
+    while (stalled < 200 && sent < 256u * 1024 * 1024) {
+        size_t offset = sent % batch.size();
+        ssize_t n = send(flooder, batch.data() + offset, batch.size() - offset, MSG_DONTWAIT);
+        if (n > 0) {
+            sent += n;
+            stalled = 0;
+        } else {
+            ++stalled;
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    EXPECT_EQ(stalled, 200);
+
+    // Meanwhile the other client is served
+    std::string ping = "*1\r\n$4\r\nPING\r\n";
+    send(other, ping.data(), ping.size(), 0);
+    EXPECT_EQ(receive(other, 7), "+PONG\r\n");
+
+    // Once the flooder reads, every complete command is answered
+    std::string reply = "$1000\r\n" + value + "\r\n";
+    const size_t expected = (sent / cmd.size()) * reply.size();
+    size_t received = 0;
+    char buffer[65536];
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (received < expected && std::chrono::steady_clock::now() < deadline) {
+        ssize_t n = recv(flooder, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n > 0) {
+            received += n;
+        } else if (n == 0) {
+            break;
+        } else {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    EXPECT_EQ(received, expected);
+
+    close(flooder);
+    close(other);
+}
+
+TEST_F(EventLoopTest, RejectsClientsOverLimit) {
+    // Replace the loop with one that allows a single client
+    loop->stop();
+    loop_thread.join();
+    ConnectionManager limited(1);
+    loop = std::make_unique<EventLoop>(listen_fd, handler, limited);
+    loop_thread = std::thread([this]() { loop->run(); });
+
+    int first = connectClient();
+    ASSERT_GE(first, 0);
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (limited.getActiveConnections() != 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    int second = connectClient();
+    ASSERT_GE(second, 0);
+    std::string reply = receive(second, 64);
+    EXPECT_NE(reply.find("max number of clients"), std::string::npos);
+
+    close(first);
+    close(second);
+    loop->stop();
+    loop_thread.join();
+}
+
+TEST_F(EventLoopTest, StopClosesClients) {
+    int fd = connectClient();
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(waitForConnections(1));
+
+    loop->stop();
+    loop_thread.join();
+
+    EXPECT_EQ(connections.getActiveConnections(), 0);
+    char buffer[8];
+    EXPECT_EQ(recv(fd, buffer, sizeof(buffer), 0), 0);
+    close(fd);
+}
+
+TEST_F(EventLoopTest, StopBeforeRunReturnsImmediately) {
+    loop->stop();
+    loop_thread.join();
+
+    EventLoop idle(listen_fd, handler, connections);
+    idle.stop();
+    idle.run();
+    SUCCEED();
+}
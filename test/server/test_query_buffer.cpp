@@ -0,0 +1,127 @@
+// server/test_query_buffer.cpp
+#include <gtest/gtest.h>
+#include <string>
+#include "server/query_buffer.h"
+
+TEST(QueryBufferTest, StartsEmptyWithoutAllocation) {
+    QueryBuffer buffer;
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.size(), 0u);
+    EXPECT_EQ(buffer.getCapacity(), 0u);
+    EXPECT_EQ(buffer.readable(), "");
+}
+
+TEST(QueryBufferTest, AppendAndConsume) {
+    QueryBuffer buffer;
+    buffer.append("PING\r\nECHO\r\n", 12);
+    EXPECT_EQ(buffer.readable(), "PING\r\nECHO\r\n");
+
+    buffer.consume(6);
+    EXPECT_EQ(buffer.readable(), "ECHO\r\n");
+    EXPECT_EQ(buffer.size(), 6u);
+
+    buffer.consume(6);
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(QueryBufferTest, ConsumeDoesNotMoveRemainingBytes) {
+    QueryBuffer buffer;
+    buffer.append("aaaabbbb", 8);
+    const char* second = buffer.readable().data() + 4;
+
+    buffer.consume(4);
+    EXPECT_EQ(buffer.readable().data(), second);
+}
+
+TEST(QueryBufferTest, PrepareWriteAndCommit) {
+    QueryBuffer buffer;
+    char* dst = buffer.prepareWrite(5);
+    ASSERT_GE(buffer.writableBytes(), 5u);
+    memcpy(dst, "hello", 5);
+    buffer.commitWrite(5);
+    EXPECT_EQ(buffer.readable(), "hello");
+}
+
+TEST(QueryBufferTest, CompactsInsteadOfGrowingWhenThereIsRoom) {
+    QueryBuffer buffer;
+    std::string chunk(10 * 1024, 'x');
+    buffer.append(chunk.data(), chunk.size());
+    size_t capacity = buffer.getCapacity();
+
+    // Leave a partial command behind and ask for more room than the tail has
+    buffer.consume(chunk.size() - 3);
+    buffer.prepareWrite(capacity - 10);
+    EXPECT_EQ(buffer.getCapacity(), capacity);
+    EXPECT_EQ(buffer.readable(), "xxx");
+}
+
+TEST(QueryBufferTest, GrowsForLargeRequests) {
+    QueryBuffer buffer;
+    std::string large(200 * 1024, 'y');
+    for (size_t offset = 0; offset < large.size(); offset += 4096) {
+        buffer.append(large.data() + offset, 4096);
+    }
+    EXPECT_EQ(buffer.size(), large.size());
+    EXPECT_EQ(buffer.readable(), large);
+    EXPECT_GE(buffer.getCapacity(), large.size());
+}
+
+TEST(QueryBufferTest, ShrinksAfterBurst) {
+    QueryBuffer buffer;
+    std::string large(100 * 1024, 'z');
+    buffer.append(large.data(), large.size());
+
+    // Not released while bytes are still unread
+    buffer.shrinkIfIdle();
+    EXPECT_EQ(buffer.size(), large.size());
+
+    buffer.consume(large.size());
+    buffer.shrinkIfIdle();
+    EXPECT_EQ(buffer.getCapacity(), 0u);
+}
+
+TEST(QueryBufferTest, KeepsNormalSizedBufferWhenIdle) {
+    QueryBuffer buffer;
+    buffer.append("PING\r\n", 6);
+    size_t capacity = buffer.getCapacity();
+    buffer.consume(6);
+    buffer.shrinkIfIdle();
+    EXPECT_EQ(buffer.getCapacity(), capacity);
+}
+
+TEST(QueryBufferTest, OverLimitOnlyPastMaxSize) {
+    QueryBuffer buffer;
+    size_t default_max = QueryBuffer::DEFAULT_MAX_SIZE;
+    EXPECT_EQ(buffer.getMaxSize(), default_max);
+    buffer.setMaxSize(64 * 1024);
+
+    std::string chunk(64 * 1024, 'a');
+    buffer.append(chunk.data(), chunk.size());
+    EXPECT_FALSE(buffer.overLimit());
+    buffer.append("b", 1);
+    EXPECT_TRUE(buffer.overLimit());
+
+    // Consumed bytes do not count
+    buffer.consume(1024);
+    EXPECT_FALSE(buffer.overLimit());
+}
+
+TEST(QueryBufferTest, GrowthStopsAtMaxSize) {
+    QueryBuffer buffer;
+    buffer.setMaxSize(100 * 1024);
+    std::string chunk(60 * 1024, 'c');
+    buffer.append(chunk.data(), chunk.size());
+    buffer.append(chunk.data(), chunk.size());
+
+    // Doubling would give 128 KB; only what the data needs is allocated
+    EXPECT_EQ(buffer.getCapacity(), 120u * 1024);
+    EXPECT_TRUE(buffer.overLimit());
+}
+
+TEST(QueryBufferTest, ClearReleasesEverything) {
+    QueryBuffer buffer;
+    buffer.append("PING\r\n", 6);
+    buffer.clear();
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.getCapacity(), 0u);
+}
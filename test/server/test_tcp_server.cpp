@@ -274,7 +274,7 @@ TEST_F(TCPServerTest, DestructorWhileRunning) {
     // Client socket should be closed by server cleanup
     char buffer[10];
     ssize_t result = recv(client_socket, buffer, sizeof(buffer), MSG_DONTWAIT);
-    EXPECT_EQ(result, -1); // Should return 0 for closed connection
+    EXPECT_EQ(result, 0); // Should return 0 for closed connection
     
     close(client_socket);
 }
@@ -319,6 +319,182 @@ TEST_F(TCPServerTest, RapidConnectDisconnect) {
     EXPECT_TRUE(server->isRunning());
 }
 
+// Test multi-reactor mode: several listeners share one keyspace
+TEST(TCPServerReactorTest, MultipleReactorsShareDatabase) {
+    ServerConfig config;
+    config.port = 8767;
+    config.reactors = 4;
+    TCPServer server(config);
+    EXPECT_EQ(server.getReactorCount(), 4u);
+
+    auto server_thread = std::async(std::launch::async, [&server]() { server.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(server.isRunning());
+
+    auto connectClient = []() {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(8767);
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    };
+    auto roundTrip = [](int fd, const std::string& command) {
+        send(fd, command.data(), command.size(), 0);
+        char buffer[256];
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        return n > 0 ? std::string(buffer, n) : std::string();
+    };
+
+    // Enough clients that SO_REUSEPORT spreads them over several reactors
+    std::vector<int> clients;
+    for (int i = 0; i < 16; ++i) {
+        int fd = connectClient();
+        ASSERT_GT(fd, 0);
+        clients.push_back(fd);
+    }
+
+    EXPECT_EQ(roundTrip(clients[0], "*3\r\n$3\r\nSET\r\n$6\r\nshared\r\n$5\r\nvalue\r\n"), "+OK\r\n");
+    for (int fd : clients) {
+        EXPECT_EQ(roundTrip(fd, "*2\r\n$3\r\nGET\r\n$6\r\nshared\r\n"), "$5\r\nvalue\r\n");
+    }
+    EXPECT_EQ(server.getActiveConnections(), clients.size());
+
+    for (int fd : clients) close(fd);
+    server.stop();
+    server_thread.wait_for(std::chrono::seconds(1));
+    EXPECT_FALSE(server.isRunning());
+}
+
+// Test that INFO counts the commands of every reactor, not just its own
+TEST(TCPServerReactorTest, CommandCountCoversAllReactors) {
+    ServerConfig config;
+    config.port = 8771;
+    config.reactors = 2;
+    TCPServer server(config);
+
+    auto server_thread = std::async(std::launch::async, [&server]() { server.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(server.isRunning());
+
+    // Enough clients that both reactors get some
+    std::vector<int> clients;
+    for (int i = 0; i < 16; ++i) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(8771);
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        ASSERT_EQ(connect(fd, (sockaddr*)&addr, sizeof(addr)), 0);
+        clients.push_back(fd);
+    }
+
+    std::string ping = "*1\r\n$4\r\nPING\r\n";
+    char buffer[4096];
+    for (int round = 0; round < 3; ++round) {
+        for (int fd : clients) {
+            send(fd, ping.data(), ping.size(), 0);
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            EXPECT_EQ(std::string(buffer, n > 0 ? n : 0), "+PONG\r\n");
+        }
+    }
+
+    // 48 PINGs plus the INFO itself, whichever reactor serves it
+    for (int fd : {clients.front(), clients.back()}) {
+        std::string info = "*1\r\n$4\r\nINFO\r\n";
+        send(fd, info.data(), info.size(), 0);
+        std::string reply;
+        while (reply.find("total_commands_processed:") == std::string::npos ||
+               reply.find("\r\n", reply.find("total_commands_processed:")) == std::string::npos) {
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            ASSERT_GT(n, 0);
+            reply.append(buffer, n);
+        }
+        std::string expected = fd == clients.front() ? "total_commands_processed:49\r\n"
+                                                     : "total_commands_processed:50\r\n";
+        EXPECT_NE(reply.find(expected), std::string::npos);
+    }
+
+    for (int fd : clients) close(fd);
+    server.stop();
+    server_thread.wait_for(std::chrono::seconds(1));
+}
+
+// Test that a zero reactor count falls back to a single reactor
+TEST(TCPServerReactorTest, ZeroReactorsMeansOne) {
+    ServerConfig config;
+    config.port = 8768;
+    config.reactors = 0;
+    TCPServer server(config);
+    EXPECT_EQ(server.getReactorCount(), 1u);
+}
+
+// Test that CPU pinning does not prevent the server from serving clients
+TEST(TCPServerReactorTest, CpuAffinityStillServes) {
+    ServerConfig config;
+    config.port = 8769;
+    config.reactors = 2;
+    config.cpu_affinity = true;
+    TCPServer server(config);
+
+    auto server_thread = std::async(std::launch::async, [&server]() { server.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(server.isRunning());
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(8769);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    ASSERT_EQ(connect(fd, (sockaddr*)&addr, sizeof(addr)), 0);
+
+    std::string ping = "*1\r\n$4\r\nPING\r\n";
+    send(fd, ping.data(), ping.size(), 0);
+    char buffer[16];
+    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+    EXPECT_EQ(std::string(buffer, n > 0 ? n : 0), "+PONG\r\n");
+
+    close(fd);
+    server.stop();
+    server_thread.wait_for(std::chrono::seconds(1));
+}
+
+// Test that the io_uring backend serves clients, or falls back to epoll
+TEST(TCPServerReactorTest, UringBackendServesOrFallsBack) {
+    ServerConfig config;
+    config.port = 8770;
+    config.reactors = 2;
+    config.backend = IOBackend::IO_URING;
+    TCPServer server(config);
+    EXPECT_EQ(server.getBackend(),
+              UringEventLoop::isSupported() ? IOBackend::IO_URING : IOBackend::EPOLL);
+
+    auto server_thread = std::async(std::launch::async, [&server]() { server.start(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(server.isRunning());
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(8770);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    ASSERT_EQ(connect(fd, (sockaddr*)&addr, sizeof(addr)), 0);
+
+    std::string ping = "*1\r\n$4\r\nPING\r\n";
+    send(fd, ping.data(), ping.size(), 0);
+    char buffer[16];
+    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+    EXPECT_EQ(std::string(buffer, n > 0 ? n : 0), "+PONG\r\n");
+
+    close(fd);
+    server.stop();
+    server_thread.wait_for(std::chrono::seconds(1));
+}
+
 // Mock test for connection manager integration
 class MockConnectionManager {
 public:
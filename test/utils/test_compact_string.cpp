@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include "utils/compact_string.h"
+
+class CompactStringTest : public ::testing::Test {};
+
+TEST_F(CompactStringTest, EmptyByDefault) {
+    CompactString str;
+    EXPECT_EQ(str.size(), 0u);
+    EXPECT_EQ(str.view(), "");
+    EXPECT_EQ(str.allocatedSize(), 0u);
+}
+
+TEST_F(CompactStringTest, HeaderGrowsWithSizeClass) {
+    // Two length fields plus the class byte
+    CompactString small(std::string(40, 'a'));
+    EXPECT_EQ(small.allocatedSize(), 40u + 3);
+
+    CompactString medium(std::string(300, 'b'));
+    EXPECT_EQ(medium.allocatedSize(), 300u + 5);
+    EXPECT_EQ(medium.view(), std::string(300, 'b'));
+
+    CompactString large(std::string(70000, 'c'));
+    EXPECT_EQ(large.allocatedSize(), 70000u + 9);
+    EXPECT_EQ(large.size(), 70000u);
+}
+
+TEST_F(CompactStringTest, AppendCrossesSizeClasses) {
+    CompactString str("x");
+    std::string expected = "x";
+    for (int i = 0; i < 2000; ++i) {
+        str.append("0123456789");
+        expected += "0123456789";
+    }
+    EXPECT_EQ(str.view(), expected);
+    EXPECT_GE(str.capacity(), str.size());
+
+    // Appending its own bytes reads them before the old block is freed
+    str.append(str.view());
+    EXPECT_EQ(str.view(), expected + expected);
+}
+
+TEST_F(CompactStringTest, AssignReusesBlock) {
+    CompactString str(std::string(100, 'a'));
+    str.assign("short");
+    EXPECT_EQ(str.view(), "short");
+    EXPECT_EQ(str.capacity(), 100u);
+
+    str.assign(std::string(200, 'b'));
+    EXPECT_EQ(str.view(), std::string(200, 'b'));
+}
+
+TEST_F(CompactStringTest, MoveLeavesSourceEmpty) {
+    CompactString source("moved");
+    CompactString target(std::move(source));
+    EXPECT_EQ(target.view(), "moved");
+    EXPECT_EQ(source.view(), "");
+
+    source = std::move(target);
+    EXPECT_EQ(source.view(), "moved");
+}
+
+TEST_F(CompactStringTest, EmbeddedStringKeepsShortStringsInline) {
+    std::string fits(EmbeddedString::INLINE_CAPACITY, 'k');
+    EmbeddedString short_key(fits);
+    EXPECT_TRUE(short_key.isInline());
+    EXPECT_EQ(short_key.view(), fits);
+
+    std::string too_long(EmbeddedString::INLINE_CAPACITY + 1, 'k');
+    EmbeddedString long_key(too_long);
+    EXPECT_FALSE(long_key.isInline());
+    EXPECT_TRUE(long_key == too_long);
+    EXPECT_EQ(sizeof(EmbeddedString), 32u);
+}
+
+TEST_F(CompactStringTest, EmbeddedStringMoves) {
+    EmbeddedString inline_key("session:1");
+    EmbeddedString heap_key(std::string(50, 'h'));
+
+    EmbeddedString moved_inline(std::move(inline_key));
+    EmbeddedString moved_heap(std::move(heap_key));
+    EXPECT_EQ(moved_inline.view(), "session:1");
+    EXPECT_EQ(moved_heap.view(), std::string(50, 'h'));
+
+    moved_inline = std::move(moved_heap);
+    EXPECT_EQ(moved_inline.view(), std::string(50, 'h'));
+    EXPECT_FALSE(moved_inline.isInline());
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "utils/server_clock.h"
+
+class ServerClockTest : public ::testing::Test {
+protected:
+    void TearDown() override { ServerClock::stopCaching(); }
+};
+
+// First in the file, so the clock is first read here: times just before
+// and after that first read are a whole second apart in milliseconds too
+TEST_F(ServerClockTest, StepsEvenlyAroundFirstRead) {
+    auto before = std::chrono::steady_clock::now();
+    ServerClock::nowMs();
+    auto after = std::chrono::steady_clock::now();
+    for (auto t = before - std::chrono::milliseconds(2); t < after + std::chrono::milliseconds(2);
+         t += std::chrono::microseconds(100)) {
+        ServerClock::update(t);
+        int64_t ms = ServerClock::nowMs();
+        ServerClock::update(t + std::chrono::seconds(1));
+        ASSERT_EQ(ServerClock::nowMs() - ms, 1000);
+    }
+}
+
+TEST_F(ServerClockTest, StartsNearWallClock) {
+    auto wall = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    EXPECT_NEAR(static_cast<double>(ServerClock::nowMs()), static_cast<double>(wall), 1000.0);
+}
+
+TEST_F(ServerClockTest, CachedUntilNextUpdate) {
+    auto now = std::chrono::steady_clock::now();
+    ServerClock::update(now);
+    int64_t cached = ServerClock::nowMs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(ServerClock::nowMs(), cached);
+
+    ServerClock::update(now + std::chrono::seconds(5));
+    EXPECT_EQ(ServerClock::nowMs(), cached + 5000);
+}
+
+TEST_F(ServerClockTest, CacheIsPerThread) {
+    ServerClock::update(std::chrono::steady_clock::now() + std::chrono::hours(1));
+    int64_t cached = ServerClock::nowMs();
+    int64_t other = 0;
+    std::thread([&other]() { other = ServerClock::nowMs(); }).join();
+    EXPECT_LT(other, cached - 3000000);
+}
+
+TEST_F(ServerClockTest, StopCachingReadsClockAgain) {
+    ServerClock::update(std::chrono::steady_clock::now() - std::chrono::hours(1));
+    int64_t stale = ServerClock::nowMs();
+    ServerClock::stopCaching();
+    EXPECT_GT(ServerClock::nowMs(), stale + 3000000);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "utils/string_hash.h"
+#include "redis/database/key_table.h"
+
+class StringHashTest : public ::testing::Test {};
+
+TEST_F(StringHashTest, HashIsDeterministicAndSeeded) {
+    EXPECT_EQ(StringHash::hash("key"), StringHash::hash(std::string("key")));
+    EXPECT_NE(StringHash::hash("key"), StringHash::hash("key", 1));
+    EXPECT_NE(StringHash::hash(""), StringHash::hash(std::string(1, '\0')));
+}
+
+TEST_F(StringHashTest, DefaultSeedIsRandomPerProcess) {
+    uint64_t seed = StringHash::processSeed();
+    EXPECT_EQ(seed, StringHash::processSeed());
+    EXPECT_EQ(StringHash::hash("key"), StringHash::hash("key", seed));
+    // A fixed seed would let clients precompute colliding keys
+    EXPECT_NE(StringHash::hash("key"), StringHash::hash("key", 0));
+}
+
+TEST_F(StringHashTest, EveryLengthPathSpreadsKeys) {
+    // Lengths 0..200 cover the short, 16-byte and 48-byte loops
+    std::unordered_set<uint64_t> seen;
+    std::unordered_set<uint64_t> shards;
+    for (size_t len = 0; len <= 200; ++len) {
+        std::string base(len, 'a');
+        EXPECT_TRUE(seen.insert(StringHash::hash(base)).second) << len;
+        if (len > 0) {
+            base[len / 2] = 'b';
+            EXPECT_TRUE(seen.insert(StringHash::hash(base)).second) << len;
+        }
+        shards.insert(StringHash::hash("key:" + std::to_string(len)) >> 58);
+    }
+    // The high bits pick shards, so they must vary too
+    EXPECT_GT(shards.size(), 32u);
+}
+
+TEST_F(StringHashTest, LookupKeyBorrowsBytes) {
+    std::string buffer = "session:42";
+    HashedKey from_string(buffer);
+    HashedKey from_view(std::string_view(buffer).substr(0, 7));
+    EXPECT_EQ(from_string.view().data(), buffer.data());
+    EXPECT_EQ(from_string.hash(), StringHash::hash("session:42"));
+    EXPECT_EQ(from_view.hash(), StringHash::hash("session"));
+    EXPECT_FALSE(from_string == from_view);
+
+    // A hash computed earlier is taken as is
+    HashedKey rehashed(buffer, from_string.hash());
+    EXPECT_TRUE(rehashed == from_string);
+}
+
+TEST_F(StringHashTest, TableLooksUpByBorrowedKey) {
+    KeyTable<int> table;
+    table.tryEmplace(HashedKey("one"), 1);
+    table.tryEmplace(HashedKey(std::string_view("two")), 2);
+    std::string network_buffer = "two one";
+    std::string_view view(network_buffer);
+
+    auto* entry = table.find(HashedKey(view.substr(0, 3)));
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->value, 2);
+    EXPECT_TRUE(table.contains(HashedKey(view.substr(4))));
+    EXPECT_FALSE(table.contains(HashedKey("three")));
+
+    // Keys survive rehashing with their stored hashes
+    for (int i = 0; i < 1000; ++i) {
+        table.tryEmplace(HashedKey("k" + std::to_string(i)), i);
+    }
+    EXPECT_EQ(table.find(HashedKey("one"))->value, 1);
+    EXPECT_EQ(table.find(HashedKey("k999"))->value, 999);
+}
+
+// Benchmark: run with --gtest_also_run_disabled_tests
+TEST_F(StringHashTest, DISABLED_LookupBenchmark) {
+    const int key_count = 100000;
+    const int iterations = 5000000;
+    std::unordered_map<std::string, int> std_map;
+    KeyTable<int> hashed_map;
+    std::vector<std::string> keys;
+    for (int i = 0; i < key_count; ++i) {
+        keys.push_back("user:session:" + std::to_string(i * 7919));
+        std_map[keys.back()] = i;
+        hashed_map.tryEmplace(HashedKey(keys.back()), i);
+    }
+    // Views into one buffer, as the parser hands them over
+    std::string buffer;
+    for (const auto& key : keys) buffer += key;
+    std::vector<std::string_view> views;
+    size_t offset = 0;
+    for (const auto& key : keys) {
+        views.emplace_back(buffer.data() + offset, key.size());
+        offset += key.size();
+    }
+
+    long long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sum += std_map.find(std::string(views[(i * 31) % key_count]))->second;
+    }
+    std::chrono::duration<double, std::milli> std_ms = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sum += hashed_map.find(HashedKey(views[(i * 31) % key_count]))->value;
+    }
+    std::chrono::duration<double, std::milli> hashed_ms = std::chrono::steady_clock::now() - start;
+
+    std::cout << "std::string copy + std::hash: " << std_ms.count() << " ms" << std::endl;
+    std::cout << "borrowed key + wyhash:        " << hashed_ms.count() << " ms" << std::endl;
+    EXPECT_GT(sum, 0);
+}
@@ -123,6 +123,23 @@ TEST_F(UtilityFunctionsTest, IsValidKey_InvalidKeys) {
     EXPECT_FALSE(UtilityFunctions::isValidKey(std::string(1000, 'a'))); // way too long
 }
 
+TEST_F(UtilityFunctionsTest, ParseMemorySize_Units) {
+    EXPECT_EQ(UtilityFunctions::parseMemorySize("100"), 100u);
+    EXPECT_EQ(UtilityFunctions::parseMemorySize("2k"), 2000u);
+    EXPECT_EQ(UtilityFunctions::parseMemorySize("2kb"), 2048u);
+    EXPECT_EQ(UtilityFunctions::parseMemorySize("3MB"), 3u * 1024 * 1024);
+    EXPECT_EQ(UtilityFunctions::parseMemorySize("1g"), 1000000000u);
+    EXPECT_EQ(UtilityFunctions::parseMemorySize("0"), 0u);
+}
+
+TEST_F(UtilityFunctionsTest, ParseMemorySize_Invalid) {
+    EXPECT_FALSE(UtilityFunctions::parseMemorySize(""));
+    EXPECT_FALSE(UtilityFunctions::parseMemorySize("mb"));
+    EXPECT_FALSE(UtilityFunctions::parseMemorySize("-1"));
+    EXPECT_FALSE(UtilityFunctions::parseMemorySize("10tb"));
+    EXPECT_FALSE(UtilityFunctions::parseMemorySize("99999999999999999999gb"));
+}
+
 // Integration tests
 TEST_F(UtilityFunctionsTest, Integration_ParseValidInteger) {
     std::string validInt = "123";